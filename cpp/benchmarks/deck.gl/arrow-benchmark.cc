@@ -0,0 +1,168 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/table.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "./benchmark-utils.h"
+#include "deck.gl/core.h"
+#include "luma.gl/garrow.h"
+
+using namespace deckgl;
+
+namespace {
+
+/// \brief Table sizes and chunk counts to run table benchmarks with. Time per row should be about the same in all of
+/// them, regardless of the number of chunks.
+void tableSizes(benchmark::internal::Benchmark* config) {
+  config->ArgNames({"rows", "chunks"});
+  for (int64_t numRows : {1000, 100000, 1000000}) {
+    config->Args({numRows, 1});
+  }
+  config->Args({1000000, 100});
+  // Sized like large production tables, use --benchmark_filter to leave it out of quick local runs
+  config->Args({10000000, 100});
+}
+
+/// \brief Polygon counts and polygon sizes to run nested list benchmarks with.
+void polygonSizes(benchmark::internal::Benchmark* config) {
+  config->ArgNames({"polygons", "vertices"});
+  for (int64_t numPolygons : {1000, 10000, 100000}) {
+    config->Args({numPolygons, 16});
+  }
+  config->Args({10000, 128});
+}
+
+// Row access
+
+void BM_RowGetDouble(benchmark::State& state) {
+  auto table = benchmarks::createPointTable(state.range(0), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    double sum = 0.0;
+    ArrowMapper::forEachRow(table, [&](const Row& row) { sum += row.getDouble("value"); });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+}
+BENCHMARK(BM_RowGetDouble)->Apply(tableSizes);
+
+void BM_RowGetVector3(benchmark::State& state) {
+  auto table = benchmarks::createPointTable(state.range(0), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    float sum = 0.0f;
+    ArrowMapper::forEachRow(table, [&](const Row& row) { sum += row.getVector3<float>("position").x; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+}
+BENCHMARK(BM_RowGetVector3)->Apply(tableSizes);
+
+void BM_RowRandomAccess(benchmark::State& state) {
+  auto table = benchmarks::createPointTable(state.range(0), static_cast<int>(state.range(1)));
+  auto numRows = table->num_rows();
+  for (auto _ : state) {
+    double sum = 0.0;
+    // Visits rows out of order, creating a new row object for each one
+    for (int64_t i = 0, rowIndex = 0; i < numRows; ++i, rowIndex = (rowIndex + 7919) % numRows) {
+      sum += Row{table, rowIndex}.getDouble("value");
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * numRows);
+}
+BENCHMARK(BM_RowRandomAccess)->Apply(tableSizes);
+
+// Column mapping
+
+template <typename Function>
+void BM_MapColumn(benchmark::State& state, Function mapColumn) {
+  auto table = benchmarks::createPointTable(state.range(0), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mapColumn(table));
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+}
+
+BENCHMARK_CAPTURE(BM_MapColumn, Bool, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapBoolColumn(table, [](const Row& row) { return row.getBool("visible"); });
+})->Apply(tableSizes);
+BENCHMARK_CAPTURE(BM_MapColumn, Float, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapFloatColumn(table, [](const Row& row) { return row.getFloat("value"); });
+})->Apply(tableSizes);
+BENCHMARK_CAPTURE(BM_MapColumn, Vector2Float, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapVector2FloatColumn(table, [](const Row& row) { return row.getVector2<float>("position"); });
+})->Apply(tableSizes);
+BENCHMARK_CAPTURE(BM_MapColumn, Vector3Float, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapVector3FloatColumn(table, [](const Row& row) { return row.getVector3<float>("position"); });
+})->Apply(tableSizes);
+BENCHMARK_CAPTURE(BM_MapColumn, Vector3Double, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapVector3DoubleColumn(table, [](const Row& row) { return row.getVector3<double>("position"); });
+})->Apply(tableSizes);
+BENCHMARK_CAPTURE(BM_MapColumn, Vector4Float, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapVector4FloatColumn(table, [](const Row& row) { return row.getVector4<float>("color"); });
+})->Apply(tableSizes);
+BENCHMARK_CAPTURE(BM_MapColumn, Vector4Double, [](const std::shared_ptr<arrow::Table>& table) {
+  return ArrowMapper::mapVector4DoubleColumn(table, [](const Row& row) { return row.getVector4<double>("color"); });
+})->Apply(tableSizes);
+
+void BM_MapListVector3FloatColumn(benchmark::State& state) {
+  auto table = benchmarks::createPolygonTable(state.range(0), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ArrowMapper::mapListVector3FloatColumn(
+        table, [](const Row& row) { return row.getVector3List<float>("polygon"); }));
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows() * state.range(1));
+}
+BENCHMARK(BM_MapListVector3FloatColumn)->Apply(polygonSizes);
+
+// Attribute uploads
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+void BM_TransformTable(benchmark::State& state) {
+  auto device = benchmarks::createNullDevice();
+  auto table = benchmarks::createPointTable(state.range(0), static_cast<int>(state.range(1)));
+
+  auto positions = arrow::field("instancePositions", arrow::fixed_size_list(arrow::float32(), 3));
+  auto getPositions = [](const std::shared_ptr<arrow::Table>& table) {
+    return ArrowMapper::mapVector3FloatColumn(table, [](const Row& row) { return row.getVector3<float>("position"); });
+  };
+  auto colors = arrow::field("instanceColors", arrow::fixed_size_list(arrow::float32(), 4));
+  auto getColors = [](const std::shared_ptr<arrow::Table>& table) {
+    return ArrowMapper::mapVector4FloatColumn(table, [](const Row& row) { return row.getVector4<float>("color"); });
+  };
+  auto values = arrow::field("instanceValues", arrow::float32());
+  auto getValues = [](const std::shared_ptr<arrow::Table>& table) {
+    return ArrowMapper::mapFloatColumn(table, [](const Row& row) { return row.getFloat("value"); });
+  };
+  std::vector<lumagl::garrow::ColumnBuilder> builders{{positions, getPositions}, {colors, getColors},
+                                                      {values, getValues}};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lumagl::garrow::transformTable(table, builders, device));
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+}
+BENCHMARK(BM_TransformTable)->Apply(tableSizes)->Unit(benchmark::kMillisecond);
+#endif
+
+}  // anonymous namespace
@@ -0,0 +1,163 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./benchmark-utils.h"  // NOLINT(build/include)
+
+#include <arrow/builder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+#include <dawn_native/DawnNative.h>
+
+#include <vector>
+
+#include "luma.gl/webgpu.h"
+#endif
+
+namespace deckgl {
+namespace benchmarks {
+
+auto createPointTable(int64_t numRows, int numChunks) -> std::shared_ptr<arrow::Table> {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  arrow::ArrayVector valueChunks;
+  arrow::ArrayVector visibleChunks;
+  arrow::ArrayVector positionChunks;
+  arrow::ArrayVector colorChunks;
+
+  auto chunkSize = std::max<int64_t>((numRows + numChunks - 1) / numChunks, 1);
+  for (int64_t offset = 0; offset < numRows; offset += chunkSize) {
+    auto length = std::min(chunkSize, numRows - offset);
+
+    arrow::DoubleBuilder valueBuilder{pool};
+    arrow::BooleanBuilder visibleBuilder{pool};
+    arrow::FixedSizeListBuilder positionBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 3};
+    auto& coordinateBuilder = *(static_cast<arrow::FloatBuilder*>(positionBuilder.value_builder()));
+    arrow::FixedSizeListBuilder colorBuilder{pool, std::make_shared<arrow::DoubleBuilder>(pool), 4};
+    auto& channelBuilder = *(static_cast<arrow::DoubleBuilder*>(colorBuilder.value_builder()));
+    if (!valueBuilder.Reserve(length).ok() || !visibleBuilder.Reserve(length).ok() ||
+        !positionBuilder.Reserve(length).ok() || !coordinateBuilder.Reserve(length * 3).ok() ||
+        !colorBuilder.Reserve(length).ok() || !channelBuilder.Reserve(length * 4).ok()) {
+      throw std::runtime_error("Unable to reserve benchmark data");
+    }
+
+    for (int64_t i = offset; i < offset + length; ++i) {
+      float position[] = {static_cast<float>(i % 360) - 180.0f, static_cast<float>(i % 170) - 85.0f, 0.0f};
+      double color[] = {static_cast<double>(i % 256), 128.0, 64.0, 255.0};
+      if (!valueBuilder.Append(static_cast<double>(i)).ok() || !visibleBuilder.Append(i % 2 == 0).ok() ||
+          !positionBuilder.Append().ok() || !coordinateBuilder.AppendValues(position, 3).ok() ||
+          !colorBuilder.Append().ok() || !channelBuilder.AppendValues(color, 4).ok()) {
+        throw std::runtime_error("Unable to append benchmark data");
+      }
+    }
+
+    std::shared_ptr<arrow::Array> values;
+    std::shared_ptr<arrow::Array> visible;
+    std::shared_ptr<arrow::Array> positions;
+    std::shared_ptr<arrow::Array> colors;
+    if (!valueBuilder.Finish(&values).ok() || !visibleBuilder.Finish(&visible).ok() ||
+        !positionBuilder.Finish(&positions).ok() || !colorBuilder.Finish(&colors).ok()) {
+      throw std::runtime_error("Unable to finish benchmark data");
+    }
+    valueChunks.push_back(values);
+    visibleChunks.push_back(visible);
+    positionChunks.push_back(positions);
+    colorChunks.push_back(colors);
+  }
+
+  auto schema = arrow::schema({arrow::field("value", arrow::float64()), arrow::field("visible", arrow::boolean()),
+                               arrow::field("position", arrow::fixed_size_list(arrow::float32(), 3)),
+                               arrow::field("color", arrow::fixed_size_list(arrow::float64(), 4))});
+  return arrow::Table::Make(
+      schema, {std::make_shared<arrow::ChunkedArray>(valueChunks), std::make_shared<arrow::ChunkedArray>(visibleChunks),
+               std::make_shared<arrow::ChunkedArray>(positionChunks),
+               std::make_shared<arrow::ChunkedArray>(colorChunks)});
+}
+
+auto createPolygonTable(int64_t numRows, int verticesPerPolygon) -> std::shared_ptr<arrow::Table> {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  auto pointBuilder =
+      std::make_shared<arrow::FixedSizeListBuilder>(pool, std::make_shared<arrow::FloatBuilder>(pool), 3);
+  auto& coordinateBuilder = *(static_cast<arrow::FloatBuilder*>(pointBuilder->value_builder()));
+  arrow::ListBuilder polygonBuilder{pool, pointBuilder};
+  if (!polygonBuilder.Reserve(numRows).ok() || !pointBuilder->Reserve(numRows * verticesPerPolygon).ok() ||
+      !coordinateBuilder.Reserve(numRows * verticesPerPolygon * 3).ok()) {
+    throw std::runtime_error("Unable to reserve benchmark data");
+  }
+
+  // Star shaped polygons laid out on a grid, small enough not to overlap
+  auto gridSize = static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(numRows))));
+  auto cellSize = 0.01;
+  for (int64_t i = 0; i < numRows; ++i) {
+    auto centerX = static_cast<double>(i % gridSize) * cellSize;
+    auto centerY = static_cast<double>(i / gridSize) * cellSize;
+    if (!polygonBuilder.Append().ok()) {
+      throw std::runtime_error("Unable to append benchmark data");
+    }
+
+    for (int vertex = 0; vertex < verticesPerPolygon; ++vertex) {
+      auto angle = 2.0 * M_PI * vertex / verticesPerPolygon;
+      auto radius = (vertex % 2 == 0 ? 0.45 : 0.2) * cellSize;
+      float point[] = {static_cast<float>(centerX + radius * std::cos(angle)),
+                       static_cast<float>(centerY + radius * std::sin(angle)), 0.0f};
+      if (!pointBuilder->Append().ok() || !coordinateBuilder.AppendValues(point, 3).ok()) {
+        throw std::runtime_error("Unable to append benchmark data");
+      }
+    }
+  }
+
+  std::shared_ptr<arrow::Array> polygons;
+  if (!polygonBuilder.Finish(&polygons).ok()) {
+    throw std::runtime_error("Unable to finish benchmark data");
+  }
+
+  auto schema = arrow::schema({arrow::field("polygon", arrow::list(arrow::fixed_size_list(arrow::float32(), 3)))});
+  return arrow::Table::Make(schema, {polygons});
+}
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+auto createNullDevice() -> wgpu::Device {
+  // Instance has to outlive the devices created from it, and is expensive to create, so it is shared by all benchmarks
+  static auto instance = []() {
+    lumagl::utils::initializeProcTable();
+
+    auto instance = std::make_unique<dawn_native::Instance>();
+    instance->DiscoverDefaultAdapters();
+    return instance;
+  }();
+
+  std::vector<dawn_native::Adapter> adapters = instance->GetAdapters();
+  auto adapterIt = std::find_if(adapters.begin(), adapters.end(), [](const dawn_native::Adapter adapter) -> bool {
+    wgpu::AdapterProperties properties;
+    adapter.GetProperties(&properties);
+    return properties.backendType == wgpu::BackendType::Null;
+  });
+  if (adapterIt == adapters.end()) {
+    throw std::runtime_error("Null backend adapter not available");
+  }
+
+  return wgpu::Device::Acquire(adapterIt->CreateDevice());
+}
+#endif
+
+}  // namespace benchmarks
+}  // namespace deckgl
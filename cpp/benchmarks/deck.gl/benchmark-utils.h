@@ -0,0 +1,58 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_BENCHMARKS_BENCHMARK_UTILS_H
+#define DECKGL_BENCHMARKS_BENCHMARK_UTILS_H
+
+#include <arrow/table.h>
+
+#include <cstdint>
+#include <memory>
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+#include <dawn/webgpu_cpp.h>
+#endif
+
+namespace deckgl {
+namespace benchmarks {
+
+/// \brief Creates a table of points, split into equally sized chunks.
+/// Contains a double "value" column, a boolean "visible" column, a float fixed list "position" column and a double
+/// fixed list "color" column.
+/// \param numRows Number of rows in the table.
+/// \param numChunks Number of chunks each column is split into.
+auto createPointTable(int64_t numRows, int numChunks = 1) -> std::shared_ptr<arrow::Table>;
+
+/// \brief Creates a table with a "polygon" column, which holds a list of [lng, lat, z] float points for each row.
+/// Polygons are concave, so that tessellating them isn't trivial.
+/// \param numRows Number of polygons in the table.
+/// \param verticesPerPolygon Number of vertices in each polygon.
+auto createPolygonTable(int64_t numRows, int verticesPerPolygon) -> std::shared_ptr<arrow::Table>;
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+/// \brief Creates a device on top of the Null backend, which doesn't need a window or a GPU.
+/// \note Throws if the Null backend isn't available.
+auto createNullDevice() -> wgpu::Device;
+#endif
+
+}  // namespace benchmarks
+}  // namespace deckgl
+
+#endif  // DECKGL_BENCHMARKS_BENCHMARK_UTILS_H
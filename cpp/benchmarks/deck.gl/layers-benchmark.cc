@@ -0,0 +1,155 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/table.h>
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+
+#include "./benchmark-utils.h"
+#include "deck.gl/core.h"
+#include "deck.gl/layers.h"
+
+using namespace deckgl;
+
+namespace {
+
+void BM_SolidPolygonLayerProcessData(benchmark::State& state) {
+  auto table = benchmarks::createPolygonTable(state.range(0), static_cast<int>(state.range(1)));
+  SolidPolygonLayer layer{std::make_shared<SolidPolygonLayer::Props>()};
+
+  // Includes tessellating polygons with earcut
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(layer.processData(table));
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+}
+BENCHMARK(BM_SolidPolygonLayerProcessData)
+    ->ArgNames({"polygons", "vertices"})
+    ->Args({1000, 16})
+    ->Args({10000, 16})
+    ->Args({100000, 16})
+    ->Args({10000, 128})
+    ->Unit(benchmark::kMillisecond);
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+
+/// \brief Runs layer lifecycle methods within a Deck on top of the Null backend, which doesn't need a window or a GPU.
+/// Measures the whole data to GPU attribute pipeline, including buffer uploads.
+class NullBackendFixture : public benchmark::Fixture {
+ public:
+  using benchmark::Fixture::SetUp;
+  using benchmark::Fixture::TearDown;
+
+  void SetUp(const benchmark::State&) override {
+    auto device = benchmarks::createNullDevice();
+    auto props = std::make_shared<Deck::Props>();
+    props->drawingOptions = std::make_shared<DrawingOptions>(device, device.CreateQueue());
+    this->deck = std::make_shared<Deck>(props);
+  }
+
+  void TearDown(const benchmark::State&) override { this->deck = nullptr; }
+
+  /// \brief Measures adding a layer to the deck, which initializes it and builds all of its attributes.
+  void initializeLayer(benchmark::State& state, const std::shared_ptr<Layer::Props>& props) {
+    for (auto _ : state) {
+      this->deck->layerManager->setLayersFromProps({props});
+
+      state.PauseTiming();
+      this->deck->layerManager->setLayersFromProps({});
+      state.ResumeTiming();
+    }
+  }
+
+  /// \brief Measures updating an already initialized layer with new data of the same size.
+  void updateLayer(benchmark::State& state, const std::array<std::shared_ptr<Layer::Props>, 2>& props) {
+    this->deck->layerManager->setLayersFromProps({props[0]});
+
+    size_t iteration = 0;
+    for (auto _ : state) {
+      this->deck->layerManager->setLayersFromProps({props[++iteration % props.size()]});
+      for (const auto& layer : this->deck->layerManager->layers()) {
+        layer->setDataChangedFlag("Data updated");
+      }
+      this->deck->layerManager->updateLayers();
+    }
+  }
+
+  std::shared_ptr<Deck> deck;
+};
+
+auto createScatterplotLayerProps(int64_t numRows) -> std::shared_ptr<ScatterplotLayer::Props> {
+  auto props = std::make_shared<ScatterplotLayer::Props>();
+  props->id = "scatterplot";
+  props->data = benchmarks::createPointTable(numRows);
+  props->getFillColor = [](const Row& row) { return row.getVector4<float>("color"); };
+
+  return props;
+}
+
+auto createSolidPolygonLayerProps(int64_t numRows) -> std::shared_ptr<SolidPolygonLayer::Props> {
+  auto props = std::make_shared<SolidPolygonLayer::Props>();
+  props->id = "solid-polygon";
+  props->data = benchmarks::createPolygonTable(numRows, 16);
+
+  return props;
+}
+
+BENCHMARK_DEFINE_F(NullBackendFixture, ScatterplotLayerInitialize)(benchmark::State& state) {
+  this->initializeLayer(state, createScatterplotLayerProps(state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(NullBackendFixture, ScatterplotLayerInitialize)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(NullBackendFixture, ScatterplotLayerUpdate)(benchmark::State& state) {
+  this->updateLayer(state, {createScatterplotLayerProps(state.range(0)), createScatterplotLayerProps(state.range(0))});
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(NullBackendFixture, ScatterplotLayerUpdate)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(NullBackendFixture, SolidPolygonLayerInitialize)(benchmark::State& state) {
+  this->initializeLayer(state, createSolidPolygonLayerProps(state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(NullBackendFixture, SolidPolygonLayerInitialize)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(NullBackendFixture, SolidPolygonLayerUpdate)(benchmark::State& state) {
+  this->updateLayer(state,
+                    {createSolidPolygonLayerProps(state.range(0)), createSolidPolygonLayerProps(state.range(0))});
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(NullBackendFixture, SolidPolygonLayerUpdate)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+
+#endif
+
+}  // anonymous namespace
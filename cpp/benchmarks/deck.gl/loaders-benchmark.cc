@@ -0,0 +1,272 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/buffer.h>
+#include <arrow/io/buffered.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/writer.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "./benchmark-utils.h"
+#include "loaders.gl/csv.h"
+#include "loaders.gl/ipc.h"
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief Row counts to run loader benchmarks with.
+void rowCounts(benchmark::internal::Benchmark* config) {
+  config->ArgNames({"rows"});
+  for (int64_t numRows : {10000, 1000000}) {
+    config->Args({numRows});
+  }
+}
+
+/// \brief Creates CSV data with a numeric "value" column, "lng" and "lat" coordinate columns and a "name" column.
+auto createPointCSV(int64_t numRows) -> std::shared_ptr<arrow::Buffer> {
+  std::string csv = "value,lng,lat,name\n";
+  for (int64_t i = 0; i < numRows; ++i) {
+    auto lng = -180.0 + 360.0 * static_cast<double>(i % 7919) / 7919;
+    auto lat = -85.0 + 170.0 * static_cast<double>(i % 6271) / 6271;
+    csv += std::to_string(i) + "," + std::to_string(lng) + "," + std::to_string(lat) + ",point " + std::to_string(i);
+    csv += "\n";
+  }
+  return arrow::Buffer::FromString(std::move(csv));
+}
+
+void BM_CSVLoadTable(benchmark::State& state) {
+  auto csv = createPointCSV(state.range(0));
+  CSVLoader loader;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(loader.loadTable(std::make_shared<arrow::io::BufferReader>(csv)));
+  }
+  state.SetBytesProcessed(state.iterations() * csv->size());
+}
+BENCHMARK(BM_CSVLoadTable)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+void BM_CSVLoadBatches(benchmark::State& state) {
+  auto csv = createPointCSV(state.range(0));
+  CSVLoader loader;
+  for (auto _ : state) {
+    auto progress = loader.loadBatches(std::make_shared<arrow::io::BufferReader>(csv),
+                                       [](const std::shared_ptr<arrow::RecordBatch>&) { return true; });
+    benchmark::DoNotOptimize(progress);
+  }
+  state.SetBytesProcessed(state.iterations() * csv->size());
+}
+BENCHMARK(BM_CSVLoadBatches)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+/// \brief Time until the first rows can be displayed, which unlike loading the whole table shouldn't depend on size.
+void BM_CSVTimeToFirstBatch(benchmark::State& state) {
+  auto csv = createPointCSV(state.range(0));
+  CSVLoader loader;
+  for (auto _ : state) {
+    auto reader = loader.openBatchReader(std::make_shared<arrow::io::BufferReader>(csv));
+    std::shared_ptr<arrow::RecordBatch> batch;
+    if (!reader->ReadNext(&batch).ok()) {
+      state.SkipWithError("Failed to read the first batch");
+      break;
+    }
+    benchmark::DoNotOptimize(batch);
+  }
+}
+BENCHMARK(BM_CSVTimeToFirstBatch)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+/// \brief Reads a stream ahead on a separate thread, a chunk at a time, so that reading overlaps with parsing.
+class ReadaheadInputStream : public arrow::io::InputStream {
+ public:
+  ReadaheadInputStream(const std::shared_ptr<arrow::io::InputStream>& input, int64_t chunkSize, size_t maxChunks)
+      : _input{input} {
+    this->_thread = std::thread([this, chunkSize, maxChunks]() {
+      while (true) {
+        auto readResult = this->_input->Read(chunkSize);
+        auto chunk = readResult.ok() ? readResult.ValueOrDie() : nullptr;
+
+        std::unique_lock<std::mutex> lock{this->_mutex};
+        this->_chunkRead.wait(lock, [&]() { return this->_stopped || this->_chunks.size() < maxChunks; });
+        if (this->_stopped) {
+          return;
+        }
+        // Empty and failed reads both end the stream
+        this->_chunks.push_back(chunk && chunk->size() > 0 ? chunk : nullptr);
+        this->_chunkReady.notify_one();
+        if (!this->_chunks.back()) {
+          return;
+        }
+      }
+    });
+  }
+
+  ~ReadaheadInputStream() override {
+    {
+      std::lock_guard<std::mutex> lock{this->_mutex};
+      this->_stopped = true;
+    }
+    this->_chunkRead.notify_one();
+    this->_thread.join();
+  }
+
+  auto Close() -> arrow::Status override { return arrow::Status::OK(); }
+  auto closed() const -> bool override { return false; }
+  auto Tell() const -> arrow::Result<int64_t> override { return this->_position; }
+
+  auto Read(int64_t nbytes) -> arrow::Result<std::shared_ptr<arrow::Buffer>> override {
+    if (!this->_chunk || this->_chunk->size() == 0) {
+      std::unique_lock<std::mutex> lock{this->_mutex};
+      this->_chunkReady.wait(lock, [&]() { return !this->_chunks.empty(); });
+      this->_chunk = this->_chunks.front();
+      if (!this->_chunk) {
+        return std::make_shared<arrow::Buffer>(nullptr, 0);
+      }
+      this->_chunks.pop_front();
+      this->_chunkRead.notify_one();
+    }
+
+    // Reads may return less than requested, at most the rest of the current chunk
+    auto length = std::min(nbytes, this->_chunk->size());
+    auto buffer = arrow::SliceBuffer(this->_chunk, 0, length);
+    this->_chunk = arrow::SliceBuffer(this->_chunk, length);
+    this->_position += length;
+    return buffer;
+  }
+
+  auto Read(int64_t nbytes, void* out) -> arrow::Result<int64_t> override {
+    auto readResult = this->Read(nbytes);
+    if (!readResult.ok()) {
+      return readResult.status();
+    }
+    auto buffer = readResult.ValueOrDie();
+    std::memcpy(out, buffer->data(), static_cast<size_t>(buffer->size()));
+    return buffer->size();
+  }
+
+ private:
+  std::shared_ptr<arrow::io::InputStream> _input;
+  std::shared_ptr<arrow::Buffer> _chunk;
+  int64_t _position{0};
+
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _chunkReady;
+  std::condition_variable _chunkRead;
+  std::deque<std::shared_ptr<arrow::Buffer>> _chunks;
+  bool _stopped{false};
+};
+
+/// \brief Ways of reading a local CSV file that BM_CSVLoadFile compares.
+enum FileInput { BUFFERED, MEMORY_MAPPED, READAHEAD };
+
+/// \brief Returns a local CSV file to load, which is DECKGL_BENCHMARK_CSV_FILE if set, such as a multi-gigabyte file,
+/// or a generated file of points otherwise.
+auto getCSVFile(int64_t numRows, bool* generated) -> std::string {
+  if (auto path = std::getenv("DECKGL_BENCHMARK_CSV_FILE")) {
+    *generated = false;
+    return path;
+  }
+
+  auto path = (std::filesystem::temp_directory_path() / "deckgl-benchmark.csv").string();
+  auto csv = createPointCSV(numRows);
+  auto sink = arrow::io::FileOutputStream::Open(path).ValueOrDie();
+  if (!sink->Write(csv->data(), csv->size()).ok() || !sink->Close().ok()) {
+    throw std::runtime_error("Failed to write CSV file");
+  }
+  *generated = true;
+  return path;
+}
+
+/// \brief Loads a local CSV file through buffered reads, a memory mapping, or buffered reads on a read-ahead thread.
+/// The file stays in the page cache between iterations, so this compares the cost of getting data to the parser rather
+/// than disk throughput. Parsing is single threaded, so that input overhead isn't hidden by parallel parsing.
+void BM_CSVLoadFile(benchmark::State& state) {
+  bool generated = false;
+  auto path = getCSVFile(state.range(1), &generated);
+  auto fileSize = std::filesystem::file_size(path);
+
+  LoaderOptions options;
+  options.useThreads = false;
+  CSVLoader loader{options};
+  auto input = static_cast<FileInput>(state.range(0));
+  for (auto _ : state) {
+    if (input == MEMORY_MAPPED) {
+      benchmark::DoNotOptimize(loader.loadTable(path));
+      continue;
+    }
+
+    auto file = arrow::io::ReadableFile::Open(path).ValueOrDie();
+    auto buffered = arrow::io::BufferedInputStream::Create(options.blockSize, arrow::default_memory_pool(), file)
+                        .ValueOrDie();
+    if (input == READAHEAD) {
+      benchmark::DoNotOptimize(
+          loader.loadTable(std::make_shared<ReadaheadInputStream>(buffered, options.blockSize, 4)));
+    } else {
+      benchmark::DoNotOptimize(loader.loadTable(buffered));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(fileSize));
+
+  if (generated) {
+    std::remove(path.c_str());
+  }
+}
+BENCHMARK(BM_CSVLoadFile)
+    ->ArgNames({"input", "rows"})
+    ->Args({BUFFERED, 1000000})
+    ->Args({MEMORY_MAPPED, 1000000})
+    ->Args({READAHEAD, 1000000})
+    ->Unit(benchmark::kMillisecond);
+
+/// \brief Memory mapped IPC files are loaded without parsing or copying, so load time shouldn't depend on size.
+void BM_ArrowIPCLoadTable(benchmark::State& state) {
+  auto table = deckgl::benchmarks::createPointTable(state.range(0));
+  auto path = (std::filesystem::temp_directory_path() / "deckgl-benchmark.arrow").string();
+  {
+    auto sink = arrow::io::FileOutputStream::Open(path).ValueOrDie();
+    auto writer = arrow::ipc::NewFileWriter(sink.get(), table->schema()).ValueOrDie();
+    if (!writer->WriteTable(*table).ok() || !writer->Close().ok() || !sink->Close().ok()) {
+      state.SkipWithError("Failed to write IPC file");
+      return;
+    }
+  }
+
+  ArrowIPCLoader loader;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(loader.loadTable(path));
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_ArrowIPCLoadTable)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+}  // anonymous namespace
@@ -0,0 +1,92 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "deck.gl/core.h"
+#include "math.gl/web-mercator.h"
+
+using namespace deckgl;
+
+namespace {
+
+/// \brief Creates viewport options that differ for each index, so that no two consecutive viewports are the same.
+auto createViewportOptions(int64_t index) -> WebMercatorViewport::Options {
+  WebMercatorViewport::Options options;
+  options.width = 1280;
+  options.height = 720;
+  options.longitude = -122.45 + static_cast<double>(index % 100) * 0.001;
+  options.latitude = 37.78 + static_cast<double>(index % 50) * 0.001;
+  options.zoom = static_cast<double>(index % 20);
+  options.pitch = static_cast<double>(index % 60);
+  options.bearing = static_cast<double>(index % 360);
+
+  return options;
+}
+
+void BM_WebMercatorViewport(benchmark::State& state) {
+  auto count = state.range(0);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < count; ++i) {
+      WebMercatorViewport viewport{createViewportOptions(i)};
+      benchmark::DoNotOptimize(viewport.pixelUnprojectionMatrix);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_WebMercatorViewport)->RangeMultiplier(10)->Range(1, 10000);
+
+void BM_GetUniformsFromViewport(benchmark::State& state) {
+  // Uniforms are recalculated for each layer whenever the viewport changes
+  std::vector<std::shared_ptr<Viewport>> viewports;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    viewports.push_back(std::make_shared<WebMercatorViewport>(createViewportOptions(i)));
+  }
+
+  for (auto _ : state) {
+    for (const auto& viewport : viewports) {
+      benchmark::DoNotOptimize(getUniformsFromViewport(viewport));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetUniformsFromViewport)->RangeMultiplier(10)->Range(1, 10000);
+
+void BM_LngLatToWorld(benchmark::State& state) {
+  std::vector<mathgl::Vector2<double>> lngLats;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    lngLats.push_back({static_cast<double>(i % 360) - 180.0, static_cast<double>(i % 170) - 85.0});
+  }
+
+  for (auto _ : state) {
+    mathgl::Vector2<double> sum;
+    for (const auto& lngLat : lngLats) {
+      sum += mathgl::lngLatToWorld(lngLat);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LngLatToWorld)->RangeMultiplier(100)->Range(100, 1000000);
+
+}  // anonymous namespace
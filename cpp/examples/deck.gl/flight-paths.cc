@@ -73,7 +73,11 @@ auto createScatterplotLayer(const std::string &dataPath) -> std::shared_ptr<Scat
       return 60.0f;
     }
   };
-  props->getFillColor = [](const Row &row) { return mathgl::Vector4<float>{255.0f, 144.0f, 0.0f, 255.0f}; };
+  // Airports are colored by type through a palette, instead of comparing types of each airport
+  props->fillColorCategoryColumn = "type";
+  props->fillColorPalette = {{"major", mathgl::Vector4<float>{255.0f, 144.0f, 0.0f, 255.0f}},
+                             {"small", mathgl::Vector4<float>{255.0f, 208.0f, 128.0f, 255.0f}}};
+  props->fillColorPaletteFallback = mathgl::Vector4<float>{255.0f, 176.0f, 64.0f, 255.0f};
   props->stroked = true;
   props->getLineWidth = [](const Row &row) { return 5.0f; };
   props->getLineColor = [](const Row &row) { return mathgl::Vector4<float>{255.0f, 0.0f, 0.0f, 255.0f}; };
@@ -22,22 +22,64 @@
 
 #include <arrow/builder.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 using namespace deckgl;
 
-auto ArrowMapper::mapBoolColumn(const std::shared_ptr<arrow::Table>& table, std::function<BoolAccessor> getValueFromRow)
-    -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
+namespace {
+
+/// \brief Looks up the category of each value of a dictionary, or of a plain string chunk.
+auto getCategoryIndices(const arrow::Array& values, Categories& categories) -> std::vector<uint32_t> {
+  if (values.type_id() != arrow::Type::STRING) {
+    throw std::runtime_error("Category column must contain strings, found " + values.type()->ToString());
+  }
+
+  const auto& stringValues = static_cast<const arrow::StringArray&>(values);
+  std::vector<uint32_t> indices(static_cast<size_t>(values.length()), ArrowMapper::kNullCategory);
+  for (int64_t i = 0; i < values.length(); ++i) {
+    if (stringValues.IsValid(i)) {
+      indices[i] = categories.getIndex(stringValues.GetString(i));
+    }
+  }
+
+  return indices;
+}
+
+/// \brief Translates dictionary indices of a chunk into category indices, without touching dictionary values.
+template <typename IndexArrayType>
+void translateDictionaryIndices(const arrow::DictionaryArray& chunk, const std::vector<uint32_t>& dictionaryCategories,
+                                uint32_t* categoryIndices) {
+  const auto& indices = static_cast<const IndexArrayType&>(*chunk.indices());
+  for (int64_t i = 0; i < chunk.length(); ++i) {
+    categoryIndices[i] =
+        chunk.IsValid(i) ? dictionaryCategories[static_cast<size_t>(indices.Value(i))] : ArrowMapper::kNullCategory;
+  }
+}
+
+}  // anonymous namespace
+
+auto Categories::getIndex(const std::string& value) -> uint32_t {
+  auto [entry, inserted] = this->_indices.emplace(value, static_cast<uint32_t>(this->_values.size()));
+  if (inserted) {
+    this->_values.push_back(value);
+  }
+
+  return entry->second;
+}
+
+auto ArrowMapper::mapBoolColumn(const std::shared_ptr<arrow::Table>& table, std::function<BoolAccessor> getValueFromRow,
+                                arrow::MemoryPool* pool) -> std::shared_ptr<arrow::Array> {
   arrow::BooleanBuilder builder{pool};
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto value = getValueFromRow(row);
 
     if (!builder.Append(value).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!builder.Finish(&resultArray).ok()) {
@@ -48,19 +90,17 @@ auto ArrowMapper::mapBoolColumn(const std::shared_ptr<arrow::Table>& table, std:
 }
 
 auto ArrowMapper::mapFloatColumn(const std::shared_ptr<arrow::Table>& table,
-                                 std::function<FloatAccessor> getValueFromRow) -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
+                                 std::function<FloatAccessor> getValueFromRow, arrow::MemoryPool* pool)
+    -> std::shared_ptr<arrow::Array> {
   arrow::FloatBuilder builder{pool};
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto value = getValueFromRow(row);
 
     if (!builder.Append(value).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!builder.Finish(&resultArray).ok()) {
@@ -71,15 +111,12 @@ auto ArrowMapper::mapFloatColumn(const std::shared_ptr<arrow::Table>& table,
 }
 
 auto ArrowMapper::mapVector2FloatColumn(const std::shared_ptr<arrow::Table>& table,
-                                        std::function<Vector2FloatAccessor> getValueFromRow)
+                                        std::function<Vector2FloatAccessor> getValueFromRow, arrow::MemoryPool* pool)
     -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
   arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 2};
   arrow::FloatBuilder& valueBuilder = *(static_cast<arrow::FloatBuilder*>(listBuilder.value_builder()));
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto vector = getValueFromRow(row);
 
     if (!listBuilder.Append().ok()) {
@@ -89,7 +126,7 @@ auto ArrowMapper::mapVector2FloatColumn(const std::shared_ptr<arrow::Table>& tab
     if (!valueBuilder.AppendValues(&vector.x, 2).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!listBuilder.Finish(&resultArray).ok()) {
@@ -100,15 +137,12 @@ auto ArrowMapper::mapVector2FloatColumn(const std::shared_ptr<arrow::Table>& tab
 }
 
 auto ArrowMapper::mapVector3FloatColumn(const std::shared_ptr<arrow::Table>& table,
-                                        std::function<Vector3FloatAccessor> getValueFromRow)
+                                        std::function<Vector3FloatAccessor> getValueFromRow, arrow::MemoryPool* pool)
     -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
   arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 3};
   arrow::FloatBuilder& valueBuilder = *(static_cast<arrow::FloatBuilder*>(listBuilder.value_builder()));
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto vector = getValueFromRow(row);
 
     if (!listBuilder.Append().ok()) {
@@ -118,7 +152,7 @@ auto ArrowMapper::mapVector3FloatColumn(const std::shared_ptr<arrow::Table>& tab
     if (!valueBuilder.AppendValues(&vector.x, 3).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!listBuilder.Finish(&resultArray).ok()) {
@@ -129,15 +163,12 @@ auto ArrowMapper::mapVector3FloatColumn(const std::shared_ptr<arrow::Table>& tab
 }
 
 auto ArrowMapper::mapVector3DoubleColumn(const std::shared_ptr<arrow::Table>& table,
-                                         std::function<Vector3DoubleAccessor> getValueFromRow)
+                                         std::function<Vector3DoubleAccessor> getValueFromRow, arrow::MemoryPool* pool)
     -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
   arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::DoubleBuilder>(pool), 3};
   arrow::DoubleBuilder& valueBuilder = *(static_cast<arrow::DoubleBuilder*>(listBuilder.value_builder()));
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto vector = getValueFromRow(row);
 
     if (!listBuilder.Append().ok()) {
@@ -147,7 +178,7 @@ auto ArrowMapper::mapVector3DoubleColumn(const std::shared_ptr<arrow::Table>& ta
     if (!valueBuilder.AppendValues(&vector.x, 3).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!listBuilder.Finish(&resultArray).ok()) {
@@ -158,15 +189,12 @@ auto ArrowMapper::mapVector3DoubleColumn(const std::shared_ptr<arrow::Table>& ta
 }
 
 auto ArrowMapper::mapVector4FloatColumn(const std::shared_ptr<arrow::Table>& table,
-                                        std::function<Vector4FloatAccessor> getValueFromRow)
+                                        std::function<Vector4FloatAccessor> getValueFromRow, arrow::MemoryPool* pool)
     -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
   arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 4};
   arrow::FloatBuilder& valueBuilder = *(static_cast<arrow::FloatBuilder*>(listBuilder.value_builder()));
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto vector = getValueFromRow(row);
 
     if (!listBuilder.Append().ok()) {
@@ -176,7 +204,7 @@ auto ArrowMapper::mapVector4FloatColumn(const std::shared_ptr<arrow::Table>& tab
     if (!valueBuilder.AppendValues(&vector.x, 4).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!listBuilder.Finish(&resultArray).ok()) {
@@ -187,15 +215,12 @@ auto ArrowMapper::mapVector4FloatColumn(const std::shared_ptr<arrow::Table>& tab
 }
 
 auto ArrowMapper::mapVector4DoubleColumn(const std::shared_ptr<arrow::Table>& table,
-                                         std::function<Vector4DoubleAccessor> getValueFromRow)
+                                         std::function<Vector4DoubleAccessor> getValueFromRow, arrow::MemoryPool* pool)
     -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
-  arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::DoubleBuilder>(pool), 3};
+  arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::DoubleBuilder>(pool), 4};
   arrow::DoubleBuilder& valueBuilder = *(static_cast<arrow::DoubleBuilder*>(listBuilder.value_builder()));
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto vector = getValueFromRow(row);
 
     if (!listBuilder.Append().ok()) {
@@ -205,7 +230,7 @@ auto ArrowMapper::mapVector4DoubleColumn(const std::shared_ptr<arrow::Table>& ta
     if (!valueBuilder.AppendValues(&vector.x, 4).ok()) {
       throw std::runtime_error("Unable to append vector data");
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!listBuilder.Finish(&resultArray).ok()) {
@@ -216,17 +241,13 @@ auto ArrowMapper::mapVector4DoubleColumn(const std::shared_ptr<arrow::Table>& ta
 }
 
 auto ArrowMapper::mapListVector3FloatColumn(const std::shared_ptr<arrow::Table>& table,
-                                            std::function<ListVector3FloatAccessor> getValueFromRow)
-    -> std::shared_ptr<arrow::Array> {
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
-
+                                            std::function<ListVector3FloatAccessor> getValueFromRow,
+                                            arrow::MemoryPool* pool) -> std::shared_ptr<arrow::Array> {
   auto valueBuilder = std::make_shared<arrow::FloatBuilder>(pool);
   auto vectorBuilder = std::make_shared<arrow::FixedSizeListBuilder>(pool, valueBuilder, 3);
   auto listBuilder = std::make_shared<arrow::ListBuilder>(pool, vectorBuilder);
 
-  for (auto i = 0; i < table->num_rows(); ++i) {
-    // TODO(ilija@unfolded.ai): Move row object creation out of the loop
-    auto row = Row{table, i};
+  ArrowMapper::forEachRow(table, [&](const Row& row) {
     auto listData = getValueFromRow(row);
 
     if (!listBuilder->Append().ok()) {
@@ -242,7 +263,7 @@ auto ArrowMapper::mapListVector3FloatColumn(const std::shared_ptr<arrow::Table>&
         throw std::runtime_error("Unable to append vector data");
       }
     }
-  }
+  });
 
   std::shared_ptr<arrow::Array> resultArray;
   if (!listBuilder->Finish(&resultArray).ok()) {
@@ -251,3 +272,56 @@ auto ArrowMapper::mapListVector3FloatColumn(const std::shared_ptr<arrow::Table>&
 
   return resultArray;
 }
+
+auto ArrowMapper::mapCategoryColumn(const std::shared_ptr<arrow::Table>& table, const std::string& columnName,
+                                    Categories& categories, arrow::MemoryPool* pool) -> std::shared_ptr<arrow::Array> {
+  std::vector<uint32_t> categoryIndices(static_cast<size_t>(table->num_rows()), ArrowMapper::kNullCategory);
+
+  // Rows are left without a category when the column is missing
+  auto column = table->GetColumnByName(columnName);
+  auto chunks = column ? column->chunks() : arrow::ArrayVector{};
+  int64_t chunkOffset = 0;
+  for (const auto& chunk : chunks) {
+    auto chunkCategoryIndices = categoryIndices.data() + chunkOffset;
+    chunkOffset += chunk->length();
+
+    if (chunk->type_id() != arrow::Type::DICTIONARY) {
+      auto indices = getCategoryIndices(*chunk, categories);
+      std::copy(indices.begin(), indices.end(), chunkCategoryIndices);
+      continue;
+    }
+
+    // Distinct values are looked up once, rows then only translate dictionary indices into category indices
+    const auto& dictionaryChunk = static_cast<const arrow::DictionaryArray&>(*chunk);
+    auto dictionaryCategories = getCategoryIndices(*dictionaryChunk.dictionary(), categories);
+    switch (dictionaryChunk.indices()->type_id()) {
+      case arrow::Type::INT8:
+        translateDictionaryIndices<arrow::Int8Array>(dictionaryChunk, dictionaryCategories, chunkCategoryIndices);
+        break;
+      case arrow::Type::INT16:
+        translateDictionaryIndices<arrow::Int16Array>(dictionaryChunk, dictionaryCategories, chunkCategoryIndices);
+        break;
+      case arrow::Type::INT32:
+        translateDictionaryIndices<arrow::Int32Array>(dictionaryChunk, dictionaryCategories, chunkCategoryIndices);
+        break;
+      case arrow::Type::INT64:
+        translateDictionaryIndices<arrow::Int64Array>(dictionaryChunk, dictionaryCategories, chunkCategoryIndices);
+        break;
+
+      default:
+        throw std::runtime_error("Unsupported dictionary index type " + dictionaryChunk.indices()->type()->ToString());
+    }
+  }
+
+  arrow::UInt32Builder builder{pool};
+  if (!builder.AppendValues(categoryIndices.data(), static_cast<int64_t>(categoryIndices.size())).ok()) {
+    throw std::runtime_error("Unable to append category data");
+  }
+
+  std::shared_ptr<arrow::Array> resultArray;
+  if (!builder.Finish(&resultArray).ok()) {
+    throw std::runtime_error("Unable to append category data");
+  }
+
+  return resultArray;
+}
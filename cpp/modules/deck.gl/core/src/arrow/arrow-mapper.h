@@ -24,7 +24,11 @@
 #include <arrow/array.h>
 #include <arrow/table.h>
 
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "./row.h"
@@ -32,6 +36,28 @@
 
 namespace deckgl {
 
+/// \brief Distinct values of a categorical column, indexed in order of first appearance.
+/// Kept around between calls to ArrowMapper::mapCategoryColumn, so that indices stay stable as data is appended.
+class Categories {
+ public:
+  /// \brief Returns the index of a category, adding it if it wasn't seen before.
+  auto getIndex(const std::string &value) -> uint32_t;
+
+  /// \brief Category values, in order of their indices.
+  auto values() const -> const std::vector<std::string> & { return this->_values; }
+  auto size() const -> size_t { return this->_values.size(); }
+
+  /// \brief Forgets all categories, so that indices are assigned from scratch when data is replaced.
+  void clear() {
+    this->_indices.clear();
+    this->_values.clear();
+  }
+
+ private:
+  std::unordered_map<std::string, uint32_t> _indices;
+  std::vector<std::string> _values;
+};
+
 /// \brief Utility class that provides a way to easily map Arrow tables.
 class ArrowMapper {
  public:
@@ -48,64 +74,135 @@ class ArrowMapper {
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
-  static auto mapBoolColumn(const std::shared_ptr<arrow::Table> &table, std::function<BoolAccessor> getValueFromRow)
-      -> std::shared_ptr<arrow::Array>;
+  static auto mapBoolColumn(const std::shared_ptr<arrow::Table> &table, std::function<BoolAccessor> getValueFromRow,
+                            arrow::MemoryPool *pool = arrow::default_memory_pool()) -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
-  static auto mapFloatColumn(const std::shared_ptr<arrow::Table> &table, std::function<FloatAccessor> getValueFromRow)
-      -> std::shared_ptr<arrow::Array>;
+  static auto mapFloatColumn(const std::shared_ptr<arrow::Table> &table, std::function<FloatAccessor> getValueFromRow,
+                             arrow::MemoryPool *pool = arrow::default_memory_pool()) -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
   static auto mapVector2FloatColumn(const std::shared_ptr<arrow::Table> &table,
-                                    std::function<Vector2FloatAccessor> getValueFromRow)
+                                    std::function<Vector2FloatAccessor> getValueFromRow,
+                                    arrow::MemoryPool *pool = arrow::default_memory_pool())
       -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
   static auto mapVector3FloatColumn(const std::shared_ptr<arrow::Table> &table,
-                                    std::function<Vector3FloatAccessor> getValueFromRow)
+                                    std::function<Vector3FloatAccessor> getValueFromRow,
+                                    arrow::MemoryPool *pool = arrow::default_memory_pool())
       -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
   static auto mapVector3DoubleColumn(const std::shared_ptr<arrow::Table> &table,
-                                     std::function<Vector3DoubleAccessor> getValueFromRow)
+                                     std::function<Vector3DoubleAccessor> getValueFromRow,
+                                     arrow::MemoryPool *pool = arrow::default_memory_pool())
       -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
   static auto mapVector4FloatColumn(const std::shared_ptr<arrow::Table> &table,
-                                    std::function<Vector4FloatAccessor> getValueFromRow)
+                                    std::function<Vector4FloatAccessor> getValueFromRow,
+                                    arrow::MemoryPool *pool = arrow::default_memory_pool())
       -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
   static auto mapVector4DoubleColumn(const std::shared_ptr<arrow::Table> &table,
-                                     std::function<Vector4DoubleAccessor> getValueFromRow)
+                                     std::function<Vector4DoubleAccessor> getValueFromRow,
+                                     arrow::MemoryPool *pool = arrow::default_memory_pool())
       -> std::shared_ptr<arrow::Array>;
 
   /// \brief Maps table data using accessor function, returning a new array containing the mapped data.
   /// \param table Table to extract the data from.
   /// \param getValueFromRow Function that does the mapping on per-row basis.
+  /// \param pool Memory pool to allocate the resulting array from.
   /// \return Resulting array data.
   static auto mapListVector3FloatColumn(const std::shared_ptr<arrow::Table> &table,
-                                        std::function<ListVector3FloatAccessor> getValueFromRow)
+                                        std::function<ListVector3FloatAccessor> getValueFromRow,
+                                        arrow::MemoryPool *pool = arrow::default_memory_pool())
       -> std::shared_ptr<arrow::Array>;
+
+  /// \brief Category index of null values and of rows missing a category column.
+  static constexpr uint32_t kNullCategory = std::numeric_limits<uint32_t>::max();
+
+  /// \brief Maps values of a string column to the indices of their categories, returning a new uint32 array.
+  /// Dictionary encoded chunks are mapped through their dictionary indices, so that each distinct value is only looked
+  /// up once per chunk rather than once per row.
+  /// \param table Table to extract the data from.
+  /// \param columnName Name of a string or dictionary encoded string column.
+  /// \param categories Categories to index values by, values that weren't seen before are added to it.
+  /// \param pool Memory pool to allocate the resulting array from.
+  /// \return Category index of each row, kNullCategory for null values or if the table doesn't contain the column.
+  static auto mapCategoryColumn(const std::shared_ptr<arrow::Table> &table, const std::string &columnName,
+                                Categories &categories, arrow::MemoryPool *pool = arrow::default_memory_pool())
+      -> std::shared_ptr<arrow::Array>;
+
+  /// \brief Calls a function for each row of the table, in order.
+  /// A single row object is advanced through the table, so columns are only looked up once per table and chunk.
+  /// \param table Table to iterate over.
+  /// \param function Function to call, receiving the current row.
+  template <typename Function>
+  static void forEachRow(const std::shared_ptr<arrow::Table> &table, Function &&function) {
+    auto numRows = table->num_rows();
+    if (numRows == 0) {
+      return;
+    }
+
+    auto row = Row{table, 0};
+    for (int64_t i = 0; i < numRows; ++i) {
+      if (i > 0) {
+        row.incrementRowIndex();
+      }
+      function(row);
+    }
+  }
+
+  /// \brief Finds the columns that accessors read, by calling them on the first row of a sample of data.
+  /// \note Columns that accessors only read for some of the values of other columns may be missed.
+  /// \param sample Sample of data, such as the first batch of a table that is being loaded.
+  /// \param accessors Accessor functions to call, empty functions are skipped.
+  /// \return Names of the sample's columns that were read, in order of first access.
+  template <typename... Accessors>
+  static auto getAccessedColumnNames(const std::shared_ptr<arrow::Table> &sample, const Accessors &... accessors)
+      -> std::vector<std::string> {
+    if (!sample || sample->num_rows() == 0) {
+      return {};
+    }
+
+    auto row = Row{sample, 0};
+    auto access = [&row](const auto &accessor) {
+      if (accessor) {
+        accessor(row);
+      }
+    };
+    (access(accessors), ...);
+    return row.accessedColumnNames();
+  }
 };
 
 }  // namespace deckgl
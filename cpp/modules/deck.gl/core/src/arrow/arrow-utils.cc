@@ -0,0 +1,85 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./arrow-utils.h"  // NOLINT(build/include)
+
+#include <arrow/array.h>
+
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace deckgl;
+
+namespace {
+
+void addArrayData(const arrow::ArrayData& data, std::unordered_set<const arrow::Buffer*>* buffers,
+                  uint64_t* byteLength) {
+  for (const auto& buffer : data.buffers) {
+    if (buffer && buffers->insert(buffer.get()).second) {
+      *byteLength += static_cast<uint64_t>(buffer->size());
+    }
+  }
+  for (const auto& child : data.child_data) {
+    if (child) {
+      addArrayData(*child, buffers, byteLength);
+    }
+  }
+}
+
+}  // anonymous namespace
+
+auto deckgl::getTableByteLength(const std::shared_ptr<arrow::Table>& table) -> uint64_t {
+  if (!table) {
+    return 0;
+  }
+
+  std::unordered_set<const arrow::Buffer*> buffers;
+  uint64_t byteLength = 0;
+  for (const auto& column : table->columns()) {
+    for (const auto& chunk : column->chunks()) {
+      addArrayData(*chunk->data(), &buffers, &byteLength);
+    }
+  }
+
+  return byteLength;
+}
+
+auto deckgl::appendRecordBatch(const std::shared_ptr<arrow::Table>& table,
+                               const std::shared_ptr<arrow::RecordBatch>& batch) -> std::shared_ptr<arrow::Table> {
+  if (!table) {
+    std::shared_ptr<arrow::Table> batchTable;
+    if (!arrow::Table::FromRecordBatches({batch}, &batchTable).ok()) {
+      throw std::runtime_error("Failed to create a table from record batch");
+    }
+    return batchTable;
+  }
+  if (!table->schema()->Equals(*batch->schema(), false)) {
+    throw std::logic_error("Record batch schema doesn't match table schema");
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < table->num_columns(); i++) {
+    auto chunks = table->column(i)->chunks();
+    chunks.push_back(batch->column(i));
+    columns.push_back(std::make_shared<arrow::ChunkedArray>(chunks, table->column(i)->type()));
+  }
+
+  return arrow::Table::Make(table->schema(), columns, table->num_rows() + batch->num_rows());
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_ARROW_ARROW_UTILS_H
+#define DECKGL_CORE_ARROW_ARROW_UTILS_H
+
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+
+#include <memory>
+
+namespace deckgl {
+
+/// \brief Calculates the number of bytes held by a table's buffers, including buffers of nested arrays.
+/// \note Buffers shared between columns or chunks are only counted once, slices are counted at their full size.
+/// \param table Table to measure, may be nullptr.
+/// \return Size of all the buffers referenced by the table, in bytes.
+auto getTableByteLength(const std::shared_ptr<arrow::Table>& table) -> uint64_t;
+
+/// \brief Appends a record batch to a table without copying, by adding the batch's columns as new chunks.
+/// \param table Table to append to, may be nullptr.
+/// \param batch Batch to append, must have the same schema as the table.
+/// \return New table with the batch's rows following the table's rows.
+auto appendRecordBatch(const std::shared_ptr<arrow::Table>& table, const std::shared_ptr<arrow::RecordBatch>& batch)
+    -> std::shared_ptr<arrow::Table>;
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_ARROW_ARROW_UTILS_H
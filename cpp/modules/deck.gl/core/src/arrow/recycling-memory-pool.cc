@@ -0,0 +1,183 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./recycling-memory-pool.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <cstring>
+
+using namespace deckgl;
+
+namespace {
+
+/// Smallest size class, matching the alignment and padding Arrow uses for buffers
+constexpr int64_t kMinClassSize = 64;
+constexpr int kMinClassShift = 6;
+/// Number of size classes between two consecutive powers of two
+constexpr int kClassesPerShift = 4;
+
+auto classSizeOf(size_t index) -> int64_t {
+  if (index == 0) {
+    return kMinClassSize;
+  }
+
+  auto shift = kMinClassShift + static_cast<int>((index - 1) / kClassesPerShift);
+  auto step = (int64_t{1} << shift) / kClassesPerShift;
+  return (int64_t{1} << shift) + static_cast<int64_t>((index - 1) % kClassesPerShift + 1) * step;
+}
+
+}  // anonymous namespace
+
+RecyclingMemoryPool::RecyclingMemoryPool(arrow::MemoryPool* pool, int64_t maxRetainedBytes)
+    : _pool{pool}, _maxRetainedBytes{maxRetainedBytes} {}
+
+RecyclingMemoryPool::~RecyclingMemoryPool() { this->releaseUnused(); }
+
+auto RecyclingMemoryPool::Allocate(int64_t size, uint8_t** out) -> arrow::Status {
+  if (size == 0) {
+    return this->_pool->Allocate(0, out);
+  }
+
+  auto [index, classSize] = RecyclingMemoryPool::sizeClass(size);
+  {
+    std::lock_guard<std::mutex> lock{this->_mutex};
+    if (index < this->_freeLists.size() && !this->_freeLists[index].empty()) {
+      *out = this->_freeLists[index].back();
+      this->_freeLists[index].pop_back();
+      this->_usage.retainedBytes -= classSize;
+      this->_usage.reuseCount++;
+      this->_usage.allocationCount++;
+      this->_usage.bytesAllocated += size;
+      this->_usage.peakBytes = std::max(this->_usage.peakBytes, this->_usage.bytesAllocated);
+      return arrow::Status::OK();
+    }
+  }
+
+  auto status = this->_pool->Allocate(classSize, out);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::lock_guard<std::mutex> lock{this->_mutex};
+  this->_usage.allocationCount++;
+  this->_usage.bytesAllocated += size;
+  this->_usage.peakBytes = std::max(this->_usage.peakBytes, this->_usage.bytesAllocated);
+  return arrow::Status::OK();
+}
+
+auto RecyclingMemoryPool::Reallocate(int64_t oldSize, int64_t newSize, uint8_t** ptr) -> arrow::Status {
+  // Buffers are allocated in whole size classes, so growing within the same class doesn't need to move anything
+  if (oldSize > 0 && newSize > 0 &&
+      RecyclingMemoryPool::sizeClass(oldSize).first == RecyclingMemoryPool::sizeClass(newSize).first) {
+    std::lock_guard<std::mutex> lock{this->_mutex};
+    this->_usage.bytesAllocated += newSize - oldSize;
+    this->_usage.peakBytes = std::max(this->_usage.peakBytes, this->_usage.bytesAllocated);
+    return arrow::Status::OK();
+  }
+
+  uint8_t* newBuffer;
+  auto status = this->Allocate(newSize, &newBuffer);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (oldSize > 0 && newSize > 0) {
+    std::memcpy(newBuffer, *ptr, static_cast<size_t>(std::min(oldSize, newSize)));
+  }
+  this->Free(*ptr, oldSize);
+  *ptr = newBuffer;
+  return arrow::Status::OK();
+}
+
+void RecyclingMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  if (size == 0) {
+    this->_pool->Free(buffer, 0);
+    return;
+  }
+
+  auto [index, classSize] = RecyclingMemoryPool::sizeClass(size);
+  {
+    std::lock_guard<std::mutex> lock{this->_mutex};
+    this->_usage.bytesAllocated -= size;
+    if (this->_usage.retainedBytes + classSize <= this->_maxRetainedBytes) {
+      if (index >= this->_freeLists.size()) {
+        this->_freeLists.resize(index + 1);
+      }
+      this->_freeLists[index].push_back(buffer);
+      this->_usage.retainedBytes += classSize;
+      return;
+    }
+  }
+
+  this->_pool->Free(buffer, classSize);
+}
+
+auto RecyclingMemoryPool::bytes_allocated() const -> int64_t {
+  std::lock_guard<std::mutex> lock{this->_mutex};
+  return this->_usage.bytesAllocated;
+}
+
+auto RecyclingMemoryPool::max_memory() const -> int64_t {
+  std::lock_guard<std::mutex> lock{this->_mutex};
+  return this->_usage.peakBytes;
+}
+
+void RecyclingMemoryPool::releaseUnused() {
+  std::vector<std::vector<uint8_t*>> freeLists;
+  {
+    std::lock_guard<std::mutex> lock{this->_mutex};
+    freeLists.swap(this->_freeLists);
+    this->_usage.retainedBytes = 0;
+  }
+
+  for (size_t index = 0; index < freeLists.size(); ++index) {
+    for (auto buffer : freeLists[index]) {
+      this->_pool->Free(buffer, classSizeOf(index));
+    }
+  }
+}
+
+auto RecyclingMemoryPool::usage() const -> Usage {
+  std::lock_guard<std::mutex> lock{this->_mutex};
+  return this->_usage;
+}
+
+auto RecyclingMemoryPool::sizeClass(int64_t size) -> std::pair<size_t, int64_t> {
+  if (size <= kMinClassSize) {
+    return {0, kMinClassSize};
+  }
+
+  // Find the power of two range (2^shift, 2^(shift + 1)] that the size falls into, and round up to the next class in it
+  auto shift = kMinClassShift;
+  while ((int64_t{1} << (shift + 1)) < size) {
+    shift++;
+  }
+  auto base = int64_t{1} << shift;
+  auto step = base / kClassesPerShift;
+  auto classOffset = (size - base + step - 1) / step;
+  auto index = static_cast<size_t>((shift - kMinClassShift) * kClassesPerShift + classOffset);
+  return {index, base + classOffset * step};
+}
+
+auto deckgl::defaultMemoryPool() -> RecyclingMemoryPool* {
+  // Intentionally never destroyed, so that buffers released during static destruction still have a pool to return to
+  static auto pool = new RecyclingMemoryPool();
+  return pool;
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_ARROW_RECYCLING_MEMORY_POOL_H
+#define DECKGL_CORE_ARROW_RECYCLING_MEMORY_POOL_H
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace deckgl {
+
+/// \brief Arrow memory pool that keeps freed buffers around and hands them out again to later allocations of a similar
+/// size. Attribute updates allocate and drop the same set of builders and arrays over and over again, and recycling
+/// them avoids most of the malloc churn and fragmentation that would otherwise cause on long running processes.
+/// Allocations are rounded up to size classes spaced a quarter of a power of two apart, and each class keeps its own
+/// list of free buffers. Memory is requested from the underlying pool in whole size classes.
+/// \note All methods are thread safe.
+class RecyclingMemoryPool : public arrow::MemoryPool {
+ public:
+  /// \brief Allocation statistics, as returned by usage().
+  struct Usage {
+    /// \brief Number of bytes currently allocated by users of the pool.
+    int64_t bytesAllocated{0};
+    /// \brief Highest number of bytes that users of the pool had allocated at any one time.
+    int64_t peakBytes{0};
+    /// \brief Number of bytes held in free lists, ready to be reused.
+    int64_t retainedBytes{0};
+    /// \brief Total number of allocations, including reallocations that had to move data.
+    uint64_t allocationCount{0};
+    /// \brief Number of allocations that were served from free lists.
+    uint64_t reuseCount{0};
+
+    auto reuseRate() const -> double {
+      return this->allocationCount > 0 ? static_cast<double>(this->reuseCount) / this->allocationCount : 0.0;
+    }
+  };
+
+  /// \param pool Pool that memory is requested from, and returned to.
+  /// \param maxRetainedBytes Maximum number of bytes to keep in free lists. Buffers freed beyond that are returned to
+  /// the underlying pool right away.
+  explicit RecyclingMemoryPool(arrow::MemoryPool* pool = arrow::default_memory_pool(),
+                               int64_t maxRetainedBytes = int64_t{256} << 20);
+  ~RecyclingMemoryPool() override;
+
+  RecyclingMemoryPool(const RecyclingMemoryPool&) = delete;
+  auto operator=(const RecyclingMemoryPool&) -> RecyclingMemoryPool& = delete;
+
+  auto Allocate(int64_t size, uint8_t** out) -> arrow::Status override;
+  auto Reallocate(int64_t oldSize, int64_t newSize, uint8_t** ptr) -> arrow::Status override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  auto bytes_allocated() const -> int64_t override;
+  auto max_memory() const -> int64_t override;
+  auto backend_name() const -> std::string override { return "deck.gl"; }
+
+  /// \brief Returns all the buffers held in free lists to the underlying pool.
+  void releaseUnused();
+
+  /// \brief Returns current allocation statistics.
+  auto usage() const -> Usage;
+
+  /// \brief Returns the index and size of the size class that an allocation of the given size falls into.
+  static auto sizeClass(int64_t size) -> std::pair<size_t, int64_t>;
+
+ private:
+  arrow::MemoryPool* _pool;
+  int64_t _maxRetainedBytes;
+
+  mutable std::mutex _mutex;
+  std::vector<std::vector<uint8_t*>> _freeLists;
+  Usage _usage;
+};
+
+/// \brief Returns the memory pool that deck.gl allocates attribute data from, unless configured otherwise.
+auto defaultMemoryPool() -> RecyclingMemoryPool*;
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_ARROW_RECYCLING_MEMORY_POOL_H
@@ -22,96 +22,87 @@
 
 #include <arrow/array.h>
 
+#include <algorithm>
+#include <iterator>
+
 using namespace deckgl;
 using namespace mathgl;
 
-Row::Row(const std::shared_ptr<arrow::Table>& table, int64_t rowIndex) : _table{table}, _rowIndex{rowIndex} {
-  auto [chunkIndex, chunkRowIndex] = this->_getRowChunkData(table, rowIndex);
+namespace {
+
+/// \brief Reads a numeric value out of an array of a known type.
+template <typename ArrayType>
+auto readValue(const arrow::Array& array, int64_t index) -> double {
+  return static_cast<double>(static_cast<const ArrayType&>(array).Value(index));
+}
 
-  this->_chunkIndex = chunkIndex;
-  this->_chunkRowIndex = chunkRowIndex;
+}  // anonymous namespace
+
+Row::Row(const std::shared_ptr<arrow::Table>& table, int64_t rowIndex) : _table{table}, _rowIndex{rowIndex} {
+  if (rowIndex < 0 || rowIndex >= table->num_rows()) {
+    throw std::range_error("Invalid row index");
+  }
 }
 
 // NOTE: Accessors largely based on https://arrow.apache.org/docs/cpp/examples/row_columnar_conversion.html
 
 auto Row::getInt(const std::string& columnName, int defaultValue) const -> int {
-  if (!this->isValid(columnName)) {
+  auto column = this->_getValidColumn(columnName);
+  if (!column || !column->readValue) {
     return defaultValue;
   }
 
-  auto chunk = this->_getChunk(columnName);
-  std::optional<double> doubleValue = this->_getDouble(chunk);
-  if (doubleValue) {
-    return static_cast<int>(doubleValue.value());
-  }
-
-  return defaultValue;
+  return static_cast<int>(column->readValue(*column->values, this->_getValueIndex(*column)));
 }
 
 auto Row::getFloat(const std::string& columnName, float defaultValue) const -> float {
-  if (!this->isValid(columnName)) {
+  auto column = this->_getValidColumn(columnName);
+  if (!column || !column->readValue) {
     return defaultValue;
   }
 
-  auto chunk = this->_getChunk(columnName);
-  std::optional<double> doubleValue = this->_getDouble(chunk);
-  if (doubleValue) {
-    return static_cast<float>(doubleValue.value());
-  }
-
-  return defaultValue;
+  return static_cast<float>(column->readValue(*column->values, this->_getValueIndex(*column)));
 }
 
 auto Row::getDouble(const std::string& columnName, double defaultValue) const -> double {
-  if (!this->isValid(columnName)) {
+  auto column = this->_getValidColumn(columnName);
+  if (!column || !column->readValue) {
     return defaultValue;
   }
 
-  auto chunk = this->_getChunk(columnName);
-  std::optional<double> doubleValue = this->_getDouble(chunk);
-  if (doubleValue) {
-    return doubleValue.value();
-  }
-
-  return defaultValue;
+  return column->readValue(*column->values, this->_getValueIndex(*column));
 }
 
 auto Row::getBool(const std::string& columnName, bool defaultValue) const -> bool {
-  if (!this->isValid(columnName)) {
+  auto column = this->_getValidColumn(columnName);
+  if (!column) {
     return defaultValue;
   }
 
-  auto chunk = this->_getChunk(columnName);
-  if (auto boolArray = std::dynamic_pointer_cast<arrow::BooleanArray>(chunk)) {
-    return boolArray->Value(this->_chunkRowIndex);
-  } else if (std::optional<double> doubleValue = this->_getDouble(chunk)) {
-    return static_cast<bool>(doubleValue.value());
+  auto valueIndex = this->_getValueIndex(*column);
+  if (column->values->type_id() == arrow::Type::BOOL) {
+    return static_cast<const arrow::BooleanArray&>(*column->values).Value(valueIndex);
+  } else if (column->readValue) {
+    return static_cast<bool>(column->readValue(*column->values, valueIndex));
   }
 
   return defaultValue;
 }
 
 auto Row::getString(const std::string& columnName, const std::string& defaultValue) const -> std::string {
-  if (!this->isValid(columnName)) {
+  auto column = this->_getValidColumn(columnName);
+  if (!column) {
     return defaultValue;
   }
 
-  auto chunk = this->_getChunk(columnName);
-  if (auto stringArray = std::dynamic_pointer_cast<arrow::StringArray>(chunk)) {
-    return stringArray->GetString(this->_chunkRowIndex);
+  if (column->values->type_id() == arrow::Type::STRING) {
+    return static_cast<const arrow::StringArray&>(*column->values).GetString(this->_getValueIndex(*column));
   }
 
   return defaultValue;
 }
 
-auto Row::isValid(const std::string& columnName) const -> bool {
-  try {
-    auto chunk = this->_getChunk(columnName);
-    return chunk->IsValid(this->_chunkRowIndex);
-  } catch (...) {
-    return false;
-  }
-}
+auto Row::isValid(const std::string& columnName) const -> bool { return this->_getValidColumn(columnName) != nullptr; }
 
 void Row::incrementRowIndex(uint64_t increment) {
   int64_t newRowIndex = this->_rowIndex + increment;
@@ -119,105 +110,185 @@ void Row::incrementRowIndex(uint64_t increment) {
     throw std::range_error("Increment index out of bounds");
   }
 
-  // NOTE: Columns are chunked in the same way, so we pick an arbitrary column
-  // https://arrow.apache.org/docs/cpp/tables.html#tables
-  auto column = this->_table->column(0);
+  // Bound columns move on to the following chunks lazily, the next time they're accessed
+  this->_rowIndex = newRowIndex;
+}
 
-  // Look up incremented row, starting with the chunk previous row index was in
-  int chunkIndex = this->_chunkIndex;
-  auto chunk = column->chunk(chunkIndex);
-  int64_t newChunkRowIndex = this->_chunkRowIndex + increment;
-  int64_t stepSize = chunk->length() - this->_chunkRowIndex;
-  while (newChunkRowIndex >= chunk->length()) {
-    newChunkRowIndex -= stepSize;
-    chunk = column->chunk(++chunkIndex);
-    stepSize = chunk->length();
+auto Row::accessedColumnNames() const -> std::vector<std::string> {
+  std::vector<std::string> names;
+  for (const auto& boundColumn : this->_boundColumns) {
+    // Missing columns are bound too, but aren't part of the table
+    if (boundColumn.column) {
+      names.push_back(boundColumn.name);
+    }
   }
-
-  this->_chunkIndex = chunkIndex;
-  this->_chunkRowIndex = newChunkRowIndex;
-  this->_rowIndex = newRowIndex;
+  return names;
 }
 
-auto Row::_getChunk(const std::string& columnName) const -> std::shared_ptr<arrow::Array> {
-  auto column = this->_table->GetColumnByName(columnName);
-  if (column == nullptr) {
-    throw std::logic_error("Invalid column name");
+auto Row::_bindColumn(const std::string& columnName) const -> BoundColumn& {
+  auto column = std::find_if(this->_boundColumns.begin(), this->_boundColumns.end(),
+                             [&](const BoundColumn& boundColumn) { return boundColumn.name == columnName; });
+  if (column == this->_boundColumns.end()) {
+    // Missing columns are bound as well, so that they aren't looked up again
+    this->_boundColumns.push_back(BoundColumn{columnName, this->_table->GetColumnByName(columnName)});
+    column = std::prev(this->_boundColumns.end());
   }
 
-  // Iterate over column chunks and find the chunk that contains row data
-  int64_t offset = 0;
-  for (const auto& chunk : column->chunks()) {
-    if (this->_rowIndex >= offset && this->_rowIndex < offset + chunk->length()) {
-      // TODO(ilija@unfolded.ai): Cache chunks once Rows are being reused properly
-      return chunk;
+  auto& boundColumn = *column;
+  auto chunkEnd = boundColumn.chunk ? boundColumn.chunkOffset + boundColumn.chunk->length() : boundColumn.chunkOffset;
+  if (!boundColumn.column || (this->_rowIndex >= boundColumn.chunkOffset && this->_rowIndex < chunkEnd)) {
+    return boundColumn;
+  }
+
+  // Rows are mostly visited in order, so the lookup continues from the previously bound chunk when possible
+  if (this->_rowIndex < boundColumn.chunkOffset) {
+    boundColumn.chunkIndex = 0;
+    boundColumn.chunkOffset = 0;
+  } else if (boundColumn.chunk) {
+    boundColumn.chunkIndex++;
+    boundColumn.chunkOffset = chunkEnd;
+  }
+
+  Row::_bindChunk(boundColumn, nullptr);
+  for (; boundColumn.chunkIndex < boundColumn.column->num_chunks(); ++boundColumn.chunkIndex) {
+    auto chunk = boundColumn.column->chunk(boundColumn.chunkIndex);
+    if (this->_rowIndex < boundColumn.chunkOffset + chunk->length()) {
+      Row::_bindChunk(boundColumn, chunk);
+      break;
     }
 
-    offset += chunk->length();
+    boundColumn.chunkOffset += chunk->length();
   }
 
-  throw std::logic_error("Invalid chunk lookup");
+  return boundColumn;
 }
 
-auto Row::_getRowChunkData(const std::shared_ptr<arrow::Table>& table, int64_t rowIndex) const
-    -> std::tuple<int, int64_t> {
-  if (rowIndex >= table->num_rows()) {
-    throw std::range_error("Invalid row index");
+auto Row::_getValidColumn(const std::string& columnName) const -> const BoundColumn* {
+  const auto& column = this->_bindColumn(columnName);
+  if (!column.chunk || !column.chunk->IsValid(this->_rowIndex - column.chunkOffset)) {
+    return nullptr;
   }
 
-  // NOTE: Columns are chunked in the same way, so we pick an arbitrary column
-  // https://arrow.apache.org/docs/cpp/tables.html#tables
-  auto column = table->column(0);
+  return &column;
+}
 
-  // Iterate over column chunks and find the chunk that contains row data
-  int64_t chunkRowIndex = rowIndex;
-  for (int chunkIndex = 0; chunkIndex < column->num_chunks(); ++chunkIndex) {
-    auto chunk = column->chunk(chunkIndex);
-    if (chunkRowIndex < chunk->length()) {
-      return {chunkIndex, chunkRowIndex};
-    }
+auto Row::_getValueIndex(const BoundColumn& column) const -> int64_t {
+  auto chunkRowIndex = this->_rowIndex - column.chunkOffset;
+  if (column.dictionaryIndices) {
+    return static_cast<int64_t>(column.readDictionaryIndex(*column.dictionaryIndices, chunkRowIndex));
+  }
+
+  return chunkRowIndex;
+}
+
+auto Row::_getValidListColumn(const std::string& columnName) const -> const BoundColumn* {
+  auto column = this->_getValidColumn(columnName);
+  if (!column) {
+    probegl::WarningLog() << "Requested column data not valid, returning default value";
+    return nullptr;
+  }
+  if (!column->listValues) {
+    probegl::WarningLog() << "Requested list type not supported, returning default value";
+    return nullptr;
+  }
+  if (!column->readListValue) {
+    probegl::WarningLog() << "Unsupported list value type, returning default value";
+    return nullptr;
+  }
+
+  return column;
+}
 
-    chunkRowIndex -= chunk->length();
+auto Row::_getValidNestedListColumn(const std::string& columnName) const -> const BoundColumn* {
+  auto column = this->_getValidColumn(columnName);
+  if (!column) {
+    probegl::WarningLog() << "Requested column data not valid, returning default value";
+    return nullptr;
+  }
+  if (!column->listValues) {
+    probegl::WarningLog() << "Requested list type not supported, returning default value";
+    return nullptr;
+  }
+  if (!column->nestedListValues) {
+    probegl::WarningLog() << "List type for nested array not supported, returning default value";
+    return nullptr;
+  }
+  if (!column->readNestedListValue) {
+    probegl::WarningLog() << "Unsupported list value type, returning default value";
+    return nullptr;
   }
 
-  throw std::logic_error("Invalid chunk lookup");
+  return column;
 }
 
-// Sacrificing performance and precision for conciseness. Revisit if this becomes a bottleneck
-auto Row::_getDouble(const std::shared_ptr<arrow::Array>& chunk) const -> std::optional<double> {
-  switch (chunk->type_id()) {
+void Row::_bindChunk(BoundColumn& column, const std::shared_ptr<arrow::Array>& chunk) {
+  column.chunk = chunk;
+  column.values = chunk.get();
+  column.dictionaryIndices = nullptr;
+  column.readDictionaryIndex = nullptr;
+  if (chunk && chunk->type_id() == arrow::Type::DICTIONARY) {
+    // Dictionaries and indices are owned by the chunk, like list values
+    const auto& dictionaryArray = static_cast<const arrow::DictionaryArray&>(*chunk);
+    column.values = dictionaryArray.dictionary().get();
+    column.dictionaryIndices = dictionaryArray.indices().get();
+    column.readDictionaryIndex = Row::_getValueReader(column.dictionaryIndices->type_id());
+  }
+  column.readValue = column.values ? Row::_getValueReader(column.values->type_id()) : nullptr;
+  column.listValues = chunk ? Row::_getListValues(*chunk) : nullptr;
+  column.readListValue = column.listValues ? Row::_getValueReader(column.listValues->type_id()) : nullptr;
+  column.nestedListValues = column.listValues ? Row::_getListValues(*column.listValues) : nullptr;
+  column.readNestedListValue =
+      column.nestedListValues ? Row::_getValueReader(column.nestedListValues->type_id()) : nullptr;
+}
+
+auto Row::_getValueReader(arrow::Type::type typeId) -> ValueReader {
+  switch (typeId) {
     case arrow::Type::DOUBLE:
-      return std::static_pointer_cast<arrow::DoubleArray>(chunk)->Value(this->_chunkRowIndex);
+      return readValue<arrow::DoubleArray>;
     case arrow::Type::FLOAT:
-      return static_cast<double>(std::static_pointer_cast<arrow::FloatArray>(chunk)->Value(this->_chunkRowIndex));
+      return readValue<arrow::FloatArray>;
     case arrow::Type::INT64:
-      return static_cast<double>(std::static_pointer_cast<arrow::Int64Array>(chunk)->Value(this->_chunkRowIndex));
+      return readValue<arrow::Int64Array>;
     case arrow::Type::INT32:
-      return static_cast<double>(std::static_pointer_cast<arrow::Int32Array>(chunk)->Value(this->_chunkRowIndex));
+      return readValue<arrow::Int32Array>;
+    case arrow::Type::INT16:
+      return readValue<arrow::Int16Array>;
+    case arrow::Type::INT8:
+      return readValue<arrow::Int8Array>;
+    case arrow::Type::UINT64:
+      return readValue<arrow::UInt64Array>;
+    case arrow::Type::UINT32:
+      return readValue<arrow::UInt32Array>;
+    case arrow::Type::UINT16:
+      return readValue<arrow::UInt16Array>;
+    case arrow::Type::UINT8:
+      return readValue<arrow::UInt8Array>;
 
     default:
-      return std::nullopt;
+      return nullptr;
   }
 }
 
-auto Row::_getListArrayMetadata(const std::shared_ptr<arrow::Array>& array, int64_t index) const
-    -> std::optional<ListArrayMetadata> {
-  switch (array->type_id()) {
-    case arrow::Type::FIXED_SIZE_LIST: {
-      auto listArray = std::static_pointer_cast<arrow::FixedSizeListArray>(array);
-      auto offset = listArray->value_offset(index);
-      auto length = listArray->value_length();
+auto Row::_getListValues(const arrow::Array& array) -> const arrow::Array* {
+  // List values are owned by the list array, which outlives the returned pointer as long as the chunk stays bound
+  switch (array.type_id()) {
+    case arrow::Type::FIXED_SIZE_LIST:
+      return static_cast<const arrow::FixedSizeListArray&>(array).values().get();
+    case arrow::Type::LIST:
+      return static_cast<const arrow::ListArray&>(array).values().get();
 
-      return ListArrayMetadata{offset, length, listArray->values()};
-    }
-    case arrow::Type::LIST: {
-      auto listArray = std::static_pointer_cast<arrow::ListArray>(array);
-      auto offset = listArray->value_offset(index);
-      auto length = listArray->value_length(index);
-
-      return ListArrayMetadata{offset, length, listArray->values()};
-    }
     default:
-      return std::nullopt;
+      return nullptr;
+  }
+}
+
+auto Row::_getListArrayMetadata(const arrow::Array& array, int64_t index, const arrow::Array* values)
+    -> ListArrayMetadata {
+  if (array.type_id() == arrow::Type::FIXED_SIZE_LIST) {
+    const auto& listArray = static_cast<const arrow::FixedSizeListArray&>(array);
+    return ListArrayMetadata{listArray.value_offset(index), listArray.value_length(), values};
   }
+
+  const auto& listArray = static_cast<const arrow::ListArray&>(array);
+  return ListArrayMetadata{listArray.value_offset(index), listArray.value_length(index), values};
 }
@@ -24,10 +24,11 @@
 #include <arrow/array.h>
 #include <arrow/table.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <optional>
 #include <string>
-#include <tuple>
 #include <vector>
 
 #include "math.gl/core.h"
@@ -35,18 +36,20 @@
 
 namespace deckgl {
 
-/// \brief Utility structure that holds metadata of a generic list array.
+/// \brief Utility structure that describes the values of a single element of a generic list array.
 struct ListArrayMetadata {
  public:
-  ListArrayMetadata(int32_t offset, int32_t length, const std::shared_ptr<arrow::Array>& values)
+  ListArrayMetadata(int64_t offset, int64_t length, const arrow::Array* values)
       : offset{offset}, length{length}, values{values} {}
 
-  int32_t offset;
-  int32_t length;
-  std::shared_ptr<arrow::Array> values;
+  int64_t offset;
+  int64_t length;
+  /// \brief Values of the list array, owned by the list array itself.
+  const arrow::Array* values;
 };
 
 /// \brief Represents a single row within a given table, which can be queried for easy access to typed data.
+/// Dictionary encoded columns are read through their dictionaries, as if they held the decoded values.
 class Row {
  public:
   Row(const std::shared_ptr<arrow::Table>& table, int64_t rowIndex);
@@ -93,8 +96,12 @@ class Row {
   template <typename T>
   auto getVector2(const std::string& columnName, const mathgl::Vector2<T>& defaultValue = {}) const
       -> mathgl::Vector2<T> {
-    auto data = this->getListData<T>(columnName, {defaultValue.x, defaultValue.y});
-    return mathgl::Vector2<T>{data.size() > 0 ? data.at(0) : 0, data.size() > 1 ? data.at(1) : 0};
+    std::array<T, 2> data;
+    if (!this->readListData(columnName, data)) {
+      return defaultValue;
+    }
+
+    return mathgl::Vector2<T>{data[0], data[1]};
   }
 
   /// \brief Attempts to get vector data out of a list array found in this row, for a given columnName.
@@ -105,9 +112,12 @@ class Row {
   template <typename T>
   auto getVector3(const std::string& columnName, const mathgl::Vector3<T>& defaultValue = {}) const
       -> mathgl::Vector3<T> {
-    auto data = this->getListData<T>(columnName, {defaultValue.x, defaultValue.y, defaultValue.z});
-    return mathgl::Vector3<T>{data.size() > 0 ? data.at(0) : 0, data.size() > 1 ? data.at(1) : 0,
-                              data.size() > 2 ? data.at(2) : 0};
+    std::array<T, 3> data;
+    if (!this->readListData(columnName, data)) {
+      return defaultValue;
+    }
+
+    return mathgl::Vector3<T>{data[0], data[1], data[2]};
   }
 
   /// \brief Attempts to get vector data out of a list array found in this row, for a given columnName.
@@ -118,9 +128,12 @@ class Row {
   template <typename T>
   auto getVector4(const std::string& columnName, const mathgl::Vector4<T>& defaultValue = {}) const
       -> mathgl::Vector4<T> {
-    auto data = this->getListData<T>(columnName, {defaultValue.x, defaultValue.y, defaultValue.z, defaultValue.w});
-    return mathgl::Vector4<T>{data.size() > 0 ? data.at(0) : 0, data.size() > 1 ? data.at(1) : 0,
-                              data.size() > 2 ? data.at(2) : 0, data.size() > 3 ? data.at(3) : 0};
+    std::array<T, 4> data;
+    if (!this->readListData(columnName, data)) {
+      return defaultValue;
+    }
+
+    return mathgl::Vector4<T>{data[0], data[1], data[2], data[3]};
   }
 
   /// \brief Attempts to get a set of vector data out of a nested list array found in this row, for a given columnName.
@@ -131,14 +144,11 @@ class Row {
   template <typename T>
   auto getVector2List(const std::string& columnName, const std::vector<mathgl::Vector2<T>>& defaultValue = {}) const
       -> std::vector<mathgl::Vector2<T>> {
-    auto listData = this->getNestedListData<T>(columnName, {});
     std::vector<mathgl::Vector2<T>> vectorData;
-    vectorData.reserve(listData.size());
-    for (const auto& data : listData) {
-      vectorData.push_back(mathgl::Vector2<T>{data.size() > 0 ? data[0] : 0, data.size() > 1 ? data[1] : 0});
-    }
+    auto found = this->_readNestedListData<T, 2>(
+        columnName, vectorData, [](const std::array<T, 2>& data) { return mathgl::Vector2<T>{data[0], data[1]}; });
 
-    return vectorData;
+    return found ? vectorData : defaultValue;
   }
 
   /// \brief Attempts to get a set of vector data out of a nested list array found in this row, for a given columnName.
@@ -149,15 +159,12 @@ class Row {
   template <typename T>
   auto getVector3List(const std::string& columnName, const std::vector<mathgl::Vector3<T>>& defaultValue = {}) const
       -> std::vector<mathgl::Vector3<T>> {
-    auto listData = this->getNestedListData<T>(columnName, {});
     std::vector<mathgl::Vector3<T>> vectorData;
-    vectorData.reserve(listData.size());
-    for (const auto& data : listData) {
-      vectorData.push_back(mathgl::Vector3<T>{data.size() > 0 ? data[0] : 0, data.size() > 1 ? data[1] : 0,
-                                              data.size() > 2 ? data[2] : 0});
-    }
+    auto found = this->_readNestedListData<T, 3>(columnName, vectorData, [](const std::array<T, 3>& data) {
+      return mathgl::Vector3<T>{data[0], data[1], data[2]};
+    });
 
-    return vectorData;
+    return found ? vectorData : defaultValue;
   }
 
   /// \brief Attempts to get a set of vector data out of a nested list array found in this row, for a given columnName.
@@ -168,15 +175,28 @@ class Row {
   template <typename T>
   auto getVector4List(const std::string& columnName, const std::vector<mathgl::Vector4<T>>& defaultValue = {}) const
       -> std::vector<mathgl::Vector4<T>> {
-    auto listData = this->getNestedListData<T>(columnName, {});
     std::vector<mathgl::Vector4<T>> vectorData;
-    vectorData.reserve(listData.size());
-    for (const auto& data : listData) {
-      vectorData.push_back(mathgl::Vector4<T>{data.size() > 0 ? data[0] : 0, data.size() > 1 ? data[1] : 0,
-                                              data.size() > 2 ? data[2] : 0, data.size() > 3 ? data[3] : 0});
+    auto found = this->_readNestedListData<T, 4>(columnName, vectorData, [](const std::array<T, 4>& data) {
+      return mathgl::Vector4<T>{data[0], data[1], data[2], data[3]};
+    });
+
+    return found ? vectorData : defaultValue;
+  }
+
+  /// \brief Attempts to read list data found in this row into a caller provided array, without allocating.
+  /// \param columnName Name of the column to get the data for.
+  /// \param values Array to read the data into, padded with zeros if the list was not of a sufficient length.
+  /// Left untouched if data could not be found.
+  /// \returns Number of values read from the list, or std::nullopt if data could not be found.
+  template <typename T, size_t N>
+  auto readListData(const std::string& columnName, std::array<T, N>& values) const -> std::optional<size_t> {
+    auto column = this->_getValidListColumn(columnName);
+    if (!column) {
+      return std::nullopt;
     }
 
-    return vectorData;
+    auto list = Row::_getListArrayMetadata(*column->chunk, this->_rowIndex - column->chunkOffset, column->listValues);
+    return Row::_readListValues(list, column->readListValue, values);
   }
 
   /// \brief Attempts to get a variable sized collection of arbitrary data.
@@ -185,18 +205,13 @@ class Row {
   /// \returns A collection of requested data type, or defaultValue if data could not be found.
   template <typename T>
   auto getListData(const std::string& columnName, const std::vector<T>& defaultValue = {}) const -> std::vector<T> {
-    if (!this->isValid(columnName)) {
-      probegl::WarningLog() << "Requested column data not valid, returning default value";
-      return defaultValue;
-    }
-
-    auto optionalMetadata = this->_getListArrayMetadata(this->_getChunk(columnName), this->_chunkRowIndex);
-    if (!optionalMetadata) {
-      probegl::WarningLog() << "Requested list type not supported, returning default value";
+    auto column = this->_getValidListColumn(columnName);
+    if (!column) {
       return defaultValue;
     }
 
-    return this->_getListData(optionalMetadata.value(), defaultValue);
+    auto list = Row::_getListArrayMetadata(*column->chunk, this->_rowIndex - column->chunkOffset, column->listValues);
+    return Row::_readListValues<T>(list, column->readListValue);
   }
 
   /// \brief Attempts to get a nested, variable sized collection of arbitrary data.
@@ -206,18 +221,20 @@ class Row {
   template <typename T>
   auto getNestedListData(const std::string& columnName, const std::vector<std::vector<T>>& defaultValue = {}) const
       -> std::vector<std::vector<T>> {
-    if (!this->isValid(columnName)) {
-      probegl::WarningLog() << "Requested column data not valid, returning default value";
+    auto column = this->_getValidNestedListColumn(columnName);
+    if (!column) {
       return defaultValue;
     }
 
-    auto optionalMetadata = this->_getListArrayMetadata(this->_getChunk(columnName), this->_chunkRowIndex);
-    if (!optionalMetadata) {
-      probegl::WarningLog() << "Requested list type not supported, returning default value";
-      return defaultValue;
+    auto list = Row::_getListArrayMetadata(*column->chunk, this->_rowIndex - column->chunkOffset, column->listValues);
+    std::vector<std::vector<T>> data;
+    data.reserve(static_cast<size_t>(list.length));
+    for (int64_t i = 0; i < list.length; i++) {
+      auto nestedList = Row::_getListArrayMetadata(*list.values, list.offset + i, column->nestedListValues);
+      data.push_back(Row::_readListValues<T>(nestedList, column->readNestedListValue));
     }
 
-    return this->_getNestedListData(optionalMetadata.value(), defaultValue);
+    return data;
   }
 
   /// \brief Checks whether value at this row, for columnName is valid and not null.
@@ -226,105 +243,140 @@ class Row {
   auto isValid(const std::string& columnName) const -> bool;
 
   /// \brief Increments current row index.
+  /// \note Columns that were already accessed stay bound, so moving to the next row is a constant time operation.
+  /// Reusing a single row while iterating over a table is therefore much cheaper than creating a row for each index.
   /// \param increment Amount to increment the current row index by.
   void incrementRowIndex(uint64_t increment = 1);
 
+  /// \brief Returns names of the table's columns that were accessed through this row so far, in order of first access.
+  auto accessedColumnNames() const -> std::vector<std::string>;
+
  private:
-  /// \brief Retrieves a chunk for a given columName.
+  /// \brief Reads a numeric value at a given index of an array, converting it to a double.
+  using ValueReader = auto (*)(const arrow::Array& array, int64_t index) -> double;
+
+  /// \brief Column looked up by name, along with the chunk that contains the current row.
+  /// Typed views into the chunk are resolved when it's bound, so that reading values doesn't have to dispatch on
+  /// value types nor touch reference counts.
+  struct BoundColumn {
+    std::string name;
+    /// \brief Column data, nullptr if the table doesn't contain a column with this name.
+    std::shared_ptr<arrow::ChunkedArray> column;
+    /// \brief Chunk the current row belongs to, nullptr if the column doesn't contain the current row.
+    std::shared_ptr<arrow::Array> chunk;
+    int chunkIndex{0};
+    /// \brief Index of the first row of the chunk within the table.
+    int64_t chunkOffset{0};
+
+    /// \brief Values of the chunk: the chunk itself, or its dictionary if the chunk is dictionary encoded.
+    /// Owned by the chunk.
+    const arrow::Array* values{nullptr};
+    /// \brief Reads values, nullptr if they aren't numeric.
+    ValueReader readValue{nullptr};
+    /// \brief Dictionary indices of the chunk, nullptr if the chunk isn't dictionary encoded. Owned by the chunk.
+    const arrow::Array* dictionaryIndices{nullptr};
+    /// \brief Reads dictionary indices.
+    ValueReader readDictionaryIndex{nullptr};
+    /// \brief Values of the chunk, nullptr if the chunk isn't a list array. Owned by the chunk.
+    const arrow::Array* listValues{nullptr};
+    /// \brief Reads list values, nullptr if they aren't numeric.
+    ValueReader readListValue{nullptr};
+    /// \brief Values of nested lists, nullptr if list values aren't list arrays themselves. Owned by the chunk.
+    const arrow::Array* nestedListValues{nullptr};
+    /// \brief Reads nested list values, nullptr if they aren't numeric.
+    ValueReader readNestedListValue{nullptr};
+  };
+
+  /// \brief Retrieves a column bound to the chunk that contains the current row.
+  /// Columns are looked up by name only once per row object, and chunks are only looked up again when the current row
+  /// moves out of the previously bound one.
   /// \param columnName Name of the column to do the lookup for.
-  /// \return Returns a chunk within column named columnName, that this row belongs to.
-  /// \throw Throws an exception if columnName does not exist in the table, or if the chunk couldn't be found.
-  auto _getChunk(const std::string& columnName) const -> std::shared_ptr<arrow::Array>;
+  auto _bindColumn(const std::string& columnName) const -> BoundColumn&;
 
-  /// \brief Calculates a relative index of a row within the appropriate chunk.
-  /// \param table Table to do chunk lookup in.
-  /// \param rowIndex Index of the row to do lookup for.
-  /// \return Tuple containing index of the chunk this row belongs to, and a row index within the chunk.
-  /// \throw Throws an exception if rowIndex exceeds table bounds, or if the chunk couldn't be found.
-  auto _getRowChunkData(const std::shared_ptr<arrow::Table>& table, int64_t rowIndex) const -> std::tuple<int, int64_t>;
+  /// \brief Retrieves a bound column, if it exists and its value at the current row is valid and not null.
+  /// \param columnName Name of the column to do the lookup for.
+  /// \return Bound column, or nullptr if the value is not valid. Only valid until another column is bound.
+  auto _getValidColumn(const std::string& columnName) const -> const BoundColumn*;
 
-  auto _getDouble(const std::shared_ptr<arrow::Array>& chunk) const -> std::optional<double>;
-  auto _getListArrayMetadata(const std::shared_ptr<arrow::Array>& array, int64_t index) const
-      -> std::optional<ListArrayMetadata>;
+  /// \brief Index of the current row's value within values of a bound column, which for dictionary encoded chunks is
+  /// the dictionary index stored at the current row.
+  auto _getValueIndex(const BoundColumn& column) const -> int64_t;
 
-  template <typename T>
-  auto _getListData(const ListArrayMetadata& metadata, const std::vector<T>& defaultValue = {}) const
-      -> std::vector<T> {
-    std::vector<T> data;
-    switch (metadata.values->type_id()) {
-      case arrow::Type::type::DOUBLE: {
-        auto doubleArray = std::static_pointer_cast<arrow::DoubleArray>(metadata.values);
-        for (int32_t i = 0; i < metadata.length; i++) {
-          data.push_back(static_cast<T>(doubleArray->Value(metadata.offset + i)));
-        }
-        break;
-      }
-      case arrow::Type::type::FLOAT: {
-        auto floatArray = std::static_pointer_cast<arrow::FloatArray>(metadata.values);
-        for (int32_t i = 0; i < metadata.length; i++) {
-          data.push_back(static_cast<T>(floatArray->Value(metadata.offset + i)));
-        }
-        break;
-      }
-      case arrow::Type::type::INT64: {
-        auto int64Array = std::static_pointer_cast<arrow::Int64Array>(metadata.values);
-        for (int32_t i = 0; i < metadata.length; i++) {
-          data.push_back(static_cast<T>(int64Array->Value(metadata.offset + i)));
-        }
-        break;
-      }
-      case arrow::Type::type::INT32: {
-        auto int32Array = std::static_pointer_cast<arrow::Int32Array>(metadata.values);
-        for (int32_t i = 0; i < metadata.length; i++) {
-          data.push_back(static_cast<T>(int32Array->Value(metadata.offset + i)));
-        }
-        break;
-      }
-      default:
-        probegl::WarningLog() << "Unsupported list value type, returning default value";
-        return defaultValue;
+  /// \brief Retrieves a valid bound column that holds lists of numeric values, logging a warning otherwise.
+  auto _getValidListColumn(const std::string& columnName) const -> const BoundColumn*;
+
+  /// \brief Retrieves a valid bound column that holds lists of lists of numeric values, logging a warning otherwise.
+  auto _getValidNestedListColumn(const std::string& columnName) const -> const BoundColumn*;
+
+  /// \brief Resolves typed views into a newly bound chunk.
+  static void _bindChunk(BoundColumn& column, const std::shared_ptr<arrow::Array>& chunk);
+
+  /// \brief Selects a reader for numeric values of a given type.
+  /// \return Value reader, or nullptr if the type isn't numeric.
+  static auto _getValueReader(arrow::Type::type typeId) -> ValueReader;
+
+  /// \brief Retrieves values of a list array, without taking ownership of them.
+  /// \return List values, or nullptr if array isn't a list array.
+  static auto _getListValues(const arrow::Array& array) -> const arrow::Array*;
+
+  /// \brief Retrieves offset and length of an element of a list array, whose values were resolved beforehand.
+  static auto _getListArrayMetadata(const arrow::Array& array, int64_t index, const arrow::Array* values)
+      -> ListArrayMetadata;
+
+  template <typename T, size_t N>
+  static auto _readListValues(const ListArrayMetadata& list, ValueReader readValue, std::array<T, N>& values)
+      -> size_t {
+    auto count = static_cast<size_t>(std::min(list.length, static_cast<int64_t>(N)));
+    for (size_t i = 0; i < count; i++) {
+      values[i] = static_cast<T>(readValue(*list.values, list.offset + static_cast<int64_t>(i)));
     }
+    std::fill(values.begin() + count, values.end(), T{0});
 
-    return data;
+    return count;
   }
 
   template <typename T>
-  auto _getNestedListData(const ListArrayMetadata& metadata, const std::vector<std::vector<T>>& defaultValue = {}) const
-      -> std::vector<std::vector<T>> {
-    std::vector<std::vector<T>> data;
-    switch (metadata.values->type_id()) {
-      case arrow::Type::type::LIST:
-      case arrow::Type::type::FIXED_SIZE_LIST: {
-        for (int32_t i = 0; i < metadata.length; i++) {
-          auto optionalMetadata = this->_getListArrayMetadata(metadata.values, metadata.offset + i);
-          if (!optionalMetadata) {
-            probegl::WarningLog() << "List type for nested array not supported, returning default value";
-            return defaultValue;
-          }
-
-          data.push_back(this->_getListData(optionalMetadata.value(), std::vector<T>{}));
-        }
-        break;
-      }
-      default:
-        probegl::WarningLog() << "Unsupported list value type, returning default value";
-        return defaultValue;
+  static auto _readListValues(const ListArrayMetadata& list, ValueReader readValue) -> std::vector<T> {
+    std::vector<T> data(static_cast<size_t>(list.length));
+    for (int64_t i = 0; i < list.length; i++) {
+      data[static_cast<size_t>(i)] = static_cast<T>(readValue(*list.values, list.offset + i));
     }
 
     return data;
   }
 
+  /// \brief Reads each list of a nested list array found in this row into a fixed size array, and converts them into
+  /// output elements, without allocating anything but the output itself.
+  /// \return true if data was found, false otherwise.
+  template <typename T, size_t N, typename Element, typename Function>
+  auto _readNestedListData(const std::string& columnName, std::vector<Element>& output, Function&& convert) const
+      -> bool {
+    auto column = this->_getValidNestedListColumn(columnName);
+    if (!column) {
+      return false;
+    }
+
+    auto list = Row::_getListArrayMetadata(*column->chunk, this->_rowIndex - column->chunkOffset, column->listValues);
+    output.reserve(output.size() + static_cast<size_t>(list.length));
+
+    std::array<T, N> values;
+    for (int64_t i = 0; i < list.length; i++) {
+      auto nestedList = Row::_getListArrayMetadata(*list.values, list.offset + i, column->nestedListValues);
+      Row::_readListValues(nestedList, column->readNestedListValue, values);
+      output.push_back(convert(values));
+    }
+
+    return true;
+  }
+
   /// \brief Table that this row belongs to.
   std::shared_ptr<arrow::Table> _table;
 
   /// \brief Index of the row within table.
   int64_t _rowIndex;
 
-  /// \brief Index of the chunk that this row belongs to.
-  int _chunkIndex;
-
-  /// \brief Relative row index in respect to the chunk.
-  int64_t _chunkRowIndex;
+  /// \brief Columns that were accessed through this row so far.
+  mutable std::vector<BoundColumn> _boundColumns;
 };
 
 }  // namespace deckgl
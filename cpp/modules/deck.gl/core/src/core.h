@@ -22,11 +22,18 @@
 #define DECKGL_CORE_CORE_H
 
 #include "./arrow/arrow-mapper.h"
+#include "./arrow/arrow-utils.h"
+#include "./arrow/recycling-memory-pool.h"
 #include "./arrow/row.h"
 #include "./lib/attribute/attribute-manager.h"
 #include "./lib/constants.h"
+#include "./lib/cpu-picker.h"
 #include "./lib/deck.h"
 #include "./lib/layer.h"
+#include "./lib/pending-data.h"
+#include "./lib/picking-geometry.h"
+#include "./lib/spatial-index.h"
+#include "./shaderlib/picking/picking-uniforms.h"
 #include "./shaderlib/project/viewport-uniforms.h"
 #include "./viewports/viewport.h"
 #include "./viewports/web-mercator-viewport.h"
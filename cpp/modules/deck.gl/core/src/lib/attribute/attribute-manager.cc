@@ -20,11 +20,169 @@
 
 #include "./attribute-manager.h"  // NOLINT(build/include)
 
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
 #include "probe.gl/core.h"
 
 using namespace deckgl;
 using namespace lumagl;
 
+namespace {
+
+/// \brief Copies the given rows of a fixed width array, or a fixed size list of fixed width values, into a new array.
+auto takeRows(const std::shared_ptr<arrow::Array>& array, const std::vector<uint32_t>& rows, arrow::MemoryPool* pool)
+    -> std::shared_ptr<arrow::Array> {
+  auto data = array->data();
+  auto valueData = data;
+  int64_t valuesPerRow = 1;
+  if (auto listType = std::dynamic_pointer_cast<arrow::FixedSizeListType>(array->type())) {
+    valueData = data->child_data[0];
+    valuesPerRow = listType->list_size();
+  }
+
+  auto valueType = std::dynamic_pointer_cast<arrow::FixedWidthType>(valueData->type);
+  if (!valueType || valueType->bit_width() % 8 != 0) {
+    throw std::runtime_error("Unsupported attribute type");
+  }
+
+  auto valueByteWidth = valueType->bit_width() / 8;
+  auto rowByteWidth = valuesPerRow * valueByteWidth;
+  auto source = valueData->buffers[1]->data() + (valueData->offset + data->offset * valuesPerRow) * valueByteWidth;
+
+  auto length = static_cast<int64_t>(rows.size());
+  auto allocateResult = arrow::AllocateBuffer(length * rowByteWidth, pool);
+  if (!allocateResult.ok()) {
+    throw std::runtime_error("Unable to allocate attribute buffer");
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(allocateResult).ValueOrDie();
+
+  auto destination = buffer->mutable_data();
+  for (int64_t i = 0; i < length; ++i) {
+    std::memcpy(destination + i * rowByteWidth, source + rows[i] * rowByteWidth, rowByteWidth);
+  }
+
+  auto takenValues = arrow::ArrayData::Make(valueData->type, length * valuesPerRow, {nullptr, buffer}, 0);
+  if (valueData == data) {
+    return arrow::MakeArray(takenValues);
+  }
+
+  return arrow::MakeArray(arrow::ArrayData::Make(data->type, length, {nullptr}, {takenValues}, 0));
+}
+
+/// \brief Converts values of a fixed width array, or a fixed size list of fixed width values, to floats.
+template <typename CType>
+void convertValues(const arrow::ArrayData& valueData, int64_t start, int64_t length, float* destination) {
+  auto source = valueData.GetValues<CType>(1) + start;
+  for (int64_t i = 0; i < length; ++i) {
+    destination[i] = static_cast<float>(source[i]);
+  }
+}
+
+/// \brief Checks that precomputed attribute values can be uploaded as an attribute, converting them to the type of
+/// the attribute if needed.
+auto prepareBinaryAttribute(const arrow::Field& field, const std::shared_ptr<arrow::Array>& array,
+                            arrow::MemoryPool* pool) -> std::shared_ptr<arrow::Array> {
+  if (array->type()->Equals(field.type())) {
+    return array;
+  }
+
+  // Values are converted to floats as long as each row has the same number of components
+  auto listType = std::dynamic_pointer_cast<arrow::FixedSizeListType>(field.type());
+  auto arrayListType = std::dynamic_pointer_cast<arrow::FixedSizeListType>(array->type());
+  auto valueType = listType ? listType->value_type() : field.type();
+  auto sameSize = listType ? arrayListType && arrayListType->list_size() == listType->list_size() : !arrayListType;
+  if (valueType->id() != arrow::Type::FLOAT || !sameSize) {
+    throw std::runtime_error("Binary attribute " + field.name() + " has type " + array->type()->ToString() +
+                             ", expected " + field.type()->ToString());
+  }
+
+  auto data = array->data();
+  auto valueData = arrayListType ? data->child_data[0] : data;
+  int64_t valuesPerRow = listType ? listType->list_size() : 1;
+  auto start = arrayListType ? data->offset * valuesPerRow : 0;
+  auto length = array->length() * valuesPerRow;
+
+  auto allocateResult = arrow::AllocateBuffer(length * static_cast<int64_t>(sizeof(float)), pool);
+  if (!allocateResult.ok()) {
+    throw std::runtime_error("Unable to allocate attribute buffer");
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(allocateResult).ValueOrDie();
+
+  auto destination = reinterpret_cast<float*>(buffer->mutable_data());
+  switch (valueData->type->id()) {
+    case arrow::Type::UINT8:
+      convertValues<uint8_t>(*valueData, start, length, destination);
+      break;
+    case arrow::Type::INT8:
+      convertValues<int8_t>(*valueData, start, length, destination);
+      break;
+    case arrow::Type::UINT16:
+      convertValues<uint16_t>(*valueData, start, length, destination);
+      break;
+    case arrow::Type::INT16:
+      convertValues<int16_t>(*valueData, start, length, destination);
+      break;
+    case arrow::Type::UINT32:
+      convertValues<uint32_t>(*valueData, start, length, destination);
+      break;
+    case arrow::Type::INT32:
+      convertValues<int32_t>(*valueData, start, length, destination);
+      break;
+    case arrow::Type::DOUBLE:
+      convertValues<double>(*valueData, start, length, destination);
+      break;
+    default:
+      throw std::runtime_error("Binary attribute " + field.name() + " has unsupported type " +
+                               array->type()->ToString());
+  }
+
+  auto values = arrow::ArrayData::Make(arrow::float32(), length, {nullptr, buffer}, 0);
+  if (!listType) {
+    return arrow::MakeArray(values);
+  }
+
+  return arrow::MakeArray(arrow::ArrayData::Make(field.type(), array->length(), {nullptr}, {values}, 0));
+}
+
+/// \brief Sorts row indices by the position of their bounding box centers along a space filling curve.
+auto sortRows(const std::vector<SpatialIndex::Box>& boxes, SpatialOrder order) -> std::vector<uint32_t> {
+  std::vector<uint32_t> rows(boxes.size());
+  std::iota(rows.begin(), rows.end(), 0);
+  if (order == SpatialOrder::NONE || boxes.empty()) {
+    return rows;
+  }
+
+  auto infinity = std::numeric_limits<float>::infinity();
+  SpatialIndex::Box bounds{infinity, infinity, -infinity, -infinity};
+  for (const auto& box : boxes) {
+    bounds[0] = std::min(bounds[0], box[0]);
+    bounds[1] = std::min(bounds[1], box[1]);
+    bounds[2] = std::max(bounds[2], box[2]);
+    bounds[3] = std::max(bounds[3], box[3]);
+  }
+
+  // Map centers onto a 16-bit curve spanning the bounds of all the rows, the same way spatial indices do
+  SpatialIndex::CurveGrid grid{bounds};
+  std::vector<uint32_t> curveValues(boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    curveValues[i] = order == SpatialOrder::HILBERT ? grid.hilbert(boxes[i]) : grid.morton(boxes[i]);
+  }
+
+  // Keep data order for rows at the same position along the curve
+  std::stable_sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) { return curveValues[a] < curveValues[b]; });
+  return rows;
+}
+
+}  // anonymous namespace
+
 auto AttributeManager::getNeedsRedraw(bool clearRedrawFlags) -> bool {
   bool redraw = this->_needsRedraw;
   this->_needsRedraw = this->_needsRedraw && !clearRedrawFlags;
@@ -46,5 +204,168 @@ void AttributeManager::invalidateAll() {
 }
 
 auto AttributeManager::update(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<garrow::Table> {
-  return garrow::transformTable(table, this->_builders, this->device);
+  PROBEGL_TRACE_SCOPE("AttributeManager::update", this->id);
+  probegl::ScopedStatTimer updateTimer{this->_updateTime};
+
+  // Binary attributes skip mapping, builders just forward their values
+  std::vector<garrow::ColumnBuilder> builders;
+  for (auto const& builder : this->_builders) {
+    auto mapColumn = [this, builder](const std::shared_ptr<arrow::Table>& table) {
+      return this->_mapColumn(builder, table);
+    };
+    builders.push_back(garrow::ColumnBuilder{builder.field, mapColumn});
+  }
+
+  this->_permutation.clear();
+  this->_chunks.clear();
+  auto attributes = garrow::transformTable(table, builders, this->device);
+  this->_uploadedAttributes = attributes;
+  this->_recordUpload(attributes);
+  return attributes;
+}
+
+auto AttributeManager::append(const std::shared_ptr<arrow::Table>& table, int64_t startRow)
+    -> std::shared_ptr<garrow::Table> {
+  auto attributes = this->_uploadedAttributes;
+  if (!attributes || attributes->num_rows() != startRow || startRow > table->num_rows()) {
+    return this->update(table);
+  }
+
+  PROBEGL_TRACE_SCOPE("AttributeManager::append", this->id);
+  probegl::ScopedStatTimer updateTimer{this->_updateTime};
+
+  auto appendedRows = table->Slice(startRow);
+  uint64_t byteLength = 0;
+  for (size_t i = 0; i < this->_builders.size(); ++i) {
+    auto column = attributes->column(static_cast<int>(i));
+    auto previousByteLength = column->byteLength();
+    column->appendData(this->_mapColumn(this->_builders[i], appendedRows, startRow), wgpu::BufferUsage::Vertex);
+    byteLength += column->byteLength() - previousByteLength;
+  }
+
+  if (this->stats->enabled()) {
+    this->_rebuilds.increment(static_cast<uint64_t>(attributes->num_columns()));
+    this->_bytesUploaded.increment(byteLength);
+  }
+
+  return attributes;
+}
+
+auto AttributeManager::map(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Table> {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (auto const& builder : this->_builders) {
+    fields.push_back(builder.field);
+    arrays.push_back(this->_mapColumn(builder, table));
+  }
+
+  return arrow::Table::Make(std::make_shared<arrow::Schema>(fields), arrays);
+}
+
+auto AttributeManager::upload(const std::shared_ptr<arrow::Table>& attributes) -> std::shared_ptr<garrow::Table> {
+  return this->_upload(attributes, nullptr);
+}
+
+auto AttributeManager::upload(const std::shared_ptr<arrow::Table>& attributes, const std::vector<uint32_t>& rows)
+    -> std::shared_ptr<garrow::Table> {
+  return this->_upload(attributes, &rows);
+}
+
+auto AttributeManager::uploadSorted(const std::shared_ptr<arrow::Table>& attributes,
+                                    const std::vector<SpatialIndex::Box>& boxes, SpatialOrder order, size_t chunkSize)
+    -> std::shared_ptr<garrow::Table> {
+  if (boxes.size() != static_cast<size_t>(attributes->num_rows())) {
+    throw std::logic_error("Expected a bounding box for each attribute row");
+  }
+  if (chunkSize == 0) {
+    throw std::logic_error("Chunk size has to be positive");
+  }
+
+  auto rows = sortRows(boxes, order);
+  auto uploadedAttributes = this->upload(attributes, rows);
+
+  auto infinity = std::numeric_limits<float>::infinity();
+  for (size_t first = 0; first < rows.size(); first += chunkSize) {
+    auto end = std::min(first + chunkSize, rows.size());
+    SpatialIndex::Box bounds{infinity, infinity, -infinity, -infinity};
+    for (auto instance = first; instance < end; ++instance) {
+      const auto& box = boxes[rows[instance]];
+      bounds[0] = std::min(bounds[0], box[0]);
+      bounds[1] = std::min(bounds[1], box[1]);
+      bounds[2] = std::max(bounds[2], box[2]);
+      bounds[3] = std::max(bounds[3], box[3]);
+    }
+
+    this->_chunks.emplace_back(static_cast<uint32_t>(first), static_cast<uint32_t>(end - first), bounds);
+  }
+
+  return uploadedAttributes;
+}
+
+auto AttributeManager::_upload(const std::shared_ptr<arrow::Table>& attributes, const std::vector<uint32_t>* rows)
+    -> std::shared_ptr<garrow::Table> {
+  PROBEGL_TRACE_SCOPE("AttributeManager::upload", this->id);
+  probegl::ScopedStatTimer updateTimer{this->_updateTime};
+
+  std::vector<garrow::ColumnBuilder> builders;
+  for (auto i = 0; i < attributes->num_columns(); ++i) {
+    auto column = attributes->column(i);
+    if (column->num_chunks() != 1) {
+      throw std::runtime_error("Mapped attributes are expected to be contiguous");
+    }
+
+    // Attributes have already been mapped, so builders just forward them, or the subset of rows
+    auto values = rows ? takeRows(column->chunk(0), *rows, this->memoryPool) : column->chunk(0);
+    auto forwardValues = [values](const std::shared_ptr<arrow::Table>&) { return values; };
+    builders.push_back(garrow::ColumnBuilder{attributes->schema()->field(i), forwardValues});
+  }
+
+  this->_permutation = rows ? *rows : std::vector<uint32_t>{};
+  this->_chunks.clear();
+  this->_uploadedAttributes = nullptr;
+  auto uploadedAttributes = garrow::transformTable(attributes, builders, this->device);
+  this->_recordUpload(uploadedAttributes);
+  return uploadedAttributes;
+}
+
+auto AttributeManager::_mapColumn(const garrow::ColumnBuilder& builder, const std::shared_ptr<arrow::Table>& table,
+                                  int64_t startRow) -> std::shared_ptr<arrow::Array> {
+  auto binaryAttribute = this->_binaryAttributes.find(builder.field->name());
+  if (binaryAttribute == this->_binaryAttributes.end()) {
+    return this->_fillNulls(builder, builder.mapColumn(table));
+  }
+
+  auto array = binaryAttribute->second;
+  if (array->length() != startRow + table->num_rows()) {
+    throw std::runtime_error("Binary attribute " + builder.field->name() + " has " + std::to_string(array->length()) +
+                             " values, expected " + std::to_string(startRow + table->num_rows()));
+  }
+
+  // Nulls are replaced before values are converted, as values behind them are undefined
+  auto values = startRow > 0 ? array->Slice(startRow) : array;
+  return prepareBinaryAttribute(*builder.field, this->_fillNulls(builder, values), this->memoryPool);
+}
+
+auto AttributeManager::_fillNulls(const garrow::ColumnBuilder& builder, const std::shared_ptr<arrow::Array>& array)
+    -> std::shared_ptr<arrow::Array> {
+  auto filled = garrow::fillNulls(array, builder.nullValue, this->memoryPool);
+  if (filled.filledCount > 0 && this->stats->enabled()) {
+    this->_nullValues.increment(static_cast<uint64_t>(filled.filledCount));
+  }
+
+  return filled.array;
+}
+
+void AttributeManager::_recordUpload(const std::shared_ptr<garrow::Table>& attributes) {
+  if (!this->stats->enabled()) {
+    return;
+  }
+
+  uint64_t byteLength = 0;
+  for (auto const& column : attributes->columns()) {
+    byteLength += column->byteLength();
+  }
+
+  this->_rebuilds.increment(static_cast<uint64_t>(attributes->num_columns()));
+  this->_bytesUploaded.increment(byteLength);
 }
@@ -23,11 +23,15 @@
 
 #include <arrow/table.h>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "../constants.h"
+#include "../spatial-index.h"
 #include "luma.gl/garrow.h"
+#include "probe.gl/core.h"
 
 namespace deckgl {
 
@@ -55,24 +59,133 @@ namespace deckgl {
  */
 class AttributeManager {
  public:
-  AttributeManager(const std::string& id, wgpu::Device device) : id{id}, device{device} {}
+  class Chunk;
+
+  /// \param id Identifier of this attribute manager, usually the id of the layer it belongs to.
+  /// \param device Device that attributes are uploaded to.
+  /// \param stats Stats that attribute rebuilds and uploads are recorded into, a new set of stats is created if not
+  /// provided.
+  /// \param memoryPool Pool that transient attribute data is allocated from.
+  AttributeManager(const std::string& id, wgpu::Device device, const std::shared_ptr<probegl::Stats>& stats = nullptr,
+                   arrow::MemoryPool* memoryPool = arrow::default_memory_pool())
+      : id{id},
+        device{device},
+        stats{stats ? stats : std::make_shared<probegl::Stats>(id)},
+        memoryPool{memoryPool ? memoryPool : arrow::default_memory_pool()},
+        _updateTime{this->stats->get("Attribute Update Time", probegl::Stat::Type::TIMER)},
+        _rebuilds{this->stats->get("Attribute Rebuilds")},
+        _bytesUploaded{this->stats->get("Bytes Uploaded")},
+        _nullValues{this->stats->get("Null Attribute Values")} {}
 
   auto getNeedsRedraw(bool clearRedrawFlags = false) -> bool;
   void setNeedsRedraw();
 
   void add(const lumagl::garrow::ColumnBuilder& builder);
 
+  /// \brief Sets precomputed values of attributes, which are used as they are instead of being mapped from data.
+  /// \param attributes Values by attribute name, with one value per data row. Values have to be of the attribute's
+  /// type, or have the same number of components if the attribute is of a float type, in which case they're converted.
+  void setBinaryAttributes(const std::map<std::string, std::shared_ptr<arrow::Array>>& attributes) {
+    this->_binaryAttributes = attributes;
+  }
+
   void invalidate(const std::string& attributeName);
   void invalidateAll();
 
   auto update(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<lumagl::garrow::Table>;
 
+  /// \brief Maps and uploads only the rows appended to a table since it was last passed to update(), adding them to
+  /// the end of the previously uploaded attributes. Falls back to update() if attributes were uploaded differently.
+  /// \param table Data that was previously passed to update(), with rows appended to it.
+  /// \param startRow Index of the first appended row.
+  /// \return Attribute table returned by update(), now containing the appended rows.
+  auto append(const std::shared_ptr<arrow::Table>& table, int64_t startRow) -> std::shared_ptr<lumagl::garrow::Table>;
+
+  /// \brief Maps data into attribute columns on the CPU, without uploading them to the GPU.
+  /// \param table Data to map using registered column builders.
+  /// \return Table containing a column for each registered attribute.
+  auto map(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Uploads previously mapped attributes to the GPU as they are, in data order.
+  /// \param attributes Attribute table, as returned by map().
+  auto upload(const std::shared_ptr<arrow::Table>& attributes) -> std::shared_ptr<lumagl::garrow::Table>;
+
+  /// \brief Uploads a subset of rows of previously mapped attributes to the GPU.
+  /// \param attributes Attribute table, as returned by map().
+  /// \param rows Indices of rows to upload, in the order they should be drawn in.
+  auto upload(const std::shared_ptr<arrow::Table>& attributes, const std::vector<uint32_t>& rows)
+      -> std::shared_ptr<lumagl::garrow::Table>;
+
+  /// \brief Reorders rows of previously mapped attributes along a space filling curve, and uploads them to the GPU.
+  /// Consecutive instances are grouped into chunks with known bounds, so that chunks outside of the viewport can be
+  /// skipped when drawing.
+  /// \param attributes Attribute table, as returned by map().
+  /// \param boxes Bounding box of each row, in unprojected coordinates.
+  /// \param order Space filling curve to order rows along.
+  /// \param chunkSize Maximum number of instances in a single chunk.
+  auto uploadSorted(const std::shared_ptr<arrow::Table>& attributes, const std::vector<SpatialIndex::Box>& boxes,
+                    SpatialOrder order, size_t chunkSize = 65536) -> std::shared_ptr<lumagl::garrow::Table>;
+
+  /// \brief Returns chunks of instances uploaded by the last call to uploadSorted().
+  auto chunks() const -> const std::vector<Chunk>& { return this->_chunks; }
+
+  /// \brief Maps an index of an uploaded instance back to the index of the data row it was created from.
+  auto rowIndex(uint32_t instanceIndex) const -> uint32_t {
+    return this->_permutation.empty() ? instanceIndex : this->_permutation.at(instanceIndex);
+  }
+
+  /// \brief Returns the amount of CPU memory retained for mapping uploaded instances back to data rows, in bytes.
+  auto byteLength() const -> uint64_t {
+    return this->_permutation.capacity() * sizeof(uint32_t) + this->_chunks.capacity() * sizeof(Chunk);
+  }
+
   std::string id;
   wgpu::Device device;
+  std::shared_ptr<probegl::Stats> stats;
+  arrow::MemoryPool* memoryPool;
 
  private:
+  /// \brief Uploads previously mapped attributes, or the given rows of them if rows isn't null.
+  auto _upload(const std::shared_ptr<arrow::Table>& attributes, const std::vector<uint32_t>* rows)
+      -> std::shared_ptr<lumagl::garrow::Table>;
+
+  /// \brief Records attribute columns that were rebuilt and uploaded to the GPU.
+  void _recordUpload(const std::shared_ptr<lumagl::garrow::Table>& attributes);
+
+  /// \brief Maps a single attribute, or takes its values from binary attributes if they've been set.
+  /// \param table Data rows to map, following startRow rows that have been mapped previously.
+  auto _mapColumn(const lumagl::garrow::ColumnBuilder& builder, const std::shared_ptr<arrow::Table>& table,
+                  int64_t startRow = 0) -> std::shared_ptr<arrow::Array>;
+  /// \brief Replaces null elements of a mapped attribute with the null value of its builder, counting them in stats.
+  auto _fillNulls(const lumagl::garrow::ColumnBuilder& builder, const std::shared_ptr<arrow::Array>& array)
+      -> std::shared_ptr<arrow::Array>;
+
+  probegl::Stat& _updateTime;
+  probegl::Stat& _rebuilds;
+  probegl::Stat& _bytesUploaded;
+  probegl::Stat& _nullValues;
+
   bool _needsRedraw{false};
   std::vector<lumagl::garrow::ColumnBuilder> _builders;
+  std::map<std::string, std::shared_ptr<arrow::Array>> _binaryAttributes;
+
+  /// Attributes uploaded by the last call to update(), which rows can be appended to
+  std::shared_ptr<lumagl::garrow::Table> _uploadedAttributes;
+  /// Data row of each uploaded instance, empty if instances were uploaded in data order
+  std::vector<uint32_t> _permutation;
+  std::vector<Chunk> _chunks;
+};
+
+/// \brief Range of consecutive instances uploaded by AttributeManager::uploadSorted(), and their bounds.
+class AttributeManager::Chunk {
+ public:
+  Chunk(uint32_t firstInstance, uint32_t instanceCount, const SpatialIndex::Box& bounds)
+      : firstInstance{firstInstance}, instanceCount{instanceCount}, bounds{bounds} {}
+
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+  /// \brief Bounds of all the instances in this chunk, as [minX, minY, maxX, maxY].
+  SpatialIndex::Box bounds;
 };
 
 }  // namespace deckgl
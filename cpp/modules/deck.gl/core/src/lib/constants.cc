@@ -20,8 +20,19 @@
 
 #include "./constants.h"  // NOLINT(build/include)
 
+#include <map>
+#include <stdexcept>
+#include <string>
+
 using namespace deckgl;
 
+namespace {
+
+const std::map<std::string, SpatialOrder> kSpatialOrders{
+    {"none", SpatialOrder::NONE}, {"hilbert", SpatialOrder::HILBERT}, {"morton", SpatialOrder::MORTON}};
+
+}  // anonymous namespace
+
 auto deckgl::operator<<(std::ostream& os, COORDINATE_SYSTEM cs) -> std::ostream& {
   switch (cs) {
     case COORDINATE_SYSTEM::DEFAULT:
@@ -45,3 +56,26 @@ auto deckgl::operator<<(std::ostream& os, COORDINATE_SYSTEM cs) -> std::ostream&
   }
   return os;
 }
+
+auto deckgl::operator<<(std::ostream& os, SpatialOrder order) -> std::ostream& {
+  for (const auto& [name, value] : kSpatialOrders) {
+    if (value == order) {
+      return os << name;
+    }
+  }
+  return os << "Unknown";
+}
+
+namespace deckgl {
+
+template <>
+auto fromJson<SpatialOrder>(const Json::Value& jsonValue) -> SpatialOrder {
+  auto name = fromJson<std::string>(jsonValue);
+  auto order = kSpatialOrders.find(name);
+  if (order == kSpatialOrders.end()) {
+    throw std::runtime_error("Unknown spatial order: " + name);
+  }
+  return order->second;
+}
+
+}  // namespace deckgl
@@ -52,6 +52,15 @@ inline auto fromJson<COORDINATE_SYSTEM>(const Json::Value& jsonValue) -> COORDIN
   return static_cast<COORDINATE_SYSTEM>(fromJson<int>(jsonValue));
 }
 
+/// \brief Space filling curves that instances can be ordered along.
+enum class SpatialOrder { NONE, HILBERT, MORTON };
+
+auto operator<<(std::ostream& os, SpatialOrder order) -> std::ostream&;
+
+/// \brief Reads a spatial order from its name, "none", "hilbert" or "morton".
+template <>
+auto fromJson<SpatialOrder>(const Json::Value& jsonValue) -> SpatialOrder;
+
 /// \brief Describes the common space.
 enum class PROJECTION_MODE {
   IDENTITY = 0,
@@ -0,0 +1,166 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./cpu-picker.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <limits>
+
+using namespace deckgl;
+
+void CPUPicker::setLayers(const std::list<std::shared_ptr<Layer>>& layers) {
+  std::vector<std::future<LayerIndex>> builds;
+  for (auto const& layer : layers) {
+    auto props = layer->props();
+    // Layers whose data is still loading have nothing to pick yet
+    if (!props->pickable || !props->data) {
+      continue;
+    }
+
+    // Reuse indexes of layers whose data hasn't changed, and build the rest in parallel
+    auto existing = std::find_if(this->_layers.begin(), this->_layers.end(), [&](const LayerIndex& layerIndex) {
+      return layerIndex.layer == layer && layerIndex.data == props->data;
+    });
+    if (existing != this->_layers.end()) {
+      std::promise<LayerIndex> existingIndex;
+      existingIndex.set_value(*existing);
+      builds.push_back(existingIndex.get_future());
+    } else {
+      builds.push_back(std::async(std::launch::async, &CPUPicker::_buildIndex, layer));
+    }
+  }
+
+  this->_layers.clear();
+  for (auto& build : builds) {
+    auto layerIndex = build.get();
+    if (layerIndex.index) {
+      this->_layers.push_back(std::move(layerIndex));
+    }
+  }
+}
+
+auto CPUPicker::pickObject(const std::shared_ptr<Viewport>& viewport, double x, double y, double radius)
+    -> std::optional<Hit> {
+  std::optional<Hit> closest;
+  for (auto const& hit : this->_query(viewport, {x, y, x, y}, radius)) {
+    // Hits are ordered from the topmost layer down, within a layer objects drawn later end up on top
+    auto onTop = closest && hit.layer == closest->layer && hit.index > closest->index;
+    if (!closest || hit.distance < closest->distance || (hit.distance == closest->distance && onTop)) {
+      closest = hit;
+    }
+  }
+
+  return closest;
+}
+
+auto CPUPicker::pickObjects(const std::shared_ptr<Viewport>& viewport, double x, double y, double width,
+                            double height) -> std::vector<Hit> {
+  return this->_query(viewport, {x, y, x + width, y + height}, 0.0);
+}
+
+auto CPUPicker::queryPoint(double x, double y, double radius) -> std::vector<Hit> {
+  return this->_query(nullptr, {x, y, x, y}, radius);
+}
+
+auto CPUPicker::queryRect(double minX, double minY, double maxX, double maxY) -> std::vector<Hit> {
+  return this->_query(nullptr, {minX, minY, maxX, maxY}, 0.0);
+}
+
+auto CPUPicker::_buildIndex(const std::shared_ptr<Layer>& layer) -> LayerIndex {
+  LayerIndex layerIndex{layer, layer->props()->data, layer->getPickingGeometry(), nullptr};
+  if (!layerIndex.geometry) {
+    return layerIndex;
+  }
+
+  auto shapeCount = layerIndex.geometry->shapeCount();
+  layerIndex.index = std::make_shared<SpatialIndex>(shapeCount);
+  for (size_t shape = 0; shape < shapeCount; ++shape) {
+    auto bounds = layerIndex.geometry->shapeBounds(shape);
+    layerIndex.index->add(bounds[0], bounds[1], bounds[2], bounds[3]);
+  }
+  layerIndex.index->finish();
+
+  return layerIndex;
+}
+
+auto CPUPicker::_query(const std::shared_ptr<Viewport>& viewport, const PickingGeometry::Box& box, double radius)
+    -> std::vector<Hit> {
+  std::vector<Hit> hits;
+  for (auto layerIndex = this->_layers.rbegin(); layerIndex != this->_layers.rend(); ++layerIndex) {
+    const auto& geometry = *layerIndex->geometry;
+    auto metersPerPixel = viewport ? viewport->metersPerPixel() : 0.0;
+
+    // Shapes are indexed without their sizes, so the search area has to be padded by the largest one instead
+    PickingGeometry::Box searchBox{box[0] - radius, box[1] - radius, box[2] + radius, box[3] + radius};
+    if (viewport) {
+      auto padding = geometry.sizes.empty() ? 0.0 : geometry.sizePixels(geometry.maxSize(), metersPerPixel);
+      auto infinity = std::numeric_limits<double>::infinity();
+      PickingGeometry::Box pixelBox{searchBox[0] - padding, searchBox[1] - padding, searchBox[2] + padding,
+                                    searchBox[3] + padding};
+      searchBox = {infinity, infinity, -infinity, -infinity};
+
+      // Pixel boxes cover convex areas on the ground, which are bounded by the unprojected box corners
+      std::array<PickingGeometry::Point, 4> corners{PickingGeometry::Point{pixelBox[0], pixelBox[1]},
+                                                    {pixelBox[2], pixelBox[1]},
+                                                    {pixelBox[2], pixelBox[3]},
+                                                    {pixelBox[0], pixelBox[3]}};
+      for (auto const& corner : corners) {
+        auto position = viewport->unproject(mathgl::Vector2<double>(corner[0], corner[1]));
+        searchBox[0] = std::min(searchBox[0], position.x);
+        searchBox[1] = std::min(searchBox[1], position.y);
+        searchBox[2] = std::max(searchBox[2], position.x);
+        searchBox[3] = std::max(searchBox[3], position.y);
+      }
+    }
+
+    auto verticesPerShape = PickingGeometry::verticesPerShape(geometry.type);
+    std::vector<PickingGeometry::Point> projectedVertices(verticesPerShape);
+    std::vector<Hit> layerHits;
+    for (auto shape : layerIndex->index->search(searchBox[0], searchBox[1], searchBox[2], searchBox[3])) {
+      auto vertices = geometry.shapeVertices(shape);
+      double size = 0.0;
+      if (viewport) {
+        for (size_t i = 0; i < verticesPerShape; ++i) {
+          auto pixel = viewport->project(mathgl::Vector2<double>(vertices[i][0], vertices[i][1]));
+          projectedVertices[i] = {pixel.x, pixel.y};
+        }
+        vertices = projectedVertices.data();
+        size = geometry.sizes.empty() ? 0.0 : geometry.sizePixels(geometry.sizes[shape], metersPerPixel);
+      }
+
+      auto distance = std::max(PickingGeometry::distanceToBox(geometry.type, vertices, box) - size, 0.0);
+      if (distance <= radius) {
+        layerHits.push_back({layerIndex->layer, geometry.shapeRow(shape), distance});
+      }
+    }
+
+    // Objects can be made up of multiple shapes, only the closest one is reported
+    std::sort(layerHits.begin(), layerHits.end(), [](const Hit& a, const Hit& b) {
+      return a.index < b.index || (a.index == b.index && a.distance < b.distance);
+    });
+    auto last = std::unique(layerHits.begin(), layerHits.end(),
+                            [](const Hit& a, const Hit& b) { return a.index == b.index; });
+    hits.insert(hits.end(), layerHits.begin(), last);
+  }
+
+  return hits;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_LIB_CPU_PICKER_H
+#define DECKGL_CORE_LIB_CPU_PICKER_H
+
+#include <list>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "./layer.h"
+#include "./picking-geometry.h"
+#include "./spatial-index.h"
+#include "../viewports/viewport.h"
+
+namespace deckgl {
+
+/// \brief Picks objects without a GPU, by querying spatial indexes built over the picking geometry of each layer.
+/// Useful for headless deployments, and for queries that cover large areas or many objects at once.
+class CPUPicker {
+ public:
+  class Hit;
+
+  /// \brief Sets the layers to pick from, listed in the order they are drawn in.
+  /// Indexes are only rebuilt for layers whose data has changed since the last call, concurrently.
+  /// \note Only pickable layers that provide picking geometry are indexed. Layers must not be updated meanwhile.
+  void setLayers(const std::list<std::shared_ptr<Layer>>& layers);
+
+  /// \brief Finds the object closest to a position on screen, the same way GPU picking would.
+  /// \param viewport Viewport the layers are being viewed through.
+  /// \param x X coordinate, in pixels from the left edge of the viewport.
+  /// \param y Y coordinate, in pixels from the top edge of the viewport.
+  /// \param radius Objects within this many pixels of the position are picked as well.
+  /// \return Closest object, with objects in layers drawn on top winning ties, or std::nullopt if nothing was hit.
+  /// \note Positions are assumed to be below the horizon in pitched viewports.
+  auto pickObject(const std::shared_ptr<Viewport>& viewport, double x, double y, double radius = 0)
+      -> std::optional<Hit>;
+
+  /// \brief Finds all the objects that overlap a rectangle on screen.
+  /// \param viewport Viewport the layers are being viewed through.
+  /// \param x X coordinate of the top left corner, in pixels.
+  /// \param y Y coordinate of the top left corner, in pixels.
+  /// \return Objects overlapping the rectangle, topmost layers first.
+  auto pickObjects(const std::shared_ptr<Viewport>& viewport, double x, double y, double width, double height)
+      -> std::vector<Hit>;
+
+  /// \brief Finds all the objects within a distance of a position, in unprojected coordinates.
+  /// \note Object sizes are specified relative to the screen, so only their geometry is taken into account.
+  auto queryPoint(double x, double y, double radius = 0) -> std::vector<Hit>;
+
+  /// \brief Finds all the objects that overlap a box, in unprojected coordinates.
+  /// \note Object sizes are specified relative to the screen, so only their geometry is taken into account.
+  auto queryRect(double minX, double minY, double maxX, double maxY) -> std::vector<Hit>;
+
+ private:
+  struct LayerIndex {
+    std::shared_ptr<Layer> layer;
+    /// Data the index was built from, used to detect data changes
+    std::shared_ptr<arrow::Table> data;
+    std::shared_ptr<PickingGeometry> geometry;
+    std::shared_ptr<SpatialIndex> index;
+  };
+
+  static auto _buildIndex(const std::shared_ptr<Layer>& layer) -> LayerIndex;
+
+  /// \brief Collects objects whose shapes are within a distance of a box.
+  /// \param box Query box, in pixels if a viewport is provided and in unprojected coordinates otherwise.
+  /// \param radius Maximum distance to the box, in the same units.
+  auto _query(const std::shared_ptr<Viewport>& viewport, const PickingGeometry::Box& box, double radius)
+      -> std::vector<Hit>;
+
+  /// Indexes of the picked layers, in drawing order
+  std::vector<LayerIndex> _layers;
+};
+
+/// \brief Object found by CPUPicker.
+class CPUPicker::Hit {
+ public:
+  /// \brief Layer the object belongs to.
+  std::shared_ptr<Layer> layer;
+  /// \brief Index of the data row the object was created from.
+  int64_t index;
+  /// \brief Distance between the object and the query, in pixels or unprojected units, 0 if they overlap.
+  double distance;
+};
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_LIB_CPU_PICKER_H
@@ -20,8 +20,11 @@
 
 #include "./deck.h"  // NOLINT(build/include)
 
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 
+#include "../shaderlib/picking/picking-uniforms.h"
 #include "../shaderlib/project/viewport-uniforms.h"
 #include "luma.gl/garrow.h"
 
@@ -86,10 +89,17 @@ void Deck::draw(wgpu::TextureView textureView, probegl::Error& error) noexcept {
   probegl::catchError([&]() { this->draw(textureView); }, error);
 }
 
+auto Deck::pickObject(int x, int y, int radius, probegl::Error& error) noexcept -> std::optional<PickInfo> {
+  std::optional<PickInfo> pickInfo;
+  probegl::catchError([&]() { pickInfo = this->pickObject(x, y, radius); }, error);
+  return pickInfo;
+}
+
 Deck::Deck(std::shared_ptr<Deck::Props> props) : Component(props), _needsRedraw{"Initial render"} {
   this->animationLoop = lumagl::AnimationLoopFactory::createAnimationLoop(props->drawingOptions);
   this->context = std::make_shared<LayerContext>(this, this->animationLoop->device());
   this->layerManager = std::make_shared<LayerManager>(this->context);
+  this->_redrawTime = &this->context->stats->get("Redraw Time", probegl::Stat::Type::TIMER);
 
   this->setProps(props);
 
@@ -98,6 +108,10 @@ Deck::Deck(std::shared_ptr<Deck::Props> props) : Component(props), _needsRedraw{
   // TODO(ilija@unfolded.ai): Delegate to project shader module
   this->_viewportUniformsBuffer =
       lumagl::utils::createBuffer(this->animationLoop->device(), sizeof(ViewportUniforms), wgpu::BufferUsage::Uniform);
+
+  PickingUniforms pickingUniforms{0.0f, 0.0f};
+  this->_pickingDisabledUniformsBuffer = lumagl::utils::createBufferFromData(
+      this->animationLoop->device(), &pickingUniforms, sizeof(PickingUniforms), wgpu::BufferUsage::Uniform);
 }
 
 Deck::~Deck() { this->animationLoop->stop(); }
@@ -142,6 +156,45 @@ void Deck::draw(wgpu::TextureView textureView, std::function<void(Deck*)> onAfte
 
 void Deck::stop() { this->animationLoop->stop(); }
 
+auto Deck::pickObject(int x, int y, int radius) -> std::optional<PickInfo> {
+  if (radius < 0) {
+    throw std::logic_error("Picking radius cannot be negative");
+  }
+
+  auto width = this->_size.width;
+  auto height = this->_size.height;
+  if (x < 0 || y < 0 || x >= width || y >= height) {
+    return std::nullopt;
+  }
+
+  // Picking is only redrawn after layers or viewports have changed, rather than along with every frame
+  auto viewportsChanged = this->viewManager->getViewports() != this->_pickingViewports;
+  if (this->layerManager->pickingNeedsRedraw() || viewportsChanged) {
+    this->_drawPickingLayers();
+  }
+
+  // Only read back the pixels within radius, clipped to the picking buffer
+  auto left = std::max(x - radius, 0);
+  auto top = std::max(y - radius, 0);
+  auto regionWidth = static_cast<uint32_t>(std::min(x + radius + 1, width) - left);
+  auto regionHeight = static_cast<uint32_t>(std::min(y + radius + 1, height) - top);
+  auto alignment = lumagl::utils::kTextureRowPitchAlignment;
+  auto bytesPerRow = (regionWidth * 4 + alignment - 1) / alignment * alignment;
+
+  auto pixels = this->_readPickingPixels(static_cast<uint32_t>(left), static_cast<uint32_t>(top), regionWidth,
+                                         regionHeight, bytesPerRow);
+  auto pickingIndex = findClosestPickingIndex(pixels.data(), regionWidth, regionHeight, bytesPerRow, x - left, y - top);
+  if (!pickingIndex || pickingIndex->layerIndex >= this->_pickingLayers.size()) {
+    return std::nullopt;
+  }
+
+  auto layer = this->_pickingLayers[pickingIndex->layerIndex];
+  auto attributeManager = layer->attributeManager();
+  auto rowIndex = attributeManager ? attributeManager->rowIndex(pickingIndex->objectIndex) : pickingIndex->objectIndex;
+
+  return PickInfo{layer, static_cast<int64_t>(rowIndex), x, y};
+}
+
 auto Deck::needsRedraw(bool clearRedrawFlags) -> std::optional<std::string> {
   auto redraw = this->_needsRedraw;
 
@@ -182,18 +235,26 @@ void Deck::_setSize(const lumagl::Size& size) {
 }
 
 void Deck::_redraw(wgpu::RenderPassEncoder pass, std::function<void(Deck*)> onAfterRender, bool force) {
+  // Data loaded in the background is handed over on the render thread, so that layers are never updated concurrently
+  this->layerManager->updatePendingData();
+
+  // Always query redraw flags, so that they get cleared even if a redraw is forced
+  auto needsRedraw = this->needsRedraw(true);
+
   // If force is falsy, check if we need to redraw
-  std::optional<std::string> redrawReason = force ? "Redraw Forced" : this->needsRedraw(true);
+  std::optional<std::string> redrawReason = force ? "Redraw Forced" : needsRedraw;
 
   if (!redrawReason) {
     return;
   }
 
+  probegl::ScopedStatTimer redrawTimer{this->_redrawTime};
   this->_drawLayers(pass, onAfterRender, redrawReason.value());
 }
 
 void Deck::_drawLayers(wgpu::RenderPassEncoder pass, std::function<void(Deck*)> onAfterRender,
                        const std::string& redrawReason) {
+  PROBEGL_TRACE_SCOPE("Deck::_drawLayers");
   this->props()->onBeforeRender(this);
 
   for (auto const& viewport : this->viewManager->getViewports()) {
@@ -201,21 +262,139 @@ void Deck::_drawLayers(wgpu::RenderPassEncoder pass, std::function<void(Deck*)>
     this->layerManager->activateViewport(viewport);
 
     for (auto const& layer : this->layerManager->layers()) {
-      auto layerProps = layer->props();
-      auto viewportUniforms = getUniformsFromViewport(viewport, this->animationLoop->devicePixelRatio(),
-                                                      layerProps->modelMatrix, layerProps->coordinateSystem,
-                                                      layerProps->coordinateOrigin, layerProps->wrapLongitude);
-
-      this->_viewportUniformsBuffer.SetSubData(0, sizeof(ViewportUniforms), &viewportUniforms);
+      this->_setViewportUniforms(viewport, layer);
       for (auto const& model : layer->models()) {
-        // Viewport uniforms are currently bound to index 0
-        model->setUniformBuffer(0, this->_viewportUniformsBuffer);
+        // Picking uniforms are currently bound to index 2
+        model->setUniformBuffer(2, this->_pickingDisabledUniformsBuffer);
       }
 
       layer->draw(pass);
     }
   }
 
+  this->layerManager->updateMemoryUsage();
+
   onAfterRender(this);
   this->props()->onAfterRender(this);
 }
+
+void Deck::_drawPickingLayers() {
+  auto device = this->animationLoop->device();
+  auto width = static_cast<uint32_t>(this->_size.width);
+  auto height = static_cast<uint32_t>(this->_size.height);
+  if (this->_pickingPass.width != width || this->_pickingPass.height != height) {
+    this->_pickingPass = lumagl::utils::createBasicRenderPass(device, width, height);
+  }
+
+  this->_pickingLayers.clear();
+  this->_pickingViewports = this->viewManager->getViewports();
+
+  wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+  wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&this->_pickingPass.renderPassInfo);
+
+  for (auto const& viewport : this->_pickingViewports) {
+    this->layerManager->activateViewport(viewport);
+
+    for (auto const& layer : this->layerManager->layers()) {
+      auto layerProps = layer->props();
+      if (!layerProps->pickable || !layerProps->visible) {
+        continue;
+      }
+
+      // Layers keep their index across viewports, so that all of their objects can be told apart
+      auto layerIt = std::find(this->_pickingLayers.begin(), this->_pickingLayers.end(), layer);
+      auto layerIndex = static_cast<uint32_t>(layerIt - this->_pickingLayers.begin());
+      if (layerIt == this->_pickingLayers.end()) {
+        if (layerIndex >= kMaxPickingLayers) {
+          probegl::WarningLog() << "Too many pickable layers, skipping layer " << layerProps->id;
+          continue;
+        }
+        this->_pickingLayers.push_back(layer);
+      }
+
+      while (this->_pickingUniformsBuffers.size() <= layerIndex) {
+        PickingUniforms pickingUniforms{1.0f, static_cast<float>(this->_pickingUniformsBuffers.size())};
+        this->_pickingUniformsBuffers.push_back(lumagl::utils::createBufferFromData(
+            device, &pickingUniforms, sizeof(PickingUniforms), wgpu::BufferUsage::Uniform));
+      }
+
+      this->_setViewportUniforms(viewport, layer);
+      for (auto const& model : layer->models()) {
+        model->setUniformBuffer(2, this->_pickingUniformsBuffers[layerIndex]);
+      }
+
+      layer->drawPicking(pass);
+    }
+  }
+
+  pass.EndPass();
+  wgpu::CommandBuffer commands = encoder.Finish();
+  {
+    PROBEGL_TRACE_SCOPE("Queue::Submit");
+    this->animationLoop->queue().Submit(1, &commands);
+  }
+
+  this->layerManager->pickingNeedsRedraw(true);
+}
+
+void Deck::_setViewportUniforms(const std::shared_ptr<Viewport>& viewport, const std::shared_ptr<Layer>& layer) {
+  auto layerProps = layer->props();
+  auto viewportUniforms =
+      getUniformsFromViewport(viewport, this->animationLoop->devicePixelRatio(), layerProps->modelMatrix,
+                              layerProps->coordinateSystem, layerProps->coordinateOrigin, layerProps->wrapLongitude);
+
+  this->_viewportUniformsBuffer.SetSubData(0, sizeof(ViewportUniforms), &viewportUniforms);
+  for (auto const& model : layer->models()) {
+    // Viewport uniforms are currently bound to index 0
+    model->setUniformBuffer(0, this->_viewportUniformsBuffer);
+  }
+}
+
+auto Deck::_readPickingPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t bytesPerRow)
+    -> std::vector<uint8_t> {
+  auto device = this->animationLoop->device();
+  auto buffer = lumagl::utils::createBuffer(device, bytesPerRow * height,
+                                            wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst);
+
+  auto bufferCopyView = lumagl::utils::createBufferCopyView(buffer, 0, bytesPerRow, 0);
+  auto textureCopyView = lumagl::utils::createTextureCopyView(this->_pickingPass.color, 0, 0, {x, y, 0});
+  wgpu::Extent3D copySize = {width, height, 1};
+
+  wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+  encoder.CopyTextureToBuffer(&textureCopyView, &bufferCopyView, &copySize);
+  wgpu::CommandBuffer commands = encoder.Finish();
+  {
+    PROBEGL_TRACE_SCOPE("Queue::Submit");
+    this->animationLoop->queue().Submit(1, &commands);
+  }
+
+  struct ReadState {
+    bool done{false};
+    bool succeeded{false};
+    std::vector<uint8_t> pixels;
+  } state;
+
+  buffer.MapReadAsync(
+      [](WGPUBufferMapAsyncStatus status, const void* data, uint64_t dataLength, void* userdata) {
+        auto state = static_cast<ReadState*>(userdata);
+        if (status == WGPUBufferMapAsyncStatus_Success) {
+          auto bytes = static_cast<const uint8_t*>(data);
+          state->pixels.assign(bytes, bytes + dataLength);
+          state->succeeded = true;
+        }
+        state->done = true;
+      },
+      &state);
+
+  // Picking is synchronous, wait for the copy to finish
+  while (!state.done) {
+    device.Tick();
+  }
+  buffer.Unmap();
+
+  if (!state.succeeded) {
+    throw std::runtime_error("Failed to read back picking buffer");
+  }
+
+  return state.pixels;
+}
@@ -25,6 +25,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "./layer-manager.h"
 #include "./view-manager.h"
@@ -39,6 +40,7 @@ namespace deckgl {
 class Deck : public Component {
  public:
   class Props;
+  class PickInfo;
   struct RenderingOptions;
 
 #pragma mark - Exception-free API
@@ -51,6 +53,7 @@ class Deck : public Component {
   void run(probegl::Error& error) noexcept;
   void draw(wgpu::TextureView textureView, std::function<void(Deck*)> onAfterRender, probegl::Error& error) noexcept;
   void draw(wgpu::TextureView textureView, probegl::Error& error) noexcept;
+  auto pickObject(int x, int y, int radius, probegl::Error& error) noexcept -> std::optional<PickInfo>;
 
 #pragma mark -
 
@@ -82,6 +85,15 @@ class Deck : public Component {
   /// \returns Returns an optional string summarizing the redraw reason.
   auto needsRedraw(bool clearRedrawFlags = false) -> std::optional<std::string>;
 
+  /// \brief Finds the object of a pickable layer that was drawn closest to the given position.
+  /// \note Layers are drawn into an offscreen picking buffer, which is only redrawn if something has changed since the
+  /// last time it was drawn.
+  /// \param x X coordinate of the position, in pixels from the left edge of the viewport.
+  /// \param y Y coordinate of the position, in pixels from the top edge of the viewport.
+  /// \param radius Number of pixels around the position to search for objects in.
+  /// \returns Information about the closest object, or std::nullopt if there are no objects around the position.
+  auto pickObject(int x, int y, int radius = 0) -> std::optional<PickInfo>;
+
   /// \brief Gets a list of views that this Deck is viewed from.
   /// \returns A list of View instances that this Deck can be viewed from.
   auto getViews() -> std::list<std::shared_ptr<View>> { return this->viewManager->getViews(); }
@@ -90,6 +102,10 @@ class Deck : public Component {
   /// \returns Width and height of the current viewport.
   auto size() -> lumagl::Size { return this->_size; };
 
+  /// \brief Gets stats recorded while updating and drawing layers of this Deck.
+  /// \note Frame timings are recorded separately, into animationLoop->stats.
+  auto stats() -> std::shared_ptr<probegl::Stats> { return this->context->stats; }
+
   // TODO(ilija@unfolded.ai): These should be get-only?
   std::shared_ptr<lumagl::AnimationLoop> animationLoop;
   std::shared_ptr<ViewManager> viewManager{new ViewManager()};
@@ -107,10 +123,37 @@ class Deck : public Component {
   void _redraw(wgpu::RenderPassEncoder pass, std::function<void(Deck*)> onAfterRender, bool force = false);
   void _drawLayers(wgpu::RenderPassEncoder pass, std::function<void(Deck*)> onAfterRender,
                    const std::string& redrawReason);
+  void _drawPickingLayers();
+  void _setViewportUniforms(const std::shared_ptr<Viewport>& viewport, const std::shared_ptr<Layer>& layer);
+  auto _readPickingPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t bytesPerRow)
+      -> std::vector<uint8_t>;
 
   std::optional<std::string> _needsRedraw;
+  /// Timer of redraws, resolved once the context is created
+  probegl::Stat* _redrawTime{nullptr};
   wgpu::Buffer _viewportUniformsBuffer;
   lumagl::Size _size;
+
+  lumagl::utils::BasicRenderPass _pickingPass;
+  /// Layers drawn into the picking buffer, in the order of their picking layer indices
+  std::vector<std::shared_ptr<Layer>> _pickingLayers;
+  /// Viewports the picking buffer was last drawn for, which get rebuilt whenever views, view state or size change
+  std::list<std::shared_ptr<Viewport>> _pickingViewports;
+  /// Picking uniforms for each picking layer index, and the ones that disable picking during regular draws
+  std::vector<wgpu::Buffer> _pickingUniformsBuffers;
+  wgpu::Buffer _pickingDisabledUniformsBuffer;
+};
+
+/// \brief Information about an object found by Deck::pickObject.
+class Deck::PickInfo {
+ public:
+  /// \brief Layer the object belongs to.
+  std::shared_ptr<Layer> layer;
+  /// \brief Index of the data row the object was created from.
+  int64_t index;
+  /// \brief Position that was picked, in pixels from the top left corner of the viewport.
+  int x;
+  int y;
 };
 
 // Instead of maintaining another structure with options, we reuse the relevant struct from lumagl
@@ -23,8 +23,10 @@
 
 #include <memory>
 
+#include "deck.gl/core/src/arrow/recycling-memory-pool.h"
 #include "deck.gl/core/src/viewports/web-mercator-viewport.h"
 #include "luma.gl/webgpu.h"
+#include "probe.gl/core.h"
 
 namespace deckgl {
 
@@ -44,6 +46,14 @@ class LayerContext {
   std::shared_ptr<LayerManager> layerManager;
   // Make sure context.viewport is not empty on the first layer initialization
   std::shared_ptr<Viewport> viewport{new WebMercatorViewport{{}}};
+  /// \brief Stats that layers record their updates and draws into.
+  std::shared_ptr<probegl::Stats> stats{std::make_shared<probegl::Stats>("deck.gl")};
+  /// \brief Whether each layer records the time spent drawing it into a separate stat, named after the layer id.
+  /// \note Draw times measure encoding of draw commands on the CPU, as the Dawn version we build against doesn't
+  /// support timestamp queries yet.
+  bool recordLayerDrawTimes{false};
+  /// \brief Pool that layers allocate mapped attributes and processed data from.
+  RecyclingMemoryPool* memoryPool{defaultMemoryPool()};
 
   LayerContext(Deck* deck, wgpu::Device device, float devicePixelRatio = 1.0)
       : deck{deck}, device{device}, devicePixelRatio{devicePixelRatio} {}
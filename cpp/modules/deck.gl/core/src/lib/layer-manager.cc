@@ -30,12 +30,23 @@ LayerManager::LayerManager(std::shared_ptr<LayerContext> _context) : context{_co
   this->_needsRedraw = "Initial render";
   this->_needsUpdate = std::nullopt;
   this->_debug = false;
+
+  if (this->context) {
+    auto &stats = *this->context->stats;
+    this->_gpuMemory = &stats.get("GPU Memory", probegl::Stat::Type::GAUGE);
+    this->_cpuMemory = &stats.get("CPU Memory", probegl::Stat::Type::GAUGE);
+    this->_poolBytesAllocated = &stats.get("Memory Pool Bytes Allocated", probegl::Stat::Type::GAUGE);
+    this->_poolPeakBytes = &stats.get("Memory Pool Peak Bytes", probegl::Stat::Type::GAUGE);
+    this->_poolRetainedBytes = &stats.get("Memory Pool Retained Bytes", probegl::Stat::Type::GAUGE);
+    this->_poolAllocations = &stats.get("Memory Pool Allocations", probegl::Stat::Type::GAUGE);
+    this->_poolReusedAllocations = &stats.get("Memory Pool Reused Allocations", probegl::Stat::Type::GAUGE);
+  }
 }
 
 LayerManager::~LayerManager() {
   // Finalize all layers
   for (auto layer : this->_layers) {
-    layer->finalize();
+    this->_finalizeLayer(layer);
   }
 }
 
@@ -59,19 +70,31 @@ auto LayerManager::needsRedraw(bool clearRedrawFlags) -> std::optional<std::stri
   return std::nullopt;
 }
 
+auto LayerManager::pickingNeedsRedraw(bool clearRedrawFlags) -> bool {
+  auto redraw = this->_pickingNeedsRedraw;
+  if (clearRedrawFlags) {
+    this->_pickingNeedsRedraw = false;
+  }
+  return redraw;
+}
+
 void LayerManager::setNeedsRedraw(const std::string &reason) {
-  if (this->_needsRedraw) {
+  this->_pickingNeedsRedraw = true;
+  if (!this->_needsRedraw) {
     this->_needsRedraw = reason;
   }
 }
 
 void LayerManager::setNeedsUpdate(const std::string &reason) {
+  this->_pickingNeedsRedraw = true;
   if (!this->_needsUpdate) {
     this->_needsUpdate = reason;
   }
 }
 
 void LayerManager::setLayersFromProps(const std::list<std::shared_ptr<Layer::Props>> &layerPropsList) {
+  this->_pickingNeedsRedraw = true;
+
   // Create a map of old layers
   std::map<std::string, std::shared_ptr<Layer>> oldLayerMap;
   for (auto oldLayer : this->_layers) {
@@ -115,23 +138,48 @@ void LayerManager::addLayer(const std::shared_ptr<Layer> &layer) {
   layer->initialize(this->context);
 
   this->_layers.push_back(layer);
+  this->_memoryUsageNeedsUpdate = true;
+  this->_pickingNeedsRedraw = true;
 }
 
 void LayerManager::removeLayer(const std::shared_ptr<Layer> &layer) {
-  this->_layers.remove_if([layer](auto layer_) { return layer_ == layer; });
+  this->_layers.remove_if([this, layer](auto layer_) {
+    if (layer_ != layer) {
+      return false;
+    }
+    this->_finalizeLayer(layer_);
+    return true;
+  });
 }
 
 void LayerManager::removeLayer(const std::string &id) {
-  this->_layers.remove_if([id](auto layer) { return layer->props()->id == id; });
+  this->_layers.remove_if([this, id](auto layer) {
+    if (layer->props()->id != id) {
+      return false;
+    }
+    this->_finalizeLayer(layer);
+    return true;
+  });
 }
 
 void LayerManager::updateLayers() {
+  PROBEGL_TRACE_SCOPE("LayerManager::updateLayers");
   for (auto layer : this->_layers) {
     // TODO(ib@unfolded.ai): Handle exceptions
     layer->update();
   }
 }
 
+void LayerManager::updatePendingData() {
+  PROBEGL_TRACE_SCOPE("LayerManager::updatePendingData");
+  for (const auto &layer : this->_layers) {
+    if (layer->_receivePendingData()) {
+      this->_updateLayer(layer);
+      this->setNeedsRedraw("Data loaded");
+    }
+  }
+}
+
 void LayerManager::activateViewport(const std::shared_ptr<Viewport> &viewport) {
   auto oldViewport = this->context->viewport;
   auto viewportChanged = !oldViewport || oldViewport != viewport;
@@ -148,6 +196,92 @@ void LayerManager::activateViewport(const std::shared_ptr<Viewport> &viewport) {
   }
 }
 
+auto LayerManager::updateMemoryUsage() -> Layer::MemoryUsage {
+  // Caches keep being released for as long as the budget is exceeded, otherwise usage only changes along with layers
+  if (!this->_memoryUsageNeedsUpdate && !this->_gpuMemoryBudgetExceeded &&
+      this->gpuMemoryBudget == this->_checkedGpuMemoryBudget) {
+    return this->_memoryUsage;
+  }
+  this->_memoryUsageNeedsUpdate = false;
+  this->_checkedGpuMemoryBudget = this->gpuMemoryBudget;
+
+  Layer::MemoryUsage totalUsage;
+  for (const auto &layer : this->_layers) {
+    auto usage = layer->getMemoryUsage();
+    totalUsage.gpuBytes += usage.gpuBytes;
+    totalUsage.cpuBytes += usage.cpuBytes;
+
+    if (this->context) {
+      const auto &id = layer->props()->id;
+      auto stats = this->_layerMemoryStats.find(id);
+      if (stats == this->_layerMemoryStats.end()) {
+        LayerMemoryStats layerStats{this->context->stats->get("Layer GPU Memory " + id, probegl::Stat::Type::GAUGE),
+                                    this->context->stats->get("Layer CPU Memory " + id, probegl::Stat::Type::GAUGE)};
+        stats = this->_layerMemoryStats.emplace(id, layerStats).first;
+      }
+
+      stats->second.gpuMemory.set(usage.gpuBytes);
+      stats->second.cpuMemory.set(usage.cpuBytes);
+    }
+  }
+
+  if (this->context) {
+    this->_gpuMemory->set(totalUsage.gpuBytes);
+    this->_cpuMemory->set(totalUsage.cpuBytes);
+    this->_recordMemoryPoolUsage();
+  }
+  this->_memoryUsage = totalUsage;
+
+  auto budgetExceeded = this->gpuMemoryBudget && totalUsage.gpuBytes > this->gpuMemoryBudget.value();
+  if (budgetExceeded) {
+    // Warn once each time the budget gets exceeded, but keep evicting caches for as long as it is
+    if (!this->_gpuMemoryBudgetExceeded) {
+      probegl::WarningLog() << "Layers use " << totalUsage.gpuBytes << " bytes of GPU memory, exceeding the budget of "
+                            << this->gpuMemoryBudget.value() << " bytes";
+    }
+    for (const auto &layer : this->_layers) {
+      layer->releaseCaches();
+    }
+    if (this->context && this->context->memoryPool) {
+      this->context->memoryPool->releaseUnused();
+    }
+  }
+  this->_gpuMemoryBudgetExceeded = budgetExceeded;
+
+  return totalUsage;
+}
+
+void LayerManager::_recordMemoryPoolUsage() {
+  if (!this->context->memoryPool) {
+    return;
+  }
+
+  auto usage = this->context->memoryPool->usage();
+  this->_poolBytesAllocated->set(static_cast<uint64_t>(usage.bytesAllocated));
+  this->_poolPeakBytes->set(static_cast<uint64_t>(usage.peakBytes));
+  this->_poolRetainedBytes->set(static_cast<uint64_t>(usage.retainedBytes));
+  this->_poolAllocations->set(usage.allocationCount);
+  this->_poolReusedAllocations->set(usage.reuseCount);
+}
+
+void LayerManager::_finalizeLayer(const std::shared_ptr<Layer> &layer) {
+  layer->finalize();
+  this->_memoryUsageNeedsUpdate = true;
+  this->_pickingNeedsRedraw = true;
+
+  // Layers are matched by id when their props are set, so their id is the one their stats were created with
+  const auto &id = layer->props()->id;
+  auto stats = this->_layerMemoryStats.find(id);
+  if (stats != this->_layerMemoryStats.end()) {
+    this->_layerMemoryStats.erase(stats);
+    this->context->stats->remove("Layer GPU Memory " + id);
+    this->context->stats->remove("Layer CPU Memory " + id);
+  }
+  if (this->context) {
+    this->context->stats->remove("Layer Draw Time " + id);
+  }
+}
+
 void LayerManager::_updateLayer(const std::shared_ptr<Layer> &layer) {
   try {
     layer->update();
@@ -43,6 +43,12 @@ class LayerManager {
   /// \return Returns a reason for redraw, if one exists.
   auto needsRedraw(bool clearRedrawFlags = false) -> std::optional<std::string>;
 
+  /// \brief Check if the picking buffer needs to be redrawn, because layers were added, removed or updated, or
+  /// a redraw was requested since it was last drawn. Viewport changes are left to the caller, which knows which
+  /// viewports the picking buffer was drawn for.
+  /// \param clearRedrawFlags Whether or not to clear the picking redraw flag.
+  auto pickingNeedsRedraw(bool clearRedrawFlags = false) -> bool;
+
   /// \brief Check if a deep update of layers is needed.
   /// \return Returns a reason for update, if one exists.
   auto needsUpdate() -> std::optional<std::string> { return this->_needsUpdate; };
@@ -67,11 +73,13 @@ class LayerManager {
   /// \param layer Layer to add.
   void addLayer(const std::shared_ptr<Layer>& layer);
 
-  /// \brief Removes the given layer from this manager, if it's been added previously.
+  /// \brief Removes the given layer from this manager, if it's been added previously. Removed layers are finalized,
+  /// which cancels loading of their pending data.
   /// \param layer Layer to remove.
   void removeLayer(const std::shared_ptr<Layer>& layer);
 
-  /// \brief Removes the given layer from this manager, if it's been added previously.
+  /// \brief Removes the given layer from this manager, if it's been added previously. Removed layers are finalized,
+  /// which cancels loading of their pending data.
   /// \param id Identifier of the layer to remove.
   void removeLayer(const std::string& id);
 
@@ -81,22 +89,67 @@ class LayerManager {
   /// \brief Update layers from last cycle if `setNeedsUpdate()` has been called.
   void updateLayers();
 
+  /// \brief Hands data that has finished loading in the background over to layers, see Layer::Props::pendingData.
+  /// Layers receiving data are updated right away, so this should be called on the render thread before drawing.
+  void updatePendingData();
+
   /// \brief Makes a viewport "current" in layer context, updating viewportChanged flags.
   /// \param viewport Viewport to activate.
   void activateViewport(const std::shared_ptr<Viewport>& viewport);
 
+  /// \brief Records memory retained by each layer, by all the layers combined, and allocation statistics of the
+  /// context memory pool into context stats.
+  /// Memory usage is only recomputed after layers have been added, removed or updated, see setNeedsMemoryUsageUpdate.
+  /// If gpuMemoryBudget is exceeded, a warning is logged, layers are asked to release their caches and unused memory
+  /// of the context memory pool is released, until usage is back within the budget.
+  /// \return Combined memory usage of all the managed layers.
+  auto updateMemoryUsage() -> Layer::MemoryUsage;
+
+  /// \brief Makes the next updateMemoryUsage() call recompute memory usage, for layers that upload data outside of
+  /// their updates.
+  void setNeedsMemoryUsageUpdate() { this->_memoryUsageNeedsUpdate = true; }
+
   std::shared_ptr<LayerContext> context;
+  /// \brief Optional limit on GPU memory retained by all the layers combined, in bytes.
+  std::optional<uint64_t> gpuMemoryBudget;
 
  private:
   /// \brief Updates a single layer, cleaning all flags.
   void _updateLayer(const std::shared_ptr<Layer>& layer);
+  /// \brief Finalizes a layer that is being removed, and removes its memory gauges and draw time from context stats.
+  void _finalizeLayer(const std::shared_ptr<Layer>& layer);
+  /// \brief Records allocation statistics of the context memory pool.
+  void _recordMemoryPoolUsage();
 
   /// A list of layers currently being managed.
   std::list<std::shared_ptr<Layer>> _layers;
 
   std::optional<std::string> _needsRedraw;
   std::optional<std::string> _needsUpdate;
+  bool _pickingNeedsRedraw{true};
   bool _debug;
+
+  /// \brief Memory gauges of a single layer.
+  struct LayerMemoryStats {
+    probegl::Stat& gpuMemory;
+    probegl::Stat& cpuMemory;
+  };
+
+  /// Gauges of layers whose memory usage has been recorded, by layer id
+  std::map<std::string, LayerMemoryStats> _layerMemoryStats;
+  bool _memoryUsageNeedsUpdate{true};
+  /// Memory usage and budget as of the last time memory usage was recomputed
+  Layer::MemoryUsage _memoryUsage;
+  std::optional<uint64_t> _checkedGpuMemoryBudget;
+  /// Stats that are recorded whenever memory usage is updated, resolved once as looking them up takes a lock
+  probegl::Stat* _gpuMemory{nullptr};
+  probegl::Stat* _cpuMemory{nullptr};
+  probegl::Stat* _poolBytesAllocated{nullptr};
+  probegl::Stat* _poolPeakBytes{nullptr};
+  probegl::Stat* _poolRetainedBytes{nullptr};
+  probegl::Stat* _poolAllocations{nullptr};
+  probegl::Stat* _poolReusedAllocations{nullptr};
+  bool _gpuMemoryBudgetExceeded{false};
 };
 
 }  // namespace deckgl
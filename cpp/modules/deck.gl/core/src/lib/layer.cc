@@ -20,7 +20,11 @@
 
 #include "./layer.h"  // NOLINT(build/include)
 
+#include <algorithm>
+#include <functional>
+
 #include "./layer-manager.h"
+#include "deck.gl/core/src/arrow/arrow-utils.h"
 
 using namespace mathgl;
 using namespace deckgl;
@@ -34,6 +38,9 @@ static const std::vector<std::shared_ptr<Property>> propTypeDefs = {
     std::make_shared<PropertyT<float>>(
         "opacity", [](const JSONObject* props) { return dynamic_cast<const Layer::Props*>(props)->opacity; },
         [](JSONObject* props, float value) { return dynamic_cast<Layer::Props*>(props)->opacity = value; }, 1.0),
+    std::make_shared<PropertyT<bool>>(
+        "pickable", [](const JSONObject* props) { return dynamic_cast<const Layer::Props*>(props)->pickable; },
+        [](JSONObject* props, bool value) { return dynamic_cast<Layer::Props*>(props)->pickable = value; }, false),
     std::make_shared<PropertyT<COORDINATE_SYSTEM>>(
         "coordinateSystem",
         [](const JSONObject* props) { return dynamic_cast<const Layer::Props*>(props)->coordinateSystem; },
@@ -74,11 +81,42 @@ auto Layer::Props::getProperties() const -> const std::shared_ptr<Properties> {
 }
 
 void Layer::setProps(std::shared_ptr<Layer::Props> newProps) {
+  auto props = std::dynamic_pointer_cast<Layer::Props>(this->_props);
+  if (props->pendingData && props->pendingData != newProps->pendingData) {
+    props->pendingData->cancel();
+  }
+  // Previous data stays on screen while new data is loading
+  if (newProps->pendingData && !newProps->data) {
+    newProps->data = props->data;
+  }
+  // Draw times are recorded under the layer id
+  if (newProps->id != props->id) {
+    this->_drawTime = nullptr;
+  }
+
   this->_props = newProps;
   this->setNeedsUpdate("Props updated");
   this->setNeedsRedraw("Props updated");
 }
 
+void Layer::appendData(const std::shared_ptr<arrow::RecordBatch>& batch) {
+  auto props = std::dynamic_pointer_cast<Layer::Props>(this->_props);
+  auto startRow = props->data ? props->data->num_rows() : 0;
+  props->data = appendRecordBatch(props->data, batch);
+  if (!this->_stateInitialized) {
+    // Data is uploaded in full when the layer is initialized
+    return;
+  }
+
+  // Consecutive appends are uploaded together, other data changes require data to be processed again
+  auto appendStartRow = this->_changeFlags.dataChanged ? this->_changeFlags.dataAppendStartRow : startRow;
+  this->setDataChangedFlag("Data appended");
+  this->_changeFlags.dataAppendStartRow = appendStartRow;
+
+  this->setNeedsUpdate("Data appended");
+  this->setNeedsRedraw("Data appended");
+}
+
 void Layer::triggerUpdate(const std::string& attributeName) {
   this->_attributeManager->invalidate(attributeName);
   this->setNeedsUpdate(attributeName);
@@ -133,6 +171,18 @@ void Layer::updateState(const Layer::ChangeFlags& changeFlags, const std::shared
 
 void Layer::finalizeState() {}
 
+auto Layer::getMemoryUsage() const -> MemoryUsage {
+  MemoryUsage memoryUsage;
+  for (const auto& model : this->_models) {
+    memoryUsage.gpuBytes += model->bufferByteLength();
+  }
+  if (this->_attributeManager) {
+    memoryUsage.cpuBytes += this->_attributeManager->byteLength();
+  }
+
+  return memoryUsage;
+}
+
 void Layer::drawState(wgpu::RenderPassEncoder pass) {
   for (auto model : this->models()) {
     model->draw(pass);
@@ -140,9 +190,51 @@ void Layer::drawState(wgpu::RenderPassEncoder pass) {
 }
 
 void Layer::draw(wgpu::RenderPassEncoder pass) {
+  if (!this->_stateInitialized) {
+    return;
+  }
+
+  PROBEGL_TRACE_SCOPE("Layer::draw", this->props()->id);
+  if (this->context->recordLayerDrawTimes && !this->_drawTime) {
+    this->_drawTime = &this->context->stats->get("Layer Draw Time " + this->props()->id, probegl::Stat::Type::TIMER);
+  }
+  probegl::ScopedStatTimer drawTimer{this->context->recordLayerDrawTimes ? this->_drawTime : nullptr};
+
+  uint64_t drawCallCount = 0;
+  uint64_t drawnInstanceCount = 0;
+  for (auto const& model : this->models()) {
+    drawCallCount -= model->drawCallCount();
+    drawnInstanceCount -= model->drawnInstanceCount();
+  }
+
   // Call subclass lifecycle method
   this->drawState(pass);
   // End lifecycle method
+
+  for (auto const& model : this->models()) {
+    drawCallCount += model->drawCallCount();
+    drawnInstanceCount += model->drawnInstanceCount();
+  }
+  this->_drawCalls->increment(drawCallCount);
+  this->_instancesDrawn->increment(drawnInstanceCount);
+}
+
+void Layer::drawPicking(wgpu::RenderPassEncoder pass) {
+  if (!this->_stateInitialized) {
+    return;
+  }
+
+  PROBEGL_TRACE_SCOPE("Layer::drawPicking", this->props()->id);
+  for (auto const& model : this->models()) {
+    model->setPicking(true);
+  }
+
+  // Draw stats only describe what ends up on screen, so the picking pass skips them and calls drawState directly
+  this->drawState(pass);
+
+  for (auto const& model : this->models()) {
+    model->setPicking(false);
+  }
 }
 
 void Layer::_invalidateAttribute(const std::string& name, const std::string& diffReason) {
@@ -181,23 +273,95 @@ void Layer::_updateAttributes() {
   */
 }
 
-void Layer::initialize(const std::shared_ptr<LayerContext>& context) {
-  this->context = context;
-  this->_attributeManager = std::make_shared<AttributeManager>(this->props()->id, context->device);
+auto Layer::_cullInstances(const SpatialIndex& spatialIndex, double paddingPixels, size_t maxRanges)
+    -> std::vector<lumagl::InstanceRange> {
+  auto bounds = this->context->viewport->getBounds(paddingPixels);
+  auto visibleRows = spatialIndex.search(bounds[0], bounds[1], bounds[2], bounds[3]);
+  this->_drawnInstanceCount = 0;
+  if (visibleRows.empty()) {
+    return {};
+  }
 
-  // Call subclass lifecycle method
-  this->initializeState();
-  // End subclass lifecycle method
+  // Keep the original data order, so that overlapping instances are drawn consistently
+  std::sort(visibleRows.begin(), visibleRows.end());
 
-  auto reason = "Layer initialization";
-  this->setDataChangedFlag(reason);
-  this->setPropsChangedFlag(reason);
-  this->setViewportChangedFlag(reason);
+  // Only the largest maxRanges - 1 gaps between visible rows split ranges, instances in smaller gaps are drawn anyway
+  std::vector<uint32_t> gaps;
+  for (size_t i = 1; i < visibleRows.size(); ++i) {
+    if (visibleRows[i] - visibleRows[i - 1] > 1) {
+      gaps.push_back(visibleRows[i] - visibleRows[i - 1] - 1);
+    }
+  }
+  uint32_t minSplitGap = 1;
+  auto maxSplits = std::max(maxRanges, static_cast<size_t>(1)) - 1;
+  if (gaps.size() > maxSplits) {
+    std::nth_element(gaps.begin(), gaps.begin() + maxSplits, gaps.end(), std::greater<uint32_t>());
+    minSplitGap = gaps[maxSplits] + 1;
+  }
 
+  std::vector<lumagl::InstanceRange> ranges{{visibleRows[0], 1}};
+  for (size_t i = 1; i < visibleRows.size(); ++i) {
+    auto& range = ranges.back();
+    auto rangeEnd = range.firstInstance + range.instanceCount;
+    if (visibleRows[i] - rangeEnd >= minSplitGap) {
+      this->_drawnInstanceCount += range.instanceCount;
+      ranges.emplace_back(visibleRows[i], 1);
+    } else {
+      range.instanceCount = visibleRows[i] + 1 - range.firstInstance;
+    }
+  }
+  this->_drawnInstanceCount += ranges.back().instanceCount;
+
+  return ranges;
+}
+
+auto Layer::_cullChunks(double paddingPixels) -> std::vector<lumagl::InstanceRange> {
+  auto bounds = this->context->viewport->getBounds(paddingPixels);
+
+  std::vector<lumagl::InstanceRange> ranges;
+  this->_drawnInstanceCount = 0;
+  for (auto const& chunk : this->_attributeManager->chunks()) {
+    auto visible = !(bounds[2] < chunk.bounds[0] || bounds[3] < chunk.bounds[1] || bounds[0] > chunk.bounds[2] ||
+                     bounds[1] > chunk.bounds[3]);
+    if (!visible) {
+      continue;
+    }
+
+    if (!ranges.empty() && ranges.back().firstInstance + ranges.back().instanceCount == chunk.firstInstance) {
+      ranges.back().instanceCount += chunk.instanceCount;
+    } else {
+      ranges.emplace_back(chunk.firstInstance, chunk.instanceCount);
+    }
+    this->_drawnInstanceCount += chunk.instanceCount;
+  }
+
+  return ranges;
+}
+
+void Layer::initialize(const std::shared_ptr<LayerContext>& context) {
+  this->context = context;
+  this->_drawCalls = &context->stats->get("Draw Calls");
+  this->_instancesDrawn = &context->stats->get("Instances Drawn");
+  this->_updateTime = &context->stats->get("Layer Update Time", probegl::Stat::Type::TIMER);
+  this->_updates = &context->stats->get("Layer Updates");
+  this->_attributeManager =
+      std::make_shared<AttributeManager>(this->props()->id, context->device, context->stats, context->memoryPool);
+
+  // Layers without any data to show wait for their data to load
+  auto props = this->props();
+  if (!props->data && props->pendingData) {
+    return;
+  }
+
+  this->_initializeState();
   this->_updateState();
 }
 
 void Layer::update() {
+  if (!this->_stateInitialized) {
+    return;
+  }
+
   // Call subclass lifecycle method
   auto stateNeedsUpdate = this->getNeedsUpdate();
   // End lifecycle method
@@ -207,8 +371,60 @@ void Layer::update() {
   }
 }
 
+auto Layer::_receivePendingData() -> bool {
+  auto props = std::dynamic_pointer_cast<Layer::Props>(this->_props);
+  if (props->pendingData && props->pendingData->isReady()) {
+    // Handles are only received once
+    auto pendingData = std::move(props->pendingData);
+    try {
+      // Props can be set again with a handle that has already been received
+      auto data = pendingData->get();
+      auto dataChanged = data != props->data;
+
+      // Data of the current props is replaced, like appended data
+      props->data = data;
+      if (dataChanged && this->_stateInitialized) {
+        this->setDataChangedFlag("Data loaded");
+        this->setNeedsUpdate("Data loaded");
+        this->setNeedsRedraw("Data loaded");
+        return true;
+      }
+    } catch (const std::exception& ex) {
+      probegl::ErrorLog() << "Loading data of layer " << props->id << " failed with: " << ex.what();
+    }
+  }
+
+  // Layers that were waiting for data are initialized once they've got some, loaded or set through props
+  if (!this->_stateInitialized && props->data) {
+    this->_initializeState();
+    this->setNeedsRedraw("Data loaded");
+    return true;
+  }
+
+  return false;
+}
+
+void Layer::_initializeState() {
+  this->_attributeManager->setBinaryAttributes(this->props()->attributes);
+
+  // Call subclass lifecycle method
+  this->initializeState();
+  // End subclass lifecycle method
+  this->_stateInitialized = true;
+
+  auto reason = "Layer initialization";
+  this->setDataChangedFlag(reason);
+  this->setPropsChangedFlag(reason);
+  this->setViewportChangedFlag(reason);
+}
+
 // Common code for _initialize and _update
 void Layer::_updateState() {
+  PROBEGL_TRACE_SCOPE("Layer::update", this->props()->id);
+  probegl::ScopedStatTimer updateTimer{this->_updateTime};
+  this->_updates->increment();
+  this->_attributeManager->setBinaryAttributes(this->props()->attributes);
+
   // Safely call subclass lifecycle methods
   // if (!this->context->gl) {
   //   return;
@@ -217,6 +433,11 @@ void Layer::_updateState() {
   this->updateState(this->_changeFlags, this->oldProps);
   // End subclass lifecycle methods
 
+  // Attributes are only uploaded again when data or props change
+  if (this->_changeFlags.propsOrDataChanged && this->context->layerManager) {
+    this->context->layerManager->setNeedsMemoryUsageUpdate();
+  }
+
   // if (this->isComposite) {
   //   // Render or update previously rendered sublayers
   //   this->_renderLayers();
@@ -237,10 +458,17 @@ void Layer::_updateState() {
 // Note: not guaranteed to be called on application shutdown
 void Layer::finalize() {
   // debug(TRACE_FINALIZE, this);
+  if (auto pendingData = this->props()->pendingData) {
+    pendingData->cancel();
+  }
+  if (!this->_stateInitialized) {
+    return;
+  }
 
   // Call subclass lifecycle method
   this->finalizeState();
   // End subclass lifecycle method
+  this->_stateInitialized = false;
 }
 
 auto Layer::getChangeFlags() -> Layer::ChangeFlags { return this->_changeFlags; }
@@ -249,6 +477,7 @@ void Layer::setDataChangedFlag(const std::string& reason) {
   if (!this->_changeFlags.dataChanged) {
     this->_changeFlags.dataChanged = reason;
   }
+  this->_changeFlags.dataAppendStartRow = std::nullopt;
   this->_updateChangeFlags();
 }
 
@@ -269,6 +498,7 @@ void Layer::setViewportChangedFlag(const std::string& reason) {
 void Layer::clearChangeFlags() {
   // Primary changeFlags, can be strings stating reason for change
   this->_changeFlags.dataChanged = std::nullopt;
+  this->_changeFlags.dataAppendStartRow = std::nullopt;
   this->_changeFlags.propsChanged = std::nullopt;
   this->_changeFlags.viewportChanged = std::nullopt;
 
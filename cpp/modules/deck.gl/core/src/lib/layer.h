@@ -33,6 +33,9 @@
 #include "./component.h"
 #include "./constants.h"
 #include "./layer-context.h"
+#include "./pending-data.h"
+#include "./picking-geometry.h"
+#include "./spatial-index.h"
 #include "attribute/attribute-manager.h"
 #include "deck.gl/json.h"
 #include "luma.gl/core.h"
@@ -59,6 +62,12 @@ class Layer : public Component {
   /// \brief Updates all the layer props.
   void setProps(std::shared_ptr<Layer::Props> newProps);
 
+  /// \brief Appends rows to the data of this layer, such as batches of a table that is still being loaded. Layers that
+  /// upload all of their data only map and upload the appended rows, others process their data again.
+  /// \note Data of the current props is replaced, props are not copied.
+  /// \param batch Rows to append, must have the same schema as data.
+  void appendData(const std::shared_ptr<arrow::RecordBatch>& batch);
+
   explicit Layer(std::shared_ptr<Layer::Props> props) : Component{std::dynamic_pointer_cast<Component::Props>(props)} {}
 
   /// \brief Invalidates the given attributeName, triggering a redraw.
@@ -96,6 +105,9 @@ class Layer : public Component {
   /// \brief Return an array of models used by this layer, can be overriden by layer.
   auto models() -> std::list<std::shared_ptr<lumagl::Model>> { return this->_models; };
 
+  /// \brief Returns the number of instances that were submitted for drawing the last time this layer was drawn.
+  auto drawnInstanceCount() const -> int64_t { return this->_drawnInstanceCount; }
+
   /// \brief Called once to set up the initial state: App can create WebGPU resources.
   virtual void initializeState();
 
@@ -115,6 +127,30 @@ class Layer : public Component {
 
   void draw(wgpu::RenderPassEncoder pass);
 
+  /// \brief Draws this layer into a picking buffer, with each instance encoded as a unique color.
+  /// \note Picking uniforms need to be bound by the caller, see picking.glsl.h.
+  void drawPicking(wgpu::RenderPassEncoder pass);
+
+  /// \brief Returns the geometry of objects drawn by this layer, used for picking objects on the CPU.
+  /// \return Picking geometry, or nullptr if this layer doesn't support CPU picking.
+  virtual auto getPickingGeometry() -> std::shared_ptr<PickingGeometry> { return nullptr; }
+
+  /// \brief Amount of memory retained by a layer.
+  struct MemoryUsage {
+    /// \brief Size of attribute, index and uniform buffers, in bytes.
+    uint64_t gpuBytes{0};
+    /// \brief Size of data retained on the CPU, such as processed Arrow tables and spatial indices, in bytes.
+    uint64_t cpuBytes{0};
+  };
+
+  /// \brief Returns the amount of memory retained by this layer. Default implementation accounts for buffers set on
+  /// models and data retained by the attribute manager, layers should add anything else they hold on to.
+  virtual auto getMemoryUsage() const -> MemoryUsage;
+
+  /// \brief Releases memory that can be recreated on demand, called when the layer manager's memory budget is
+  /// exceeded. Default implementation does nothing.
+  virtual void releaseCaches() {}
+
   const std::shared_ptr<Layer::Props> oldProps;
   std::shared_ptr<LayerContext> context;
 
@@ -122,14 +158,37 @@ class Layer : public Component {
   std::string needsUpdate;
 
  protected:
+  /// \brief Returns the pool that attribute data is allocated from. Layers that haven't been initialized yet, such as
+  /// layers whose accessors are called directly, use Arrow's default pool.
+  auto _memoryPool() const -> arrow::MemoryPool* {
+    return this->context ? this->context->memoryPool : arrow::default_memory_pool();
+  }
+
   /// \brief Default implementation of attribute invalidation, can be redefined.
   void _invalidateAttribute(const std::string& name = "all", const std::string& diffReason = "");
 
   /// \brief Calls attribute manager to update any WebGPU attributes.
   void _updateAttributes();
 
+  /// \brief Finds ranges of instances that can be visible in the current viewport, out of instances uploaded in data
+  /// order. Ranges are merged across the smallest gaps until there are at most maxRanges of them, so that a few
+  /// invisible instances are drawn in exchange for fewer draw calls.
+  /// \param spatialIndex Index over bounding boxes of all the instances, in unprojected coordinates.
+  /// \param paddingPixels Number of pixels to extend the viewport by, accounting for the size of instances on screen.
+  /// \param maxRanges Maximum number of ranges, and therefore draw calls, to return.
+  /// \return Instance ranges to draw, in data order.
+  auto _cullInstances(const SpatialIndex& spatialIndex, double paddingPixels, size_t maxRanges = 64)
+      -> std::vector<lumagl::InstanceRange>;
+
+  /// \brief Finds ranges of instances uploaded by AttributeManager::uploadSorted() whose chunks can be visible in the
+  /// current viewport.
+  /// \param paddingPixels Number of pixels to extend the viewport by, accounting for the size of instances on screen.
+  /// \return Instance ranges to draw, with adjacent visible chunks merged into a single range.
+  auto _cullChunks(double paddingPixels) -> std::vector<lumagl::InstanceRange>;
+
   std::shared_ptr<AttributeManager> _attributeManager;
   std::list<std::shared_ptr<lumagl::Model>> _models;
+  int64_t _drawnInstanceCount{0};
 
  private:
   // LAYER MANAGER API (Should only be called by the deck.gl LayerManager class)
@@ -145,7 +204,13 @@ class Layer : public Component {
   /// \note Not guaranteed to be called on application shutdown.
   void finalize();
 
+  /// \brief Replaces data with pending data once it has finished loading. Layers that were waiting for data are
+  /// initialized once they've got some, others have their data changed flag set.
+  /// \return Whether data has changed and the layer needs to be updated.
+  auto _receivePendingData() -> bool;
+
   // Helpers
+  void _initializeState();
   void _updateState();
 
  public:
@@ -157,6 +222,8 @@ class Layer : public Component {
     std::optional<std::string> propsChanged;
     std::optional<std::string> viewportChanged;
     std::optional<std::string> extensionsChanged;
+    /// Index of the first appended row, if data has only changed by having rows appended to it
+    std::optional<int64_t> dataAppendStartRow;
 
     // Derived changeFlags
     std::optional<std::string> propsOrDataChanged;
@@ -166,6 +233,7 @@ class Layer : public Component {
         : dataChanged{std::nullopt},
           propsChanged{std::nullopt},
           viewportChanged{std::nullopt},
+          dataAppendStartRow{std::nullopt},
 
           // Derived changeFlags
           propsOrDataChanged{std::nullopt},
@@ -174,6 +242,16 @@ class Layer : public Component {
 
  private:
   ChangeFlags _changeFlags;
+  /// Whether initializeState() has been called, which is deferred until data has been loaded
+  bool _stateInitialized{false};
+
+  /// Context stats recorded on every draw and update, resolved once the layer gets its context
+  probegl::Stat* _drawCalls{nullptr};
+  probegl::Stat* _instancesDrawn{nullptr};
+  probegl::Stat* _updateTime{nullptr};
+  probegl::Stat* _updates{nullptr};
+  /// Timer of this layer's draws, resolved on the first draw after the layer id changes
+  probegl::Stat* _drawTime{nullptr};
 };
 
 class Layer::Props : public Component::Props {
@@ -181,9 +259,19 @@ class Layer::Props : public Component::Props {
   using super = Component::Props;
 
   std::shared_ptr<arrow::Table> data;
+  /// \brief Data that is still being loaded, such as a table returned by loadersgl::CSVLoader::loadTableAsync and
+  /// wrapped with makePendingData. Until it's ready, the layer keeps drawing its previous data, or nothing if it hasn't
+  /// got any. Once it's ready, it replaces data on the render thread, see LayerManager::updatePendingData.
+  std::shared_ptr<PendingData> pendingData;
+  /// \brief Precomputed attribute values by attribute name, such as "instancePositions", uploaded as they are instead
+  /// of being mapped from data through accessors. Arrays need one value per data row, of the attribute's type or with
+  /// the same number of components, see lumagl::garrow::arrayFromBuffer for wrapping GPU-ready buffers.
+  /// \note Data still determines the number of instances, a table without columns works if all attributes are set.
+  std::map<std::string, std::shared_ptr<arrow::Array>> attributes;
 
   bool visible{true};
   float opacity{1.0};
+  bool pickable{false};
 
   COORDINATE_SYSTEM coordinateSystem{COORDINATE_SYSTEM::DEFAULT};
   mathgl::Vector3<double> coordinateOrigin;
@@ -193,6 +281,14 @@ class Layer::Props : public Component::Props {
   std::string positionFormat{"XYZ"};
   std::string colorFormat{"RGBA"};
 
+  /// \brief Returns the columns of data that this layer's accessors read, so that loaders can skip the others. See
+  /// loadersgl::LoaderOptions::includeColumns.
+  /// \param sample Sample of data that accessors are run on, such as the first batch of a table that is being loaded.
+  /// \return Names of accessed columns, or an empty list if the layer can't tell which columns it needs.
+  virtual auto getDataColumns(const std::shared_ptr<arrow::Table>& sample) const -> std::vector<std::string> {
+    return {};
+  }
+
   // Property Type Machinery
   static constexpr const char* getTypeName() { return "Layer"; }
   auto getProperties() const -> const std::shared_ptr<Properties> override;
@@ -0,0 +1,71 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_LIB_PENDING_DATA_H
+#define DECKGL_CORE_LIB_PENDING_DATA_H
+
+#include <arrow/table.h>
+
+#include <memory>
+#include <utility>
+
+namespace deckgl {
+
+/// \brief Table that is still being produced in the background, such as one that a loader is loading. Layers take
+/// it through Layer::Props::pendingData, without depending on whatever produces it.
+class PendingData {
+ public:
+  virtual ~PendingData() = default;
+
+  /// \brief Returns whether producing the table has finished, successfully or not. Never blocks.
+  virtual auto isReady() const -> bool = 0;
+
+  /// \brief Waits for the table to be produced.
+  /// \return Produced table. Throws the error that producing it failed with.
+  virtual auto get() const -> std::shared_ptr<arrow::Table> = 0;
+
+  /// \brief Asks for the table to no longer be produced, as it isn't going to be used.
+  virtual void cancel() = 0;
+};
+
+/// \brief Adapts a handle that has isReady(), get() and cancel() methods, such as loadersgl::LoadHandle.
+template <typename Handle>
+class PendingHandle : public PendingData {
+ public:
+  explicit PendingHandle(std::shared_ptr<Handle> handle) : _handle{std::move(handle)} {}
+
+  auto isReady() const -> bool override { return this->_handle->isReady(); }
+  auto get() const -> std::shared_ptr<arrow::Table> override { return this->_handle->get(); }
+  void cancel() override { this->_handle->cancel(); }
+
+ private:
+  std::shared_ptr<Handle> _handle;
+};
+
+/// \brief Wraps a handle to a table that is being loaded, such as one returned by loadersgl::CSVLoader::loadTableAsync,
+/// so that it can be set as Layer::Props::pendingData.
+template <typename Handle>
+auto makePendingData(std::shared_ptr<Handle> handle) -> std::shared_ptr<PendingData> {
+  return std::make_shared<PendingHandle<Handle>>(std::move(handle));
+}
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_LIB_PENDING_DATA_H
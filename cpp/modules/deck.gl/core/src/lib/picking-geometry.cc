@@ -0,0 +1,169 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./picking-geometry.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace deckgl;
+
+namespace {
+
+using Point = PickingGeometry::Point;
+using Box = PickingGeometry::Box;
+
+auto boxContains(const Box& box, const Point& p) -> bool {
+  return p[0] >= box[0] && p[0] <= box[2] && p[1] >= box[1] && p[1] <= box[3];
+}
+
+auto pointBoxDistance(const Point& p, const Box& box) -> double {
+  auto dx = std::max({box[0] - p[0], 0.0, p[0] - box[2]});
+  auto dy = std::max({box[1] - p[1], 0.0, p[1] - box[3]});
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+/// \brief Squared distance between point p and a segment defined by points a and b.
+auto squaredSegmentDistance(const Point& p, const Point& a, const Point& b) -> double {
+  auto x = a[0];
+  auto y = a[1];
+  auto dx = b[0] - x;
+  auto dy = b[1] - y;
+
+  if (dx != 0.0 || dy != 0.0) {
+    auto t = ((p[0] - x) * dx + (p[1] - y) * dy) / (dx * dx + dy * dy);
+    if (t > 1.0) {
+      x = b[0];
+      y = b[1];
+    } else if (t > 0.0) {
+      x += dx * t;
+      y += dy * t;
+    }
+  }
+
+  dx = p[0] - x;
+  dy = p[1] - y;
+  return dx * dx + dy * dy;
+}
+
+/// \brief Twice the signed area of triangle abc, positive if its vertices are in counter-clockwise order.
+auto orientation(const Point& a, const Point& b, const Point& c) -> double {
+  return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+/// \brief Checks whether segments ab and cd cross each other.
+auto segmentsIntersect(const Point& a, const Point& b, const Point& c, const Point& d) -> bool {
+  auto abc = orientation(a, b, c);
+  auto abd = orientation(a, b, d);
+  auto cda = orientation(c, d, a);
+  auto cdb = orientation(c, d, b);
+  return ((abc > 0 && abd < 0) || (abc < 0 && abd > 0)) && ((cda > 0 && cdb < 0) || (cda < 0 && cdb > 0));
+}
+
+auto triangleContains(const Point* triangle, const Point& p) -> bool {
+  auto d1 = orientation(triangle[0], triangle[1], p);
+  auto d2 = orientation(triangle[1], triangle[2], p);
+  auto d3 = orientation(triangle[2], triangle[0], p);
+  auto hasNegative = d1 < 0 || d2 < 0 || d3 < 0;
+  auto hasPositive = d1 > 0 || d2 > 0 || d3 > 0;
+  return !(hasNegative && hasPositive);
+}
+
+auto boxCorners(const Box& box) -> std::array<Point, 4> {
+  return {Point{box[0], box[1]}, Point{box[2], box[1]}, Point{box[2], box[3]}, Point{box[0], box[3]}};
+}
+
+auto segmentBoxDistance(const Point& a, const Point& b, const Box& box) -> double {
+  if (boxContains(box, a) || boxContains(box, b)) {
+    return 0.0;
+  }
+
+  auto corners = boxCorners(box);
+  for (size_t i = 0; i < corners.size(); ++i) {
+    if (segmentsIntersect(a, b, corners[i], corners[(i + 1) % corners.size()])) {
+      return 0.0;
+    }
+  }
+
+  // Segment lies completely outside of the box, so the closest points are either its endpoints or box corners
+  auto squaredDistance = std::numeric_limits<double>::infinity();
+  for (const auto& corner : corners) {
+    squaredDistance = std::min(squaredDistance, squaredSegmentDistance(corner, a, b));
+  }
+  return std::min({std::sqrt(squaredDistance), pointBoxDistance(a, box), pointBoxDistance(b, box)});
+}
+
+}  // anonymous namespace
+
+auto PickingGeometry::verticesPerShape(Type type) -> size_t {
+  switch (type) {
+    case Type::POINTS:
+      return 1;
+    case Type::SEGMENTS:
+      return 2;
+    case Type::TRIANGLES:
+      return 3;
+  }
+  return 1;
+}
+
+auto PickingGeometry::shapeBounds(size_t shape) const -> Box {
+  auto shapeVertices = this->shapeVertices(shape);
+  Box bounds{shapeVertices[0][0], shapeVertices[0][1], shapeVertices[0][0], shapeVertices[0][1]};
+  for (size_t i = 1; i < PickingGeometry::verticesPerShape(this->type); ++i) {
+    bounds[0] = std::min(bounds[0], shapeVertices[i][0]);
+    bounds[1] = std::min(bounds[1], shapeVertices[i][1]);
+    bounds[2] = std::max(bounds[2], shapeVertices[i][0]);
+    bounds[3] = std::max(bounds[3], shapeVertices[i][1]);
+  }
+  return bounds;
+}
+
+auto PickingGeometry::maxSize() const -> double {
+  auto maxSize = std::max_element(this->sizes.begin(), this->sizes.end());
+  return maxSize == this->sizes.end() ? 0.0 : *maxSize;
+}
+
+auto PickingGeometry::sizePixels(double size, double metersPerPixel) const -> double {
+  auto pixels = size * this->sizeScale / (this->sizeInPixels ? 1.0 : metersPerPixel);
+  return std::clamp(pixels, this->sizeMinPixels, std::max(this->sizeMinPixels, this->sizeMaxPixels));
+}
+
+auto PickingGeometry::distanceToBox(Type type, const Point* vertices, const Box& box) -> double {
+  switch (type) {
+    case Type::POINTS:
+      return pointBoxDistance(vertices[0], box);
+    case Type::SEGMENTS:
+      return segmentBoxDistance(vertices[0], vertices[1], box);
+    case Type::TRIANGLES: {
+      // Box is either partially inside the triangle, or the closest point lies on one of the triangle edges
+      for (const auto& corner : boxCorners(box)) {
+        if (triangleContains(vertices, corner)) {
+          return 0.0;
+        }
+      }
+      return std::min({segmentBoxDistance(vertices[0], vertices[1], box),
+                       segmentBoxDistance(vertices[1], vertices[2], box),
+                       segmentBoxDistance(vertices[2], vertices[0], box)});
+    }
+  }
+  return std::numeric_limits<double>::infinity();
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_LIB_PICKING_GEOMETRY_H
+#define DECKGL_CORE_LIB_PICKING_GEOMETRY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace deckgl {
+
+/// \brief Simplified geometry of the objects drawn by a layer, used for picking objects on the CPU.
+/// Each object is made up of one or more shapes of the same type, described by their vertices in unprojected
+/// coordinates and an optional size that extends the shape in all directions.
+class PickingGeometry {
+ public:
+  using Point = std::array<double, 2>;
+  /// \brief Axis aligned box, as [minX, minY, maxX, maxY].
+  using Box = std::array<double, 4>;
+
+  enum class Type { POINTS, SEGMENTS, TRIANGLES };
+
+  explicit PickingGeometry(Type type) : type{type} {}
+
+  /// \brief Returns the number of vertices that make up a single shape of the given type.
+  static auto verticesPerShape(Type type) -> size_t;
+
+  /// \brief Returns the number of shapes in this geometry.
+  auto shapeCount() const -> size_t { return this->vertices.size() / PickingGeometry::verticesPerShape(this->type); }
+
+  /// \brief Returns a pointer to the first vertex of a shape.
+  auto shapeVertices(size_t shape) const -> const Point* {
+    return this->vertices.data() + shape * PickingGeometry::verticesPerShape(this->type);
+  }
+
+  /// \brief Returns the index of the data row a shape was created from.
+  auto shapeRow(size_t shape) const -> uint32_t {
+    return this->rows.empty() ? static_cast<uint32_t>(shape) : this->rows[shape];
+  }
+
+  /// \brief Returns the bounding box of a shape's vertices, not accounting for its size.
+  auto shapeBounds(size_t shape) const -> Box;
+
+  /// \brief Returns the size of the largest shape, before any scaling is applied.
+  auto maxSize() const -> double;
+
+  /// \brief Converts a shape size to pixels, the same way the layer's shaders do.
+  /// \param size Shape size, as stored in sizes.
+  /// \param metersPerPixel Number of meters a single pixel covers in the viewport objects are being picked in.
+  auto sizePixels(double size, double metersPerPixel) const -> double;
+
+  /// \brief Calculates the distance between a shape and a box.
+  /// \param type Type of the shape.
+  /// \param vertices Shape vertices, verticesPerShape(type) of them.
+  /// \param box Box to measure the distance to. Boxes with no extent are treated as points.
+  /// \return Distance between the closest points of the shape and the box, 0 if they overlap.
+  static auto distanceToBox(Type type, const Point* vertices, const Box& box) -> double;
+
+  Type type;
+  /// \brief Shape vertices, laid out consecutively shape by shape.
+  std::vector<Point> vertices;
+  /// \brief Distance each shape extends by in all directions, i.e. point radius or half of the line width.
+  /// Shapes have no size if empty.
+  std::vector<float> sizes;
+  /// \brief Index of the data row each shape was created from. Shapes map to rows one to one if empty.
+  std::vector<uint32_t> rows;
+
+  /// \brief Multiplier applied to all the sizes.
+  double sizeScale{1.0};
+  /// \brief Whether sizes are specified in pixels, or in meters otherwise.
+  bool sizeInPixels{false};
+  /// \brief Range scaled sizes are clamped to, in pixels.
+  double sizeMinPixels{0.0};
+  double sizeMaxPixels{std::numeric_limits<double>::max()};
+};
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_LIB_PICKING_GEOMETRY_H
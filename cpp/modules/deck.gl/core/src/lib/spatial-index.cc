@@ -0,0 +1,293 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./spatial-index.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+using namespace deckgl;
+
+namespace {
+
+auto intersects(const SpatialIndex::Box& box, float minX, float minY, float maxX, float maxY) -> bool {
+  return !(maxX < box[0] || maxY < box[1] || minX > box[2] || minY > box[3]);
+}
+
+/// Indexes with fewer items per thread than this are sorted on the calling thread only
+constexpr size_t kMinItemsPerThread = 1 << 16;
+
+/// \brief Splits [0, count) into contiguous slices, and processes them concurrently when there are enough items.
+/// \return Offsets at which the slices start, followed by count.
+template <typename Function>
+auto parallelSlices(size_t count, Function&& function) -> std::vector<size_t> {
+  auto threads = std::clamp(count / kMinItemsPerThread, static_cast<size_t>(1),
+                            static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)));
+  auto sliceSize = (count + threads - 1) / threads;
+
+  std::vector<size_t> offsets;
+  std::vector<std::future<void>> slices;
+  for (size_t begin = 0; begin < count; begin += sliceSize) {
+    offsets.push_back(begin);
+    slices.push_back(std::async(threads > 1 ? std::launch::async : std::launch::deferred, function, begin,
+                                std::min(begin + sliceSize, count)));
+  }
+  for (auto& slice : slices) {
+    slice.get();
+  }
+
+  offsets.push_back(count);
+  return offsets;
+}
+
+}  // anonymous namespace
+
+SpatialIndex::SpatialIndex(size_t numItems, size_t nodeSize)
+    : _numItems{numItems}, _nodeSize{std::max(nodeSize, static_cast<size_t>(2))} {
+  if (numItems > std::numeric_limits<uint32_t>::max()) {
+    throw std::logic_error("Too many items for a spatial index");
+  }
+
+  // Calculate the total number of nodes in the tree, and where each level ends
+  auto levelSize = numItems;
+  auto numNodes = numItems;
+  this->_levelBounds.push_back(numNodes);
+  while (levelSize > 1) {
+    levelSize = (levelSize + this->_nodeSize - 1) / this->_nodeSize;
+    numNodes += levelSize;
+    this->_levelBounds.push_back(numNodes);
+  }
+
+  this->_boxes.resize(numNodes);
+  this->_indices.resize(numNodes);
+
+  auto infinity = std::numeric_limits<float>::infinity();
+  this->_bounds = {infinity, infinity, -infinity, -infinity};
+}
+
+auto SpatialIndex::add(double minX, double minY, double maxX, double maxY) -> uint32_t {
+  if (this->_position >= this->_numItems) {
+    throw std::logic_error("Added more items than the spatial index was created for");
+  }
+
+  auto index = static_cast<uint32_t>(this->_position);
+  Box box{static_cast<float>(minX), static_cast<float>(minY), static_cast<float>(maxX), static_cast<float>(maxY)};
+  this->_indices[index] = index;
+  this->_boxes[index] = box;
+  this->_position++;
+
+  this->_bounds[0] = std::min(this->_bounds[0], box[0]);
+  this->_bounds[1] = std::min(this->_bounds[1], box[1]);
+  this->_bounds[2] = std::max(this->_bounds[2], box[2]);
+  this->_bounds[3] = std::max(this->_bounds[3], box[3]);
+
+  return index;
+}
+
+void SpatialIndex::finish() {
+  if (this->_position != this->_numItems) {
+    throw std::logic_error("Added fewer items than the spatial index was created for");
+  }
+
+  if (this->_numItems == 0) {
+    return;
+  }
+
+  // Map item centers onto a 16-bit Hilbert curve spanning the bounds of all the items
+  CurveGrid grid{this->_bounds};
+
+  // Sort keys hold Hilbert values in the upper and item indices in the lower half, so items sort by their values
+  std::vector<uint64_t> keys(this->_numItems);
+  auto slices = parallelSlices(this->_numItems, [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      keys[i] = static_cast<uint64_t>(grid.hilbert(this->_boxes[i])) << 32 | i;
+    }
+    std::sort(keys.begin() + begin, keys.begin() + end);
+  });
+
+  // Merge sorted slices pairwise until a single one is left
+  while (slices.size() > 2) {
+    std::vector<std::future<void>> merges;
+    std::vector<size_t> merged;
+    for (size_t i = 0; i + 1 < slices.size(); i += 2) {
+      merged.push_back(slices[i]);
+      if (i + 2 < slices.size()) {
+        auto first = keys.begin() + slices[i];
+        auto middle = keys.begin() + slices[i + 1];
+        auto last = keys.begin() + slices[i + 2];
+        merges.push_back(std::async(std::launch::async, [=]() { std::inplace_merge(first, middle, last); }));
+      }
+    }
+    for (auto& merge : merges) {
+      merge.get();
+    }
+    merged.push_back(slices.back());
+    slices = merged;
+  }
+
+  // Sort items by their Hilbert values, so that nearby items end up in the same nodes
+  std::vector<Box> sortedBoxes(this->_numItems);
+  parallelSlices(this->_numItems, [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto index = static_cast<uint32_t>(keys[i]);
+      sortedBoxes[i] = this->_boxes[index];
+      this->_indices[i] = index;
+    }
+  });
+  std::copy(sortedBoxes.begin(), sortedBoxes.end(), this->_boxes.begin());
+
+  // Generate parent nodes level by level, each one bounding up to nodeSize consecutive children
+  size_t node = 0;
+  for (size_t level = 0; level < this->_levelBounds.size() - 1; ++level) {
+    auto end = this->_levelBounds[level];
+    while (node < end) {
+      auto firstChild = node;
+      auto infinity = std::numeric_limits<float>::infinity();
+      Box parent{infinity, infinity, -infinity, -infinity};
+      for (size_t i = 0; i < this->_nodeSize && node < end; ++i, ++node) {
+        const auto& box = this->_boxes[node];
+        parent[0] = std::min(parent[0], box[0]);
+        parent[1] = std::min(parent[1], box[1]);
+        parent[2] = std::max(parent[2], box[2]);
+        parent[3] = std::max(parent[3], box[3]);
+      }
+
+      this->_indices[this->_position] = static_cast<uint32_t>(firstChild);
+      this->_boxes[this->_position] = parent;
+      this->_position++;
+    }
+  }
+}
+
+auto SpatialIndex::search(double minX, double minY, double maxX, double maxY) const -> std::vector<uint32_t> {
+  if (this->_position != this->_boxes.size()) {
+    throw std::logic_error("Spatial index has to be finished before it can be searched");
+  }
+
+  std::vector<uint32_t> results;
+  if (this->_numItems == 0) {
+    return results;
+  }
+
+  auto queryMinX = static_cast<float>(minX);
+  auto queryMinY = static_cast<float>(minY);
+  auto queryMaxX = static_cast<float>(maxX);
+  auto queryMaxY = static_cast<float>(maxY);
+
+  // Start at the root node, which is always the last one
+  std::vector<size_t> queue{this->_boxes.size() - 1};
+  while (!queue.empty()) {
+    auto node = queue.back();
+    queue.pop_back();
+
+    // Children of a node are laid out consecutively, up until the end of the level they're in
+    auto levelEnd = *std::upper_bound(this->_levelBounds.begin(), this->_levelBounds.end(), node);
+    auto end = std::min(node + this->_nodeSize, levelEnd);
+    for (auto position = node; position < end; ++position) {
+      if (!intersects(this->_boxes[position], queryMinX, queryMinY, queryMaxX, queryMaxY)) {
+        continue;
+      }
+
+      if (position < this->_numItems) {
+        results.push_back(this->_indices[position]);
+      } else {
+        queue.push_back(this->_indices[position]);
+      }
+    }
+  }
+
+  return results;
+}
+
+auto SpatialIndex::hilbert(uint32_t x, uint32_t y) -> uint32_t {
+  // Fast Hilbert curve algorithm by http://threadlocalmutex.com/ (public domain)
+  uint32_t a = x ^ y;
+  uint32_t b = 0xFFFF ^ a;
+  uint32_t c = 0xFFFF ^ (x | y);
+  uint32_t d = x & (y ^ 0xFFFF);
+
+  uint32_t A = a | (b >> 1);
+  uint32_t B = (a >> 1) ^ a;
+  uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+  uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+  B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+  C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+  D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+  B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+  C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+  D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+  D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+  a = C ^ (C >> 1);
+  b = D ^ (D >> 1);
+
+  uint32_t i0 = x ^ y;
+  uint32_t i1 = b | (0xFFFF ^ (i0 | a));
+
+  i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+  i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+  i0 = (i0 | (i0 << 2)) & 0x33333333;
+  i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+  i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+  i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+  i1 = (i1 | (i1 << 2)) & 0x33333333;
+  i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+  return (i1 << 1) | i0;
+}
+
+auto SpatialIndex::morton(uint32_t x, uint32_t y) -> uint32_t {
+  // Interleave the bits of both coordinates, x taking the even bits and y the odd ones
+  x &= 0xFFFF;
+  x = (x | (x << 8)) & 0x00FF00FF;
+  x = (x | (x << 4)) & 0x0F0F0F0F;
+  x = (x | (x << 2)) & 0x33333333;
+  x = (x | (x << 1)) & 0x55555555;
+
+  y &= 0xFFFF;
+  y = (y | (y << 8)) & 0x00FF00FF;
+  y = (y | (y << 4)) & 0x0F0F0F0F;
+  y = (y | (y << 2)) & 0x33333333;
+  y = (y | (y << 1)) & 0x55555555;
+
+  return (y << 1) | x;
+}
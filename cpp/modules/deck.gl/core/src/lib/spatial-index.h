@@ -0,0 +1,135 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_LIB_SPATIAL_INDEX_H
+#define DECKGL_CORE_LIB_SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deckgl {
+
+/// \brief Static, packed Hilbert R-tree over axis-aligned bounding boxes.
+/// Items are sorted along a Hilbert curve of their box centers and packed bottom-up into nodes of a fixed size, which
+/// keeps memory overhead low and makes both building and querying very cache friendly.
+/// Based on https://github.com/mourner/flatbush
+class SpatialIndex {
+ public:
+  using Box = std::array<float, 4>;
+  class CurveGrid;
+
+  /// \brief Creates an empty index with space for the given number of items.
+  /// \param numItems Number of items that will be added to the index.
+  /// \param nodeSize Maximum number of children a single tree node can have.
+  explicit SpatialIndex(size_t numItems, size_t nodeSize = 16);
+
+  /// \brief Adds an item bounding box to the index.
+  /// \return Index of the added item, as returned by search().
+  auto add(double minX, double minY, double maxX, double maxY) -> uint32_t;
+
+  /// \brief Sorts items and builds the tree. Has to be called after all the items have been added.
+  /// \note Large indexes are sorted on multiple threads.
+  void finish();
+
+  /// \brief Returns indices of all the items whose bounding boxes intersect the given box.
+  auto search(double minX, double minY, double maxX, double maxY) const -> std::vector<uint32_t>;
+
+  /// \brief Returns the number of items in the index.
+  auto size() const -> size_t { return this->_numItems; }
+
+  /// \brief Returns the bounding box of all the items in the index, as [minX, minY, maxX, maxY].
+  auto bounds() const -> Box { return this->_bounds; }
+
+  /// \brief Returns the amount of memory allocated for the tree, in bytes.
+  auto byteLength() const -> uint64_t {
+    return this->_levelBounds.capacity() * sizeof(size_t) + this->_boxes.capacity() * sizeof(Box) +
+           this->_indices.capacity() * sizeof(uint32_t);
+  }
+
+  /// \brief Calculates the position of a point along a 16-bit Hilbert curve.
+  /// \param x X coordinate, in range [0, 65535].
+  /// \param y Y coordinate, in range [0, 65535].
+  static auto hilbert(uint32_t x, uint32_t y) -> uint32_t;
+
+  /// \brief Calculates the position of a point along a 16-bit Morton (Z-order) curve.
+  /// \param x X coordinate, in range [0, 65535].
+  /// \param y Y coordinate, in range [0, 65535].
+  static auto morton(uint32_t x, uint32_t y) -> uint32_t;
+
+ private:
+  size_t _numItems;
+  size_t _nodeSize;
+  size_t _position{0};
+
+  /// Offset at which each level of the tree ends, in the number of nodes
+  std::vector<size_t> _levelBounds;
+  std::vector<Box> _boxes;
+  /// Item indices for leaf nodes, offsets of the first child for parent nodes
+  std::vector<uint32_t> _indices;
+
+  Box _bounds;
+};
+
+/// \brief Maps centers of boxes within some bounds onto the 16-bit grid that hilbert() and morton() curves span.
+class SpatialIndex::CurveGrid {
+ public:
+  /// \param bounds Bounds of all the boxes that are going to be mapped, as [minX, minY, maxX, maxY].
+  explicit CurveGrid(const Box& bounds)
+      : _minX{bounds[0]},
+        _minY{bounds[1]},
+        _scaleX{bounds[2] > bounds[0] ? kMaxCoordinate / (static_cast<double>(bounds[2]) - bounds[0]) : 0.0},
+        _scaleY{bounds[3] > bounds[1] ? kMaxCoordinate / (static_cast<double>(bounds[3]) - bounds[1]) : 0.0} {}
+
+  /// \brief Returns grid coordinates of the center of a box, as [x, y].
+  auto cell(const Box& box) const -> std::array<uint32_t, 2> {
+    auto centerX = (static_cast<double>(box[0]) + box[2]) / 2;
+    auto centerY = (static_cast<double>(box[1]) + box[3]) / 2;
+    return {static_cast<uint32_t>(std::min(std::floor(this->_scaleX * (centerX - this->_minX)), kMaxCoordinate)),
+            static_cast<uint32_t>(std::min(std::floor(this->_scaleY * (centerY - this->_minY)), kMaxCoordinate))};
+  }
+
+  /// \brief Returns the position of the center of a box along the Hilbert curve.
+  auto hilbert(const Box& box) const -> uint32_t {
+    auto cell = this->cell(box);
+    return SpatialIndex::hilbert(cell[0], cell[1]);
+  }
+
+  /// \brief Returns the position of the center of a box along the Morton curve.
+  auto morton(const Box& box) const -> uint32_t {
+    auto cell = this->cell(box);
+    return SpatialIndex::morton(cell[0], cell[1]);
+  }
+
+ private:
+  static constexpr double kMaxCoordinate = (1 << 16) - 1;
+
+  double _minX;
+  double _minY;
+  double _scaleX;
+  double _scaleY;
+};
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_LIB_SPATIAL_INDEX_H
@@ -0,0 +1,67 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./picking-uniforms.h"  // NOLINT(build/include)
+
+#include <limits>
+
+namespace deckgl {
+
+auto encodePickingColor(const PickingIndex& index) -> std::array<uint8_t, 4> {
+  auto encoded = index.objectIndex + 1;
+  return {static_cast<uint8_t>(encoded & 0xFF), static_cast<uint8_t>((encoded >> 8) & 0xFF),
+          static_cast<uint8_t>((encoded >> 16) & 0xFF), static_cast<uint8_t>(index.layerIndex + 1)};
+}
+
+auto decodePickingColor(const uint8_t* color) -> std::optional<PickingIndex> {
+  auto encoded = static_cast<uint32_t>(color[0]) | (static_cast<uint32_t>(color[1]) << 8) |
+                 (static_cast<uint32_t>(color[2]) << 16);
+  if (encoded == 0 || color[3] == 0) {
+    return std::nullopt;
+  }
+
+  return PickingIndex{static_cast<uint32_t>(color[3] - 1), encoded - 1};
+}
+
+auto findClosestPickingIndex(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t bytesPerRow, int32_t x,
+                             int32_t y) -> std::optional<PickingIndex> {
+  std::optional<PickingIndex> closest;
+  auto closestDistance = std::numeric_limits<int64_t>::max();
+  for (uint32_t row = 0; row < height; ++row) {
+    for (uint32_t column = 0; column < width; ++column) {
+      auto index = decodePickingColor(pixels + row * bytesPerRow + column * 4);
+      if (!index) {
+        continue;
+      }
+
+      int64_t dx = static_cast<int64_t>(column) - x;
+      int64_t dy = static_cast<int64_t>(row) - y;
+      auto distance = dx * dx + dy * dy;
+      if (distance < closestDistance) {
+        closest = index;
+        closestDistance = distance;
+      }
+    }
+  }
+
+  return closest;
+}
+
+}  // namespace deckgl
@@ -0,0 +1,70 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_SHADERLIB_PICKING_PICKING_UNIFORMS_H
+#define DECKGL_CORE_SHADERLIB_PICKING_PICKING_UNIFORMS_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace deckgl {
+
+/// \brief Mirrors the PickingOptions uniform block, see picking.glsl.h.
+struct PickingUniforms {
+  /// \brief Whether layers should output picking colors instead of regular colors, 1 if they should and 0 otherwise.
+  float active;
+  /// \brief Index of the layer being drawn, encoded into the alpha channel of picking colors.
+  float layerIndex;
+};
+
+/// \brief Identifies an object drawn into a picking buffer.
+struct PickingIndex {
+  uint32_t layerIndex;
+  uint32_t objectIndex;
+};
+
+/// \brief Maximum number of layers that can be told apart in a picking buffer.
+static constexpr uint32_t kMaxPickingLayers = 255u;
+/// \brief Maximum number of objects per layer that can be told apart in a picking buffer.
+static constexpr uint32_t kMaxPickingObjects = (1u << 24) - 1;
+
+/// \brief Encodes a layer and an object index into a RGBA picking color, the same way picking shaders do.
+/// \note Indices are offset by one, so that a cleared buffer does not match any object.
+auto encodePickingColor(const PickingIndex& index) -> std::array<uint8_t, 4>;
+
+/// \brief Decodes a RGBA picking color.
+/// \return Layer and object index the color was encoded from, or std::nullopt if no object was drawn.
+auto decodePickingColor(const uint8_t* color) -> std::optional<PickingIndex>;
+
+/// \brief Finds the object drawn closest to the given position within a region read back from a picking buffer.
+/// \param pixels RGBA pixel data, rows starting bytesPerRow bytes apart.
+/// \param width Width of the region, in pixels.
+/// \param height Height of the region, in pixels.
+/// \param bytesPerRow Number of bytes between the starts of consecutive rows.
+/// \param x X coordinate to search around, relative to the region.
+/// \param y Y coordinate to search around, relative to the region.
+/// \return Closest picked object, or std::nullopt if there are no objects in the region.
+auto findClosestPickingIndex(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t bytesPerRow, int32_t x,
+                             int32_t y) -> std::optional<PickingIndex>;
+
+}  // namespace deckgl
+
+#endif  // DECKGL_CORE_SHADERLIB_PICKING_PICKING_UNIFORMS_H
@@ -0,0 +1,60 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_CORE_SHADERLIB_PICKING_PICKING_GLSL_H
+#define DECKGL_CORE_SHADERLIB_PICKING_PICKING_GLSL_H
+
+#include <string>
+
+// Picking colors are passed between shader stages at the last location available, so that they don't clash with
+// locations used by layers
+// NOLINTNEXTLINE(runtime/string)
+static const std::string pickingUniforms = R"GLSL(
+#define PICKING_COLOR_LOCATION 15
+
+layout(std140, set = 0, binding = 2) uniform PickingOptions {
+  float active;
+  float layerIndex;
+} picking;
+)GLSL";
+
+// NOLINTNEXTLINE(runtime/string)
+static const std::string pickingVS = pickingUniforms + R"GLSL(
+layout(location = PICKING_COLOR_LOCATION) flat out vec4 picking_vColor;
+
+// Index is offset by one in order for the cleared picking buffer to not match any object
+void picking_setPickingIndex(int index) {
+  int encoded = index + 1;
+  vec3 encodedIndex = vec3(encoded & 0xFF, (encoded >> 8) & 0xFF, (encoded >> 16) & 0xFF);
+  picking_vColor = vec4(encodedIndex, picking.layerIndex + 1.0) / 255.0;
+}
+)GLSL";
+
+// NOLINTNEXTLINE(runtime/string)
+static const std::string pickingFS = pickingUniforms + R"GLSL(
+layout(location = PICKING_COLOR_LOCATION) flat in vec4 picking_vColor;
+
+// Returns the encoded picking color while drawing into the picking buffer, and the given color otherwise
+vec4 picking_filterColor(vec4 color) {
+  return picking.active > 0.5 ? picking_vColor : color;
+}
+)GLSL";
+
+#endif  // DECKGL_CORE_SHADERLIB_PICKING_PICKING_GLSL_H
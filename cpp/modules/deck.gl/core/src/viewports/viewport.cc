@@ -20,6 +20,8 @@
 
 #include "./viewport.h"  // NOLINT(build/include)
 
+#include <algorithm>
+
 #include "math.gl/web-mercator.h"
 
 using namespace std;
@@ -48,6 +50,17 @@ auto Viewport::containsPixel(double x, double y, double width, double height) ->
   return (x < this->x + this->width) && (this->x < x + width) && (y < this->y + this->height) && (this->y < y + height);
 }
 
+auto Viewport::getBounds(double paddingPixels) -> std::array<double, 4> {
+  // Looking straight down, the visible area is an axis aligned rectangle around the center
+  auto halfWidth = (this->width / 2 + paddingPixels) / this->scale;
+  auto halfHeight = (this->height / 2 + paddingPixels) / this->scale;
+  auto minCorner = this->unprojectFlat(Vector2<double>(this->center.x - halfWidth, this->center.y - halfHeight));
+  auto maxCorner = this->unprojectFlat(Vector2<double>(this->center.x + halfWidth, this->center.y + halfHeight));
+
+  return {min(minCorner.x, maxCorner.x), min(minCorner.y, maxCorner.y), max(minCorner.x, maxCorner.x),
+          max(minCorner.y, maxCorner.y)};
+}
+
 auto Viewport::projectFlat(const mathgl::Vector2<double>& xy) -> mathgl::Vector2<double> {
   if (this->isGeospatial) {
     return lngLatToWorld(xy);
@@ -62,6 +75,20 @@ auto Viewport::unprojectFlat(const mathgl::Vector2<double>& xy) -> mathgl::Vecto
   return xy;
 }
 
+auto Viewport::project(const mathgl::Vector2<double>& lngLat, bool topLeft) -> mathgl::Vector2<double> {
+  auto worldPosition = this->projectPosition(lngLat);
+  auto coord = worldToPixels(worldPosition, this->pixelProjectionMatrix);
+  auto y2 = topLeft ? coord.y : this->height - coord.y;
+  return Vector2<double>(coord.x, y2);
+}
+
+auto Viewport::project(const mathgl::Vector3<double>& lngLatZ, bool topLeft) -> mathgl::Vector3<double> {
+  auto worldPosition = this->projectPosition(lngLatZ);
+  auto coord = worldToPixels(worldPosition, this->pixelProjectionMatrix);
+  auto y2 = topLeft ? coord.y : this->height - coord.y;
+  return Vector3<double>(coord.x, y2, coord.z);
+}
+
 auto Viewport::unproject(const mathgl::Vector2<double>& xy, bool topLeft, double targetZ) -> mathgl::Vector2<double> {
   auto y2 = topLeft ? xy.y : this->height - xy.y;
   auto targetZWorld = targetZ * this->distanceScales.unitsPerMeter.z;
@@ -201,29 +228,23 @@ void Viewport::_initPixelMatrices() {
   /*
    * Builds matrices that converts preprojected lngLats to screen pixels
    * and vice versa.
-   * Note: Currently returns bottom-left coordinates!
    * Note: Starts with the GL projection matrix and adds steps to the
    *       scale and translate that matrix onto the window.
    * Note: WebGL controls clip space to screen projection with gl.viewport
    *       and does not need this step.
    */
 
-  /*
-  // matrix for conversion from world location to screen (pixel) coordinates
-  const viewportMatrix = createMat4(); // matrix from NDC to viewport.
-  const pixelProjectionMatrix = createMat4(); // matrix from world space to viewport.
-  mat4.scale(viewportMatrix, viewportMatrix, [this.width / 2, -this.height / 2, 1]);
-  mat4.translate(viewportMatrix, viewportMatrix, [1, -1, 0]);
-  mat4.multiply(pixelProjectionMatrix, viewportMatrix, this.viewProjectionMatrix);
-  this.pixelProjectionMatrix = pixelProjectionMatrix;
-  this.viewportMatrix = viewportMatrix;
-
-  this.pixelUnprojectionMatrix = mat4.invert(createMat4(), this.pixelProjectionMatrix);
-  if (!this.pixelUnprojectionMatrix) {
-    log.warn('Pixel project matrix not invertible')();
-    // throw new Error('Pixel project matrix not invertible');
+  // Matrix for conversion from NDC to screen (pixel) coordinates, with y pointing down
+  this->viewportMatrix = Matrix4<double>::makeUnit()
+                             .scale(Vector3<double>(this->width / 2, -this->height / 2, 1))
+                             .translate(Vector3<double>(1, -1, 0));
+  // Matrix for conversion from world location to screen (pixel) coordinates
+  this->pixelProjectionMatrix = this->viewportMatrix * this->viewProjectionMatrix;
+
+  // elided: JS logs a warning instead, unprojection stays an identity for degenerate viewports
+  if (this->pixelProjectionMatrix.determinant() != 0) {
+    this->pixelUnprojectionMatrix = this->pixelProjectionMatrix.invert();
   }
-  */
 }
 
 auto operator==(const Viewport& v1, const Viewport& v2) -> bool {
@@ -21,6 +21,7 @@
 #ifndef DECKGL_CORE_VIEWPORTS_VIEWPORT_H
 #define DECKGL_CORE_VIEWPORTS_VIEWPORT_H
 
+#include <array>
 #include <optional>
 #include <string>
 
@@ -79,6 +80,7 @@ class Viewport {
            const mathgl::ProjectionMatrixOptions& projectionMatrixOptions,
            // Window width/height in pixels (for pixel projection)
            double x = 0, double y = 0, double width = 1, double height = 1);
+  virtual ~Viewport() = default;
 
   auto metersPerPixel() -> double;
   auto projectionMode() -> PROJECTION_MODE;
@@ -129,6 +131,12 @@ class Viewport {
                              std::optional<mathgl::Vector2<double>>()) -> mathgl::DistanceScales;
   auto containsPixel(double x, double y, double width = 1, double height = 1) -> bool;
 
+  /// \brief Calculates a bounding box of the area visible in this viewport, in unprojected coordinates.
+  /// \note The default implementation assumes a top-down view, subclasses account for camera orientation.
+  /// \param paddingPixels Number of pixels to extend the visible area by on each side.
+  /// \return [minX, minY, maxX, maxY], i.e. [minLng, minLat, maxLng, maxLat] for geospatial viewports.
+  virtual auto getBounds(double paddingPixels = 0.0) -> std::array<double, 4>;
+
   // Extract frustum planes in common space
   // TODO(isaac@unfolded.ai): don't know type
   void getFrustrumPlanes();
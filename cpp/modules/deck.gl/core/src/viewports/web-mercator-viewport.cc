@@ -21,6 +21,8 @@
 #include "./web-mercator-viewport.h"  // NOLINT(build/include)
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "math.gl/web-mercator.h"
 
@@ -64,7 +66,10 @@ ProjectionMatrixOptions calculateProjectionMatrixOptions(const WebMercatorViewpo
 
 WebMercatorViewport::WebMercatorViewport(const WebMercatorViewport::Options& opts)
     : Viewport("web-mercator-viewport", calculateViewMatrixOptions(opts), calculateProjectionMatrixOptions(opts), 0, 0,
-               opts.width == 0 ? 1 : opts.width, opts.height == 0 ? 1 : opts.height) {
+               opts.width == 0 ? 1 : opts.width, opts.height == 0 ? 1 : opts.height),
+      pitch{opts.pitch},
+      bearing{opts.bearing},
+      altitude{max(0.75, opts.altitude)} {
   // TODO(isaac@unfolded.ai): Need to cleanup the call to the superclass ctor. In JS this is done partway through this
   // ctor, but that can't be done in C++. Perhaps just call a non-virtual _init method instead?
 
@@ -110,8 +115,8 @@ auto WebMercatorViewport::fitBounds(mathgl::Vector2<double> topLeft, mathgl::Vec
 
   WebMercatorViewport viewport = WebMercatorViewport(options);
 
-  auto nw = viewport.projectFlat(topLeft);
-  auto se = viewport.projectFlat(bottomRight);
+  auto nw = viewport.project(topLeft);
+  auto se = viewport.project(bottomRight);
 
   mathgl::Vector2<double> size(max(abs(se.x - nw.x), minExtent), max(abs(se.y - nw.y), minExtent));
 
@@ -137,3 +142,45 @@ auto WebMercatorViewport::fitBounds(mathgl::Vector2<double> topLeft, mathgl::Vec
 
   return viewport;
 }
+
+auto WebMercatorViewport::getBounds(double paddingPixels) -> std::array<double, 4> {
+  // Camera is located `altitude` screen heights away from the center, tilted by pitch and rotated by bearing
+  auto pitchRadians = this->pitch * DEGREES_TO_RADIANS;
+  auto bearingRadians = this->bearing * DEGREES_TO_RADIANS;
+  auto cameraDistance = this->altitude * this->height;
+  auto cameraHeight = cameraDistance * cos(pitchRadians);
+
+  auto halfWidth = this->width / 2 + paddingPixels;
+  auto halfHeight = this->height / 2 + paddingPixels;
+
+  auto infinity = numeric_limits<double>::infinity();
+  std::array<double, 4> bounds{infinity, infinity, -infinity, -infinity};
+  for (auto screenY : {-halfHeight, halfHeight}) {
+    // Find where the ray through this screen row hits the ground, in pixels relative to the center
+    auto descent = cameraHeight - screenY * sin(pitchRadians);
+    if (descent <= numeric_limits<double>::epsilon() * cameraDistance) {
+      // Ray never reaches the ground, the area above the horizon is visible
+      return {-infinity, -infinity, infinity, infinity};
+    }
+
+    auto rayScale = cameraHeight / descent;
+    auto forward = rayScale * (cameraDistance * sin(pitchRadians) + screenY * cos(pitchRadians)) -
+                   cameraDistance * sin(pitchRadians);
+    for (auto screenX : {-halfWidth, halfWidth}) {
+      auto right = rayScale * screenX;
+
+      // Rotate into world space, where bearing is measured clockwise from north
+      auto offsetX = forward * sin(bearingRadians) + right * cos(bearingRadians);
+      auto offsetY = forward * cos(bearingRadians) - right * sin(bearingRadians);
+      auto corner = this->unprojectFlat(
+          Vector2<double>(this->center.x + offsetX / this->scale, this->center.y + offsetY / this->scale));
+
+      bounds[0] = min(bounds[0], corner.x);
+      bounds[1] = min(bounds[1], corner.y);
+      bounds[2] = max(bounds[2], corner.x);
+      bounds[3] = max(bounds[3], corner.y);
+    }
+  }
+
+  return bounds;
+}
@@ -65,6 +65,10 @@ class WebMercatorViewport : public Viewport {
 
   explicit WebMercatorViewport(const Options& options);
 
+  double pitch;
+  double bearing;
+  double altitude;
+
   // elided subViewports feature
   // get subViewports()
 
@@ -93,6 +97,12 @@ class WebMercatorViewport : public Viewport {
   auto fitBounds(mathgl::Vector2<double> topLeft, mathgl::Vector2<double> bottomRight, double minExtent = 0.0,
                  double maxZoom = 24.0, int padding = 0, mathgl::Vector2<int> offset = mathgl::Vector2<int>())
       -> WebMercatorViewport;
+
+  /// \brief Calculates a bounding box of the ground area visible in this viewport, taking pitch and bearing into
+  /// account.
+  /// \param paddingPixels Number of pixels to extend the visible area by on each side.
+  /// \return [minLng, minLat, maxLng, maxLat], or an unbounded box if the horizon is visible.
+  auto getBounds(double paddingPixels = 0.0) -> std::array<double, 4> override;
 };
 
 }  // namespace deckgl
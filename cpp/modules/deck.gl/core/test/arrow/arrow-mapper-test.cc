@@ -0,0 +1,105 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../../src/arrow/arrow-mapper.h"
+
+#include <arrow/builder.h>
+#include <arrow/table.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace deckgl;
+
+auto makeStringArray(const std::vector<std::string>& values) -> std::shared_ptr<arrow::Array> {
+  arrow::StringBuilder builder;
+  for (const auto& value : values) {
+    EXPECT_TRUE((value.empty() ? builder.AppendNull() : builder.Append(value)).ok());
+  }
+
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder.Finish(&array).ok());
+  return array;
+}
+
+auto makeDictionaryArray(const std::vector<int16_t>& indices, const std::vector<std::string>& dictionary)
+    -> std::shared_ptr<arrow::Array> {
+  arrow::Int16Builder builder;
+  EXPECT_TRUE(builder.AppendValues(indices).ok());
+  std::shared_ptr<arrow::Array> indexArray;
+  EXPECT_TRUE(builder.Finish(&indexArray).ok());
+
+  auto type = arrow::dictionary(arrow::int16(), arrow::utf8());
+  return arrow::DictionaryArray::FromArrays(type, indexArray, makeStringArray(dictionary)).ValueOrDie();
+}
+
+auto getCategoryIndices(const std::shared_ptr<arrow::Array>& array) -> std::vector<uint32_t> {
+  auto& values = static_cast<const arrow::UInt32Array&>(*array);
+  return std::vector<uint32_t>(values.raw_values(), values.raw_values() + values.length());
+}
+
+TEST(ArrowMapper, MapCategoryColumn) {
+  // Chunks with different dictionaries share categories, which are indexed in the order dictionaries list them
+  auto chunks = arrow::ArrayVector{makeDictionaryArray({1, 0, 1}, {"private", "commercial"}),
+                                   makeDictionaryArray({0, 1, 2}, {"military", "", "private"})};
+  auto schema = arrow::schema({arrow::field("type", arrow::dictionary(arrow::int16(), arrow::utf8()))});
+  auto table = arrow::Table::Make(schema, {std::make_shared<arrow::ChunkedArray>(chunks)});
+
+  Categories categories;
+  auto indices = ArrowMapper::mapCategoryColumn(table, "type", categories);
+  auto null = ArrowMapper::kNullCategory;
+  EXPECT_EQ(indices->type_id(), arrow::Type::UINT32);
+  EXPECT_EQ(getCategoryIndices(indices), (std::vector<uint32_t>{1, 0, 1, 2, null, 0}));
+  EXPECT_EQ(categories.values(), (std::vector<std::string>{"private", "commercial", "military"}));
+
+  // Plain string columns are mapped too, categories seen before keep their indices
+  auto appended = arrow::Table::Make(arrow::schema({arrow::field("type", arrow::utf8())}),
+                                     {makeStringArray({"seaplane", "", "military"})});
+  EXPECT_EQ(getCategoryIndices(ArrowMapper::mapCategoryColumn(appended, "type", categories)),
+            (std::vector<uint32_t>{3, null, 2}));
+  EXPECT_EQ(categories.size(), 4u);
+
+  // Rows of missing columns have no category
+  EXPECT_EQ(getCategoryIndices(ArrowMapper::mapCategoryColumn(appended, "missing", categories)),
+            (std::vector<uint32_t>{null, null, null}));
+
+  // Cleared categories are indexed from scratch
+  categories.clear();
+  EXPECT_EQ(getCategoryIndices(ArrowMapper::mapCategoryColumn(appended, "type", categories)),
+            (std::vector<uint32_t>{0, null, 1}));
+  EXPECT_EQ(categories.values(), (std::vector<std::string>{"seaplane", "military"}));
+}
+
+TEST(ArrowMapper, MapCategoryColumnUnsupportedType) {
+  arrow::Int32Builder builder;
+  EXPECT_TRUE(builder.Append(1).ok());
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder.Finish(&array).ok());
+
+  auto table = arrow::Table::Make(arrow::schema({arrow::field("type", arrow::int32())}), {array});
+  Categories categories;
+  EXPECT_THROW(ArrowMapper::mapCategoryColumn(table, "type", categories), std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,94 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../../src/arrow/arrow-utils.h"
+
+#include <arrow/builder.h>
+#include <arrow/table.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using namespace deckgl;
+
+TEST(ArrowUtils, GetTableByteLength) {
+  EXPECT_EQ(getTableByteLength(nullptr), 0u);
+
+  arrow::Int32Builder intBuilder;
+  EXPECT_TRUE(intBuilder.AppendValues(std::vector<int32_t>{1, 2, 3, 4}).ok());
+  std::shared_ptr<arrow::Array> intArray;
+  EXPECT_TRUE(intBuilder.Finish(&intArray).ok());
+
+  arrow::ListBuilder listBuilder{arrow::default_memory_pool(), std::make_shared<arrow::FloatBuilder>()};
+  auto& listValueBuilder = *(static_cast<arrow::FloatBuilder*>(listBuilder.value_builder()));
+  EXPECT_TRUE(listBuilder.Append().ok());
+  EXPECT_TRUE(listValueBuilder.AppendValues(std::vector<float>{1.0f, 2.0f, 3.0f}).ok());
+  std::shared_ptr<arrow::Array> listArray;
+  EXPECT_TRUE(listBuilder.Finish(&listArray).ok());
+
+  auto byteLength = [](const std::shared_ptr<arrow::Array>& array) {
+    int64_t size = 0;
+    for (const auto& buffer : array->data()->buffers) {
+      size += buffer ? buffer->size() : 0;
+    }
+    return static_cast<uint64_t>(size);
+  };
+  auto listByteLength = byteLength(listArray) + byteLength(static_cast<arrow::ListArray&>(*listArray).values());
+
+  // Nested list values are included
+  auto schema =
+      arrow::schema({arrow::field("int", arrow::int32()), arrow::field("list", arrow::list(arrow::float32()))});
+  auto table = arrow::Table::Make(schema, {intArray, listArray});
+  EXPECT_EQ(getTableByteLength(table), byteLength(intArray) + listByteLength);
+
+  // Buffers shared between columns are only counted once
+  auto sharedSchema = arrow::schema({arrow::field("a", arrow::int32()), arrow::field("b", arrow::int32())});
+  auto sharedTable = arrow::Table::Make(sharedSchema, {intArray, intArray});
+  EXPECT_EQ(getTableByteLength(sharedTable), byteLength(intArray));
+}
+
+TEST(ArrowUtils, AppendRecordBatch) {
+  arrow::Int32Builder intBuilder;
+  EXPECT_TRUE(intBuilder.AppendValues(std::vector<int32_t>{1, 2, 3}).ok());
+  std::shared_ptr<arrow::Array> intArray;
+  EXPECT_TRUE(intBuilder.Finish(&intArray).ok());
+
+  auto schema = arrow::schema({arrow::field("int", arrow::int32())});
+  auto batch = arrow::RecordBatch::Make(schema, intArray->length(), {intArray});
+
+  auto table = appendRecordBatch(nullptr, batch);
+  EXPECT_EQ(table->num_rows(), 3);
+
+  // Batches are added as new chunks, without copying data
+  table = appendRecordBatch(table, batch);
+  EXPECT_EQ(table->num_rows(), 6);
+  ASSERT_EQ(table->column(0)->num_chunks(), 2);
+  EXPECT_EQ(table->column(0)->chunk(1)->data()->buffers[1], intArray->data()->buffers[1]);
+  EXPECT_EQ(getTableByteLength(table), getTableByteLength(appendRecordBatch(nullptr, batch)));
+
+  auto otherSchema = arrow::schema({arrow::field("other", arrow::int32())});
+  auto otherBatch = arrow::RecordBatch::Make(otherSchema, intArray->length(), {intArray});
+  EXPECT_THROW(appendRecordBatch(table, otherBatch), std::logic_error);
+}
+
+}  // namespace
@@ -0,0 +1,104 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../../src/arrow/recycling-memory-pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace {
+
+using namespace deckgl;
+
+TEST(RecyclingMemoryPool, SizeClass) {
+  EXPECT_EQ(RecyclingMemoryPool::sizeClass(1), std::make_pair(size_t{0}, int64_t{64}));
+  EXPECT_EQ(RecyclingMemoryPool::sizeClass(64), std::make_pair(size_t{0}, int64_t{64}));
+  EXPECT_EQ(RecyclingMemoryPool::sizeClass(65), std::make_pair(size_t{1}, int64_t{80}));
+  EXPECT_EQ(RecyclingMemoryPool::sizeClass(128), std::make_pair(size_t{4}, int64_t{128}));
+  EXPECT_EQ(RecyclingMemoryPool::sizeClass(129), std::make_pair(size_t{5}, int64_t{160}));
+  EXPECT_EQ(RecyclingMemoryPool::sizeClass(1000000), std::make_pair(size_t{56}, int64_t{1048576}));
+
+  // Classes never waste more than a quarter of the allocation
+  for (int64_t size = 65; size < 100000; size += 37) {
+    auto classSize = RecyclingMemoryPool::sizeClass(size).second;
+    EXPECT_GE(classSize, size);
+    EXPECT_LE(classSize, size + size / 4 + 1);
+  }
+}
+
+TEST(RecyclingMemoryPool, Recycle) {
+  auto underlyingPool = arrow::default_memory_pool();
+  auto initialBytes = underlyingPool->bytes_allocated();
+  RecyclingMemoryPool pool{underlyingPool};
+
+  uint8_t* buffer;
+  ASSERT_TRUE(pool.Allocate(1000, &buffer).ok());
+  std::memset(buffer, 1, 1000);
+  EXPECT_EQ(pool.bytes_allocated(), 1000);
+  pool.Free(buffer, 1000);
+  EXPECT_EQ(pool.bytes_allocated(), 0);
+  EXPECT_EQ(pool.usage().retainedBytes, 1024);
+
+  // Allocations within the same size class reuse the freed buffer
+  uint8_t* reusedBuffer;
+  ASSERT_TRUE(pool.Allocate(980, &reusedBuffer).ok());
+  EXPECT_EQ(reusedBuffer, buffer);
+  EXPECT_EQ(pool.usage().reuseCount, 1u);
+  EXPECT_DOUBLE_EQ(pool.usage().reuseRate(), 0.5);
+
+  // Growing within a size class keeps the buffer in place, growing past it moves the data
+  ASSERT_TRUE(pool.Reallocate(980, 1020, &reusedBuffer).ok());
+  EXPECT_EQ(reusedBuffer, buffer);
+  ASSERT_TRUE(pool.Reallocate(1020, 4000, &reusedBuffer).ok());
+  EXPECT_NE(reusedBuffer, buffer);
+  EXPECT_EQ(reusedBuffer[999], 1);
+  EXPECT_EQ(pool.bytes_allocated(), 4000);
+  // Both buffers are allocated at the same time while data is being moved
+  EXPECT_EQ(pool.max_memory(), 1020 + 4000);
+
+  pool.Free(reusedBuffer, 4000);
+  EXPECT_EQ(pool.usage().retainedBytes, 1024 + 4096);
+  EXPECT_EQ(underlyingPool->bytes_allocated() - initialBytes, 1024 + 4096);
+
+  pool.releaseUnused();
+  EXPECT_EQ(pool.usage().retainedBytes, 0);
+  EXPECT_EQ(underlyingPool->bytes_allocated(), initialBytes);
+}
+
+TEST(RecyclingMemoryPool, MaxRetainedBytes) {
+  auto underlyingPool = arrow::default_memory_pool();
+  auto initialBytes = underlyingPool->bytes_allocated();
+  RecyclingMemoryPool pool{underlyingPool, 2048};
+
+  uint8_t* buffers[3];
+  for (auto& buffer : buffers) {
+    ASSERT_TRUE(pool.Allocate(1024, &buffer).ok());
+  }
+  for (auto& buffer : buffers) {
+    pool.Free(buffer, 1024);
+  }
+
+  // Buffers beyond the limit are returned to the underlying pool right away
+  EXPECT_EQ(pool.usage().retainedBytes, 2048);
+  EXPECT_EQ(underlyingPool->bytes_allocated() - initialBytes, 2048);
+}
+
+}  // namespace
@@ -24,7 +24,10 @@
 #include <arrow/table.h>
 #include <gtest/gtest.h>
 
+#include <array>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace {
 
@@ -169,6 +172,137 @@ TEST_F(RowTest, getDoubleVector3) {
   EXPECT_EQ(row->getVector3<double>("fixed_list", expectedVector), expectedVector);
 }
 
+TEST_F(RowTest, ReadListData) {
+  auto row = std::make_unique<Row>(table, 0);
+  std::array<double, 4> values{};
+  EXPECT_EQ(row->readListData("fixed_list", values), 3u);
+  EXPECT_EQ(values, (std::array<double, 4>{-256.2, 0.0, 1.23, 0.0}));
+
+  // Values are converted to the requested type, and lists longer than the array are truncated
+  std::array<int, 1> intValues{};
+  EXPECT_EQ(row->readListData("list", intValues), 1u);
+  EXPECT_EQ(intValues[0], 355);
+
+  // Values are left untouched when data can't be found
+  row = std::make_unique<Row>(table, 1);
+  values = {1.0, 2.0, 3.0, 4.0};
+  EXPECT_FALSE(row->readListData("fixed_list", values));
+  EXPECT_FALSE(row->readListData("double", values));
+  EXPECT_EQ(values, (std::array<double, 4>{1.0, 2.0, 3.0, 4.0}));
+}
+
+TEST_F(RowTest, IncrementRowIndex) {
+  auto row = std::make_unique<Row>(table, 0);
+  EXPECT_EQ(row->getInt("int"), 42);
+
+  row->incrementRowIndex();
+  EXPECT_EQ(row->getInt("int"), -212);
+  EXPECT_DOUBLE_EQ(row->getDouble("double"), 991.1);
+  EXPECT_THROW(row->incrementRowIndex(), std::range_error);
+}
+
+TEST_F(RowTest, ChunkedColumns) {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+
+  // Columns split into chunks differently, including an empty chunk
+  arrow::ArrayVector intChunks;
+  arrow::ArrayVector doubleChunks;
+  for (auto chunkLength : {2, 0, 3}) {
+    arrow::Int32Builder intBuilder{pool};
+    for (auto i = 0; i < chunkLength; i++) {
+      EXPECT_TRUE(intBuilder.Append(static_cast<int32_t>(intChunks.size() * 10 + i)).ok());
+    }
+    std::shared_ptr<arrow::Array> intArray;
+    EXPECT_TRUE(intBuilder.Finish(&intArray).ok());
+    intChunks.push_back(intArray);
+  }
+  for (auto chunkLength : {4, 1}) {
+    arrow::DoubleBuilder doubleBuilder{pool};
+    for (auto i = 0; i < chunkLength; i++) {
+      EXPECT_TRUE(doubleBuilder.Append(doubleChunks.size() + i / 10.0).ok());
+    }
+    std::shared_ptr<arrow::Array> doubleArray;
+    EXPECT_TRUE(doubleBuilder.Finish(&doubleArray).ok());
+    doubleChunks.push_back(doubleArray);
+  }
+
+  auto schema = arrow::schema({arrow::field("int", arrow::int32()), arrow::field("double", arrow::float64())});
+  auto chunkedTable = arrow::Table::Make(schema, {std::make_shared<arrow::ChunkedArray>(intChunks),
+                                                  std::make_shared<arrow::ChunkedArray>(doubleChunks)});
+
+  std::vector<int> expectedInts{0, 1, 20, 21, 22};
+  std::vector<double> expectedDoubles{0.0, 0.1, 0.2, 0.3, 1.0};
+  auto row = std::make_unique<Row>(chunkedTable, 0);
+  for (size_t i = 0; i < expectedInts.size(); i++) {
+    EXPECT_EQ(row->getInt("int"), expectedInts[i]);
+    EXPECT_DOUBLE_EQ(row->getDouble("double"), expectedDoubles[i]);
+    EXPECT_FALSE(row->isValid("missing"));
+    if (i + 1 < expectedInts.size()) {
+      row->incrementRowIndex();
+    }
+  }
+
+  // Rows can also be looked up directly
+  EXPECT_EQ(Row(chunkedTable, 3).getInt("int"), 21);
+  EXPECT_DOUBLE_EQ(Row(chunkedTable, 4).getDouble("double"), 1.0);
+}
+
+TEST_F(RowTest, DictionaryColumns) {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+
+  arrow::StringBuilder dictionaryBuilder{pool};
+  EXPECT_TRUE(dictionaryBuilder.AppendValues(std::vector<std::string>{"small", "large"}).ok());
+  std::shared_ptr<arrow::Array> dictionary;
+  EXPECT_TRUE(dictionaryBuilder.Finish(&dictionary).ok());
+
+  arrow::DoubleBuilder sizeBuilder{pool};
+  EXPECT_TRUE(sizeBuilder.AppendValues(std::vector<double>{2.5, 10.0}).ok());
+  std::shared_ptr<arrow::Array> sizes;
+  EXPECT_TRUE(sizeBuilder.Finish(&sizes).ok());
+
+  arrow::Int8Builder indexBuilder{pool};
+  EXPECT_TRUE(indexBuilder.Append(1).ok());
+  EXPECT_TRUE(indexBuilder.AppendNull().ok());
+  EXPECT_TRUE(indexBuilder.Append(0).ok());
+  std::shared_ptr<arrow::Array> indices;
+  EXPECT_TRUE(indexBuilder.Finish(&indices).ok());
+
+  auto types = arrow::DictionaryArray::FromArrays(arrow::dictionary(arrow::int8(), arrow::utf8()), indices, dictionary)
+                   .ValueOrDie();
+  auto typeSizes =
+      arrow::DictionaryArray::FromArrays(arrow::dictionary(arrow::int8(), arrow::float64()), indices, sizes)
+          .ValueOrDie();
+  auto schema = arrow::schema({arrow::field("type", types->type()), arrow::field("size", typeSizes->type())});
+  auto dictionaryTable = arrow::Table::Make(schema, {types, typeSizes});
+
+  // Values are read through the dictionary, and null indices are reported as invalid values
+  auto row = Row{dictionaryTable, 0};
+  EXPECT_EQ(row.getString("type"), "large");
+  EXPECT_DOUBLE_EQ(row.getDouble("size"), 10.0);
+  EXPECT_EQ(row.getInt("size"), 10);
+
+  row.incrementRowIndex();
+  EXPECT_FALSE(row.isValid("type"));
+  EXPECT_EQ(row.getString("type", "default"), "default");
+  EXPECT_DOUBLE_EQ(row.getDouble("size", -1.0), -1.0);
+
+  row.incrementRowIndex();
+  EXPECT_EQ(row.getString("type"), "small");
+  EXPECT_FLOAT_EQ(row.getFloat("size"), 2.5f);
+}
+
+TEST_F(RowTest, AccessedColumnNames) {
+  auto row = std::make_unique<Row>(table, 0);
+  EXPECT_TRUE(row->accessedColumnNames().empty());
+
+  // Columns are listed once, in order of first access, and missing columns are left out
+  row->getDouble("double");
+  row->getInt("int");
+  row->getDouble("double");
+  row->getInt("missing");
+  EXPECT_EQ(row->accessedColumnNames(), (std::vector<std::string>{"double", "int"}));
+}
+
 TEST_F(RowTest, isValid) {
   auto row = std::make_unique<Row>(table, 1);
   EXPECT_TRUE(row->isValid("int"));
@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <vector>
 
 #include "deck.gl/core.h"
 #include "deck.gl/layers.h"
@@ -91,4 +92,93 @@ TEST_F(AttributeManagerTest, Update) {
   //  EXPECT_EQ(resultTable->ColumnNames()[1], "attribute-two");
 }
 
+/// Tests that attributes are mapped on the CPU without requiring a device.
+TEST_F(AttributeManagerTest, Map) {
+  auto mapPositions = [](const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
+    arrow::MemoryPool* pool = arrow::default_memory_pool();
+    arrow::FixedSizeListBuilder listBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 2};
+    arrow::FloatBuilder& valueBuilder = *(static_cast<arrow::FloatBuilder*>(listBuilder.value_builder()));
+
+    std::vector<float> values{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    EXPECT_TRUE(listBuilder.AppendValues(3).ok());
+    EXPECT_TRUE(valueBuilder.AppendValues(values.data(), values.size()).ok());
+
+    std::shared_ptr<arrow::Array> resultArray;
+    EXPECT_TRUE(listBuilder.Finish(&resultArray).ok());
+    return resultArray;
+  };
+
+  auto field = std::make_shared<arrow::Field>("positions", arrow::fixed_size_list(arrow::float32(), 2));
+  manager->add(lumagl::garrow::ColumnBuilder{field, mapPositions});
+
+  auto attributes = manager->map(emptyTable);
+  EXPECT_EQ(attributes->num_rows(), 3);
+  EXPECT_EQ(attributes->num_columns(), 1);
+  EXPECT_EQ(attributes->schema()->field(0)->name(), "positions");
+}
+
+/// Tests that binary attributes are used instead of mapping data.
+TEST_F(AttributeManagerTest, BinaryAttributes) {
+  auto mapUnexpectedly = [](const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
+    ADD_FAILURE() << "Binary attributes shouldn't be mapped";
+    return nullptr;
+  };
+  auto positionField = std::make_shared<arrow::Field>("positions", arrow::fixed_size_list(arrow::float32(), 2));
+  auto colorField = std::make_shared<arrow::Field>("colors", arrow::fixed_size_list(arrow::float32(), 4));
+  manager->add(lumagl::garrow::ColumnBuilder{positionField, mapUnexpectedly});
+  manager->add(lumagl::garrow::ColumnBuilder{colorField, mapUnexpectedly});
+
+  std::vector<float> positionValues{1.0, 2.0, 3.0, 4.0};
+  std::vector<uint8_t> colorValues{255, 0, 0, 255, 0, 128, 255, 64};
+  auto positions = lumagl::garrow::arrayFromBuffer(
+      std::make_shared<arrow::Buffer>(reinterpret_cast<const uint8_t*>(positionValues.data()), 16),
+      wgpu::VertexFormat::Float2);
+  auto colors = lumagl::garrow::arrayFromBuffer(std::make_shared<arrow::Buffer>(colorValues.data(), 8),
+                                                wgpu::VertexFormat::UChar4);
+  manager->setBinaryAttributes({{"positions", positions}, {"colors", colors}});
+
+  // Data only determines the number of rows
+  auto data = arrow::Table::Make(arrow::schema({}), std::vector<std::shared_ptr<arrow::Array>>{}, 2);
+  auto attributes = manager->map(data);
+  ASSERT_EQ(attributes->num_rows(), 2);
+
+  // Values of the attribute's type are used as they are, others are converted
+  EXPECT_EQ(attributes->GetColumnByName("positions")->chunk(0), positions);
+  auto mappedColors =
+      std::static_pointer_cast<arrow::FixedSizeListArray>(attributes->GetColumnByName("colors")->chunk(0));
+  auto mappedColorValues = std::static_pointer_cast<arrow::FloatArray>(mappedColors->values());
+  EXPECT_FLOAT_EQ(mappedColorValues->Value(0), 255.0f);
+  EXPECT_FLOAT_EQ(mappedColorValues->Value(5), 128.0f);
+
+  auto longerData = arrow::Table::Make(arrow::schema({}), std::vector<std::shared_ptr<arrow::Array>>{}, 3);
+  EXPECT_THROW(manager->map(longerData), std::runtime_error);
+
+  manager->setBinaryAttributes({{"positions", colors}});
+  EXPECT_THROW(manager->map(data), std::runtime_error);
+}
+
+/// Tests that null values are replaced by the null value of their attribute, and counted.
+TEST_F(AttributeManagerTest, NullValues) {
+  auto mapRadii = [](const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
+    arrow::FloatBuilder builder;
+    EXPECT_TRUE(builder.Append(2.0f).ok());
+    EXPECT_TRUE(builder.AppendNull().ok());
+    EXPECT_TRUE(builder.AppendNull().ok());
+    EXPECT_TRUE(builder.Append(4.0f).ok());
+
+    std::shared_ptr<arrow::Array> resultArray;
+    EXPECT_TRUE(builder.Finish(&resultArray).ok());
+    return resultArray;
+  };
+  auto field = std::make_shared<arrow::Field>("radii", arrow::float32());
+  manager->add(lumagl::garrow::ColumnBuilder{field, mapRadii, {1.0}});
+
+  auto attributes = manager->map(emptyTable);
+  auto radii = std::static_pointer_cast<arrow::FloatArray>(attributes->GetColumnByName("radii")->chunk(0));
+  EXPECT_EQ(radii->null_count(), 0);
+  EXPECT_EQ(std::vector<float>(radii->raw_values(), radii->raw_values() + radii->length()),
+            (std::vector<float>{2.0f, 1.0f, 1.0f, 4.0f}));
+  EXPECT_EQ(manager->stats->get("Null Attribute Values").snapshot().count, 2u);
+}
+
 }  // namespace
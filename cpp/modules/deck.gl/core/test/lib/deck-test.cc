@@ -0,0 +1,225 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "deck.gl/core/src/lib/deck.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+#include <arrow/api.h>
+#include <dawn_native/DawnNative.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "deck.gl/layers.h"
+#include "loaders.gl/core.h"
+#include "luma.gl/webgpu.h"
+#endif
+
+using namespace deckgl;
+
+namespace {
+
+#if defined(LUMAGL_ENABLE_BACKEND_NULL)
+
+/// \brief Runs Deck on top of the Null backend, which doesn't need a window or a GPU.
+class DeckNullBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    lumagl::utils::initializeProcTable();
+
+    this->_instance = std::make_unique<dawn_native::Instance>();
+    this->_instance->DiscoverDefaultAdapters();
+
+    std::vector<dawn_native::Adapter> adapters = this->_instance->GetAdapters();
+    auto adapterIt = std::find_if(adapters.begin(), adapters.end(), [](const dawn_native::Adapter adapter) -> bool {
+      wgpu::AdapterProperties properties;
+      adapter.GetProperties(&properties);
+      return properties.backendType == wgpu::BackendType::Null;
+    });
+    ASSERT_NE(adapterIt, adapters.end());
+
+    this->device = wgpu::Device::Acquire(adapterIt->CreateDevice());
+    this->queue = this->device.CreateQueue();
+  }
+
+  auto createDeck(std::shared_ptr<Deck::Props> props = std::make_shared<Deck::Props>()) -> std::shared_ptr<Deck> {
+    props->drawingOptions = std::make_shared<DrawingOptions>(this->device, this->queue);
+    return std::make_shared<Deck>(props);
+  }
+
+  /// \brief Creates a view of a texture that Deck can draw into.
+  auto createTextureView(uint32_t width, uint32_t height) -> wgpu::TextureView {
+    wgpu::TextureDescriptor descriptor;
+    descriptor.size.width = width;
+    descriptor.size.height = height;
+    descriptor.size.depth = 1;
+    descriptor.format = wgpu::TextureFormat::BGRA8Unorm;
+    descriptor.usage = wgpu::TextureUsage::OutputAttachment | wgpu::TextureUsage::Sampled;
+    return this->device.CreateTexture(&descriptor).CreateView();
+  }
+
+  wgpu::Device device;
+  wgpu::Queue queue;
+
+ private:
+  std::unique_ptr<dawn_native::Instance> _instance;
+};
+
+TEST_F(DeckNullBackendTest, PickObject) {
+  auto deck = this->createDeck();
+
+  // Nothing is drawn into the picking buffer without any pickable layers
+  EXPECT_FALSE(deck->pickObject(50, 50).has_value());
+  EXPECT_FALSE(deck->pickObject(50, 50, 5).has_value());
+
+  // Positions outside of the viewport can never be picked
+  EXPECT_FALSE(deck->pickObject(-1, 50).has_value());
+  EXPECT_FALSE(deck->pickObject(50, 100).has_value());
+
+  EXPECT_THROW(deck->pickObject(50, 50, -1), std::logic_error);
+
+  probegl::Error error;
+  EXPECT_FALSE(deck->pickObject(50, 50, -1, error).has_value());
+  EXPECT_TRUE(error.has_value());
+}
+
+/// \brief Returns a table of points at the origin, with radii counting up from firstRadius.
+auto makePoints(int count, float firstRadius) -> std::shared_ptr<arrow::Table> {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  arrow::FixedSizeListBuilder positionBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 3};
+  auto& positionValueBuilder = static_cast<arrow::FloatBuilder&>(*positionBuilder.value_builder());
+  arrow::FloatBuilder radiusBuilder;
+  std::vector<float> origin{0.0f, 0.0f, 0.0f};
+  for (auto i = 0; i < count; i++) {
+    EXPECT_TRUE(positionBuilder.Append().ok());
+    EXPECT_TRUE(positionValueBuilder.AppendValues(origin.data(), origin.size()).ok());
+    EXPECT_TRUE(radiusBuilder.Append(firstRadius + i).ok());
+  }
+
+  std::shared_ptr<arrow::Array> positions;
+  std::shared_ptr<arrow::Array> radii;
+  EXPECT_TRUE(positionBuilder.Finish(&positions).ok());
+  EXPECT_TRUE(radiusBuilder.Finish(&radii).ok());
+  auto schema = arrow::schema({arrow::field("position", positions->type()), arrow::field("radius", arrow::float32())});
+  return arrow::Table::Make(schema, {positions, radii});
+}
+
+TEST_F(DeckNullBackendTest, ReplacedDataIsUploaded) {
+  auto deck = this->createDeck();
+  WebMercatorViewport::Options viewportOptions;
+  viewportOptions.width = 100;
+  viewportOptions.height = 100;
+  deck->layerManager->activateViewport(std::make_shared<WebMercatorViewport>(viewportOptions));
+
+  std::vector<float> mappedRadii;
+  auto makeProps = [&]() {
+    auto props = std::make_shared<ScatterplotLayer::Props>();
+    props->id = "points";
+    props->getRadius = [&](const Row& row) {
+      mappedRadii.push_back(row.getFloat("radius"));
+      return mappedRadii.back();
+    };
+    return props;
+  };
+
+  auto props = makeProps();
+  props->data = makePoints(2, 1.0f);
+  auto layer = std::make_shared<ScatterplotLayer>(props);
+  deck->layerManager->addLayer(layer);
+  EXPECT_EQ(mappedRadii, (std::vector<float>{1.0f, 2.0f}));
+
+  // Positions, radius, fill color, line color and line width of each point
+  const uint64_t bytesPerPoint = (3 + 1 + 4 + 4 + 1) * sizeof(float);
+  auto& bytesUploaded = deck->stats()->get("Bytes Uploaded");
+  auto initialBytesUploaded = bytesUploaded.snapshot().count;
+
+  // Data loaded into new props replaces the previous data, and all the points are uploaded again
+  loadersgl::LoaderPool pool{1};
+  auto replacement = makePoints(5, 10.0f);
+  auto newProps = makeProps();
+  auto handle = pool.load([=](const loadersgl::CancellationToken&) { return replacement; });
+  newProps->pendingData = makePendingData(handle);
+  mappedRadii.clear();
+  deck->layerManager->setLayersFromProps({newProps});
+  handle->get();
+  deck->layerManager->updatePendingData();
+
+  EXPECT_EQ(layer->props()->data, replacement);
+  EXPECT_EQ(mappedRadii, (std::vector<float>{10.0f, 11.0f, 12.0f, 13.0f, 14.0f}));
+  EXPECT_EQ(bytesUploaded.snapshot().count - initialBytesUploaded, 5 * bytesPerPoint);
+}
+
+TEST_F(DeckNullBackendTest, PickingRedrawsOnlyAfterChanges) {
+  auto layerProps = std::make_shared<ScatterplotLayer::Props>();
+  layerProps->id = "points";
+  layerProps->pickable = true;
+  layerProps->data = makePoints(2, 1.0f);
+
+  auto props = std::make_shared<Deck::Props>();
+  props->layers = {layerProps};
+  props->views = {std::make_shared<MapView>()};
+  props->initialViewState = std::make_shared<ViewState>();
+  auto deck = this->createDeck(props);
+  auto textureView = this->createTextureView(100, 100);
+
+  // Layer models draw both on screen and into the picking buffer, but only draws on screen are counted in stats
+  auto layer = deck->layerManager->layers().front();
+  auto& drawCalls = deck->stats()->get("Draw Calls");
+  auto pickingDrawCount = [&]() {
+    uint64_t modelDrawCallCount = 0;
+    for (auto const& model : layer->models()) {
+      modelDrawCallCount += model->drawCallCount();
+    }
+    return modelDrawCallCount - drawCalls.snapshot().count;
+  };
+
+  deck->draw(textureView);
+  deck->pickObject(50, 50);
+  auto initialPickingDrawCount = pickingDrawCount();
+  EXPECT_GT(initialPickingDrawCount, 0u);
+
+  // Drawing frames without any changes keeps the picking buffer
+  deck->draw(textureView);
+  deck->draw(textureView);
+  deck->pickObject(50, 50);
+  EXPECT_EQ(pickingDrawCount(), initialPickingDrawCount);
+
+  // Layer changes make the next pick redraw the picking buffer
+  deck->layerManager->setNeedsRedraw("Test");
+  deck->draw(textureView);
+  deck->pickObject(50, 50);
+  EXPECT_EQ(pickingDrawCount(), 2 * initialPickingDrawCount);
+
+  // And so do viewport changes
+  auto viewState = std::make_shared<ViewState>();
+  viewState->zoom = 2.0;
+  deck->viewManager->setViewState(viewState);
+  deck->draw(textureView);
+  deck->pickObject(50, 50);
+  EXPECT_EQ(pickingDrawCount(), 3 * initialPickingDrawCount);
+}
+
+#endif
+
+}  // anonymous namespace
@@ -20,9 +20,14 @@
 
 #include "deck.gl/core/src/lib/layer-manager.h"
 
+#include <arrow/api.h>
 #include <gtest/gtest.h>
 
+#include <future>
 #include <memory>
+#include <string>
+
+#include "loaders.gl/core.h"
 
 using namespace deckgl;
 
@@ -34,4 +39,171 @@ TEST(LayerManager, Construct) {
   EXPECT_TRUE(layerManager != nullptr);
 }
 
+/// \brief Layer that reports a fixed amount of memory, and counts how many times it was asked to release caches.
+class MemoryUsageLayer : public Layer {
+ public:
+  MemoryUsageLayer(const std::string& id, uint64_t gpuBytes) : Layer{std::make_shared<Layer::Props>()} {
+    this->_props->id = id;
+    this->memoryUsage.gpuBytes = gpuBytes;
+    this->memoryUsage.cpuBytes = gpuBytes / 2;
+  }
+
+  auto getMemoryUsage() const -> MemoryUsage override {
+    this->usageCount++;
+    return this->memoryUsage;
+  }
+  void releaseCaches() override { this->releaseCount++; }
+
+  MemoryUsage memoryUsage;
+  mutable int usageCount{0};
+  int releaseCount{0};
+};
+
+TEST(LayerManager, MemoryUsage) {
+  auto context = std::make_shared<LayerContext>(nullptr, wgpu::Device{});
+  auto layerManager = std::make_shared<LayerManager>(context);
+  context->layerManager = layerManager;
+
+  auto layer1 = std::make_shared<MemoryUsageLayer>("layer-1", 1000);
+  auto layer2 = std::make_shared<MemoryUsageLayer>("layer-2", 3000);
+  layerManager->addLayer(layer1);
+  layerManager->addLayer(layer2);
+
+  auto usage = layerManager->updateMemoryUsage();
+  EXPECT_EQ(usage.gpuBytes, 4000u);
+  EXPECT_EQ(usage.cpuBytes, 2000u);
+  EXPECT_EQ(context->stats->get("GPU Memory", probegl::Stat::Type::GAUGE).snapshot().count, 4000u);
+  EXPECT_EQ(context->stats->get("Layer CPU Memory layer-2", probegl::Stat::Type::GAUGE).snapshot().count, 1500u);
+
+  // Usage isn't recomputed until layers change
+  usage = layerManager->updateMemoryUsage();
+  EXPECT_EQ(usage.gpuBytes, 4000u);
+  EXPECT_EQ(layer1->usageCount, 1);
+
+  // Caches are released for as long as the budget is exceeded, along with memory retained by the memory pool
+  uint8_t* buffer;
+  ASSERT_TRUE(context->memoryPool->Allocate(1024, &buffer).ok());
+  context->memoryPool->Free(buffer, 1024);
+  EXPECT_GT(context->memoryPool->usage().retainedBytes, 0);
+
+  layerManager->gpuMemoryBudget = 3500;
+  layerManager->updateMemoryUsage();
+  layerManager->updateMemoryUsage();
+  EXPECT_EQ(layer1->releaseCount, 2);
+  EXPECT_EQ(layer2->releaseCount, 2);
+  EXPECT_EQ(context->memoryPool->usage().retainedBytes, 0);
+
+  // Removed layers no longer report any memory, and their gauges and draw times are removed
+  context->recordLayerDrawTimes = true;
+  layer2->draw(wgpu::RenderPassEncoder{});
+  layerManager->removeLayer("layer-2");
+  usage = layerManager->updateMemoryUsage();
+  EXPECT_EQ(usage.gpuBytes, 1000u);
+  EXPECT_EQ(layer1->releaseCount, 2);
+  for (const auto& stat : context->stats->snapshot()) {
+    EXPECT_EQ(stat.name.find("layer-2"), std::string::npos);
+  }
+}
+
+/// \brief Layer that counts calls to its lifecycle methods.
+class LifecycleLayer : public Layer {
+ public:
+  explicit LifecycleLayer(const std::shared_ptr<Layer::Props>& props) : Layer{props} {}
+
+  void initializeState() override { this->initializeCount++; }
+  void updateState(const ChangeFlags& changeFlags, const std::shared_ptr<Layer::Props>& oldProps) override {
+    this->updateCount++;
+  }
+  void finalizeState() override { this->finalizeCount++; }
+
+  int initializeCount{0};
+  int updateCount{0};
+  int finalizeCount{0};
+};
+
+auto makeTable() -> std::shared_ptr<arrow::Table> {
+  arrow::DoubleBuilder builder;
+  EXPECT_TRUE(builder.Append(1.0).ok());
+
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder.Finish(&array).ok());
+  return arrow::Table::Make(arrow::schema({arrow::field("value", arrow::float64())}), {array});
+}
+
+TEST(LayerManager, PendingData) {
+  auto context = std::make_shared<LayerContext>(nullptr, wgpu::Device{});
+  auto layerManager = std::make_shared<LayerManager>(context);
+  context->layerManager = layerManager;
+  loadersgl::LoaderPool pool{2};
+
+  auto table = makeTable();
+  std::promise<void> loaded;
+  auto loadedFuture = loaded.get_future().share();
+  auto props = std::make_shared<Layer::Props>();
+  props->id = "loading";
+  auto loadedHandle = pool.load([=](const loadersgl::CancellationToken&) {
+    loadedFuture.wait();
+    return table;
+  });
+  props->pendingData = makePendingData(loadedHandle);
+  auto layer = std::make_shared<LifecycleLayer>(props);
+  layerManager->addLayer(layer);
+
+  // Layers without data wait for it to load before being initialized
+  layerManager->updatePendingData();
+  EXPECT_EQ(layer->initializeCount, 0);
+  EXPECT_EQ(layer->updateCount, 0);
+
+  loaded.set_value();
+  loadedHandle->get();
+  layerManager->updatePendingData();
+  EXPECT_EQ(layer->initializeCount, 1);
+  EXPECT_EQ(layer->updateCount, 1);
+  EXPECT_EQ(layer->props()->data, table);
+  EXPECT_EQ(layer->props()->pendingData, nullptr);
+
+  // Loads of removed layers are cancelled
+  std::promise<void> removed;
+  auto removedFuture = removed.get_future().share();
+  auto removedProps = std::make_shared<Layer::Props>();
+  removedProps->id = "removed";
+  auto handle = pool.load([=](const loadersgl::CancellationToken& token) {
+    removedFuture.wait();
+    EXPECT_TRUE(token.isCancelled());
+    return table;
+  });
+  removedProps->pendingData = makePendingData(handle);
+  auto removedLayer = std::make_shared<LifecycleLayer>(removedProps);
+  layerManager->addLayer(removedLayer);
+
+  layerManager->setLayersFromProps({props});
+  EXPECT_TRUE(handle->isCancelled());
+  EXPECT_EQ(removedLayer->finalizeCount, 0);
+  EXPECT_EQ(layerManager->layers().size(), 1u);
+  removed.set_value();
+  EXPECT_THROW(handle->get(), std::runtime_error);
+
+  // Loads superseded by new props of a layer are cancelled
+  std::promise<void> superseded;
+  auto supersededFuture = superseded.get_future().share();
+  auto supersededProps = std::make_shared<Layer::Props>();
+  supersededProps->id = "loading";
+  auto supersededHandle = pool.load([=](const loadersgl::CancellationToken& token) {
+    supersededFuture.wait();
+    EXPECT_TRUE(token.isCancelled());
+    return table;
+  });
+  supersededProps->pendingData = makePendingData(supersededHandle);
+  layerManager->setLayersFromProps({supersededProps});
+  EXPECT_FALSE(supersededHandle->isCancelled());
+
+  auto newProps = std::make_shared<Layer::Props>();
+  newProps->id = "loading";
+  newProps->data = table;
+  layerManager->setLayersFromProps({newProps});
+  EXPECT_TRUE(supersededHandle->isCancelled());
+  superseded.set_value();
+  EXPECT_THROW(supersededHandle->get(), std::runtime_error);
+}
+
 }  // namespace
@@ -39,7 +39,53 @@ TEST(Layer, Props) {
   auto properties = layerProps1->getProperties();
 
   EXPECT_TRUE(properties->hasProp("opacity"));
+  EXPECT_TRUE(properties->hasProp("pickable"));
   EXPECT_FALSE(properties->hasProp("radiusScale"));
 }
 
+/// \brief Layer without any models, so that it can be drawn without a device.
+class EmptyLayer : public Layer {
+ public:
+  EmptyLayer() : Layer{std::make_shared<Layer::Props>()} { this->_props->id = "empty"; }
+};
+
+TEST(Layer, PickingSkipsDrawStats) {
+  auto context = std::make_shared<LayerContext>(nullptr, wgpu::Device{});
+  context->recordLayerDrawTimes = true;
+  auto layer = std::make_shared<EmptyLayer>();
+  layer->initialize(context);
+
+  auto& drawTime = context->stats->get("Layer Draw Time empty", probegl::Stat::Type::TIMER);
+  layer->draw(wgpu::RenderPassEncoder{});
+  EXPECT_EQ(drawTime.snapshot().count, 1u);
+
+  auto stats = context->stats->snapshot();
+  layer->drawPicking(wgpu::RenderPassEncoder{});
+  auto pickingStats = context->stats->snapshot();
+  ASSERT_EQ(pickingStats.size(), stats.size());
+  for (size_t i = 0; i < stats.size(); ++i) {
+    EXPECT_EQ(pickingStats[i].name, stats[i].name);
+    EXPECT_EQ(pickingStats[i].count, stats[i].count) << stats[i].name;
+  }
+}
+
+TEST(Layer, DrawTimeFollowsLayerId) {
+  auto context = std::make_shared<LayerContext>(nullptr, wgpu::Device{});
+  auto layer = std::make_shared<EmptyLayer>();
+  layer->initialize(context);
+
+  // Draw times are only recorded when enabled
+  layer->draw(wgpu::RenderPassEncoder{});
+  context->recordLayerDrawTimes = true;
+  layer->draw(wgpu::RenderPassEncoder{});
+  EXPECT_EQ(context->stats->get("Layer Draw Time empty", probegl::Stat::Type::TIMER).snapshot().count, 1u);
+
+  auto props = std::make_shared<Layer::Props>();
+  props->id = "renamed";
+  layer->setProps(props);
+  layer->draw(wgpu::RenderPassEncoder{});
+  EXPECT_EQ(context->stats->get("Layer Draw Time empty", probegl::Stat::Type::TIMER).snapshot().count, 1u);
+  EXPECT_EQ(context->stats->get("Layer Draw Time renamed", probegl::Stat::Type::TIMER).snapshot().count, 1u);
+}
+
 }  // namespace
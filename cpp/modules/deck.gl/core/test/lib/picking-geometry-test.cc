@@ -0,0 +1,91 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "deck.gl/core/src/lib/picking-geometry.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace deckgl;
+
+namespace {
+
+using Point = PickingGeometry::Point;
+using Type = PickingGeometry::Type;
+
+TEST(PickingGeometry, Shapes) {
+  PickingGeometry geometry{Type::SEGMENTS};
+  geometry.vertices = {{0, 0}, {2, 1}, {-1, 3}, {1, -2}};
+  geometry.rows = {7, 7};
+
+  EXPECT_EQ(geometry.shapeCount(), 2u);
+  EXPECT_EQ(geometry.shapeRow(1), 7u);
+  EXPECT_EQ(geometry.shapeVertices(1)[0], (Point{-1, 3}));
+  EXPECT_EQ(geometry.shapeBounds(1), (PickingGeometry::Box{-1, -2, 1, 3}));
+  EXPECT_DOUBLE_EQ(geometry.maxSize(), 0.0);
+}
+
+TEST(PickingGeometry, SizePixels) {
+  PickingGeometry geometry{Type::POINTS};
+  geometry.sizeScale = 2.0;
+  geometry.sizeMinPixels = 1.0;
+  geometry.sizeMaxPixels = 10.0;
+
+  // Sizes in meters are scaled to pixels, and clamped afterwards
+  EXPECT_DOUBLE_EQ(geometry.sizePixels(4.0, 2.0), 4.0);
+  EXPECT_DOUBLE_EQ(geometry.sizePixels(0.1, 2.0), 1.0);
+  EXPECT_DOUBLE_EQ(geometry.sizePixels(40.0, 2.0), 10.0);
+
+  geometry.sizeInPixels = true;
+  EXPECT_DOUBLE_EQ(geometry.sizePixels(4.0, 2.0), 8.0);
+}
+
+TEST(PickingGeometry, PointDistance) {
+  Point point{3, 4};
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::POINTS, &point, {0, 0, 0, 0}), 5.0);
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::POINTS, &point, {0, 0, 3, 5}), 0.0);
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::POINTS, &point, {0, 0, 3, 1}), 3.0);
+}
+
+TEST(PickingGeometry, SegmentDistance) {
+  std::vector<Point> segment{{0, 0}, {10, 0}};
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::SEGMENTS, segment.data(), {5, 2, 5, 2}), 2.0);
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::SEGMENTS, segment.data(), {13, 4, 13, 4}), 5.0);
+
+  // Segment crossing the box without any of its endpoints being inside
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::SEGMENTS, segment.data(), {4, -1, 6, 1}), 0.0);
+  // Box corner closest to the segment
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::SEGMENTS, segment.data(), {4, 1, 6, 3}), 1.0);
+}
+
+TEST(PickingGeometry, TriangleDistance) {
+  std::vector<Point> triangle{{0, 0}, {10, 0}, {0, 10}};
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::TRIANGLES, triangle.data(), {2, 2, 2, 2}), 0.0);
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::TRIANGLES, triangle.data(), {-3, 5, -3, 5}), 3.0);
+  EXPECT_NEAR(PickingGeometry::distanceToBox(Type::TRIANGLES, triangle.data(), {6, 6, 6, 6}), std::sqrt(2.0), 1e-9);
+
+  // Triangle completely inside the box, and box completely inside the triangle
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::TRIANGLES, triangle.data(), {-1, -1, 11, 11}), 0.0);
+  EXPECT_DOUBLE_EQ(PickingGeometry::distanceToBox(Type::TRIANGLES, triangle.data(), {1, 1, 2, 2}), 0.0);
+}
+
+}  // namespace
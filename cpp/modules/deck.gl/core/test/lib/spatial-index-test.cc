@@ -0,0 +1,113 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "deck.gl/core/src/lib/spatial-index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+
+using namespace deckgl;
+
+namespace {
+
+TEST(SpatialIndex, Hilbert) {
+  // First order curve visits the quadrants in a U shape
+  EXPECT_EQ(SpatialIndex::hilbert(0, 0), 0u);
+  EXPECT_LT(SpatialIndex::hilbert(0, 0xFFFF), SpatialIndex::hilbert(0xFFFF, 0xFFFF));
+  EXPECT_LT(SpatialIndex::hilbert(0xFFFF, 0xFFFF), SpatialIndex::hilbert(0xFFFF, 0));
+}
+
+TEST(SpatialIndex, Morton) {
+  // Bits of x and y are interleaved, visiting the quadrants in a Z shape
+  EXPECT_EQ(SpatialIndex::morton(0, 0), 0u);
+  EXPECT_EQ(SpatialIndex::morton(1, 0), 1u);
+  EXPECT_EQ(SpatialIndex::morton(0, 1), 2u);
+  EXPECT_EQ(SpatialIndex::morton(3, 3), 15u);
+  EXPECT_EQ(SpatialIndex::morton(0xFFFF, 0xFFFF), 0xFFFFFFFFu);
+}
+
+TEST(SpatialIndex, CurveGrid) {
+  SpatialIndex::CurveGrid grid{{-10, 0, 10, 100}};
+
+  // Box centers are mapped onto the grid, with the bounds spanning all of it
+  EXPECT_EQ(grid.cell({-10, 0, -10, 0}), (std::array<uint32_t, 2>{0, 0}));
+  EXPECT_EQ(grid.cell({10, 100, 10, 100}), (std::array<uint32_t, 2>{0xFFFF, 0xFFFF}));
+  EXPECT_EQ(grid.cell({-10, 0, 10, 100}), (std::array<uint32_t, 2>{0x7FFF, 0x7FFF}));
+  EXPECT_EQ(grid.hilbert({10, 100, 10, 100}), SpatialIndex::hilbert(0xFFFF, 0xFFFF));
+  EXPECT_EQ(grid.morton({10, 100, 10, 100}), 0xFFFFFFFFu);
+
+  // Bounds without any extent map everything onto the first cell
+  SpatialIndex::CurveGrid pointGrid{{5, 5, 5, 5}};
+  EXPECT_EQ(pointGrid.cell({5, 5, 5, 5}), (std::array<uint32_t, 2>{0, 0}));
+}
+
+TEST(SpatialIndex, Search) {
+  // Points on a 100x100 grid
+  SpatialIndex index{10000, 8};
+  for (auto y = 0; y < 100; y++) {
+    for (auto x = 0; x < 100; x++) {
+      EXPECT_EQ(index.add(x, y, x, y), static_cast<uint32_t>(y * 100 + x));
+    }
+  }
+  index.finish();
+
+  auto bounds = index.bounds();
+  EXPECT_FLOAT_EQ(bounds[0], 0.0);
+  EXPECT_FLOAT_EQ(bounds[3], 99.0);
+
+  auto results = index.search(10.5, 20.5, 13.5, 22.5);
+  std::set<uint32_t> resultSet{results.begin(), results.end()};
+  std::set<uint32_t> expected{2111, 2112, 2113, 2211, 2212, 2213};
+  EXPECT_EQ(resultSet, expected);
+  EXPECT_EQ(results.size(), expected.size());
+
+  EXPECT_EQ(index.search(-10.0, -10.0, 200.0, 200.0).size(), 10000u);
+  EXPECT_TRUE(index.search(200.0, 200.0, 300.0, 300.0).empty());
+}
+
+TEST(SpatialIndex, SearchBoxes) {
+  SpatialIndex index{3};
+  index.add(0.0, 0.0, 10.0, 10.0);
+  index.add(20.0, 20.0, 30.0, 30.0);
+  index.add(5.0, 5.0, 25.0, 25.0);
+  index.finish();
+
+  auto results = index.search(12.0, 12.0, 14.0, 14.0);
+  EXPECT_EQ(results, std::vector<uint32_t>{2});
+
+  results = index.search(9.0, 9.0, 21.0, 21.0);
+  std::sort(results.begin(), results.end());
+  EXPECT_EQ(results, (std::vector<uint32_t>{0, 1, 2}));
+}
+
+TEST(SpatialIndex, Empty) {
+  SpatialIndex index{0};
+  index.finish();
+  EXPECT_TRUE(index.search(-1.0, -1.0, 1.0, 1.0).empty());
+
+  SpatialIndex unfinished{1};
+  EXPECT_THROW(unfinished.finish(), std::logic_error);
+}
+
+}  // namespace
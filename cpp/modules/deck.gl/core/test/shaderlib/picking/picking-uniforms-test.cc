@@ -0,0 +1,75 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "deck.gl/core/src/shaderlib/picking/picking-uniforms.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace deckgl;
+
+namespace {
+
+TEST(PickingUniforms, EncodeDecode) {
+  auto color = encodePickingColor(PickingIndex{2, 0x123456});
+  EXPECT_EQ(color[0], 0x57);
+  EXPECT_EQ(color[1], 0x34);
+  EXPECT_EQ(color[2], 0x12);
+  EXPECT_EQ(color[3], 3);
+
+  auto index = decodePickingColor(color.data());
+  ASSERT_TRUE(index.has_value());
+  EXPECT_EQ(index->layerIndex, 2u);
+  EXPECT_EQ(index->objectIndex, 0x123456u);
+
+  // Cleared picking buffer does not match any object
+  uint8_t cleared[4] = {0, 0, 0, 0};
+  EXPECT_FALSE(decodePickingColor(cleared).has_value());
+}
+
+TEST(PickingUniforms, FindClosest) {
+  // 5x3 region with rows padded to 32 bytes
+  uint32_t width = 5;
+  uint32_t height = 3;
+  uint32_t bytesPerRow = 32;
+  std::vector<uint8_t> pixels(bytesPerRow * height, 0);
+  EXPECT_FALSE(findClosestPickingIndex(pixels.data(), width, height, bytesPerRow, 2, 1).has_value());
+
+  auto setPixel = [&](uint32_t x, uint32_t y, const PickingIndex& index) {
+    auto color = encodePickingColor(index);
+    std::copy(color.begin(), color.end(), pixels.begin() + y * bytesPerRow + x * 4);
+  };
+  setPixel(0, 0, PickingIndex{0, 7});
+  setPixel(4, 1, PickingIndex{1, 9});
+
+  auto closest = findClosestPickingIndex(pixels.data(), width, height, bytesPerRow, 3, 1);
+  ASSERT_TRUE(closest.has_value());
+  EXPECT_EQ(closest->layerIndex, 1u);
+  EXPECT_EQ(closest->objectIndex, 9u);
+
+  closest = findClosestPickingIndex(pixels.data(), width, height, bytesPerRow, 1, 0);
+  ASSERT_TRUE(closest.has_value());
+  EXPECT_EQ(closest->layerIndex, 0u);
+  EXPECT_EQ(closest->objectIndex, 7u);
+}
+
+}  // anonymous namespace
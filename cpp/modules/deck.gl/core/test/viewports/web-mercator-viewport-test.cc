@@ -28,7 +28,7 @@ using namespace mathgl;
 using namespace deckgl;
 
 auto const LNGLAT_TOLERANCE = 1e-6;
-// auto const ALT_TOLERANCE = 1e-5;
+auto const ALT_TOLERANCE = 1e-5;
 auto const OFFSET_TOLERANCE = 1e-5;
 auto const ZOOM_TOLERANCE = 1e-6;
 
@@ -84,36 +84,34 @@ TEST_F(WebMercatorViewportTest, projectFlat) {
   }
 }
 
-// TODO(isaac@unfolded.ai): project/unproject not implemented
-// TEST_F(WebMercatorViewportTest, project3D) {
-//   for (auto viewport : TEST_VIEWPORTS) {
-//     const double TEST_OFFSETS[] = {0, 0.5, 1.0, 5.0};
-//     for (auto offset : TEST_OFFSETS) {
-//       auto lnglatIn3 = Vector3<double>(viewport.longitude + offset, viewport.latitude + offset, 0);
-//       auto xyz3 = viewport.project(lnglatIn3);
-//       auto lnglat3 = viewport.unproject(xyz3);
-
-//       EXPECT_NEAR(lnglatIn3.x, lnglat3.x, LNGLAT_TOLERANCE);
-//       EXPECT_NEAR(lnglatIn3.y, lnglat3.y, LNGLAT_TOLERANCE);
-//       EXPECT_NEAR(lnglatIn3.z, lnglat3.z, ALT_TOLERANCE);
-//     }
-//   }
-// }
-
-// TODO(isaac@unfolded.ai): project/unproject not implemented
-// TEST_F(WebMercatorViewportTest, project2D) {
-//   for (auto viewport : TEST_VIEWPORTS) {
-//     const double TEST_OFFSETS[] = {0, 0.5, 1.0, 5.0};
-//     for (auto offset : TEST_OFFSETS) {
-//       auto lnglatIn = Vector2<double>(viewport.longitude + offset, viewport.latitude + offset);
-//       auto xy = viewport.project(lnglatIn);
-//       auto lnglat = viewport.unproject(xy);
-
-//       EXPECT_NEAR(lnglatIn.x, lnglat.x, LNGLAT_TOLERANCE);
-//       EXPECT_NEAR(lnglatIn.y, lnglat.y, LNGLAT_TOLERANCE);
-//     }
-//   }
-// }
+TEST_F(WebMercatorViewportTest, project3D) {
+  for (auto viewport : TEST_VIEWPORTS) {
+    const double TEST_OFFSETS[] = {0, 0.5, 1.0, 5.0};
+    for (auto offset : TEST_OFFSETS) {
+      auto lnglatIn3 = Vector3<double>(viewport.longitude + offset, viewport.latitude + offset, 0);
+      auto xyz3 = viewport.project(lnglatIn3);
+      auto lnglat3 = viewport.unproject(xyz3);
+
+      EXPECT_NEAR(lnglatIn3.x, lnglat3.x, LNGLAT_TOLERANCE);
+      EXPECT_NEAR(lnglatIn3.y, lnglat3.y, LNGLAT_TOLERANCE);
+      EXPECT_NEAR(lnglatIn3.z, lnglat3.z, ALT_TOLERANCE);
+    }
+  }
+}
+
+TEST_F(WebMercatorViewportTest, project2D) {
+  for (auto viewport : TEST_VIEWPORTS) {
+    const double TEST_OFFSETS[] = {0, 0.5, 1.0, 5.0};
+    for (auto offset : TEST_OFFSETS) {
+      auto lnglatIn = Vector2<double>(viewport.longitude + offset, viewport.latitude + offset);
+      auto xy = viewport.project(lnglatIn);
+      auto lnglat = viewport.unproject(xy);
+
+      EXPECT_NEAR(lnglatIn.x, lnglat.x, LNGLAT_TOLERANCE);
+      EXPECT_NEAR(lnglatIn.y, lnglat.y, LNGLAT_TOLERANCE);
+    }
+  }
+}
 
 TEST_F(WebMercatorViewportTest, getScales) {
   for (auto viewport : TEST_VIEWPORTS) {
@@ -183,6 +181,41 @@ TEST_F(WebMercatorViewportTest, fitBounds) {
   }
 }
 
+TEST_F(WebMercatorViewportTest, getBounds) {
+  auto viewport = makeTestViewport(800, 600, 0, 0, 1, 0, 0);
+  auto bounds = viewport.getBounds();
+
+  // At zoom level 1 the world is 1024 pixels wide, meaning that 800 pixels cover 281.25 degrees of longitude
+  EXPECT_NEAR(bounds[0], -140.625, LNGLAT_TOLERANCE);
+  EXPECT_NEAR(bounds[2], 140.625, LNGLAT_TOLERANCE);
+  EXPECT_NEAR(bounds[1], -bounds[3], LNGLAT_TOLERANCE);
+  EXPECT_GT(bounds[3], 0.0);
+
+  auto paddedBounds = viewport.getBounds(100);
+  EXPECT_LT(paddedBounds[0], bounds[0]);
+  EXPECT_LT(paddedBounds[1], bounds[1]);
+  EXPECT_GT(paddedBounds[2], bounds[2]);
+  EXPECT_GT(paddedBounds[3], bounds[3]);
+
+  // Pitched viewport sees further towards the top of the screen. The bottom edge is tilted towards the camera, so it
+  // also reaches slightly further than without pitch, and matches the unprojected bottom corners
+  auto pitchedViewport = makeTestViewport(800, 600, 0, 0, 1, 45, 0);
+  auto pitchedBounds = pitchedViewport.getBounds();
+  EXPECT_GT(pitchedBounds[3], bounds[3]);
+  EXPECT_LT(pitchedBounds[1], bounds[1]);
+  EXPECT_NEAR(pitchedBounds[0], -pitchedBounds[2], LNGLAT_TOLERANCE);
+  auto bottomLeft = pitchedViewport.unproject(Vector2<double>(0, 600));
+  auto bottomRight = pitchedViewport.unproject(Vector2<double>(800, 600));
+  EXPECT_NEAR(pitchedBounds[1], bottomLeft.y, LNGLAT_TOLERANCE);
+  EXPECT_NEAR(bottomLeft.x, -bottomRight.x, LNGLAT_TOLERANCE);
+
+  // Rotating by 90 degrees swaps the extents
+  auto rotatedViewport = makeTestViewport(600, 800, 0, 0, 1, 0, 90);
+  auto rotatedBounds = rotatedViewport.getBounds();
+  EXPECT_NEAR(rotatedBounds[0], bounds[0], LNGLAT_TOLERANCE);
+  EXPECT_NEAR(rotatedBounds[2], bounds[2], LNGLAT_TOLERANCE);
+}
+
 // Ensures viewport matrix values are correct by comparing them to a known expected output.
 // Input and output values taken from web-based deck.gl Flight Paths example.
 TEST_F(WebMercatorViewportTest, FlightPathsMatrices) {
@@ -24,6 +24,7 @@
 #include <string>
 
 #include "deck.gl/core/src/shaderlib/misc/geometry.glsl.h"
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
 
 namespace {
 
@@ -37,13 +38,13 @@ layout(location = 0) out vec4 fragColor;
 void main(void) {
   geometry.uv = uv;
 
-  fragColor = vColor;
+  fragColor = picking_filterColor(vColor);
 }
 )GLSL";
 
 }  // anonymous namespace
 
 // NOLINTNEXTLINE(runtime/string)
-static const std::string fs = "#version 450\n" + geometryFS + "\n" + lineLayerFS;
+static const std::string fs = "#version 450\n" + geometryFS + "\n" + pickingFS + "\n" + lineLayerFS;
 
 #endif  // DECKGL_LAYERS_LINE_LAYER_FRAGMENT_H
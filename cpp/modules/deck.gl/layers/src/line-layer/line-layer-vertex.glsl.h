@@ -25,6 +25,7 @@
 
 #include "deck.gl/core/src/shaderlib/project/project32.glsl.h"
 #include "deck.gl/core/src/shaderlib/misc/geometry.glsl.h"
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
 
 namespace {
 
@@ -92,12 +93,15 @@ void main(void) {
   // Color
   vec4 normalizedInstanceColors = clamp(instanceColors, 0, 255) / 255.0;
   vColor = vec4(normalizedInstanceColors.rgb, normalizedInstanceColors.a * layerOptions.opacity);
+
+  picking_setPickingIndex(gl_InstanceIndex);
 }
 )GLSL";
 
 }  // anonymous namespace
 
 // NOLINTNEXTLINE(runtime/string)
-static const std::string vs = "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + lineLayerVS;
+static const std::string vs = "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + pickingVS + "\n" +
+                             lineLayerVS;
 
 #endif  // DECKGL_LAYERS_LINE_LAYER_VERTEX_H
@@ -22,6 +22,8 @@
 
 #include <arrow/builder.h>
 
+#include <algorithm>
+
 #include "./line-layer-fragment.glsl.h"
 #include "./line-layer-vertex.glsl.h"
 #include "deck.gl/core.h"
@@ -46,13 +48,31 @@ const std::vector<std::shared_ptr<Property>> propTypeDefs = {
         "widthMaxPixels",
         [](const JSONObject* props) { return dynamic_cast<const LineLayer::Props*>(props)->widthMaxPixels; },
         [](JSONObject* props, float value) { return dynamic_cast<LineLayer::Props*>(props)->widthMaxPixels = value; },
-        std::numeric_limits<float>::max())};
+        std::numeric_limits<float>::max()),
+    std::make_shared<PropertyT<bool>>(
+        "cullInstances",
+        [](const JSONObject* props) { return dynamic_cast<const LineLayer::Props*>(props)->cullInstances; },
+        [](JSONObject* props, bool value) { return dynamic_cast<LineLayer::Props*>(props)->cullInstances = value; },
+        false),
+    std::make_shared<PropertyT<SpatialOrder>>(
+        "spatialOrder",
+        [](const JSONObject* props) { return dynamic_cast<const LineLayer::Props*>(props)->spatialOrder; },
+        [](JSONObject* props, SpatialOrder value) {
+          return dynamic_cast<LineLayer::Props*>(props)->spatialOrder = value;
+        },
+        SpatialOrder::NONE)};
 
 auto LineLayer::Props::getProperties() const -> const std::shared_ptr<Properties> {
   static auto properties = Properties::from<LineLayer::Props>(propTypeDefs);
   return properties;
 }
 
+auto LineLayer::Props::getDataColumns(const std::shared_ptr<arrow::Table>& sample) const
+    -> std::vector<std::string> {
+  return ArrowMapper::getAccessedColumnNames(sample, this->getSourcePosition, this->getTargetPosition, this->getColor,
+                                             this->getWidth);
+}
+
 void LineLayer::initializeState() {
   // TODO(ilija@unfolded.ai): Revisit type once double precision is in place
   auto sourcePosition =
@@ -98,6 +118,8 @@ void LineLayer::updateState(const Layer::ChangeFlags& changeFlags, const std::sh
     this->_layerUniforms.SetSubData(0, sizeof(LineLayerUniforms), &layerUniforms);
   }
 
+  this->_updateCulling(changeFlags);
+
   /*
   if (changeFlags.extensionsChanged) {
     this->getAttributeManager().invalidateAll();
@@ -107,7 +129,23 @@ void LineLayer::updateState(const Layer::ChangeFlags& changeFlags, const std::sh
 
 void LineLayer::finalizeState() {}
 
+auto LineLayer::getMemoryUsage() const -> MemoryUsage {
+  auto memoryUsage = super::getMemoryUsage();
+  memoryUsage.gpuBytes += sizeof(LineLayerUniforms);
+  // Mapped attributes and the spatial index are only retained while culling or spatial ordering is enabled
+  memoryUsage.cpuBytes += getTableByteLength(this->_attributes);
+  memoryUsage.cpuBytes += this->_spatialIndex ? this->_spatialIndex->byteLength() : 0;
+  return memoryUsage;
+}
+
 void LineLayer::drawState(wgpu::RenderPassEncoder pass) {
+  if (!this->_attributes) {
+    this->_drawnInstanceCount = this->props()->data->num_rows();
+  }
+  if (this->_drawnInstanceCount == 0) {
+    return;
+  }
+
   for (auto const& model : this->models()) {
     // Layer uniforms are currently bound to index 1
     model->setUniformBuffer(1, this->_layerUniforms);
@@ -115,6 +153,129 @@ void LineLayer::drawState(wgpu::RenderPassEncoder pass) {
   }
 }
 
+auto LineLayer::getPickingGeometry() -> std::shared_ptr<PickingGeometry> {
+  auto props = std::dynamic_pointer_cast<LineLayer::Props>(this->props());
+  // Attributes mapped for culling are created by the same accessors, so they can be reused when available
+  auto attributes = this->_attributes ? this->_attributes : this->_attributeManager->map(props->data);
+
+  auto sourcePositions = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      attributes->GetColumnByName("instanceSourcePositions")->chunk(0));
+  auto targetPositions = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      attributes->GetColumnByName("instanceTargetPositions")->chunk(0));
+  auto sourceValues = std::static_pointer_cast<arrow::FloatArray>(sourcePositions->values())->raw_values();
+  auto targetValues = std::static_pointer_cast<arrow::FloatArray>(targetPositions->values())->raw_values();
+  auto widths = std::static_pointer_cast<arrow::FloatArray>(attributes->GetColumnByName("instanceWidths")->chunk(0));
+
+  // Lines extend by half of their width on each side
+  auto geometry = std::make_shared<PickingGeometry>(PickingGeometry::Type::SEGMENTS);
+  geometry->vertices.resize(sourcePositions->length() * 2);
+  geometry->sizes.resize(sourcePositions->length());
+  for (int64_t i = 0; i < sourcePositions->length(); ++i) {
+    auto source = sourceValues + sourcePositions->value_offset(i);
+    auto target = targetValues + targetPositions->value_offset(i);
+    geometry->vertices[i * 2] = {source[0], source[1]};
+    geometry->vertices[i * 2 + 1] = {target[0], target[1]};
+    geometry->sizes[i] = widths->Value(i) / 2;
+  }
+
+  geometry->sizeScale = props->widthScale;
+  geometry->sizeInPixels = props->widthUnits == "pixels";
+  geometry->sizeMinPixels = props->widthMinPixels / 2;
+  geometry->sizeMaxPixels = props->widthMaxPixels / 2;
+  return geometry;
+}
+
+void LineLayer::_updateCulling(const Layer::ChangeFlags& changeFlags) {
+  auto props = std::dynamic_pointer_cast<LineLayer::Props>(this->props());
+  // Per instance culling takes precedence over culling chunks of spatially sorted instances
+  auto spatialOrder = props->cullInstances ? SpatialOrder::NONE : props->spatialOrder;
+  if (!props->cullInstances && spatialOrder == SpatialOrder::NONE) {
+    auto wasCulled = static_cast<bool>(this->_attributes);
+    if (wasCulled) {
+      // Culling has just been disabled, upload all the instances again
+      this->_attributes = nullptr;
+      this->_spatialIndex = nullptr;
+      this->_spatialOrder = SpatialOrder::NONE;
+      this->_models = {this->_getModel(this->context->device)};
+    }
+
+    std::shared_ptr<garrow::Table> instancedAttributes;
+    if (changeFlags.dataAppendStartRow && !wasCulled) {
+      // Only rows appended to data need to be mapped and uploaded
+      instancedAttributes = this->_attributeManager->append(props->data, changeFlags.dataAppendStartRow.value());
+    } else if (changeFlags.dataChanged || wasCulled) {
+      // Data has been set for the first time or replaced, for example by a load that has completed
+      instancedAttributes = this->_attributeManager->update(props->data);
+    }
+    if (instancedAttributes) {
+      for (auto const& model : this->models()) {
+        model->setInstancedAttributes(instancedAttributes);
+      }
+    }
+    return;
+  }
+
+  if (changeFlags.dataChanged || !this->_attributes || spatialOrder != this->_spatialOrder) {
+    this->_attributes = this->_attributeManager->map(props->data);
+
+    auto sourcePositions = std::static_pointer_cast<arrow::FixedSizeListArray>(
+        this->_attributes->GetColumnByName("instanceSourcePositions")->chunk(0));
+    auto targetPositions = std::static_pointer_cast<arrow::FixedSizeListArray>(
+        this->_attributes->GetColumnByName("instanceTargetPositions")->chunk(0));
+    auto sourceValues = std::static_pointer_cast<arrow::FloatArray>(sourcePositions->values())->raw_values();
+    auto targetValues = std::static_pointer_cast<arrow::FloatArray>(targetPositions->values())->raw_values();
+    auto widths = this->_attributes->GetColumnByName("instanceWidths")->chunk(0);
+    auto widthValues = std::static_pointer_cast<arrow::FloatArray>(widths);
+
+    // Lines are indexed by their extents, and the query is padded by the widest line instead
+    std::vector<SpatialIndex::Box> boxes(sourcePositions->length());
+    this->_maxInstanceWidth = 0.0;
+    for (int64_t i = 0; i < sourcePositions->length(); ++i) {
+      auto source = sourceValues + sourcePositions->value_offset(i);
+      auto target = targetValues + targetPositions->value_offset(i);
+      boxes[i] = {std::min(source[0], target[0]), std::min(source[1], target[1]), std::max(source[0], target[0]),
+                  std::max(source[1], target[1])};
+      this->_maxInstanceWidth = std::max(this->_maxInstanceWidth, widthValues->Value(i));
+    }
+
+    if (props->cullInstances) {
+      this->_spatialIndex = std::make_shared<SpatialIndex>(boxes.size());
+      for (auto const& box : boxes) {
+        this->_spatialIndex->add(box[0], box[1], box[2], box[3]);
+      }
+      this->_spatialIndex->finish();
+
+      // Instances are uploaded once, viewport changes only change which ranges of them are drawn
+      auto instancedAttributes = this->_attributeManager->upload(this->_attributes);
+      for (auto const& model : this->models()) {
+        model->setInstancedAttributes(instancedAttributes);
+      }
+    } else {
+      this->_spatialIndex = nullptr;
+      auto sortedAttributes = this->_attributeManager->uploadSorted(this->_attributes, boxes, spatialOrder);
+      for (auto const& model : this->models()) {
+        model->setInstancedAttributes(sortedAttributes);
+      }
+    }
+    this->_spatialOrder = spatialOrder;
+  }
+
+  if (changeFlags.dataChanged || changeFlags.propsChanged || changeFlags.viewportChanged) {
+    // Width is specified in meters or pixels, but clamped to a range in pixels by the shader
+    double widthPixels = this->_maxInstanceWidth * props->widthScale;
+    widthPixels /= props->widthUnits == "pixels" ? 1.0 : this->context->viewport->metersPerPixel();
+    widthPixels = std::clamp(widthPixels, static_cast<double>(props->widthMinPixels),
+                             static_cast<double>(std::max(props->widthMinPixels, props->widthMaxPixels)));
+
+    auto paddingPixels = widthPixels / 2;
+    auto visibleRanges = this->_spatialIndex ? this->_cullInstances(*this->_spatialIndex, paddingPixels)
+                                             : this->_cullChunks(paddingPixels);
+    for (auto const& model : this->models()) {
+      model->setInstanceRanges(visibleRanges);
+    }
+  }
+}
+
 auto LineLayer::_getModel(wgpu::Device device) -> std::shared_ptr<lumagl::Model> {
   std::vector<std::shared_ptr<garrow::Field>> attributeFields{
       std::make_shared<garrow::Field>("positions", wgpu::VertexFormat::Float3)};
@@ -132,7 +293,8 @@ auto LineLayer::_getModel(wgpu::Device device) -> std::shared_ptr<lumagl::Model>
                                      fs,
                                      attributeSchema,
                                      instancedAttributeSchema,
-                                     {UniformDescriptor{}, UniformDescriptor{}},
+                                     {UniformDescriptor{}, UniformDescriptor{},
+                                      UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}},
                                      wgpu::PrimitiveTopology::TriangleStrip};
   auto model = std::make_shared<lumagl::Model>(device, modelOptions);
 
@@ -148,8 +310,7 @@ auto LineLayer::_getModel(wgpu::Device device) -> std::shared_ptr<lumagl::Model>
       std::make_shared<garrow::Array>(this->context->device, positionData, wgpu::BufferUsage::Vertex)};
   model->setAttributes(std::make_shared<garrow::Table>(attributeSchema, attributeArrays));
 
-  auto instancedAttributes = this->_attributeManager->update(this->props()->data);
-  model->setInstancedAttributes(instancedAttributes);
+  // Instances are uploaded by _updateCulling(), as they are or once they have been indexed or spatially sorted
 
   return model;
 }
@@ -160,7 +321,7 @@ auto LineLayer::getSourcePositionData(const std::shared_ptr<arrow::Table>& table
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector3FloatColumn(table, props->getSourcePosition);
+  return ArrowMapper::mapVector3FloatColumn(table, props->getSourcePosition, this->_memoryPool());
 }
 
 auto LineLayer::getTargetPositionData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -169,7 +330,7 @@ auto LineLayer::getTargetPositionData(const std::shared_ptr<arrow::Table>& table
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector3FloatColumn(table, props->getTargetPosition);
+  return ArrowMapper::mapVector3FloatColumn(table, props->getTargetPosition, this->_memoryPool());
 }
 
 auto LineLayer::getColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -178,7 +339,7 @@ auto LineLayer::getColorData(const std::shared_ptr<arrow::Table>& table) -> std:
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector4FloatColumn(table, props->getColor);
+  return ArrowMapper::mapVector4FloatColumn(table, props->getColor, this->_memoryPool());
 }
 
 auto LineLayer::getWidthData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -187,5 +348,5 @@ auto LineLayer::getWidthData(const std::shared_ptr<arrow::Table>& table) -> std:
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapFloatColumn(table, props->getWidth);
+  return ArrowMapper::mapFloatColumn(table, props->getWidth, this->_memoryPool());
 }
@@ -48,6 +48,9 @@ class LineLayer : public Layer {
   auto getColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getWidthData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
 
+  auto getPickingGeometry() -> std::shared_ptr<PickingGeometry> override;
+  auto getMemoryUsage() const -> MemoryUsage override;
+
  protected:
   void initializeState() override;
   void updateState(const Layer::ChangeFlags&, const std::shared_ptr<Layer::Props>& oldProps) override;
@@ -56,8 +59,17 @@ class LineLayer : public Layer {
 
  private:
   auto _getModel(wgpu::Device) -> std::shared_ptr<lumagl::Model>;
+  /// \brief Updates culling state, and the ranges of instances that are drawn in the current viewport.
+  void _updateCulling(const Layer::ChangeFlags& changeFlags);
 
   wgpu::Buffer _layerUniforms;
+
+  /// Mapped attributes and a spatial index over line extents, only kept around when culling is enabled
+  std::shared_ptr<arrow::Table> _attributes;
+  std::shared_ptr<SpatialIndex> _spatialIndex;
+  /// Space filling curve that uploaded instances are currently ordered along
+  SpatialOrder _spatialOrder{SpatialOrder::NONE};
+  float _maxInstanceWidth{0.0};
 };
 
 /// \brief A set of properties that describe a LineLayer.
@@ -78,6 +90,16 @@ class LineLayer::Props : public Layer::Props {
   /// \brief Maximum width of the line, in pixels.
   float widthMaxPixels{std::numeric_limits<float>::max()};
 
+  /// \brief Specifies whether lines outside of the viewport should be culled before drawing.
+  /// Speeds up drawing when only a small part of the data is visible, at the cost of indexing data when it changes.
+  bool cullInstances{false};
+
+  /// \brief Space filling curve to reorder lines along when data changes, if any. Named "hilbert", "morton" or "none"
+  /// in JSON.
+  /// Sorted lines are drawn in chunks, and chunks outside of the viewport are skipped without re-uploading any data.
+  /// Ignored when cullInstances is enabled.
+  SpatialOrder spatialOrder{SpatialOrder::NONE};
+
   /// Property accessors
   std::function<ArrowMapper::Vector3FloatAccessor> getSourcePosition{
       [](const Row& row) { return row.getVector3<float>("sourcePosition"); }};
@@ -87,6 +109,8 @@ class LineLayer::Props : public Layer::Props {
       [](const Row&) { return mathgl::Vector4<float>(0.0, 0.0, 0.0, 255.0); }};
   std::function<ArrowMapper::FloatAccessor> getWidth{[](const Row&) { return 1.0; }};
 
+  auto getDataColumns(const std::shared_ptr<arrow::Table>& sample) const -> std::vector<std::string> override;
+
   // Property Type Machinery
   static constexpr const char* getTypeName() { return "LineLayer"; }
   auto getProperties() const -> const std::shared_ptr<Properties> override;
@@ -24,6 +24,7 @@
 #include <string>
 
 #include "deck.gl/core/src/shaderlib/misc/geometry.glsl.h"
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
 
 namespace {
 
@@ -76,12 +77,13 @@ void main(void) {
   }
 
   fragColor.a *= inCircle;
+  fragColor = picking_filterColor(fragColor);
 }
 )GLSL";
 
 }  // anonymous namespace
 
 // NOLINTNEXTLINE(runtime/string)
-static const std::string fs = "#version 450\n" + geometryFS + "\n" + scatterplotLayerFS;
+static const std::string fs = "#version 450\n" + geometryFS + "\n" + pickingFS + "\n" + scatterplotLayerFS;
 
 #endif  // DECKGL_LAYERS_SCATTERPLOT_LAYER_FRAGMENT_H
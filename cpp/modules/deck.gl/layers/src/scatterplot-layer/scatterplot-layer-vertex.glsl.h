@@ -25,6 +25,7 @@
 
 #include "deck.gl/core/src/shaderlib/project/project32.glsl.h"
 #include "deck.gl/core/src/shaderlib/misc/geometry.glsl.h"
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
 
 namespace {
 
@@ -46,7 +47,15 @@ layout(location = 0) in vec3 positions;
 
 layout(location = 1) in vec3 instancePositions;
 layout(location = 2) in float instanceRadius;
+#ifdef CATEGORICAL_FILL_COLORS
+layout(std140, set = 0, binding = 3) uniform ScatterplotLayerFillColorPalette {
+  vec4 colors[256];
+} fillColorPalette;
+
+layout(location = 3) in uint instanceFillColorCategories;
+#else
 layout(location = 3) in vec4 instanceFillColors;
+#endif
 layout(location = 4) in vec4 instanceLineColors;
 layout(location = 5) in float instanceLineWidths;
 
@@ -86,17 +95,30 @@ void main(void) {
   vec3 offset = positions * project_pixel_size(outerRadiusPixels);
   gl_Position = project_position_to_clipspace(instancePositions, instancePositions64Low, offset, geometry.position);
 
+#ifdef CATEGORICAL_FILL_COLORS
+  // Categories that don't fit into the palette, and null categories, use the fallback color in its last entry
+  vec4 instanceFillColors = fillColorPalette.colors[min(instanceFillColorCategories, 255u)];
+#endif
+
   // Apply opacity to instance color, or return instance picking color, then normalize the values
   vec4 normalizedFillColors = clamp(instanceFillColors, 0, 255) / 255.0;
   vFillColor = vec4(normalizedFillColors.rgb, normalizedFillColors.a * layerOptions.opacity);
   vec4 normalizedLineColors = clamp(instanceLineColors, 0, 255) / 255.0;
   vLineColor = vec4(normalizedLineColors.rgb, normalizedLineColors.a * layerOptions.opacity);
+
+  picking_setPickingIndex(gl_InstanceIndex);
 }
 )GLSL";
 
 }  // anonymous namespace
 
 // NOLINTNEXTLINE(runtime/string)
-static const std::string vs = "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + scatterplotLayerVS;
+static const std::string vs = "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + pickingVS + "\n" +
+                             scatterplotLayerVS;
+
+/// Variant that looks fill colors up in a palette by the category of each instance
+// NOLINTNEXTLINE(runtime/string)
+static const std::string categoricalFillColorsVS = "#version 450\n#define CATEGORICAL_FILL_COLORS\n" + geometryVS +
+                                                  "\n" + project32VS + "\n" + pickingVS + "\n" + scatterplotLayerVS;
 
 #endif  // DECKGL_LAYERS_SCATTERPLOT_LAYER_VERTEX_H
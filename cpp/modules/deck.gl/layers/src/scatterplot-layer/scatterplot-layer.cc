@@ -20,6 +20,8 @@
 
 #include "./scatterplot-layer.h"  // NOLINT(build/include)
 
+#include <algorithm>
+
 #include "./scatterplot-layer-fragment.glsl.h"
 #include "./scatterplot-layer-vertex.glsl.h"
 
@@ -84,13 +86,51 @@ const std::vector<std::shared_ptr<Property>> propTypeDefs = {
         [](JSONObject* props, float value) {
           return dynamic_cast<ScatterplotLayer::Props*>(props)->radiusMaxPixels = value;
         },
-        std::numeric_limits<float>::max())};
+        std::numeric_limits<float>::max()),
+    std::make_shared<PropertyT<bool>>(
+        "cullInstances",
+        [](const JSONObject* props) { return dynamic_cast<const ScatterplotLayer::Props*>(props)->cullInstances; },
+        [](JSONObject* props, bool value) {
+          return dynamic_cast<ScatterplotLayer::Props*>(props)->cullInstances = value;
+        },
+        false),
+    std::make_shared<PropertyT<SpatialOrder>>(
+        "spatialOrder",
+        [](const JSONObject* props) { return dynamic_cast<const ScatterplotLayer::Props*>(props)->spatialOrder; },
+        [](JSONObject* props, SpatialOrder value) {
+          return dynamic_cast<ScatterplotLayer::Props*>(props)->spatialOrder = value;
+        },
+        SpatialOrder::NONE),
+    std::make_shared<PropertyT<std::string>>(
+        "fillColorCategoryColumn",
+        [](const JSONObject* props) {
+          return dynamic_cast<const ScatterplotLayer::Props*>(props)->fillColorCategoryColumn;
+        },
+        [](JSONObject* props, std::string value) {
+          return dynamic_cast<ScatterplotLayer::Props*>(props)->fillColorCategoryColumn = value;
+        },
+        "")};
 
 auto ScatterplotLayer::Props::getProperties() const -> const std::shared_ptr<Properties> {
   static auto properties = Properties::from<ScatterplotLayer::Props>(propTypeDefs);
   return properties;
 }
 
+auto ScatterplotLayer::Props::getDataColumns(const std::shared_ptr<arrow::Table>& sample) const
+    -> std::vector<std::string> {
+  // Categorical fill colors are read from a column directly, without calling getFillColor
+  auto categorical = !this->fillColorCategoryColumn.empty();
+  auto getFillColor = categorical ? decltype(this->getFillColor){} : this->getFillColor;
+  auto columns = ArrowMapper::getAccessedColumnNames(sample, this->getPosition, this->getRadius, getFillColor,
+                                                     this->getLineColor, this->getLineWidth);
+  if (categorical && sample && sample->GetColumnByName(this->fillColorCategoryColumn) &&
+      std::find(columns.begin(), columns.end(), this->fillColorCategoryColumn) == columns.end()) {
+    columns.push_back(this->fillColorCategoryColumn);
+  }
+
+  return columns;
+}
+
 void ScatterplotLayer::initializeState() {
   // TODO(ilija@unfolded.ai): Revisit type once double precision is in place
   auto position = std::make_shared<arrow::Field>("instancePositions", arrow::fixed_size_list(arrow::float32(), 3));
@@ -101,9 +141,22 @@ void ScatterplotLayer::initializeState() {
   auto getRadius = [this](const std::shared_ptr<arrow::Table>& table) { return this->getRadiusData(table); };
   this->_attributeManager->add(garrow::ColumnBuilder{radius, getRadius});
 
-  auto fillColor = std::make_shared<arrow::Field>("instanceFillColors", arrow::fixed_size_list(arrow::float32(), 4));
-  auto getFillColor = [this](const std::shared_ptr<arrow::Table>& table) { return this->getFillColorData(table); };
-  this->_attributeManager->add(garrow::ColumnBuilder{fillColor, getFillColor});
+  auto props = std::dynamic_pointer_cast<ScatterplotLayer::Props>(this->props());
+  if (props->fillColorCategoryColumn.empty()) {
+    auto fillColor =
+        std::make_shared<arrow::Field>("instanceFillColors", arrow::fixed_size_list(arrow::float32(), 4));
+    auto getFillColor = [this](const std::shared_ptr<arrow::Table>& table) { return this->getFillColorData(table); };
+    this->_attributeManager->add(garrow::ColumnBuilder{fillColor, getFillColor});
+  } else {
+    // Instances only hold a category index, colors are looked up in the palette by the vertex shader
+    auto fillColorCategory = std::make_shared<arrow::Field>("instanceFillColorCategories", arrow::uint32());
+    auto getFillColorCategory = [this](const std::shared_ptr<arrow::Table>& table) {
+      return this->getFillColorCategoryData(table);
+    };
+    this->_attributeManager->add(garrow::ColumnBuilder{fillColorCategory, getFillColorCategory});
+    this->_fillColorPalette = utils::createBuffer(this->context->device, sizeof(ScatterplotLayerFillColorPalette),
+                                                  wgpu::BufferUsage::Uniform);
+  }
 
   auto lineColor = std::make_shared<arrow::Field>("instanceLineColors", arrow::fixed_size_list(arrow::float32(), 4));
   auto getLineColor = [this](const std::shared_ptr<arrow::Table>& table) { return this->getLineColorData(table); };
@@ -140,6 +193,17 @@ void ScatterplotLayer::updateState(const Layer::ChangeFlags& changeFlags,
     this->_layerUniforms.SetSubData(0, sizeof(ScatterplotLayerUniforms), &uniforms);
   }
 
+  // Replaced data is mapped again from its own categories, appended data keeps the indices of existing categories
+  if (changeFlags.dataChanged && !changeFlags.dataAppendStartRow) {
+    this->_fillColorCategories.clear();
+  }
+  this->_updateCulling(changeFlags);
+
+  // Restyling categories only rewrites the palette, data changes may have added categories to it
+  if (this->_fillColorPalette && (changeFlags.dataChanged || changeFlags.propsChanged)) {
+    this->_updateFillColorPalette();
+  }
+
   /*
   if (changeFlags.extensionsChanged) {
     this->getAttributeManager().invalidateAll();
@@ -149,21 +213,165 @@ void ScatterplotLayer::updateState(const Layer::ChangeFlags& changeFlags,
 
 void ScatterplotLayer::finalizeState() {}
 
+auto ScatterplotLayer::getMemoryUsage() const -> MemoryUsage {
+  auto memoryUsage = super::getMemoryUsage();
+  memoryUsage.gpuBytes += sizeof(ScatterplotLayerUniforms);
+  memoryUsage.gpuBytes += this->_fillColorPalette ? sizeof(ScatterplotLayerFillColorPalette) : 0;
+  // Mapped attributes and the spatial index are only retained while culling or spatial ordering is enabled
+  memoryUsage.cpuBytes += getTableByteLength(this->_attributes);
+  memoryUsage.cpuBytes += this->_spatialIndex ? this->_spatialIndex->byteLength() : 0;
+  return memoryUsage;
+}
+
 void ScatterplotLayer::drawState(wgpu::RenderPassEncoder pass) {
+  if (!this->_attributes) {
+    this->_drawnInstanceCount = this->props()->data->num_rows();
+  }
+  if (this->_drawnInstanceCount == 0) {
+    return;
+  }
+
   for (auto const& model : this->models()) {
     // Layer uniforms are currently bound to index 1
     model->setUniformBuffer(1, this->_layerUniforms);
+    if (this->_fillColorPalette) {
+      model->setUniformBuffer(3, this->_fillColorPalette);
+    }
     model->draw(pass);
   }
 }
 
+auto ScatterplotLayer::getPickingGeometry() -> std::shared_ptr<PickingGeometry> {
+  auto props = std::dynamic_pointer_cast<ScatterplotLayer::Props>(this->props());
+  // Attributes mapped for culling are created by the same accessors, so they can be reused when available
+  auto attributes = this->_attributes ? this->_attributes : this->_attributeManager->map(props->data);
+
+  auto positions =
+      std::static_pointer_cast<arrow::FixedSizeListArray>(attributes->GetColumnByName("instancePositions")->chunk(0));
+  auto positionValues = std::static_pointer_cast<arrow::FloatArray>(positions->values())->raw_values();
+  auto radii = std::static_pointer_cast<arrow::FloatArray>(attributes->GetColumnByName("instanceRadius")->chunk(0));
+
+  // Points are picked by their radius only, strokes are not taken into account
+  auto geometry = std::make_shared<PickingGeometry>(PickingGeometry::Type::POINTS);
+  geometry->vertices.resize(positions->length());
+  geometry->sizes.resize(positions->length());
+  for (int64_t i = 0; i < positions->length(); ++i) {
+    auto position = positionValues + positions->value_offset(i);
+    geometry->vertices[i] = {position[0], position[1]};
+    geometry->sizes[i] = radii->Value(i);
+  }
+
+  geometry->sizeScale = props->radiusScale;
+  geometry->sizeMinPixels = props->radiusMinPixels;
+  geometry->sizeMaxPixels = props->radiusMaxPixels;
+  return geometry;
+}
+
+void ScatterplotLayer::_updateCulling(const Layer::ChangeFlags& changeFlags) {
+  auto props = std::dynamic_pointer_cast<ScatterplotLayer::Props>(this->props());
+  // Per instance culling takes precedence over culling chunks of spatially sorted instances
+  auto spatialOrder = props->cullInstances ? SpatialOrder::NONE : props->spatialOrder;
+  if (!props->cullInstances && spatialOrder == SpatialOrder::NONE) {
+    auto wasCulled = static_cast<bool>(this->_attributes);
+    if (wasCulled) {
+      // Culling has just been disabled, upload all the instances again
+      this->_attributes = nullptr;
+      this->_spatialIndex = nullptr;
+      this->_spatialOrder = SpatialOrder::NONE;
+      this->_models = {this->_getModel(this->context->device)};
+    }
+
+    std::shared_ptr<garrow::Table> instancedAttributes;
+    if (changeFlags.dataAppendStartRow && !wasCulled) {
+      // Only rows appended to data need to be mapped and uploaded
+      instancedAttributes = this->_attributeManager->append(props->data, changeFlags.dataAppendStartRow.value());
+    } else if (changeFlags.dataChanged || wasCulled) {
+      // Data has been set for the first time or replaced, for example by a load that has completed
+      instancedAttributes = this->_attributeManager->update(props->data);
+    }
+    if (instancedAttributes) {
+      for (auto const& model : this->models()) {
+        model->setInstancedAttributes(instancedAttributes);
+      }
+    }
+    return;
+  }
+
+  if (changeFlags.dataChanged || !this->_attributes || spatialOrder != this->_spatialOrder) {
+    this->_attributes = this->_attributeManager->map(props->data);
+
+    auto positions = std::static_pointer_cast<arrow::FixedSizeListArray>(
+        this->_attributes->GetColumnByName("instancePositions")->chunk(0));
+    auto positionValues = std::static_pointer_cast<arrow::FloatArray>(positions->values())->raw_values();
+    auto radii = this->_attributes->GetColumnByName("instanceRadius")->chunk(0);
+    auto lineWidths = this->_attributes->GetColumnByName("instanceLineWidths")->chunk(0);
+    auto radiusValues = std::static_pointer_cast<arrow::FloatArray>(radii);
+    auto lineWidthValues = std::static_pointer_cast<arrow::FloatArray>(lineWidths);
+
+    // Points are indexed as they are, and the query is padded by the largest point size instead
+    std::vector<SpatialIndex::Box> boxes(positions->length());
+    this->_maxInstanceRadius = 0.0;
+    this->_maxInstanceLineWidth = 0.0;
+    for (int64_t i = 0; i < positions->length(); ++i) {
+      auto position = positionValues + positions->value_offset(i);
+      boxes[i] = {position[0], position[1], position[0], position[1]};
+      this->_maxInstanceRadius = std::max(this->_maxInstanceRadius, radiusValues->Value(i));
+      this->_maxInstanceLineWidth = std::max(this->_maxInstanceLineWidth, lineWidthValues->Value(i));
+    }
+
+    if (props->cullInstances) {
+      this->_spatialIndex = std::make_shared<SpatialIndex>(boxes.size());
+      for (auto const& box : boxes) {
+        this->_spatialIndex->add(box[0], box[1], box[2], box[3]);
+      }
+      this->_spatialIndex->finish();
+
+      // Instances are uploaded once, viewport changes only change which ranges of them are drawn
+      auto instancedAttributes = this->_attributeManager->upload(this->_attributes);
+      for (auto const& model : this->models()) {
+        model->setInstancedAttributes(instancedAttributes);
+      }
+    } else {
+      this->_spatialIndex = nullptr;
+      auto sortedAttributes = this->_attributeManager->uploadSorted(this->_attributes, boxes, spatialOrder);
+      for (auto const& model : this->models()) {
+        model->setInstancedAttributes(sortedAttributes);
+      }
+    }
+    this->_spatialOrder = spatialOrder;
+  }
+
+  if (changeFlags.dataChanged || changeFlags.propsChanged || changeFlags.viewportChanged) {
+    // Sizes are specified in meters or pixels, but clamped to a range in pixels by the shader
+    auto metersPerPixel = this->context->viewport->metersPerPixel();
+    double radiusPixels = this->_maxInstanceRadius * props->radiusScale / metersPerPixel;
+    radiusPixels = std::clamp(radiusPixels, static_cast<double>(props->radiusMinPixels),
+                              static_cast<double>(std::max(props->radiusMinPixels, props->radiusMaxPixels)));
+
+    double lineWidthPixels = 0.0;
+    if (props->stroked) {
+      lineWidthPixels = this->_maxInstanceLineWidth * props->lineWidthScale;
+      lineWidthPixels /= props->lineWidthUnits == "pixels" ? 1.0 : metersPerPixel;
+      lineWidthPixels = std::clamp(lineWidthPixels, static_cast<double>(props->lineWidthMinPixels),
+                                   static_cast<double>(std::max(props->lineWidthMinPixels, props->lineWidthMaxPixels)));
+    }
+
+    auto paddingPixels = radiusPixels + lineWidthPixels / 2;
+    auto visibleRanges = this->_spatialIndex ? this->_cullInstances(*this->_spatialIndex, paddingPixels)
+                                             : this->_cullChunks(paddingPixels);
+    for (auto const& model : this->models()) {
+      model->setInstanceRanges(visibleRanges);
+    }
+  }
+}
+
 auto ScatterplotLayer::getPositionData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
   auto props = std::dynamic_pointer_cast<ScatterplotLayer::Props>(this->props());
   if (!props) {
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector3FloatColumn(table, props->getPosition);
+  return ArrowMapper::mapVector3FloatColumn(table, props->getPosition, this->_memoryPool());
 }
 
 auto ScatterplotLayer::getRadiusData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -172,7 +380,7 @@ auto ScatterplotLayer::getRadiusData(const std::shared_ptr<arrow::Table>& table)
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapFloatColumn(table, props->getRadius);
+  return ArrowMapper::mapFloatColumn(table, props->getRadius, this->_memoryPool());
 }
 
 auto ScatterplotLayer::getFillColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -181,7 +389,18 @@ auto ScatterplotLayer::getFillColorData(const std::shared_ptr<arrow::Table>& tab
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector4FloatColumn(table, props->getFillColor);
+  return ArrowMapper::mapVector4FloatColumn(table, props->getFillColor, this->_memoryPool());
+}
+
+auto ScatterplotLayer::getFillColorCategoryData(const std::shared_ptr<arrow::Table>& table)
+    -> std::shared_ptr<arrow::Array> {
+  auto props = std::dynamic_pointer_cast<ScatterplotLayer::Props>(this->props());
+  if (!props) {
+    throw std::logic_error("Invalid layer properties");
+  }
+
+  return ArrowMapper::mapCategoryColumn(table, props->fillColorCategoryColumn, this->_fillColorCategories,
+                                        this->_memoryPool());
 }
 
 auto ScatterplotLayer::getLineColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -190,7 +409,7 @@ auto ScatterplotLayer::getLineColorData(const std::shared_ptr<arrow::Table>& tab
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector4FloatColumn(table, props->getLineColor);
+  return ArrowMapper::mapVector4FloatColumn(table, props->getLineColor, this->_memoryPool());
 }
 
 auto ScatterplotLayer::getLineWidthData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -199,7 +418,28 @@ auto ScatterplotLayer::getLineWidthData(const std::shared_ptr<arrow::Table>& tab
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapFloatColumn(table, props->getLineWidth);
+  return ArrowMapper::mapFloatColumn(table, props->getLineWidth, this->_memoryPool());
+}
+
+void ScatterplotLayer::_updateFillColorPalette() {
+  auto props = std::dynamic_pointer_cast<ScatterplotLayer::Props>(this->props());
+  auto toColor = [](const mathgl::Vector4<float>& color) {
+    return std::array<float, 4>{color.x, color.y, color.z, color.w};
+  };
+
+  // Instances whose category doesn't fit into the palette are clamped to its last entry by the shader
+  ScatterplotLayerFillColorPalette palette;
+  palette.colors.fill(toColor(props->fillColorPaletteFallback));
+  const auto& categories = this->_fillColorCategories.values();
+  auto categoryCount = std::min(categories.size(), static_cast<size_t>(kMaxFillColorCategories - 1));
+  for (size_t i = 0; i < categoryCount; ++i) {
+    auto color = props->fillColorPalette.find(categories[i]);
+    if (color != props->fillColorPalette.end()) {
+      palette.colors[i] = toColor(color->second);
+    }
+  }
+
+  this->_fillColorPalette.SetSubData(0, sizeof(ScatterplotLayerFillColorPalette), &palette);
 }
 
 auto ScatterplotLayer::_getModel(wgpu::Device device) -> std::shared_ptr<lumagl::Model> {
@@ -207,19 +447,32 @@ auto ScatterplotLayer::_getModel(wgpu::Device device) -> std::shared_ptr<lumagl:
       std::make_shared<garrow::Field>("positions", wgpu::VertexFormat::Float3)};
   auto attributeSchema = std::make_shared<lumagl::garrow::Schema>(attributeFields);
 
+  auto categorical = static_cast<bool>(this->_fillColorPalette);
+
   // TODO(ilija@unfolded.ai): **arrow**::Fields are already being specified in initializeState, consolidate?
+  auto fillColor = categorical
+                       ? std::make_shared<garrow::Field>("instanceFillColorCategories", wgpu::VertexFormat::UInt)
+                       : std::make_shared<garrow::Field>("instanceFillColors", wgpu::VertexFormat::Float4);
   std::vector<std::shared_ptr<garrow::Field>> instancedFields{
       std::make_shared<garrow::Field>("instancePositions", wgpu::VertexFormat::Float3),
-      std::make_shared<garrow::Field>("instanceRadius", wgpu::VertexFormat::Float),
-      std::make_shared<garrow::Field>("instanceFillColors", wgpu::VertexFormat::Float4),
+      std::make_shared<garrow::Field>("instanceRadius", wgpu::VertexFormat::Float), fillColor,
       std::make_shared<garrow::Field>("instanceLineColors", wgpu::VertexFormat::Float4),
       std::make_shared<garrow::Field>("instanceLineWidths", wgpu::VertexFormat::Float)};
   auto instancedAttributeSchema = std::make_shared<lumagl::garrow::Schema>(instancedFields);
 
   std::vector<UniformDescriptor> uniforms = {
-      UniformDescriptor{}, UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}};
-  auto modelOptions = Model::Options{
-      vs, fs, attributeSchema, instancedAttributeSchema, uniforms, wgpu::PrimitiveTopology::TriangleStrip};
+      UniformDescriptor{}, UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment},
+      UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}};
+  if (categorical) {
+    // Fill color palette is bound to index 3
+    uniforms.push_back(UniformDescriptor{wgpu::ShaderStage::Vertex});
+  }
+  auto modelOptions = Model::Options{categorical ? categoricalFillColorsVS : vs,
+                                     fs,
+                                     attributeSchema,
+                                     instancedAttributeSchema,
+                                     uniforms,
+                                     wgpu::PrimitiveTopology::TriangleStrip};
   auto model = std::make_shared<lumagl::Model>(device, modelOptions);
 
   // a square that minimally cover the unit circle
@@ -238,8 +491,7 @@ auto ScatterplotLayer::_getModel(wgpu::Device device) -> std::shared_ptr<lumagl:
       std::make_shared<garrow::Array>(this->context->device, positionData, wgpu::BufferUsage::Vertex)};
   model->setAttributes(std::make_shared<garrow::Table>(attributeSchema, attributeArrays));
 
-  auto instancedAttributes = this->_attributeManager->update(this->props()->data);
-  model->setInstancedAttributes(instancedAttributes);
+  // Instances are uploaded by _updateCulling(), as they are or once they have been indexed or spatially sorted
 
   return model;
 }
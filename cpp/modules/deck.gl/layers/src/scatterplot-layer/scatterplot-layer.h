@@ -21,7 +21,9 @@
 #ifndef DECKGL_LAYERS_SCATTERPLOT_LAYER_H
 #define DECKGL_LAYERS_SCATTERPLOT_LAYER_H
 
+#include <array>
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -44,9 +46,13 @@ class ScatterplotLayer : public Layer {
   auto getPositionData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getRadiusData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getFillColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
+  auto getFillColorCategoryData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getLineColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getLineWidthData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
 
+  auto getPickingGeometry() -> std::shared_ptr<PickingGeometry> override;
+  auto getMemoryUsage() const -> MemoryUsage override;
+
  protected:
   void initializeState() override;
   void updateState(const ChangeFlags&, const std::shared_ptr<Layer::Props>& oldProps) override;
@@ -55,8 +61,24 @@ class ScatterplotLayer : public Layer {
 
  private:
   auto _getModel(wgpu::Device device) -> std::shared_ptr<lumagl::Model>;
+  /// \brief Updates culling state, and the ranges of instances that are drawn in the current viewport.
+  void _updateCulling(const ChangeFlags& changeFlags);
+  /// \brief Writes the fill color of each category seen so far into the palette uniform buffer.
+  void _updateFillColorPalette();
 
   wgpu::Buffer _layerUniforms;
+
+  /// Categories that instances are filled by, and their colors, only used when categorical fill colors are enabled
+  Categories _fillColorCategories;
+  wgpu::Buffer _fillColorPalette;
+
+  /// Mapped attributes and a spatial index over instance positions, only kept around when culling is enabled
+  std::shared_ptr<arrow::Table> _attributes;
+  std::shared_ptr<SpatialIndex> _spatialIndex;
+  /// Space filling curve that uploaded instances are currently ordered along
+  SpatialOrder _spatialOrder{SpatialOrder::NONE};
+  float _maxInstanceRadius{0.0};
+  float _maxInstanceLineWidth{0.0};
 };
 
 /// \brief A set of properties that describe a ScatterplotLayer.
@@ -92,6 +114,29 @@ class ScatterplotLayer::Props : public Layer::Props {
   /// \brief Maximum radius of the point, in pixels.
   float radiusMaxPixels{std::numeric_limits<float>::max()};
 
+  /// \brief Specifies whether points outside of the viewport should be culled before drawing.
+  /// Speeds up drawing when only a small part of the data is visible, at the cost of indexing data when it changes.
+  bool cullInstances{false};
+
+  /// \brief Space filling curve to reorder points along when data changes, if any. Named "hilbert", "morton" or "none"
+  /// in JSON.
+  /// Sorted points are drawn in chunks, and chunks outside of the viewport are skipped without re-uploading any data.
+  /// Ignored when cullInstances is enabled.
+  SpatialOrder spatialOrder{SpatialOrder::NONE};
+
+  /// \brief Name of a column holding categories, such as a dictionary encoded string column, that fill colors are
+  /// looked up by in fillColorPalette instead of calling getFillColor.
+  /// Points then only upload a category index, and changing the palette doesn't map nor upload any points again.
+  /// \note Categorical fill colors are enabled or disabled when the layer is initialized.
+  std::string fillColorCategoryColumn;
+
+  /// \brief Fill color of each category, used when fillColorCategoryColumn is set.
+  std::map<std::string, mathgl::Vector4<float>> fillColorPalette;
+
+  /// \brief Fill color of points whose category is null, missing from fillColorPalette, or isn't among the first
+  /// kMaxFillColorCategories - 1 categories of the data.
+  mathgl::Vector4<float> fillColorPaletteFallback{0.0, 0.0, 0.0, 255.0};
+
   /// Property accessors
   std::function<ArrowMapper::Vector3FloatAccessor> getPosition{
       [](const Row& row) { return row.getVector3<float>("position"); }};
@@ -102,6 +147,8 @@ class ScatterplotLayer::Props : public Layer::Props {
       [](const Row&) { return mathgl::Vector4<float>(0.0, 0.0, 0.0, 255.0); }};
   std::function<ArrowMapper::FloatAccessor> getLineWidth{[](auto row) { return 1.0; }};
 
+  auto getDataColumns(const std::shared_ptr<arrow::Table>& sample) const -> std::vector<std::string> override;
+
   // Property Type Machinery
   static constexpr const char* getTypeName() { return "ScatterplotLayer"; }
   auto getProperties() const -> const std::shared_ptr<Properties> override;
@@ -125,6 +172,14 @@ struct ScatterplotLayerUniforms {
   alignas(4) bool filled;
 };
 
+/// \brief Number of entries of the fill color palette, the last of which holds the fallback color.
+static constexpr uint32_t kMaxFillColorCategories = 256;
+
+/// \brief Fill color of each category, mapped to a std140 array of vec4 in GLSL.
+struct ScatterplotLayerFillColorPalette {
+  std::array<std::array<float, 4>, kMaxFillColorCategories> colors;
+};
+
 }  // namespace deckgl
 
 #endif  // DECKGL_LAYERS_SCATTERPLOT_LAYER_H
@@ -0,0 +1,250 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./polygon-lod.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "deck.gl/core/src/lib/earcut.hpp"
+
+using namespace deckgl;
+
+namespace {
+
+/// \brief Squared distance between point p and a segment defined by points a and b.
+auto squaredSegmentDistance(const PolygonLOD::Point& p, const PolygonLOD::Point& a, const PolygonLOD::Point& b)
+    -> double {
+  double x = a[0];
+  double y = a[1];
+  double dx = static_cast<double>(b[0]) - x;
+  double dy = static_cast<double>(b[1]) - y;
+
+  if (dx != 0.0 || dy != 0.0) {
+    double t = ((p[0] - x) * dx + (p[1] - y) * dy) / (dx * dx + dy * dy);
+    if (t > 1.0) {
+      x = b[0];
+      y = b[1];
+    } else if (t > 0.0) {
+      x += dx * t;
+      y += dy * t;
+    }
+  }
+
+  dx = p[0] - x;
+  dy = p[1] - y;
+  return dx * dx + dy * dy;
+}
+
+}  // anonymous namespace
+
+PolygonLOD::PolygonLOD(std::vector<Point> points, std::vector<Polygon> polygons, const Options& options)
+    : _points{std::move(points)}, _polygons{std::move(polygons)}, _options{options} {
+  this->_levels.resize(static_cast<size_t>(std::max(options.levels, 1)));
+}
+
+void PolygonLOD::build() {
+  // Build the coarsest level right away, as it's the cheapest one to tessellate
+  auto coarsestLevel = this->levelCount() - 1;
+  std::promise<std::vector<uint32_t>> coarsestIndices;
+  coarsestIndices.set_value(this->tessellate(coarsestLevel));
+  this->_levels[coarsestLevel] = coarsestIndices.get_future().share();
+
+  for (size_t level = 0; level < coarsestLevel; ++level) {
+    this->_levels[level] = std::async(std::launch::async, [this, level]() { return this->tessellate(level); }).share();
+  }
+}
+
+auto PolygonLOD::levelDegreesPerPixel(size_t level) const -> double {
+  if (level == 0) {
+    return 0.0;
+  }
+
+  // Web mercator world is 512 pixels wide at zoom 0, and doubles in size with each zoom level
+  auto zoom = this->_options.maxZoom - this->_options.zoomStep * static_cast<double>(level - 1);
+  return 360.0 / (512.0 * std::pow(2.0, zoom));
+}
+
+auto PolygonLOD::selectLevel(double degreesPerPixel) const -> size_t {
+  for (auto level = this->levelCount() - 1; level > 0; --level) {
+    if (this->levelDegreesPerPixel(level) <= degreesPerPixel) {
+      return level;
+    }
+  }
+
+  return 0;
+}
+
+auto PolygonLOD::closestReadyLevel(size_t level) const -> std::optional<size_t> {
+  level = std::min(level, this->levelCount() - 1);
+  for (auto coarser = level; coarser < this->levelCount(); ++coarser) {
+    if (this->isReady(coarser)) {
+      return coarser;
+    }
+  }
+  for (auto finer = level; finer > 0; --finer) {
+    if (this->isReady(finer - 1)) {
+      return finer - 1;
+    }
+  }
+
+  return std::nullopt;
+}
+
+auto PolygonLOD::isReady(size_t level) const -> bool {
+  auto& indices = this->_levels.at(level);
+  return indices.valid() && indices.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+auto PolygonLOD::byteLength() const -> uint64_t {
+  uint64_t byteLength = this->_points.capacity() * sizeof(Point) + this->_polygons.capacity() * sizeof(Polygon);
+  for (size_t level = 0; level < this->levelCount(); ++level) {
+    // Levels that are still being built are skipped rather than waited on
+    if (this->isReady(level)) {
+      byteLength += this->_levels[level].get().capacity() * sizeof(uint32_t);
+    }
+  }
+
+  return byteLength;
+}
+
+auto PolygonLOD::indices(size_t level) const -> const std::vector<uint32_t>& {
+  auto& indices = this->_levels.at(level);
+  if (!indices.valid()) {
+    throw std::logic_error("Polygon levels of detail have not been built");
+  }
+
+  return indices.get();
+}
+
+auto PolygonLOD::tessellate(size_t level) const -> std::vector<uint32_t> {
+  auto degreesPerPixel = this->levelDegreesPerPixel(level);
+  auto tolerance = this->_options.tolerancePixels * degreesPerPixel;
+  auto minArea = this->_options.minPixelArea * degreesPerPixel * degreesPerPixel;
+
+  std::vector<uint32_t> indices;
+  indices.reserve(level == 0 ? this->_points.size() * 3 : this->_polygons.size() * 6);
+
+  std::vector<uint32_t> retained;
+  std::vector<std::vector<Point>> rings{1};
+  for (const auto& polygon : this->_polygons) {
+    if (level == 0) {
+      // Full resolution, every point is retained
+      retained.resize(polygon.length);
+      for (uint32_t i = 0; i < polygon.length; ++i) {
+        retained[i] = i;
+      }
+    } else {
+      if (PolygonLOD::ringArea(this->_points, polygon) < minArea) {
+        continue;
+      }
+
+      retained = PolygonLOD::simplifyRing(this->_points, polygon, tolerance);
+      if (retained.size() < 3) {
+        continue;
+      }
+    }
+
+    auto& ring = rings[0];
+    ring.clear();
+    for (auto index : retained) {
+      ring.push_back(this->_points[polygon.offset + index]);
+    }
+
+    // Map tessellated indices back to the original point list
+    for (auto index : mapbox::earcut<uint32_t>(rings)) {
+      indices.push_back(polygon.offset + retained[index]);
+    }
+  }
+
+  return indices;
+}
+
+auto PolygonLOD::simplifyRing(const std::vector<Point>& points, const Polygon& polygon, double tolerance)
+    -> std::vector<uint32_t> {
+  auto length = polygon.length;
+  auto first = points.begin() + polygon.offset;
+
+  // Closed rings repeat the first point at the end, which would otherwise degenerate the initial segment
+  if (length > 1 && first[0] == first[length - 1]) {
+    length--;
+  }
+
+  std::vector<uint32_t> retained;
+  if (length <= 3) {
+    for (uint32_t i = 0; i < length; ++i) {
+      retained.push_back(i);
+    }
+    return retained;
+  }
+
+  auto squaredTolerance = tolerance * tolerance;
+  std::vector<bool> keep(length, false);
+  keep[0] = true;
+  keep[length - 1] = true;
+
+  // Iterative Douglas-Peucker, avoiding recursion depth issues with large rings
+  std::vector<std::pair<uint32_t, uint32_t>> segments{{0, length - 1}};
+  while (!segments.empty()) {
+    auto [start, end] = segments.back();
+    segments.pop_back();
+
+    double maxDistance = 0.0;
+    uint32_t maxIndex = start;
+    for (auto i = start + 1; i < end; ++i) {
+      auto distance = squaredSegmentDistance(first[i], first[start], first[end]);
+      if (distance > maxDistance) {
+        maxDistance = distance;
+        maxIndex = i;
+      }
+    }
+
+    if (maxDistance > squaredTolerance) {
+      keep[maxIndex] = true;
+      segments.push_back({start, maxIndex});
+      segments.push_back({maxIndex, end});
+    }
+  }
+
+  for (uint32_t i = 0; i < length; ++i) {
+    if (keep[i]) {
+      retained.push_back(i);
+    }
+  }
+
+  return retained;
+}
+
+auto PolygonLOD::ringArea(const std::vector<Point>& points, const Polygon& polygon) -> double {
+  if (polygon.length < 3) {
+    return 0.0;
+  }
+
+  double area = 0.0;
+  auto first = points.begin() + polygon.offset;
+  for (uint32_t i = 0, j = polygon.length - 1; i < polygon.length; j = i++) {
+    area += (static_cast<double>(first[j][0]) - first[i][0]) * (static_cast<double>(first[j][1]) + first[i][1]);
+  }
+
+  return std::abs(area) / 2.0;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DECKGL_LAYERS_SOLIDPOLYGON_POLYGON_LOD_H
+#define DECKGL_LAYERS_SOLIDPOLYGON_POLYGON_LOD_H
+
+#include <array>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <vector>
+
+namespace deckgl {
+
+/// \brief Precomputes simplified versions of polygon geometry, so that cheaper index buffers can be drawn at lower
+/// zoom levels. Level 0 always contains full resolution geometry, while each subsequent level is simplified for a zoom
+/// level that is `zoomStep` lower than the previous one. Simplified rings only reference a subset of the original
+/// points, meaning that all the levels share the same vertex attributes and only differ in their indices.
+class PolygonLOD {
+ public:
+  using Point = std::array<float, 2>;
+
+  /// \brief Options that control how polygon levels of detail are built.
+  struct Options {
+    /// \brief Number of levels to build, including the full resolution one.
+    int levels{4};
+    /// \brief Zoom level the first simplified level is built for. Full resolution geometry is used above it.
+    double maxZoom{12.0};
+    /// \brief Difference in zoom level between two consecutive simplified levels.
+    double zoomStep{2.0};
+    /// \brief Maximum distance between simplified and original rings, in pixels.
+    double tolerancePixels{1.0};
+    /// \brief Polygons with a smaller area than this, in pixels, are dropped from simplified levels.
+    double minPixelArea{1.0};
+  };
+
+  /// \brief Range of points within the flattened point list that make up a single polygon ring.
+  struct Polygon {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  PolygonLOD(std::vector<Point> points, std::vector<Polygon> polygons, const Options& options);
+
+  PolygonLOD(const PolygonLOD&) = delete;
+  auto operator=(const PolygonLOD&) -> PolygonLOD& = delete;
+
+  /// \brief Starts tessellating all the levels. The coarsest level is built synchronously so that there is something
+  /// to draw as soon as this returns, while the remaining levels are built in parallel in the background.
+  void build();
+
+  /// \brief Returns the number of levels, including the full resolution one.
+  auto levelCount() const -> size_t { return this->_levels.size(); }
+
+  /// \brief Returns the size of a pixel, in degrees, that the given level has been simplified for.
+  /// \param level Level to get the pixel size for.
+  auto levelDegreesPerPixel(size_t level) const -> double;
+
+  /// \brief Selects the coarsest level whose simplification error stays within tolerance at the given pixel size.
+  /// \param degreesPerPixel Size of a pixel in degrees, at the current zoom level.
+  auto selectLevel(double degreesPerPixel) const -> size_t;
+
+  /// \brief Finds the level closest to the given one whose indices have been built, preferring coarser levels.
+  /// \param level Preferred level.
+  /// \return Closest level that is ready to be drawn, or nullopt if build() hasn't been called.
+  auto closestReadyLevel(size_t level) const -> std::optional<size_t>;
+
+  /// \brief Checks whether indices for the given level have been built.
+  auto isReady(size_t level) const -> bool;
+
+  /// \brief Returns the amount of memory held by source geometry and levels that have been built so far, in bytes.
+  auto byteLength() const -> uint64_t;
+
+  /// \brief Returns triangle indices for the given level, blocking until they've been built.
+  /// \throw Throws an exception if build() hasn't been called.
+  auto indices(size_t level) const -> const std::vector<uint32_t>&;
+
+  /// \brief Tessellates all the polygons for a given level.
+  /// \return Triangle indices, referencing the original (flattened) point list.
+  auto tessellate(size_t level) const -> std::vector<uint32_t>;
+
+  /// \brief Simplifies a ring using the Douglas-Peucker algorithm.
+  /// \param points Flattened point list.
+  /// \param polygon Range of the ring within points.
+  /// \param tolerance Maximum distance between the simplified and original ring, in point units.
+  /// \return Indices of retained points, relative to polygon.offset.
+  static auto simplifyRing(const std::vector<Point>& points, const Polygon& polygon, double tolerance)
+      -> std::vector<uint32_t>;
+
+  /// \brief Calculates the unsigned area of a ring using the shoelace formula, in squared point units.
+  static auto ringArea(const std::vector<Point>& points, const Polygon& polygon) -> double;
+
+ private:
+  std::vector<Point> _points;
+  std::vector<Polygon> _polygons;
+  Options _options;
+
+  // NOTE: Declared last so that it gets destroyed first, blocking until any background work referencing this finishes
+  std::vector<std::shared_future<std::vector<uint32_t>>> _levels;
+};
+
+}  // namespace deckgl
+
+#endif  // DECKGL_LAYERS_SOLIDPOLYGON_POLYGON_LOD_H
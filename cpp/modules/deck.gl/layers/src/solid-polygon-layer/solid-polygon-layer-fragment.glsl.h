@@ -23,6 +23,8 @@
 
 #include <string>
 
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
+
 namespace {
 
 // NOLINTNEXTLINE(runtime/string)
@@ -43,13 +45,13 @@ void main(void) {
   if (isValid < 0.5) {
     discard;
   }
-  fragColor = vColor;
+  fragColor = picking_filterColor(vColor);
 }
 
 )GLSL";
 
 // NOLINTNEXTLINE(runtime/string)
-static const std::string fs = "#version 450\n" + solidPolygonLayerFS;
+static const std::string fs = "#version 450\n" + pickingFS + "\n" + solidPolygonLayerFS;
 
 }  // anonymous namespace
 
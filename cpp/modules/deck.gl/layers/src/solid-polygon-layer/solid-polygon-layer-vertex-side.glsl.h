@@ -27,6 +27,7 @@
 #include "deck.gl/core/src/shaderlib/project/project32.glsl.h"
 #include "deck.gl/core/src/shaderlib/lighting/phong-lighting.glsl.h"
 #include "deck.gl/core/src/shaderlib/misc/geometry.glsl.h"
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
 
 namespace {
 
@@ -58,6 +59,8 @@ static const std::string solidPolygonLayerVSS2 = R"GLSL(
     props.nextPositions = nextPositions;
     props.nextPositions64Low = nextPositions64Low;
     calculatePosition(props);
+    // Side instances are created from data rows, so instance indices are also polygon indices
+    picking_setPickingIndex(gl_InstanceIndex);
   }
 )GLSL";
 
@@ -65,7 +68,8 @@ static const std::string solidPolygonLayerVSS2 = R"GLSL(
 static const std::string solidPolygonLayerVSS = solidPolygonLayerVSS1 + solidPolygonLayerVSM + solidPolygonLayerVSS2;
 // NOLINTNEXTLINE(runtime/string)
 static const std::string vss =
-    "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + phongLighting + "\n" + solidPolygonLayerVSS;
+    "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + phongLighting + "\n" + pickingVS + "\n" +
+    solidPolygonLayerVSS;
 
 }  // anonymous namespace
 
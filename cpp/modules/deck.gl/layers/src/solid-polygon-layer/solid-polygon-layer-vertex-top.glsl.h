@@ -27,6 +27,7 @@
 #include "deck.gl/core/src/shaderlib/project/project32.glsl.h"
 #include "deck.gl/core/src/shaderlib/lighting/phong-lighting.glsl.h"
 #include "deck.gl/core/src/shaderlib/misc/geometry.glsl.h"
+#include "deck.gl/core/src/shaderlib/picking/picking.glsl.h"
 
 namespace {
 
@@ -36,6 +37,7 @@ static const std::string solidPolygonLayerVST1 = R"GLSL(
   layout(location = 3) in float elevations;
   layout(location = 4) in vec4 fillColors;
   layout(location = 5) in vec4 lineColors;
+  layout(location = 6) in float polygonIndices;
 
   // TODO(ilija@unfolded.ai): Revisit once double splitting is in place
   vec3 positions64Low = vec3(0.);
@@ -52,6 +54,7 @@ static const std::string solidPolygonLayerVST2 = R"GLSL(
     props.fillColors = fillColors;
     props.lineColors = lineColors;
     calculatePosition(props);
+    picking_setPickingIndex(int(polygonIndices));
   }
 )GLSL";
 
@@ -59,7 +62,8 @@ static const std::string solidPolygonLayerVST2 = R"GLSL(
 static const std::string solidPolygonLayerVST = solidPolygonLayerVST1 + solidPolygonLayerVSM + solidPolygonLayerVST2;
 // NOLINTNEXTLINE(runtime/string
 static const std::string vst =
-    "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + phongLighting + "\n" + solidPolygonLayerVST;
+    "#version 450\n" + geometryVS + "\n" + project32VS + "\n" + phongLighting + "\n" + pickingVS + "\n" +
+    solidPolygonLayerVST;
 
 }  // anonymous namespace
 
@@ -20,6 +20,9 @@
 
 #include "./solid-polygon-layer.h"  // NOLINT(build/include)
 
+#include <algorithm>
+#include <utility>
+
 #include "./solid-polygon-layer-fragment.glsl.h"
 #include "./solid-polygon-layer-vertex-main.glsl.h"
 #include "./solid-polygon-layer-vertex-side.glsl.h"
@@ -41,6 +44,38 @@ const std::vector<std::shared_ptr<Property>> propTypeDefs = {
         [](JSONObject* props, float value) {
           return dynamic_cast<SolidPolygonLayer::Props*>(props)->elevationScale = value;
         },
+        1.0),
+    std::make_shared<PropertyT<bool>>(
+        "lod", [](const JSONObject* props) { return dynamic_cast<const SolidPolygonLayer::Props*>(props)->lod; },
+        [](JSONObject* props, bool value) { return dynamic_cast<SolidPolygonLayer::Props*>(props)->lod = value; },
+        false),
+    std::make_shared<PropertyT<int>>(
+        "lodLevels",
+        [](const JSONObject* props) { return dynamic_cast<const SolidPolygonLayer::Props*>(props)->lodLevels; },
+        [](JSONObject* props, int value) { return dynamic_cast<SolidPolygonLayer::Props*>(props)->lodLevels = value; },
+        4),
+    std::make_shared<PropertyT<float>>(
+        "lodMaxZoom",
+        [](const JSONObject* props) { return dynamic_cast<const SolidPolygonLayer::Props*>(props)->lodMaxZoom; },
+        [](JSONObject* props, float value) {
+          return dynamic_cast<SolidPolygonLayer::Props*>(props)->lodMaxZoom = value;
+        },
+        12.0),
+    std::make_shared<PropertyT<float>>(
+        "lodTolerancePixels",
+        [](const JSONObject* props) {
+          return dynamic_cast<const SolidPolygonLayer::Props*>(props)->lodTolerancePixels;
+        },
+        [](JSONObject* props, float value) {
+          return dynamic_cast<SolidPolygonLayer::Props*>(props)->lodTolerancePixels = value;
+        },
+        1.0),
+    std::make_shared<PropertyT<float>>(
+        "lodMinPixelArea",
+        [](const JSONObject* props) { return dynamic_cast<const SolidPolygonLayer::Props*>(props)->lodMinPixelArea; },
+        [](JSONObject* props, float value) {
+          return dynamic_cast<SolidPolygonLayer::Props*>(props)->lodMinPixelArea = value;
+        },
         1.0)};
 
 auto SolidPolygonLayer::Props::getProperties() const -> const std::shared_ptr<Properties> {
@@ -48,6 +83,12 @@ auto SolidPolygonLayer::Props::getProperties() const -> const std::shared_ptr<Pr
   return properties;
 }
 
+auto SolidPolygonLayer::Props::getDataColumns(const std::shared_ptr<arrow::Table>& sample) const
+    -> std::vector<std::string> {
+  return ArrowMapper::getAccessedColumnNames(sample, this->getPolygon, this->getElevation, this->getFillColor,
+                                             this->getLineColor);
+}
+
 void SolidPolygonLayer::initializeState() {
   auto vertexPositions = std::make_shared<arrow::Field>("vertexPositions", arrow::fixed_size_list(arrow::float32(), 2));
   auto getVertexPositions = [this](const std::shared_ptr<arrow::Table>& table) {
@@ -76,6 +117,12 @@ void SolidPolygonLayer::initializeState() {
   auto getLineColor = [this](const std::shared_ptr<arrow::Table>& table) { return this->getLineColorData(table); };
   this->_attributeManager->add(garrow::ColumnBuilder{lineColor, getLineColor});
 
+  auto polygonIndex = std::make_shared<arrow::Field>("polygonIndices", arrow::float32());
+  auto getPolygonIndex = [this](const std::shared_ptr<arrow::Table>& table) {
+    return this->getPolygonIndexData(table);
+  };
+  this->_attributeManager->add(garrow::ColumnBuilder{polygonIndex, getPolygonIndex});
+
   this->_models = this->_getModels(this->context->device);
   this->_layerUniforms =
       utils::createBuffer(this->context->device, sizeof(SolidPolygonLayerUniforms), wgpu::BufferUsage::Uniform);
@@ -131,7 +178,35 @@ void SolidPolygonLayer::updateGeometry(const Layer::ChangeFlags& changeFlags,
 
 void SolidPolygonLayer::finalizeState() {}
 
+auto SolidPolygonLayer::getMemoryUsage() const -> MemoryUsage {
+  auto memoryUsage = super::getMemoryUsage();
+  memoryUsage.gpuBytes += sizeof(SolidPolygonLayerUniforms);
+  // The index buffer of the level being drawn is already accounted for by the top model
+  for (size_t level = 0; level < this->_lodIndexArrays.size(); ++level) {
+    if (this->_lodIndexArrays[level] && level != this->_lodLevel) {
+      memoryUsage.gpuBytes += this->_lodIndexArrays[level]->byteLength();
+    }
+  }
+
+  memoryUsage.cpuBytes += getTableByteLength(this->_processedData);
+  memoryUsage.cpuBytes += this->_tesselatedIndices.capacity() * sizeof(uint32_t);
+  memoryUsage.cpuBytes += this->_polygonOffsets.capacity() * sizeof(uint32_t);
+  memoryUsage.cpuBytes += this->_lod ? this->_lod->byteLength() : 0;
+  return memoryUsage;
+}
+
+void SolidPolygonLayer::releaseCaches() {
+  // Index buffers are lazily uploaded again once their level gets selected
+  for (size_t level = 0; level < this->_lodIndexArrays.size(); ++level) {
+    if (level != this->_lodLevel) {
+      this->_lodIndexArrays[level] = nullptr;
+    }
+  }
+}
+
 void SolidPolygonLayer::drawState(wgpu::RenderPassEncoder pass) {
+  this->_updateLODIndices();
+
   for (auto const& model : this->models()) {
     // Layer uniforms are currently bound to index 1
     model->setUniformBuffer(1, this->_layerUniforms);
@@ -139,6 +214,35 @@ void SolidPolygonLayer::drawState(wgpu::RenderPassEncoder pass) {
   }
 }
 
+void SolidPolygonLayer::_updateLODIndices() {
+  if (!this->_lod || !this->_topModel) {
+    return;
+  }
+
+  // Web mercator world units are 512 pixels wide at zoom 0, so a pixel is 1 / scale units wide at the current zoom
+  auto viewport = this->context->viewport;
+  auto degreesPerPixel = viewport->distanceScales.degreesPerUnit.x / viewport->scale;
+
+  // Draw whatever is closest to the ideal level while the remaining levels are still being built
+  auto level = this->_lod->closestReadyLevel(this->_lod->selectLevel(degreesPerPixel));
+  if (!level || level == this->_lodLevel) {
+    return;
+  }
+
+  auto& indexArray = this->_lodIndexArrays[*level];
+  if (!indexArray) {
+    indexArray =
+        std::make_shared<garrow::Array>(this->context->device, this->_lod->indices(*level), wgpu::BufferUsage::Index);
+    // Levels are uploaded while drawing, outside of updates that memory usage is otherwise recomputed after
+    if (this->context->layerManager) {
+      this->context->layerManager->setNeedsMemoryUsageUpdate();
+    }
+  }
+
+  this->_topModel->setIndices(indexArray);
+  this->_lodLevel = level;
+}
+
 // TODO(ilija@unfolded.ai): Remove once specifying constant attributes is possible
 auto SolidPolygonLayer::getVertexPositionData(const std::shared_ptr<arrow::Table>& table)
     -> std::shared_ptr<arrow::Array> {
@@ -147,7 +251,8 @@ auto SolidPolygonLayer::getVertexPositionData(const std::shared_ptr<arrow::Table
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapVector2FloatColumn(table, [](const Row& row) { return mathgl::Vector2<float>{0, 1}; });
+  return ArrowMapper::mapVector2FloatColumn(
+      table, [](const Row& row) { return mathgl::Vector2<float>{0, 1}; }, this->_memoryPool());
 }
 
 // TODO(ilija@unfolded.ai): Remove once specifying constant attributes is possible
@@ -158,7 +263,7 @@ auto SolidPolygonLayer::getVertexValidData(const std::shared_ptr<arrow::Table>&
     throw std::logic_error("Invalid layer properties");
   }
 
-  return ArrowMapper::mapFloatColumn(table, [](const Row& row) { return 1.0f; });
+  return ArrowMapper::mapFloatColumn(table, [](const Row& row) { return 1.0f; }, this->_memoryPool());
 }
 
 auto SolidPolygonLayer::getPositionData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -168,7 +273,8 @@ auto SolidPolygonLayer::getPositionData(const std::shared_ptr<arrow::Table>& tab
   }
 
   // Since table data is already processed using the provided accessors, we just return the processed column data
-  return ArrowMapper::mapVector3FloatColumn(table, [](const Row& row) { return row.getVector3<float>("positions"); });
+  return ArrowMapper::mapVector3FloatColumn(
+      table, [](const Row& row) { return row.getVector3<float>("positions"); }, this->_memoryPool());
 }
 
 auto SolidPolygonLayer::getElevationData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -178,7 +284,8 @@ auto SolidPolygonLayer::getElevationData(const std::shared_ptr<arrow::Table>& ta
   }
 
   // Since table data is already processed using the provided accessors, we just return the processed column data
-  return ArrowMapper::mapFloatColumn(table, [](const Row& row) { return row.getFloat("elevations"); });
+  return ArrowMapper::mapFloatColumn(
+      table, [](const Row& row) { return row.getFloat("elevations"); }, this->_memoryPool());
 }
 
 auto SolidPolygonLayer::getFillColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -188,7 +295,8 @@ auto SolidPolygonLayer::getFillColorData(const std::shared_ptr<arrow::Table>& ta
   }
 
   // Since table data is already processed using the provided accessors, we just return the processed column data
-  return ArrowMapper::mapVector4FloatColumn(table, [](const Row& row) { return row.getVector4<float>("fillColors"); });
+  return ArrowMapper::mapVector4FloatColumn(
+      table, [](const Row& row) { return row.getVector4<float>("fillColors"); }, this->_memoryPool());
 }
 
 auto SolidPolygonLayer::getLineColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array> {
@@ -198,7 +306,49 @@ auto SolidPolygonLayer::getLineColorData(const std::shared_ptr<arrow::Table>& ta
   }
 
   // Since table data is already processed using the provided accessors, we just return the processed column data
-  return ArrowMapper::mapVector4FloatColumn(table, [](const Row& row) { return row.getVector4<float>("lineColors"); });
+  return ArrowMapper::mapVector4FloatColumn(
+      table, [](const Row& row) { return row.getVector4<float>("lineColors"); }, this->_memoryPool());
+}
+
+auto SolidPolygonLayer::getPolygonIndexData(const std::shared_ptr<arrow::Table>& table)
+    -> std::shared_ptr<arrow::Array> {
+  auto props = std::dynamic_pointer_cast<SolidPolygonLayer::Props>(this->props());
+  if (!props) {
+    throw std::logic_error("Invalid layer properties");
+  }
+
+  // Since table data is already processed using the provided accessors, we just return the processed column data
+  return ArrowMapper::mapFloatColumn(
+      table, [](const Row& row) { return row.getFloat("polygonIndices"); }, this->_memoryPool());
+}
+
+auto SolidPolygonLayer::getPickingGeometry() -> std::shared_ptr<PickingGeometry> {
+  if (!this->_processedData) {
+    return nullptr;
+  }
+
+  auto positions = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      this->_processedData->GetColumnByName("positions")->chunk(0));
+  auto positionValues = std::static_pointer_cast<arrow::FloatArray>(positions->values())->raw_values();
+
+  // Picking always uses full resolution triangles, waiting for them to be tessellated if necessary
+  const auto& indices = this->_lod ? this->_lod->indices(0) : this->_tesselatedIndices;
+
+  auto geometry = std::make_shared<PickingGeometry>(PickingGeometry::Type::TRIANGLES);
+  geometry->vertices.resize(indices.size());
+  geometry->rows.resize(indices.size() / 3);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    auto position = positionValues + positions->value_offset(indices[i]);
+    geometry->vertices[i] = {position[0], position[1]};
+  }
+
+  // Triangles never span multiple polygons, so the first vertex determines the row for the whole triangle
+  for (size_t triangle = 0; triangle < geometry->rows.size(); ++triangle) {
+    auto polygon = std::upper_bound(this->_polygonOffsets.begin(), this->_polygonOffsets.end(), indices[triangle * 3]);
+    geometry->rows[triangle] = static_cast<uint32_t>(polygon - this->_polygonOffsets.begin() - 1);
+  }
+
+  return geometry;
 }
 
 auto SolidPolygonLayer::_getModels(wgpu::Device device) -> std::list<std::shared_ptr<lumagl::Model>> {
@@ -206,6 +356,8 @@ auto SolidPolygonLayer::_getModels(wgpu::Device device) -> std::list<std::shared
   auto extruded = this->props()->extruded;
 
   std::list<std::shared_ptr<lumagl::Model>> modelsList;
+  this->_topModel = nullptr;
+  this->_lodLevel = std::nullopt;
 
   // If polygon is filled, declare a model that draws the top side of the polygon
   if (filled) {
@@ -216,11 +368,13 @@ auto SolidPolygonLayer::_getModels(wgpu::Device device) -> std::list<std::shared
         std::make_shared<garrow::Field>("positions", wgpu::VertexFormat::Float3),
         std::make_shared<garrow::Field>("elevations", wgpu::VertexFormat::Float),
         std::make_shared<garrow::Field>("fillColors", wgpu::VertexFormat::Float4),
-        std::make_shared<garrow::Field>("lineColors", wgpu::VertexFormat::Float4)};
+        std::make_shared<garrow::Field>("lineColors", wgpu::VertexFormat::Float4),
+        std::make_shared<garrow::Field>("polygonIndices", wgpu::VertexFormat::Float)};
     auto attributeSchema = std::make_shared<lumagl::garrow::Schema>(attributeFields);
     auto instancedAttributeSchema = std::make_shared<garrow::Schema>(std::vector<std::shared_ptr<garrow::Field>>{});
     std::vector<UniformDescriptor> uniforms = {
-        UniformDescriptor{}, UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}};
+        UniformDescriptor{}, UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment},
+        UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}};
 
     auto modelOptions = Model::Options{
         vst, fs, attributeSchema, instancedAttributeSchema, uniforms, wgpu::PrimitiveTopology::TriangleList};
@@ -229,10 +383,23 @@ auto SolidPolygonLayer::_getModels(wgpu::Device device) -> std::list<std::shared
     // Make sure we've processed raw data before setting attributes
     if (this->_processedData) {
       model->setAttributes(this->_attributeManager->update(this->_processedData));
-      model->setIndices(
-          std::make_shared<garrow::Array>(this->context->device, this->_tesselatedIndices, wgpu::BufferUsage::Index));
+      if (this->_lod) {
+        // Start off with the coarsest level, as it's guaranteed to be ready at this point
+        auto coarsestLevel = this->_lod->levelCount() - 1;
+        auto& indexArray = this->_lodIndexArrays[coarsestLevel];
+        if (!indexArray) {
+          indexArray = std::make_shared<garrow::Array>(this->context->device, this->_lod->indices(coarsestLevel),
+                                                       wgpu::BufferUsage::Index);
+        }
+        model->setIndices(indexArray);
+        this->_lodLevel = coarsestLevel;
+      } else {
+        model->setIndices(std::make_shared<garrow::Array>(this->context->device, this->_tesselatedIndices,
+                                                          wgpu::BufferUsage::Index));
+      }
     }
 
+    this->_topModel = model;
     modelsList.push_back(model);
   }
 
@@ -253,7 +420,8 @@ auto SolidPolygonLayer::_getModels(wgpu::Device device) -> std::list<std::shared
     auto instancedAttributeSchema = std::make_shared<lumagl::garrow::Schema>(instancedFields);
 
     std::vector<UniformDescriptor> uniforms = {
-        UniformDescriptor{}, UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}};
+        UniformDescriptor{}, UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment},
+        UniformDescriptor{wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment}};
 
     auto modelOptions =
         Model::Options{vss, fs, attributeSchema, instancedAttributeSchema, uniforms, wgpu::PrimitiveTopology::LineList};
@@ -275,10 +443,12 @@ auto SolidPolygonLayer::_getModels(wgpu::Device device) -> std::list<std::shared
 }
 
 auto SolidPolygonLayer::processData(const std::shared_ptr<arrow::Table>& data) -> std::shared_ptr<arrow::Table> {
+  PROBEGL_TRACE_SCOPE("SolidPolygonLayer::processData", this->props()->id);
+
   // We build the geometry based on input polygon data
   // Polygon data has to be tessallated, and the data table has to be rebuilt so that it contains tessellated points
   // that can be used to draw polygon triangles
-  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  arrow::MemoryPool* pool = this->_memoryPool();
 
   arrow::FixedSizeListBuilder positionListBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 3};
   arrow::FloatBuilder& positionBuilder = *(static_cast<arrow::FloatBuilder*>(positionListBuilder.value_builder()));
@@ -291,6 +461,9 @@ auto SolidPolygonLayer::processData(const std::shared_ptr<arrow::Table>& data) -
   arrow::FixedSizeListBuilder lineColorListBuilder{pool, std::make_shared<arrow::FloatBuilder>(pool), 4};
   arrow::FloatBuilder& lineColorBuilder = *(static_cast<arrow::FloatBuilder*>(lineColorListBuilder.value_builder()));
 
+  // Polygon indices are stored as floats, which represent every index that fits into the picking color exactly
+  arrow::FloatBuilder polygonIndexBuilder{pool};
+
   // Approximate the amount of space we'll need in these buffers, as we don't know the total polygon count without
   // inspecting the entire table. Assuming 4 points per polygon
   auto approximateElementCount = data->num_rows() * 4;
@@ -298,6 +471,7 @@ auto SolidPolygonLayer::processData(const std::shared_ptr<arrow::Table>& data) -
       !elevationBuilder.Reserve(approximateElementCount).ok() ||
       !fillColorListBuilder.Reserve(approximateElementCount).ok() ||
       !lineColorListBuilder.Reserve(approximateElementCount).ok() ||
+      !polygonIndexBuilder.Reserve(approximateElementCount).ok() ||
       !positionBuilder.Reserve(approximateElementCount * 3).ok() ||
       !fillColorBuilder.Reserve(approximateElementCount * 4).ok() ||
       !lineColorBuilder.Reserve(approximateElementCount * 4).ok()) {
@@ -307,18 +481,30 @@ auto SolidPolygonLayer::processData(const std::shared_ptr<arrow::Table>& data) -
 
   using Point = std::array<float, 3>;
 
+  auto props = this->props();
   uint32_t pointOffset = 0;
+  std::vector<uint32_t> polygonOffsets;
+  polygonOffsets.reserve(data->num_rows());
   std::vector<uint32_t> tesselatedIndices;
   tesselatedIndices.reserve(data->num_rows() * 6);  // Approximate 'minimum' index count
 
+  // When levels of detail are enabled, tessellation is deferred to PolygonLOD which needs flattened 2D rings
+  std::vector<PolygonLOD::Point> lodPoints;
+  std::vector<PolygonLOD::Polygon> lodPolygons;
+  if (props->lod) {
+    lodPoints.reserve(approximateElementCount);
+    lodPolygons.reserve(data->num_rows());
+  }
+
   // Iterate over the original data set
-  for (auto i = 0; i < data->num_rows(); i++) {
+  ArrowMapper::forEachRow(data, [&](const Row& row) {
     // Extract row data for this polygon
-    auto row = Row{data, i};
-    auto polygon = this->props()->getPolygon(row);
-    auto elevation = this->props()->getElevation(row);
-    auto fillColor = this->props()->getFillColor(row);
-    auto lineColor = this->props()->getLineColor(row);
+    auto polygon = props->getPolygon(row);
+    auto elevation = props->getElevation(row);
+    auto fillColor = props->getFillColor(row);
+    auto lineColor = props->getLineColor(row);
+    auto polygonIndex = static_cast<float>(polygonOffsets.size());
+    polygonOffsets.push_back(pointOffset);
 
     // Convert polygon points to a format needed by the tessellator
     // TODO(ilija@unfolded.ai): Avoid copying the data by either conforming Vector3 (or its subclass) so that it can be
@@ -335,30 +521,57 @@ auto SolidPolygonLayer::processData(const std::shared_ptr<arrow::Table>& data) -
       }
       if (!positionBuilder.AppendValues(&point.x, 3).ok() || !elevationBuilder.Append(elevation).ok() ||
           !fillColorBuilder.AppendValues(&fillColor.x, 4).ok() ||
-          !lineColorBuilder.AppendValues(&lineColor.x, 4).ok()) {
+          !lineColorBuilder.AppendValues(&lineColor.x, 4).ok() || !polygonIndexBuilder.Append(polygonIndex).ok()) {
         throw std::runtime_error("Unable to append data");
       }
 
-      points.push_back({point.x, point.y, point.z});
+      if (props->lod) {
+        lodPoints.push_back({point.x, point.y});
+      } else {
+        points.push_back({point.x, point.y, point.z});
+      }
     }
 
-    // Tessellate the polygon
-    auto indices = mapbox::earcut(std::vector<std::vector<Point>>{points});
-    for (const auto& index : indices) {
-      tesselatedIndices.push_back(pointOffset + index);
+    if (props->lod) {
+      lodPolygons.push_back({pointOffset, static_cast<uint32_t>(polygon.size())});
+    } else {
+      // Tessellate the polygon
+      auto indices = mapbox::earcut(std::vector<std::vector<Point>>{points});
+      for (const auto& index : indices) {
+        tesselatedIndices.push_back(pointOffset + index);
+      }
     }
 
     pointOffset += polygon.size();
+  });
+
+  this->_lod = nullptr;
+  this->_lodIndexArrays.clear();
+  this->_lodLevel = std::nullopt;
+  if (props->lod) {
+    PolygonLOD::Options lodOptions;
+    lodOptions.levels = props->lodLevels;
+    lodOptions.maxZoom = props->lodMaxZoom;
+    lodOptions.tolerancePixels = props->lodTolerancePixels;
+    lodOptions.minPixelArea = props->lodMinPixelArea;
+
+    this->_lod = std::make_shared<PolygonLOD>(std::move(lodPoints), std::move(lodPolygons), lodOptions);
+    this->_lod->build();
+    this->_lodIndexArrays.resize(this->_lod->levelCount());
   }
 
-  this->_tesselatedIndices = tesselatedIndices;
+  // Indices of levels of detail are only held by the LOD, and uploaded by the top model once per level
+  this->_tesselatedIndices = std::move(tesselatedIndices);
+  this->_polygonOffsets = std::move(polygonOffsets);
 
   std::shared_ptr<arrow::Array> positionArray;
   std::shared_ptr<arrow::Array> elevationArray;
   std::shared_ptr<arrow::Array> fillColorArray;
   std::shared_ptr<arrow::Array> lineColorArray;
+  std::shared_ptr<arrow::Array> polygonIndexArray;
   if (!positionListBuilder.Finish(&positionArray).ok() || !elevationBuilder.Finish(&elevationArray).ok() ||
-      !fillColorListBuilder.Finish(&fillColorArray).ok() || !lineColorListBuilder.Finish(&lineColorArray).ok()) {
+      !fillColorListBuilder.Finish(&fillColorArray).ok() || !lineColorListBuilder.Finish(&lineColorArray).ok() ||
+      !polygonIndexBuilder.Finish(&polygonIndexArray).ok()) {
     probegl::WarningLog() << "Unable to extract processed polygon data";
     return nullptr;
   }
@@ -368,6 +581,9 @@ auto SolidPolygonLayer::processData(const std::shared_ptr<arrow::Table>& data) -
   auto elevation = std::make_shared<arrow::Field>("elevations", arrow::float32());
   auto fillColor = std::make_shared<arrow::Field>("fillColors", arrow::fixed_size_list(arrow::float32(), 4));
   auto lineColor = std::make_shared<arrow::Field>("lineColors", arrow::fixed_size_list(arrow::float32(), 4));
-  auto attributeSchema = std::make_shared<arrow::Schema>(std::vector{positions, elevation, fillColor, lineColor});
-  return arrow::Table::Make(attributeSchema, {positionArray, elevationArray, fillColorArray, lineColorArray});
+  auto polygonIndex = std::make_shared<arrow::Field>("polygonIndices", arrow::float32());
+  auto attributeSchema =
+      std::make_shared<arrow::Schema>(std::vector{positions, elevation, fillColor, lineColor, polygonIndex});
+  return arrow::Table::Make(attributeSchema,
+                            {positionArray, elevationArray, fillColorArray, lineColorArray, polygonIndexArray});
 }
@@ -23,9 +23,11 @@
 
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "./polygon-lod.h"  // NOLINT(build/include)
 #include "deck.gl/core.h"
 
 namespace deckgl {
@@ -48,6 +50,13 @@ class SolidPolygonLayer : public Layer {
   auto getElevationData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getFillColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
   auto getLineColorData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
+  /// \brief Returns the index of the polygon each vertex belongs to, which is encoded into the picking buffer.
+  auto getPolygonIndexData(const std::shared_ptr<arrow::Table>& table) -> std::shared_ptr<arrow::Array>;
+
+  auto getPickingGeometry() -> std::shared_ptr<PickingGeometry> override;
+  auto getMemoryUsage() const -> MemoryUsage override;
+  /// \brief Releases index buffers of levels of detail that aren't currently being drawn.
+  void releaseCaches() override;
 
  protected:
   void initializeState() override;
@@ -59,11 +68,22 @@ class SolidPolygonLayer : public Layer {
 
  private:
   auto _getModels(wgpu::Device device) -> std::list<std::shared_ptr<lumagl::Model>>;
+  /// \brief Swaps the top model's index buffer for the level of detail that matches the current viewport.
+  void _updateLODIndices();
 
   wgpu::Buffer _layerUniforms;
 
   std::shared_ptr<arrow::Table> _processedData;
   std::vector<uint32_t> _tesselatedIndices;
+  /// Offset of the first point of each polygon, used to map tessellated points back to data rows
+  std::vector<uint32_t> _polygonOffsets;
+
+  /// Model drawing the top side of polygons, whose indices get swapped when LOD is enabled
+  std::shared_ptr<lumagl::Model> _topModel;
+  std::shared_ptr<PolygonLOD> _lod;
+  /// Lazily uploaded index buffers, one per level of detail
+  std::vector<std::shared_ptr<lumagl::garrow::Array>> _lodIndexArrays;
+  std::optional<size_t> _lodLevel;
 };
 
 /// \brief A set of properties that describes a SolidPolygonlayer.
@@ -85,6 +105,17 @@ class SolidPolygonLayer::Props : public Layer::Props {
   /// \brief Scale to use for elevation data.
   float elevationScale{1.0};
 
+  /// \brief Specifies whether polygons should be simplified when zoomed out.
+  bool lod{false};
+  /// \brief Number of levels of detail to build, including the full resolution one.
+  int lodLevels{4};
+  /// \brief Zoom level below which simplified geometry starts being drawn.
+  float lodMaxZoom{12.0};
+  /// \brief Maximum deviation of simplified polygon outlines, in pixels.
+  float lodTolerancePixels{1.0};
+  /// \brief Polygons covering fewer pixels than this are dropped from simplified levels.
+  float lodMinPixelArea{1.0};
+
   /// Property accessors
   std::function<ArrowMapper::ListVector3FloatAccessor> getPolygon{
       [](const Row& row) { return row.getVector3List<float>("polygon"); }};
@@ -94,6 +125,8 @@ class SolidPolygonLayer::Props : public Layer::Props {
   std::function<ArrowMapper::Vector4FloatAccessor> getLineColor{
       [](const Row&) { return mathgl::Vector4<float>(0.0, 0.0, 0.0, 255.0); }};
 
+  auto getDataColumns(const std::shared_ptr<arrow::Table>& sample) const -> std::vector<std::string> override;
+
   // Property Type Machinery
   static constexpr const char* getTypeName() { return "SolidPolygonLayer"; }
   auto getProperties() const -> const std::shared_ptr<Properties> override;
@@ -97,6 +97,12 @@ TEST_F(LineLayerTest, PropAccess) {
   EXPECT_TRUE(propertyTypes->hasProp("opacity"));
   EXPECT_TRUE(propertyTypes->hasProp("widthScale"));
   EXPECT_FALSE(propertyTypes->hasProp("radiusScale"));
+
+  // Spatial orders are named in JSON, unknown names are rejected when props are parsed
+  layerProps1->setPropertyFromJson("spatialOrder", Json::Value{"hilbert"}, nullptr);
+  EXPECT_EQ(layerProps1->spatialOrder, SpatialOrder::HILBERT);
+  EXPECT_THROW(layerProps1->setPropertyFromJson("spatialOrder", Json::Value{"zigzag"}, nullptr), std::runtime_error);
+  EXPECT_EQ(layerProps1->spatialOrder, SpatialOrder::HILBERT);
 }
 
 TEST_F(LineLayerTest, Create) {
@@ -0,0 +1,112 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "deck.gl/layers/src/solid-polygon-layer/polygon-lod.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace deckgl;
+
+namespace {
+
+/// \brief Creates a rough circle around given center, closing the ring by repeating the first point.
+auto createCircle(float x, float y, float radius, uint32_t segments) -> std::vector<PolygonLOD::Point> {
+  std::vector<PolygonLOD::Point> points;
+  for (uint32_t i = 0; i < segments; ++i) {
+    auto angle = 2.0 * 3.14159265358979 * i / segments;
+    points.push_back(PolygonLOD::Point{x + radius * static_cast<float>(std::cos(angle)),
+                                       y + radius * static_cast<float>(std::sin(angle))});
+  }
+  points.push_back(points.front());
+
+  return points;
+}
+
+TEST(PolygonLOD, SimplifyRing) {
+  // Square with a few collinear points along its edges
+  std::vector<PolygonLOD::Point> points{{0, 0}, {0.5, 0}, {1, 0}, {1, 0.5}, {1, 1}, {0.5, 1}, {0, 1}, {0, 0}};
+  auto retained = PolygonLOD::simplifyRing(points, {0, 8}, 0.01);
+
+  EXPECT_EQ(retained, (std::vector<uint32_t>{0, 2, 4, 6}));
+}
+
+TEST(PolygonLOD, RingArea) {
+  std::vector<PolygonLOD::Point> points{{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+  EXPECT_DOUBLE_EQ(PolygonLOD::ringArea(points, {0, 4}), 4.0);
+  EXPECT_DOUBLE_EQ(PolygonLOD::ringArea(points, {0, 2}), 0.0);
+}
+
+TEST(PolygonLOD, SelectLevel) {
+  PolygonLOD::Options options;
+  options.levels = 3;
+  options.maxZoom = 10.0;
+  options.zoomStep = 2.0;
+  PolygonLOD lod{{}, {}, options};
+
+  ASSERT_EQ(lod.levelCount(), 3u);
+  EXPECT_DOUBLE_EQ(lod.levelDegreesPerPixel(0), 0.0);
+  EXPECT_GT(lod.levelDegreesPerPixel(2), lod.levelDegreesPerPixel(1));
+
+  EXPECT_EQ(lod.selectLevel(lod.levelDegreesPerPixel(1) / 2.0), 0u);
+  EXPECT_EQ(lod.selectLevel(lod.levelDegreesPerPixel(1)), 1u);
+  EXPECT_EQ(lod.selectLevel(lod.levelDegreesPerPixel(2) * 4.0), 2u);
+}
+
+TEST(PolygonLOD, Build) {
+  // A large, finely tessellated circle and a tiny triangle
+  auto points = createCircle(0.0, 0.0, 1.0, 256);
+  std::vector<PolygonLOD::Polygon> polygons{{0, static_cast<uint32_t>(points.size())}};
+  std::vector<PolygonLOD::Point> triangle{{5.0, 5.0}, {5.0001, 5.0}, {5.0, 5.0001}};
+  polygons.push_back({static_cast<uint32_t>(points.size()), 3});
+  points.insert(points.end(), triangle.begin(), triangle.end());
+
+  PolygonLOD::Options options;
+  options.levels = 3;
+  options.maxZoom = 4.0;
+  PolygonLOD lod{points, polygons, options};
+
+  EXPECT_FALSE(lod.closestReadyLevel(0).has_value());
+  EXPECT_THROW(lod.indices(0), std::logic_error);
+
+  lod.build();
+  // Coarsest level is built synchronously
+  EXPECT_TRUE(lod.isReady(2));
+  EXPECT_TRUE(lod.closestReadyLevel(2).has_value());
+
+  auto& fullIndices = lod.indices(0);
+  auto& coarseIndices = lod.indices(2);
+
+  // Full resolution level keeps every polygon, while coarse levels drop sub-pixel ones and have fewer triangles
+  EXPECT_EQ(fullIndices.size() % 3, 0u);
+  EXPECT_EQ(coarseIndices.size() % 3, 0u);
+  EXPECT_GT(coarseIndices.size(), 0u);
+  EXPECT_LT(coarseIndices.size(), fullIndices.size());
+  for (auto index : coarseIndices) {
+    EXPECT_LT(index, polygons[1].offset);
+  }
+  EXPECT_NE(std::find(fullIndices.begin(), fullIndices.end(), polygons[1].offset), fullIndices.end());
+}
+
+}  // namespace
@@ -23,6 +23,8 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "deck.gl/layers.h"
 
@@ -69,6 +71,15 @@ TEST_F(ScatterplotLayerTest, Props) {
   EXPECT_FALSE(layerProps1->equals(layerProps2.get()));
 }
 
+TEST_F(ScatterplotLayerTest, GetDataColumns) {
+  auto layerProps = std::make_shared<ScatterplotLayer::Props>();
+  EXPECT_EQ(layerProps->getDataColumns(propData), std::vector<std::string>{"position"});
+  EXPECT_TRUE(layerProps->getDataColumns(nullptr).empty());
+
+  layerProps->getPosition = [](const Row& row) { return mathgl::Vector3<float>{}; };
+  EXPECT_TRUE(layerProps->getDataColumns(propData).empty());
+}
+
 TEST_F(ScatterplotLayerTest, GetPositionData) {
   auto layerProps = std::make_shared<ScatterplotLayer::Props>();
   layerProps->data = propData;
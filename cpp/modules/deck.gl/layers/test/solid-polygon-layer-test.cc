@@ -216,4 +216,22 @@ TEST_F(SolidPolygonLayerTest, GetLineColorData) {
   EXPECT_FLOAT_EQ(*(dataPointer + 3), 255.0);
 }
 
+TEST_F(SolidPolygonLayerTest, GetPolygonIndexData) {
+  auto layerProps = std::make_shared<SolidPolygonLayer::Props>();
+  auto data = arrow::ConcatenateTables({propData, propData}).ValueOrDie();
+  layerProps->data = data;
+
+  auto polygonLayer = std::make_shared<SolidPolygonLayer>(layerProps);
+  auto processedData = polygonLayer->processData(data);
+  auto indexData = polygonLayer->getPolygonIndexData(processedData);
+
+  // Every vertex carries the index of the polygon it belongs to, which is what gets encoded while picking
+  auto values = std::static_pointer_cast<arrow::FloatArray>(indexData);
+  EXPECT_EQ(values->length(), 6);
+  EXPECT_EQ(values->type_id(), arrow::Type::FLOAT);
+  for (int64_t i = 0; i < values->length(); ++i) {
+    EXPECT_FLOAT_EQ(values->Value(i), i < 3 ? 0.0 : 1.0);
+  }
+}
+
 }  // namespace
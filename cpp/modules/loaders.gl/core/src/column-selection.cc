@@ -0,0 +1,114 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./column-selection.h"  // NOLINT(build/include)
+
+#include <arrow/array.h>
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief Selects included columns of batches read by another reader.
+class SelectingBatchReader : public arrow::RecordBatchReader {
+ public:
+  SelectingBatchReader(const std::shared_ptr<arrow::RecordBatchReader>& reader,
+                       const std::vector<std::string>& includeColumns)
+      : _reader{reader}, _includeColumns{includeColumns}, _schema{selectFields(reader->schema(), includeColumns)} {}
+
+  auto schema() const -> std::shared_ptr<arrow::Schema> override { return this->_schema; }
+
+  auto ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) -> arrow::Status override {
+    auto status = this->_reader->ReadNext(batch);
+    if (status.ok() && *batch) {
+      *batch = selectColumns(*batch, this->_includeColumns);
+    }
+    return status;
+  }
+
+ private:
+  std::shared_ptr<arrow::RecordBatchReader> _reader;
+  std::vector<std::string> _includeColumns;
+  std::shared_ptr<arrow::Schema> _schema;
+};
+
+}  // anonymous namespace
+
+auto loadersgl::selectFields(const std::shared_ptr<arrow::Schema>& schema,
+                             const std::vector<std::string>& includeColumns) -> std::shared_ptr<arrow::Schema> {
+  if (includeColumns.empty()) {
+    return schema;
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& name : includeColumns) {
+    auto field = schema->GetFieldByName(name);
+    fields.push_back(field ? field : arrow::field(name, arrow::null()));
+  }
+
+  return arrow::schema(fields);
+}
+
+auto loadersgl::selectColumns(const std::shared_ptr<arrow::Table>& table,
+                              const std::vector<std::string>& includeColumns) -> std::shared_ptr<arrow::Table> {
+  if (includeColumns.empty()) {
+    return table;
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : includeColumns) {
+    auto column = table->GetColumnByName(name);
+    if (!column) {
+      auto nulls = std::make_shared<arrow::NullArray>(table->num_rows());
+      column = std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{nulls});
+    }
+    columns.push_back(column);
+  }
+
+  return arrow::Table::Make(selectFields(table->schema(), includeColumns), columns, table->num_rows());
+}
+
+auto loadersgl::selectColumns(const std::shared_ptr<arrow::RecordBatch>& batch,
+                              const std::vector<std::string>& includeColumns) -> std::shared_ptr<arrow::RecordBatch> {
+  if (includeColumns.empty()) {
+    return batch;
+  }
+
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (const auto& name : includeColumns) {
+    auto column = batch->GetColumnByName(name);
+    if (!column) {
+      column = std::make_shared<arrow::NullArray>(batch->num_rows());
+    }
+    columns.push_back(column);
+  }
+
+  return arrow::RecordBatch::Make(selectFields(batch->schema(), includeColumns), batch->num_rows(), columns);
+}
+
+auto loadersgl::selectColumns(const std::shared_ptr<arrow::RecordBatchReader>& reader,
+                              const std::vector<std::string>& includeColumns)
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  if (includeColumns.empty()) {
+    return reader;
+  }
+
+  return std::make_shared<SelectingBatchReader>(reader, includeColumns);
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_CORE_COLUMN_SELECTION_H
+#define LOADERSGL_CORE_COLUMN_SELECTION_H
+
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace loadersgl {
+
+/// \brief Selects columns of a schema by name, for loaders that can't skip columns while parsing.
+/// \param schema Schema to select fields from.
+/// \param includeColumns Names of fields to select, in order. All fields are selected if empty, and fields missing from
+/// the schema are selected as fields of null type.
+/// \return Schema containing selected fields.
+auto selectFields(const std::shared_ptr<arrow::Schema>& schema, const std::vector<std::string>& includeColumns)
+    -> std::shared_ptr<arrow::Schema>;
+
+/// \brief Selects columns of a table by name, without copying data. See selectFields().
+auto selectColumns(const std::shared_ptr<arrow::Table>& table, const std::vector<std::string>& includeColumns)
+    -> std::shared_ptr<arrow::Table>;
+
+/// \brief Selects columns of a record batch by name, without copying data. See selectFields().
+auto selectColumns(const std::shared_ptr<arrow::RecordBatch>& batch, const std::vector<std::string>& includeColumns)
+    -> std::shared_ptr<arrow::RecordBatch>;
+
+/// \brief Selects columns of batches read by a reader, without copying data. See selectFields().
+/// \return Reader that reads batches from the given reader, and selects their columns.
+auto selectColumns(const std::shared_ptr<arrow::RecordBatchReader>& reader,
+                   const std::vector<std::string>& includeColumns) -> std::shared_ptr<arrow::RecordBatchReader>;
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_CORE_COLUMN_SELECTION_H
@@ -0,0 +1,48 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_CORE_LOAD_PROGRESS_H
+#define LOADERSGL_CORE_LOAD_PROGRESS_H
+
+#include <arrow/record_batch.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace loadersgl {
+
+/// \brief Progress of a streaming load.
+struct LoadProgress {
+  /// \brief Number of bytes read from the input. Input can be read ahead of parsing, so this can be ahead of rowsRead.
+  int64_t bytesRead{0};
+  int64_t rowsRead{0};
+  int64_t batchesRead{0};
+  /// \brief Whether loading was stopped before reaching the end of the input.
+  bool cancelled{false};
+};
+
+/// \brief Receives record batches as they are loaded. Returning false stops loading.
+using BatchCallback = auto(const std::shared_ptr<arrow::RecordBatch>&) -> bool;
+/// \brief Receives progress after each batch has been handled.
+using ProgressCallback = void(const LoadProgress&);
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_CORE_LOAD_PROGRESS_H
@@ -0,0 +1,64 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./loader-options.h"  // NOLINT(build/include)
+
+#include <arrow/util/thread_pool.h>
+
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+#include "probe.gl/core.h"
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief Guards the thread count Arrow's CPU thread pool has been resized to, which is set at most once.
+std::mutex threadCountMutex;
+std::optional<int32_t> appliedThreadCount;
+
+}  // anonymous namespace
+
+void loadersgl::applyThreadCount(const LoaderOptions& options) {
+  if (!options.useThreads || options.threadCount <= 0) {
+    return;
+  }
+
+  // Resizing the pool while other loads are running would change their thread count halfway through, so the first
+  // thread count that's asked for is kept for the lifetime of the process
+  std::lock_guard<std::mutex> lock{threadCountMutex};
+  if (appliedThreadCount) {
+    if (appliedThreadCount.value() != options.threadCount) {
+      probegl::WarningLog() << "Ignoring thread count " << options.threadCount
+                            << ", Arrow's CPU thread pool was already resized to " << appliedThreadCount.value();
+    }
+    return;
+  }
+
+  if (arrow::GetCpuThreadPoolCapacity() != options.threadCount) {
+    auto status = arrow::SetCpuThreadPoolCapacity(options.threadCount);
+    if (!status.ok()) {
+      throw std::runtime_error("Cannot set thread pool capacity: " + status.ToString());
+    }
+  }
+  appliedThreadCount = options.threadCount;
+}
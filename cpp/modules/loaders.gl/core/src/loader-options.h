@@ -0,0 +1,78 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_CORE_LOADER_OPTIONS_H
+#define LOADERSGL_CORE_LOADER_OPTIONS_H
+
+#include <arrow/type.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace loadersgl {
+
+/// \brief Options that control how loaders parse data. Defaults match Arrow's defaults.
+struct LoaderOptions {
+  /// \brief Names of columns to load, in the order they should appear in loaded tables. All columns are loaded if
+  /// empty. Columns missing from the input are loaded as null columns.
+  /// \note Layers can derive the columns their accessors need from a sample of data, see Layer::Props::getDataColumns.
+  std::vector<std::string> includeColumns;
+
+  /// \brief Types of columns that shouldn't have their type inferred from data.
+  std::unordered_map<std::string, std::shared_ptr<arrow::DataType>> columnTypes;
+
+  /// \brief Approximate size of blocks of input that are parsed at once, in bytes. Streaming loaders produce a record
+  /// batch for each block.
+  int32_t blockSize{1 << 20};
+
+  /// \brief Whether to parse blocks in parallel on Arrow's CPU thread pool.
+  bool useThreads{true};
+
+  /// \brief Number of threads to parse blocks with, if useThreads is set. The current capacity of Arrow's CPU thread
+  /// pool is kept if zero.
+  /// \note Arrow's thread pool is shared by all readers in the process, so this is a process-wide setting. The pool is
+  /// only resized by the first load that sets a thread count, later loads asking for a different one keep its capacity.
+  int32_t threadCount{0};
+
+  /// \brief Character separating values, CSV only.
+  char delimiter{','};
+
+  /// \brief Whether values can be quoted, CSV only.
+  bool quoting{true};
+
+  /// \brief Character used for quoting values, CSV only.
+  char quoteChar{'"'};
+
+  /// \brief Strings that are interpreted as nulls, CSV only. Arrow's defaults ("", "NULL", "NaN", ...) are used if
+  /// empty.
+  std::vector<std::string> nullValues;
+};
+
+/// \brief Resizes Arrow's CPU thread pool to options.threadCount, if it's set, threads are used, and the pool hasn't
+/// been resized by an earlier call already. Safe to call from concurrent loads.
+/// \throws std::runtime_error if the thread pool couldn't be resized.
+void applyThreadCount(const LoaderOptions& options);
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_CORE_LOADER_OPTIONS_H
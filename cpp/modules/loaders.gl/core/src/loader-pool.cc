@@ -0,0 +1,142 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./loader-pool.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+using namespace loadersgl;
+
+auto LoadHandle::isReady() const -> bool {
+  return this->_table.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+auto LoadHandle::get() const -> std::shared_ptr<arrow::Table> { return this->_table.get(); }
+
+LoaderPool::LoaderPool(size_t threadCount) {
+  for (size_t i = 0; i < std::max(threadCount, static_cast<size_t>(1)); ++i) {
+    this->_threads.emplace_back([this]() { this->_runTasks(); });
+  }
+}
+
+LoaderPool::~LoaderPool() {
+  {
+    std::lock_guard<std::mutex> lock{this->_mutex};
+    this->_stopping = true;
+    // Queued tasks still run, so that their handles report cancellation
+    for (auto& task : this->_tasks) {
+      task.token->cancel();
+    }
+  }
+
+  this->_condition.notify_all();
+  for (auto& thread : this->_threads) {
+    thread.join();
+  }
+}
+
+auto LoaderPool::shared() -> LoaderPool& {
+  static LoaderPool pool{std::max(std::thread::hardware_concurrency(), 1u)};
+  return pool;
+}
+
+auto LoaderPool::load(Load load) -> std::shared_ptr<LoadHandle> {
+  auto token = std::make_shared<CancellationToken>();
+  auto task = std::make_shared<std::packaged_task<std::shared_ptr<arrow::Table>()>>([load = std::move(load), token]() {
+    if (token->isCancelled()) {
+      throw std::runtime_error("Loading was cancelled");
+    }
+
+    auto table = load(*token);
+    // Loads may return partial data once cancelled
+    if (token->isCancelled()) {
+      throw std::runtime_error("Loading was cancelled");
+    }
+    return table;
+  });
+  auto handle = std::make_shared<LoadHandle>(task->get_future().share(), token);
+
+  {
+    std::lock_guard<std::mutex> lock{this->_mutex};
+    if (this->_stopping) {
+      throw std::logic_error("Loader pool is shutting down");
+    }
+    this->_tasks.push_back(Task{[task]() { (*task)(); }, token});
+  }
+
+  this->_condition.notify_one();
+  return handle;
+}
+
+void LoaderPool::_runTasks() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock{this->_mutex};
+      this->_condition.wait(lock, [this]() { return this->_stopping || !this->_tasks.empty(); });
+      if (this->_tasks.empty()) {
+        return;
+      }
+
+      task = std::move(this->_tasks.front());
+      this->_tasks.pop_front();
+    }
+
+    task.run();
+  }
+}
+
+auto loadersgl::readTable(arrow::RecordBatchReader& reader, const CancellationToken& token)
+    -> std::shared_ptr<arrow::Table> {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (!token.isCancelled()) {
+    if (!reader.ReadNext(&batch).ok()) {
+      throw std::runtime_error("An error has occured while reading batches");
+    }
+    if (!batch) {
+      break;
+    }
+    batches.push_back(batch);
+  }
+
+  auto table = arrow::Table::FromRecordBatches(reader.schema(), batches);
+  if (!table.ok()) {
+    throw std::runtime_error("Cannot combine batches into a table");
+  }
+  return *table;
+}
+
+auto CancellableInputStream::Read(int64_t nbytes, void* out) -> arrow::Result<int64_t> {
+  if (this->_token.isCancelled()) {
+    return arrow::Status::Cancelled("Load cancelled");
+  }
+  return this->_input->Read(nbytes, out);
+}
+
+auto CancellableInputStream::Read(int64_t nbytes) -> arrow::Result<std::shared_ptr<arrow::Buffer>> {
+  if (this->_token.isCancelled()) {
+    return arrow::Status::Cancelled("Load cancelled");
+  }
+  return this->_input->Read(nbytes);
+}
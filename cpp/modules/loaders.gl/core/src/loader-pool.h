@@ -0,0 +1,131 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_CORE_LOADER_POOL_H
+#define LOADERSGL_CORE_LOADER_POOL_H
+
+#include <arrow/io/interfaces.h>
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace loadersgl {
+
+/// \brief Flag shared by a load running in the background and whoever is waiting for it, used to stop the load.
+class CancellationToken {
+ public:
+  void cancel() { this->_cancelled = true; }
+  auto isCancelled() const -> bool { return this->_cancelled; }
+
+ private:
+  std::atomic<bool> _cancelled{false};
+};
+
+/// \brief Handle to a table that is being loaded in the background, see LoaderPool.
+class LoadHandle {
+ public:
+  LoadHandle(std::shared_future<std::shared_ptr<arrow::Table>> table, std::shared_ptr<CancellationToken> token)
+      : _table{std::move(table)}, _token{std::move(token)} {}
+
+  /// \brief Returns whether loading has finished, successfully or not. Never blocks.
+  auto isReady() const -> bool;
+
+  /// \brief Waits for loading to finish.
+  /// \return Loaded table. Throws the error that loading failed with, or std::runtime_error if it was cancelled.
+  auto get() const -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Asks loading to stop. Loads that haven't started yet are skipped, running loads stop at their next check.
+  void cancel() { this->_token->cancel(); }
+  auto isCancelled() const -> bool { return this->_token->isCancelled(); }
+
+ private:
+  std::shared_future<std::shared_ptr<arrow::Table>> _table;
+  std::shared_ptr<CancellationToken> _token;
+};
+
+/// \brief Fixed number of threads that run loads in the order they were started.
+class LoaderPool {
+ public:
+  /// \brief Loads a table, checking the token as often as it can and stopping once it has been cancelled.
+  using Load = std::function<auto(const CancellationToken&)->std::shared_ptr<arrow::Table>>;
+
+  explicit LoaderPool(size_t threadCount);
+  /// \brief Cancels loads that haven't started yet, and waits for running loads to finish.
+  ~LoaderPool();
+
+  LoaderPool(const LoaderPool&) = delete;
+  auto operator=(const LoaderPool&) -> LoaderPool& = delete;
+
+  /// \brief Pool shared by all loaders, with as many threads as there are hardware threads.
+  static auto shared() -> LoaderPool&;
+
+  /// \brief Starts a load on one of the pool threads.
+  /// \return Handle to the loaded table.
+  auto load(Load load) -> std::shared_ptr<LoadHandle>;
+
+ private:
+  struct Task {
+    std::function<void()> run;
+    std::shared_ptr<CancellationToken> token;
+  };
+
+  void _runTasks();
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::deque<Task> _tasks;
+  bool _stopping{false};
+  std::vector<std::thread> _threads;
+};
+
+/// \brief Reads all the batches of a reader into a table, stopping early once the token has been cancelled.
+auto readTable(arrow::RecordBatchReader& reader, const CancellationToken& token) -> std::shared_ptr<arrow::Table>;
+
+/// \brief Forwards reads to another stream until a load is cancelled. Readers that read their input one block at a
+/// time, possibly on a separate read-ahead thread, fail at the next block once the load is cancelled.
+class CancellableInputStream : public arrow::io::InputStream {
+ public:
+  CancellableInputStream(const std::shared_ptr<arrow::io::InputStream>& input, const CancellationToken& token)
+      : _input{input}, _token{token} {}
+
+  auto Close() -> arrow::Status override { return this->_input->Close(); }
+  auto closed() const -> bool override { return this->_input->closed(); }
+  auto Tell() const -> arrow::Result<int64_t> override { return this->_input->Tell(); }
+
+  auto Read(int64_t nbytes, void* out) -> arrow::Result<int64_t> override;
+  auto Read(int64_t nbytes) -> arrow::Result<std::shared_ptr<arrow::Buffer>> override;
+
+ private:
+  std::shared_ptr<arrow::io::InputStream> _input;
+  const CancellationToken& _token;
+};
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_CORE_LOADER_POOL_H
@@ -0,0 +1,75 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./mapped-file.h"  // NOLINT(build/include)
+
+#include <stdexcept>
+
+#include "probe.gl/core.h"
+
+#if defined(PROBEGL_PLATFORM_POSIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief Advises the OS of how the mapping backing a file is going to be accessed.
+void adviseAccess(arrow::io::MemoryMappedFile& file, FileAccess access) {
+#if defined(PROBEGL_PLATFORM_POSIX)
+  auto sizeResult = file.GetSize();
+  if (!sizeResult.ok() || sizeResult.ValueOrDie() == 0) {
+    return;
+  }
+
+  // Reads of memory mapped files return slices of the mapping without copying them, so this finds the mapped address
+  auto size = sizeResult.ValueOrDie();
+  auto readResult = file.ReadAt(0, size);
+  if (!readResult.ok()) {
+    return;
+  }
+
+  auto address = reinterpret_cast<uintptr_t>(readResult.ValueOrDie()->data());
+  auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto pageAddress = address - address % pageSize;
+  auto advice = access == FileAccess::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM;
+  if (madvise(reinterpret_cast<void*>(pageAddress), static_cast<size_t>(size) + (address - pageAddress), advice) != 0) {
+    probegl::DebugLog() << "Unable to give access hints for a memory mapped file";
+  }
+#endif
+}
+
+}  // anonymous namespace
+
+auto loadersgl::mapFile(const std::string& path, FileAccess access) -> std::shared_ptr<arrow::io::MemoryMappedFile> {
+  auto mapResult = arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ);
+  if (!mapResult.ok()) {
+    throw std::runtime_error("Cannot memory map file " + path);
+  }
+
+  auto file = mapResult.ValueOrDie();
+  if (access != FileAccess::NORMAL) {
+    adviseAccess(*file, access);
+  }
+
+  return file;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_CORE_MAPPED_FILE_H
+#define LOADERSGL_CORE_MAPPED_FILE_H
+
+#include <arrow/io/file.h>
+
+#include <memory>
+#include <string>
+
+namespace loadersgl {
+
+/// \brief How a memory mapped file is going to be read, passed on to the OS as a paging hint.
+enum class FileAccess {
+  /// \brief No particular order, the OS defaults apply.
+  NORMAL,
+  /// \brief Front to back, such as when parsing text. Pages are read ahead aggressively, and may be evicted soon
+  /// after they've been read.
+  SEQUENTIAL,
+  /// \brief Scattered reads, such as record batches of an IPC file. Little to no read-ahead is done.
+  RANDOM
+};
+
+/// \brief Memory maps a local file for reading, so that loaders parse data straight out of the page cache rather than
+/// reading it into heap buffers through system calls first.
+/// \param path Path to the file.
+/// \param access How the file is going to be read.
+/// \note Access hints are only given on POSIX platforms, and are ignored if the OS doesn't accept them.
+auto mapFile(const std::string& path, FileAccess access = FileAccess::NORMAL)
+    -> std::shared_ptr<arrow::io::MemoryMappedFile>;
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_CORE_MAPPED_FILE_H
@@ -0,0 +1,121 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/api.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+#include "loaders.gl/core.h"
+
+using namespace loadersgl;
+
+namespace {
+
+auto makeTable(int64_t value) -> std::shared_ptr<arrow::Table> {
+  arrow::Int64Builder builder;
+  EXPECT_TRUE(builder.Append(value).ok());
+
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder.Finish(&array).ok());
+  return arrow::Table::Make(arrow::schema({arrow::field("value", arrow::int64())}), {array});
+}
+
+TEST(LoaderPoolTest, Load) {
+  LoaderPool pool{2};
+
+  auto handle = pool.load([](const CancellationToken&) { return makeTable(42); });
+  auto table = handle->get();
+  EXPECT_TRUE(handle->isReady());
+  EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(table->column(0)->chunk(0))->Value(0), 42);
+
+  auto failingHandle = pool.load([](const CancellationToken&) -> std::shared_ptr<arrow::Table> {
+    throw std::runtime_error("Cannot load");
+  });
+  EXPECT_THROW(failingHandle->get(), std::runtime_error);
+}
+
+TEST(LoaderPoolTest, ConcurrentLoads) {
+  LoaderPool pool{2};
+
+  // Each load waits for the other one to start, which only finishes if they run at the same time
+  std::promise<void> firstStarted;
+  std::promise<void> secondStarted;
+  auto first = pool.load([&](const CancellationToken&) {
+    firstStarted.set_value();
+    secondStarted.get_future().wait();
+    return makeTable(1);
+  });
+  auto second = pool.load([&](const CancellationToken&) {
+    secondStarted.set_value();
+    firstStarted.get_future().wait();
+    return makeTable(2);
+  });
+
+  EXPECT_EQ(first->get()->num_rows(), 1);
+  EXPECT_EQ(second->get()->num_rows(), 1);
+}
+
+TEST(LoaderPoolTest, Cancel) {
+  LoaderPool pool{1};
+
+  std::promise<void> started;
+  std::promise<void> cancelled;
+  auto running = pool.load([&](const CancellationToken& token) {
+    started.set_value();
+    cancelled.get_future().wait();
+    EXPECT_TRUE(token.isCancelled());
+    return makeTable(1);
+  });
+  auto queued = pool.load([](const CancellationToken&) -> std::shared_ptr<arrow::Table> {
+    ADD_FAILURE() << "Cancelled loads shouldn't run";
+    return nullptr;
+  });
+
+  started.get_future().wait();
+  EXPECT_FALSE(running->isReady());
+  running->cancel();
+  queued->cancel();
+  cancelled.set_value();
+
+  // Tables returned after cancellation are discarded
+  EXPECT_THROW(running->get(), std::runtime_error);
+  EXPECT_THROW(queued->get(), std::runtime_error);
+  EXPECT_TRUE(queued->isCancelled());
+}
+
+TEST(LoaderPoolTest, ReadTable) {
+  auto table = makeTable(7);
+  arrow::TableBatchReader reader{*table};
+
+  CancellationToken token;
+  auto result = readTable(reader, token);
+  EXPECT_EQ(result->num_rows(), 1);
+  EXPECT_TRUE(result->schema()->Equals(*table->schema()));
+
+  // Reading stops before the first batch once cancelled
+  arrow::TableBatchReader cancelledReader{*table};
+  token.cancel();
+  EXPECT_EQ(readTable(cancelledReader, token)->num_rows(), 0);
+}
+
+}  // namespace
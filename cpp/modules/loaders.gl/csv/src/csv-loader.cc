@@ -23,19 +23,109 @@
 #include <arrow/api.h>
 #include <arrow/csv/api.h>
 
+#include <atomic>
+#include <string>
+
+#include "../../core/src/mapped-file.h"
+
 using namespace loadersgl;
 
+namespace {
+
+/// \brief Forwards reads to another stream, counting the number of bytes read. Reads can happen on a separate
+/// read-ahead thread, so the count is atomic.
+class CountingInputStream : public arrow::io::InputStream {
+ public:
+  explicit CountingInputStream(const std::shared_ptr<arrow::io::InputStream>& input) : _input{input} {}
+
+  auto Close() -> arrow::Status override { return this->_input->Close(); }
+  auto closed() const -> bool override { return this->_input->closed(); }
+  auto Tell() const -> arrow::Result<int64_t> override { return this->_input->Tell(); }
+
+  auto Read(int64_t nbytes, void* out) -> arrow::Result<int64_t> override {
+    auto result = this->_input->Read(nbytes, out);
+    if (result.ok()) {
+      this->_bytesRead.fetch_add(result.ValueOrDie(), std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  auto Read(int64_t nbytes) -> arrow::Result<std::shared_ptr<arrow::Buffer>> override {
+    auto result = this->_input->Read(nbytes);
+    if (result.ok()) {
+      this->_bytesRead.fetch_add(result.ValueOrDie()->size(), std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  auto bytesRead() const -> int64_t { return this->_bytesRead.load(std::memory_order_relaxed); }
+
+ private:
+  std::shared_ptr<arrow::io::InputStream> _input;
+  std::atomic<int64_t> _bytesRead{0};
+};
+
+auto makeReadOptions(const LoaderOptions& options) -> arrow::csv::ReadOptions {
+  applyThreadCount(options);
+  auto readOptions = arrow::csv::ReadOptions::Defaults();
+  readOptions.use_threads = options.useThreads;
+  readOptions.block_size = options.blockSize;
+  return readOptions;
+}
+
+auto makeParseOptions(const LoaderOptions& options) -> arrow::csv::ParseOptions {
+  auto parseOptions = arrow::csv::ParseOptions::Defaults();
+  parseOptions.delimiter = options.delimiter;
+  parseOptions.quoting = options.quoting;
+  parseOptions.quote_char = options.quoteChar;
+  return parseOptions;
+}
+
+auto makeConvertOptions(const LoaderOptions& options) -> arrow::csv::ConvertOptions {
+  auto convertOptions = arrow::csv::ConvertOptions::Defaults();
+  convertOptions.include_columns = options.includeColumns;
+  convertOptions.include_missing_columns = true;
+  convertOptions.column_types = options.columnTypes;
+  if (!options.nullValues.empty()) {
+    convertOptions.null_values = options.nullValues;
+  }
+  return convertOptions;
+}
+
+}  // anonymous namespace
+
 auto CSVLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
     -> std::shared_ptr<arrow::Table> {
   return probegl::catchError<arrow::Table>([&]() { return this->loadTable(input); }, error);
 }
 
+auto CSVLoader::loadBatches(const std::shared_ptr<arrow::io::InputStream> input,
+                            const std::function<BatchCallback>& onBatch,
+                            const std::function<ProgressCallback>& onProgress, probegl::Error& error) noexcept
+    -> std::shared_ptr<Progress> {
+  return probegl::catchError<Progress>([&]() { return this->loadBatches(input, onBatch, onProgress); }, error);
+}
+
+auto CSVLoader::openBatchReader(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  return probegl::catchError<arrow::RecordBatchReader>([&]() { return this->openBatchReader(input); }, error);
+}
+
+auto CSVLoader::loadTable(const std::string& path, probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table> {
+  return probegl::catchError<arrow::Table>([&]() { return this->loadTable(path); }, error);
+}
+
+auto CSVLoader::openBatchReader(const std::string& path, probegl::Error& error) noexcept
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  return probegl::catchError<arrow::RecordBatchReader>([&]() { return this->openBatchReader(path); }, error);
+}
+
 auto CSVLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input) -> std::shared_ptr<arrow::Table> {
   arrow::MemoryPool* pool = arrow::default_memory_pool();
 
-  auto readOptions = arrow::csv::ReadOptions::Defaults();
-  auto parseOptions = arrow::csv::ParseOptions::Defaults();
-  auto convertOptions = arrow::csv::ConvertOptions::Defaults();
+  auto readOptions = makeReadOptions(this->options);
+  auto parseOptions = makeParseOptions(this->options);
+  auto convertOptions = makeConvertOptions(this->options);
 
   // Instantiate TableReader from input stream and options
   auto makeResult = arrow::csv::TableReader::Make(pool, input, readOptions, parseOptions, convertOptions);
@@ -56,3 +146,79 @@ auto CSVLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input) -
 
   return table;
 }
+
+auto CSVLoader::loadTableAsync(const std::shared_ptr<arrow::io::InputStream> input, LoaderPool& pool)
+    -> std::shared_ptr<LoadHandle> {
+  // Streaming readers fix column types after the first block, so the whole input goes through loadTable() instead,
+  // for column types to be inferred the same way
+  return pool.load([loader = *this, input](const CancellationToken& token) mutable {
+    return loader.loadTable(std::make_shared<CancellableInputStream>(input, token));
+  });
+}
+
+auto CSVLoader::loadBatches(const std::shared_ptr<arrow::io::InputStream> input,
+                            const std::function<BatchCallback>& onBatch,
+                            const std::function<ProgressCallback>& onProgress) -> Progress {
+  auto countingInput = std::make_shared<CountingInputStream>(input);
+  auto reader = this->openBatchReader(countingInput);
+
+  Progress progress;
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    if (!reader->ReadNext(&batch).ok()) {
+      throw std::runtime_error("An error has occured while parsing CSV data");
+    }
+    if (!batch) {
+      break;
+    }
+
+    progress.batchesRead++;
+    progress.rowsRead += batch->num_rows();
+    progress.bytesRead = countingInput->bytesRead();
+    progress.cancelled = !onBatch(batch);
+    if (onProgress) {
+      onProgress(progress);
+    }
+    if (progress.cancelled) {
+      break;
+    }
+  }
+
+  return progress;
+}
+
+auto CSVLoader::openBatchReader(const std::shared_ptr<arrow::io::InputStream> input)
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+
+  auto readOptions = makeReadOptions(this->options);
+  auto parseOptions = makeParseOptions(this->options);
+  auto convertOptions = makeConvertOptions(this->options);
+
+  auto makeResult = arrow::csv::StreamingReader::Make(pool, input, readOptions, parseOptions, convertOptions);
+  if (!makeResult.ok()) {
+    throw std::runtime_error("Cannot instantiate StreamingReader");
+  }
+
+  return makeResult.ValueOrDie();
+}
+
+auto CSVLoader::loadTable(const std::string& path) -> std::shared_ptr<arrow::Table> {
+  return this->loadTable(mapFile(path, FileAccess::SEQUENTIAL));
+}
+
+auto CSVLoader::loadTableAsync(const std::string& path, LoaderPool& pool) -> std::shared_ptr<LoadHandle> {
+  return pool.load([loader = *this, path](const CancellationToken& token) mutable {
+    auto input = std::make_shared<CancellableInputStream>(mapFile(path, FileAccess::SEQUENTIAL), token);
+    return loader.loadTable(input);
+  });
+}
+
+auto CSVLoader::loadBatches(const std::string& path, const std::function<BatchCallback>& onBatch,
+                            const std::function<ProgressCallback>& onProgress) -> Progress {
+  return this->loadBatches(mapFile(path, FileAccess::SEQUENTIAL), onBatch, onProgress);
+}
+
+auto CSVLoader::openBatchReader(const std::string& path) -> std::shared_ptr<arrow::RecordBatchReader> {
+  return this->openBatchReader(mapFile(path, FileAccess::SEQUENTIAL));
+}
@@ -22,24 +22,91 @@
 #define LOADERSGL_CSV_CSV_LOADER_H
 
 #include <arrow/io/interfaces.h>
+#include <arrow/record_batch.h>
 #include <arrow/table.h>
 
+#include <functional>
 #include <memory>
+#include <string>
 
+#include "../../core/src/load-progress.h"
+#include "../../core/src/loader-options.h"
+#include "../../core/src/loader-pool.h"
 #include "probe.gl/core.h"
 
 namespace loadersgl {
 
 class CSVLoader {
  public:
+  explicit CSVLoader(const LoaderOptions& options = {}) : options{options} {}
+
+  using Progress = LoadProgress;
+  using BatchCallback = loadersgl::BatchCallback;
+  using ProgressCallback = loadersgl::ProgressCallback;
+
 #pragma mark - Exception-free API
 
   auto loadTable(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
       -> std::shared_ptr<arrow::Table>;
 
+  auto loadBatches(const std::shared_ptr<arrow::io::InputStream> input, const std::function<BatchCallback>& onBatch,
+                   const std::function<ProgressCallback>& onProgress, probegl::Error& error) noexcept
+      -> std::shared_ptr<Progress>;
+
+  auto openBatchReader(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+
+  auto loadTable(const std::string& path, probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table>;
+
+  auto openBatchReader(const std::string& path, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+
 #pragma mark -
 
+  /// \brief Parses the whole input into a single table.
   auto loadTable(const std::shared_ptr<arrow::io::InputStream> input) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Parses the whole input on a loader pool thread, inferring column types the same way loadTable() does.
+  /// Cancelling the returned handle stops parsing before the next block of input is read.
+  /// \note The load uses a copy of the loader, later changes to options don't affect it.
+  auto loadTableAsync(const std::shared_ptr<arrow::io::InputStream> input, LoaderPool& pool = LoaderPool::shared())
+      -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Parses the input one block at a time, handing out each block as a record batch as soon as it's parsed, so
+  /// that the data can be displayed before the whole input has been read. Only a few blocks are held in memory at once.
+  /// \param input Stream to read CSV data from.
+  /// \param onBatch Called on the calling thread for each batch, in input order. Returning false stops loading, which
+  /// is also how loading is cancelled from other threads.
+  /// \param onProgress Optional, called after each batch has been handled.
+  /// \return Final progress of the load.
+  auto loadBatches(const std::shared_ptr<arrow::io::InputStream> input, const std::function<BatchCallback>& onBatch,
+                   const std::function<ProgressCallback>& onProgress = nullptr) -> Progress;
+
+  /// \brief Opens a reader that parses the next block of the input each time a batch is requested from it.
+  /// \note The first block is parsed right away, as column types are inferred from it.
+  auto openBatchReader(const std::shared_ptr<arrow::io::InputStream> input)
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+
+  /// \brief Parses a local file into a single table. The file is memory mapped and read sequentially, so blocks are
+  /// parsed straight out of the page cache.
+  /// \param path Path to a CSV file.
+  auto loadTable(const std::string& path) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Parses a memory mapped local file on a loader pool thread, see loadTableAsync() for streams.
+  /// \param path Path to a CSV file, which is only opened once the load starts.
+  auto loadTableAsync(const std::string& path, LoaderPool& pool = LoaderPool::shared()) -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Parses a memory mapped local file one block at a time, see loadBatches() for streams.
+  /// \param path Path to a CSV file.
+  auto loadBatches(const std::string& path, const std::function<BatchCallback>& onBatch,
+                   const std::function<ProgressCallback>& onProgress = nullptr) -> Progress;
+
+  /// \brief Opens a reader that parses the next block of a memory mapped local file each time a batch is requested.
+  /// \param path Path to a CSV file.
+  auto openBatchReader(const std::string& path) -> std::shared_ptr<arrow::RecordBatchReader>;
+
+  /// \brief Options used by all loads.
+  LoaderOptions options;
 };
 
 }  // namespace loadersgl
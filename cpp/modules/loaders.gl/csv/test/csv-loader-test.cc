@@ -20,8 +20,13 @@
 
 #include <arrow/array.h>
 #include <arrow/io/memory.h>
+#include <arrow/util/thread_pool.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -37,7 +42,7 @@ namespace {
  */
 class CSVLoaderTest : public ::testing::Test {
  protected:
-  CSVLoaderTest() : csvLoader{std::unique_ptr<CSVLoader>()} {}
+  CSVLoaderTest() : csvLoader{std::make_unique<CSVLoader>()} {}
 
   std::unique_ptr<CSVLoader> csvLoader;
 };
@@ -86,4 +91,190 @@ TEST_F(CSVLoaderTest, LoadStates) {
   EXPECT_EQ(aliases->GetString(0), "AK");
 }
 
+TEST_F(CSVLoaderTest, LoadTableAsync) {
+  auto input = std::make_shared<arrow::io::BufferReader>(csvDataStates);
+  LoaderPool pool{1};
+
+  auto handle = csvLoader->loadTableAsync(input, pool);
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = handle->get(); });
+  EXPECT_TRUE(handle->isReady());
+  EXPECT_EQ(table->num_columns(), 3);
+  EXPECT_GT(table->num_rows(), 0);
+}
+
+TEST_F(CSVLoaderTest, LoadTableAsyncSchema) {
+  LoaderOptions options;
+  options.blockSize = 16;
+  CSVLoader loader{options};
+  LoaderPool pool{1};
+
+  // Column types change after the first block, which async loads still pick up
+  std::string data = "value\n";
+  for (auto i = 0; i < 20; i++) {
+    data += std::to_string(i) + "\n";
+  }
+  data += "2.5\n";
+  auto table = loader.loadTable(std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(data)));
+  auto handle = loader.loadTableAsync(std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(data)), pool);
+
+  std::shared_ptr<arrow::Table> asyncTable;
+  ASSERT_NO_THROW({ asyncTable = handle->get(); });
+  EXPECT_EQ(table->schema()->field(0)->type()->id(), arrow::Type::DOUBLE);
+  EXPECT_TRUE(asyncTable->schema()->Equals(*table->schema()));
+  EXPECT_EQ(asyncTable->num_rows(), 21);
+}
+
+TEST_F(CSVLoaderTest, LoadFile) {
+  auto path = (std::filesystem::temp_directory_path() / "loadersgl-csv-loader-test.csv").string();
+  std::ofstream{path} << csvDataStates;
+
+  // Local files are memory mapped rather than read through a stream
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = csvLoader->loadTable(path); });
+  EXPECT_EQ(table->num_rows(), 110);
+  EXPECT_EQ(table->num_columns(), 3);
+
+  int64_t rowCount = 0;
+  auto progress = csvLoader->loadBatches(path, [&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+    rowCount += batch->num_rows();
+    return true;
+  });
+  EXPECT_EQ(rowCount, 110);
+  EXPECT_EQ(progress.bytesRead, static_cast<int64_t>(std::strlen(csvDataStates)));
+
+  LoaderPool pool{1};
+  EXPECT_EQ(csvLoader->loadTableAsync(path, pool)->get()->num_rows(), 110);
+  std::remove(path.c_str());
+
+  probegl::Error error;
+  EXPECT_EQ(csvLoader->loadTable("missing.csv", error), nullptr);
+  EXPECT_TRUE(error.has_value());
+}
+
+TEST_F(CSVLoaderTest, LoadBatches) {
+  auto input = std::make_shared<arrow::io::BufferReader>(csvDataStates);
+
+  int64_t rowCount = 0;
+  int progressCount = 0;
+  CSVLoader::Progress progress;
+  ASSERT_NO_THROW({
+    progress = csvLoader->loadBatches(
+        input,
+        [&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+          EXPECT_EQ(batch->num_columns(), 3);
+          rowCount += batch->num_rows();
+          return true;
+        },
+        [&](const CSVLoader::Progress& batchProgress) {
+          progressCount++;
+          EXPECT_EQ(batchProgress.rowsRead, rowCount);
+        });
+  });
+
+  EXPECT_EQ(rowCount, 110);
+  EXPECT_EQ(progress.rowsRead, 110);
+  EXPECT_EQ(progress.batchesRead, progressCount);
+  EXPECT_EQ(progress.bytesRead, static_cast<int64_t>(std::strlen(csvDataStates)));
+  EXPECT_FALSE(progress.cancelled);
+}
+
+TEST_F(CSVLoaderTest, LoadBatchesBlockSize) {
+  auto input = std::make_shared<arrow::io::BufferReader>(csvDataStates);
+
+  csvLoader->options.blockSize = 256;
+  int64_t rowCount = 0;
+  auto progress = csvLoader->loadBatches(input, [&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+    rowCount += batch->num_rows();
+    return true;
+  });
+
+  EXPECT_GT(progress.batchesRead, 1);
+  EXPECT_EQ(rowCount, 110);
+}
+
+TEST_F(CSVLoaderTest, CancelLoadBatches) {
+  auto input = std::make_shared<arrow::io::BufferReader>(csvDataStates);
+
+  int batchCount = 0;
+  auto progress = csvLoader->loadBatches(input, [&](const std::shared_ptr<arrow::RecordBatch>&) {
+    batchCount++;
+    return false;
+  });
+
+  EXPECT_EQ(batchCount, 1);
+  EXPECT_EQ(progress.batchesRead, 1);
+  EXPECT_TRUE(progress.cancelled);
+}
+
+TEST_F(CSVLoaderTest, OpenBatchReader) {
+  auto input = std::make_shared<arrow::io::BufferReader>(csvDataStates);
+
+  std::shared_ptr<arrow::RecordBatchReader> reader;
+  ASSERT_NO_THROW({ reader = csvLoader->openBatchReader(input); });
+  EXPECT_EQ(reader->schema()->num_fields(), 3);
+
+  std::shared_ptr<arrow::RecordBatch> batch;
+  ASSERT_TRUE(reader->ReadNext(&batch).ok());
+  ASSERT_NE(batch, nullptr);
+  auto aliases = std::static_pointer_cast<arrow::StringArray>(batch->GetColumnByName("alias"));
+  EXPECT_EQ(aliases->GetString(0), "AK");
+}
+
+TEST_F(CSVLoaderTest, LoaderOptions) {
+  auto input = std::make_shared<arrow::io::BufferReader>("int;string;value\n1;'a;b';NA\n2;c;3\n");
+
+  LoaderOptions options;
+  options.includeColumns = {"value", "int", "missing"};
+  options.columnTypes = {{"int", arrow::float32()}};
+  options.useThreads = false;
+  options.delimiter = ';';
+  options.quoteChar = '\'';
+  options.nullValues = {"NA"};
+  CSVLoader loader{options};
+
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = loader.loadTable(input); });
+
+  // Only included columns are loaded, in the order they were included in
+  ASSERT_EQ(table->num_columns(), 3);
+  EXPECT_EQ(table->num_rows(), 2);
+  EXPECT_EQ(table->schema()->field(0)->name(), "value");
+  EXPECT_EQ(table->schema()->field(1)->name(), "int");
+  EXPECT_EQ(table->schema()->field(2)->name(), "missing");
+
+  auto values = table->column(0)->chunk(0);
+  EXPECT_EQ(values->type_id(), arrow::Type::INT64);
+  EXPECT_TRUE(values->IsNull(0));
+  EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(values)->Value(1), 3);
+
+  auto ints = table->column(1)->chunk(0);
+  ASSERT_EQ(ints->type_id(), arrow::Type::FLOAT);
+  EXPECT_FLOAT_EQ(std::static_pointer_cast<arrow::FloatArray>(ints)->Value(1), 2.0f);
+
+  EXPECT_EQ(table->column(2)->null_count(), 2);
+}
+
+TEST_F(CSVLoaderTest, ThreadCount) {
+  auto capacity = arrow::GetCpuThreadPoolCapacity();
+
+  LoaderOptions options;
+  options.threadCount = capacity + 1;
+  CSVLoader loader{options};
+  ASSERT_NO_THROW(loader.loadTable(std::make_shared<arrow::io::BufferReader>("int\n1\n")));
+  EXPECT_EQ(arrow::GetCpuThreadPoolCapacity(), capacity + 1);
+
+  // Thread count is a process-wide setting, which later loads don't change
+  options.threadCount = capacity + 2;
+  CSVLoader{options}.loadTable(std::make_shared<arrow::io::BufferReader>("int\n1\n"));
+  EXPECT_EQ(arrow::GetCpuThreadPoolCapacity(), capacity + 1);
+
+  // Thread count is ignored when threads aren't used
+  options.useThreads = false;
+  CSVLoader{options}.loadTable(std::make_shared<arrow::io::BufferReader>("int\n1\n"));
+  EXPECT_EQ(arrow::GetCpuThreadPoolCapacity(), capacity + 1);
+
+  ASSERT_TRUE(arrow::SetCpuThreadPoolCapacity(capacity).ok());
+}
+
 }  // namespace
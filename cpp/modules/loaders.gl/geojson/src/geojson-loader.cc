@@ -0,0 +1,941 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./geojson-loader.h"  // NOLINT(build/include)
+
+#include <arrow/api.h>
+#include <arrow/buffer_builder.h>
+
+#include <locale.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../core/src/column-selection.h"
+
+#if defined(PROBEGL_PLATFORM_APPLE)
+#include <xlocale.h>
+#endif
+
+using namespace loadersgl;
+
+namespace {
+
+// Names of geometry columns, properties with the same names are skipped
+constexpr const char* kGeometryTypeColumn = "geometryType";
+constexpr const char* kCoordinatesColumn = "coordinates";
+constexpr const char* kRingOffsetsColumn = "ringOffsets";
+constexpr const char* kPolygonOffsetsColumn = "polygonOffsets";
+
+/// Index of properties that aren't loaded
+constexpr size_t kSkippedProperty = std::numeric_limits<size_t>::max();
+
+enum class GeometryType { None, Point, LineString, Polygon, MultiPoint, MultiLineString, MultiPolygon };
+
+const std::array<const char*, 7> kGeometryTypeNames{
+    nullptr, "Point", "LineString", "Polygon", "MultiPoint", "MultiLineString", "MultiPolygon"};
+
+auto getGeometryType(const std::string& name) -> GeometryType {
+  for (size_t i = 1; i < kGeometryTypeNames.size(); ++i) {
+    if (name == kGeometryTypeNames[i]) {
+      return static_cast<GeometryType>(i);
+    }
+  }
+  return GeometryType::None;
+}
+
+/// \brief Returns the "C" locale, which numbers are parsed and formatted in regardless of the current locale.
+/// \note Floating point std::from_chars and std::to_chars aren't available on all the platforms we build for.
+auto getClassicLocale() -> locale_t {
+  static const locale_t locale = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+  return locale;
+}
+
+/// \brief Switches the calling thread to the "C" locale, for as long as it's alive.
+class ScopedClassicLocale {
+ public:
+  ScopedClassicLocale() : _previousLocale{uselocale(getClassicLocale())} {}
+  ~ScopedClassicLocale() { uselocale(this->_previousLocale); }
+
+  ScopedClassicLocale(const ScopedClassicLocale&) = delete;
+  auto operator=(const ScopedClassicLocale&) -> ScopedClassicLocale& = delete;
+
+ private:
+  locale_t _previousLocale;
+};
+
+/// \brief Returns the end of a JSON number that text starts with, or text itself if it doesn't start with one.
+auto scanNumber(const char* text) -> const char* {
+  auto isDigit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; };
+  auto skipDigits = [&](const char* position) {
+    while (isDigit(*position)) {
+      ++position;
+    }
+    return position;
+  };
+
+  auto position = text + (*text == '-' ? 1 : 0);
+  if (!isDigit(*position)) {
+    return text;
+  }
+  position = skipDigits(position);
+
+  if (*position == '.') {
+    if (!isDigit(*++position)) {
+      return text;
+    }
+    position = skipDigits(position);
+  }
+
+  if (*position == 'e' || *position == 'E') {
+    ++position;
+    if (*position == '+' || *position == '-') {
+      ++position;
+    }
+    if (!isDigit(*position)) {
+      return text;
+    }
+    position = skipDigits(position);
+  }
+
+  return position;
+}
+
+enum class PropertyType { Null, Bool, Int, Double, String };
+
+/// \brief Returns a type that can hold values of both types. Numbers widen to doubles, anything else to strings.
+auto mergePropertyTypes(PropertyType a, PropertyType b) -> PropertyType {
+  if (a == PropertyType::Null || a == b) {
+    return b;
+  }
+  if (b == PropertyType::Null) {
+    return a;
+  }
+
+  auto isNumeric = [](PropertyType type) { return type == PropertyType::Int || type == PropertyType::Double; };
+  return isNumeric(a) && isNumeric(b) ? PropertyType::Double : PropertyType::String;
+}
+
+auto getDataType(PropertyType type) -> std::shared_ptr<arrow::DataType> {
+  switch (type) {
+    case PropertyType::Bool:
+      return arrow::boolean();
+    case PropertyType::Int:
+      return arrow::int64();
+    case PropertyType::Double:
+      return arrow::float64();
+    case PropertyType::String:
+      return arrow::utf8();
+
+    default:
+      return arrow::null();
+  }
+}
+
+/// \brief Numeric value of a property, booleans are stored as integers.
+union Number {
+  double real;
+  int64_t integer;
+};
+
+/// \brief Values of a property, one per row. Rows past the end of types are null.
+struct PropertyColumn {
+  std::string name;
+  PropertyType type{PropertyType::Null};
+  std::vector<PropertyType> types;
+  std::vector<Number> numbers;
+  /// Only holds values up to the last row with a string value
+  std::vector<std::string> strings;
+};
+
+/// \brief Columns of features parsed from a block of input. Geometry is written straight into Arrow buffers.
+struct FeatureColumns {
+  FeatureColumns() {
+    check(this->coordinateOffsets.Append(0));
+    check(this->ringListOffsets.Append(0));
+    check(this->polygonListOffsets.Append(0));
+  }
+
+  static void check(const arrow::Status& status) {
+    if (!status.ok()) {
+      throw std::runtime_error(status.ToString());
+    }
+  }
+
+  int64_t numRows{0};
+  std::vector<GeometryType> geometryTypes;
+
+  arrow::TypedBufferBuilder<double> coordinates;
+  arrow::TypedBufferBuilder<int32_t> coordinateOffsets;
+  arrow::TypedBufferBuilder<int32_t> ringOffsets;
+  arrow::TypedBufferBuilder<int32_t> ringListOffsets;
+  arrow::TypedBufferBuilder<int32_t> polygonOffsets;
+  arrow::TypedBufferBuilder<int32_t> polygonListOffsets;
+
+  std::vector<PropertyColumn> properties;
+  std::unordered_map<std::string, size_t> propertyIndices;
+};
+
+/// \brief Single pass GeoJSON parser that writes features into columns as it goes, without building a document.
+/// \note Relies on input being null terminated.
+class FeatureParser {
+ public:
+  FeatureParser(const std::string& input, size_t offset, FeatureColumns& columns,
+                const std::vector<std::string>& includeColumns)
+      : _input{input}, _position{input.data() + offset}, _columns{columns}, _includeColumns{includeColumns} {}
+
+  /// \brief Parses a single top level object.
+  /// \return Whether the object is followed by the end of a line or input.
+  auto parseValue() -> bool {
+    this->_parseFeature();
+    while (*this->_position == ' ' || *this->_position == '\t' || *this->_position == '\r') {
+      ++this->_position;
+    }
+    return *this->_position == '\n' || *this->_position == '\0';
+  }
+
+  /// \brief Parses top level objects that start before end.
+  void parseValues(const char* end) {
+    for (this->_skipWhitespace(); this->_position < end; this->_skipWhitespace()) {
+      this->_parseFeature();
+    }
+  }
+
+  auto offset() const -> size_t { return static_cast<size_t>(this->_position - this->_input.data()); }
+
+ private:
+  auto _error(const std::string& message) const -> std::runtime_error {
+    return std::runtime_error("Invalid GeoJSON data at byte " + std::to_string(this->offset()) + ": " + message);
+  }
+
+  void _skipWhitespace() {
+    while (*this->_position == ' ' || *this->_position == '\n' || *this->_position == '\r' ||
+           *this->_position == '\t') {
+      ++this->_position;
+    }
+  }
+
+  auto _consume(char character) -> bool {
+    this->_skipWhitespace();
+    if (*this->_position != character) {
+      return false;
+    }
+
+    ++this->_position;
+    return true;
+  }
+
+  void _expect(char character) {
+    if (!this->_consume(character)) {
+      throw this->_error(std::string{"expected '"} + character + "'");
+    }
+  }
+
+  auto _parseLiteral(const char* literal) -> bool {
+    this->_skipWhitespace();
+    auto length = std::strlen(literal);
+    if (std::strncmp(this->_position, literal, length) != 0) {
+      return false;
+    }
+
+    this->_position += length;
+    return true;
+  }
+
+  template <typename Function>
+  void _parseObject(Function&& parseMember) {
+    this->_expect('{');
+    if (this->_consume('}')) {
+      return;
+    }
+
+    do {
+      auto key = this->_parseString();
+      this->_expect(':');
+      parseMember(key);
+    } while (this->_consume(','));
+    this->_expect('}');
+  }
+
+  template <typename Function>
+  void _parseArray(Function&& parseElement) {
+    this->_expect('[');
+    if (this->_consume(']')) {
+      return;
+    }
+
+    do {
+      parseElement();
+    } while (this->_consume(','));
+    this->_expect(']');
+  }
+
+  auto _parseString() -> std::string {
+    this->_expect('"');
+    std::string value;
+    auto start = this->_position;
+    while (*this->_position != '"') {
+      if (*this->_position == '\0') {
+        throw this->_error("unterminated string");
+      }
+      if (*this->_position != '\\') {
+        ++this->_position;
+        continue;
+      }
+
+      value.append(start, this->_position);
+      ++this->_position;
+      switch (*this->_position++) {
+        case '"':
+          value += '"';
+          break;
+        case '\\':
+          value += '\\';
+          break;
+        case '/':
+          value += '/';
+          break;
+        case 'b':
+          value += '\b';
+          break;
+        case 'f':
+          value += '\f';
+          break;
+        case 'n':
+          value += '\n';
+          break;
+        case 'r':
+          value += '\r';
+          break;
+        case 't':
+          value += '\t';
+          break;
+        case 'u':
+          this->_appendCodePoint(value);
+          break;
+
+        default:
+          throw this->_error("invalid escape sequence");
+      }
+      start = this->_position;
+    }
+
+    value.append(start, this->_position);
+    ++this->_position;
+    return value;
+  }
+
+  auto _parseHexQuad() -> uint32_t {
+    uint32_t value = 0;
+    for (auto i = 0; i < 4; ++i) {
+      auto character = *this->_position;
+      if (!std::isxdigit(static_cast<unsigned char>(character))) {
+        throw this->_error("invalid unicode escape");
+      }
+
+      auto digit = std::isdigit(static_cast<unsigned char>(character)) ? character - '0'
+                                                                       : std::tolower(character) - 'a' + 10;
+      value = value * 16 + static_cast<uint32_t>(digit);
+      ++this->_position;
+    }
+    return value;
+  }
+
+  /// \brief Parses the digits of a \u escape sequence, combining surrogate pairs, and appends them as UTF-8.
+  void _appendCodePoint(std::string& value) {
+    auto codePoint = this->_parseHexQuad();
+    if (codePoint >= 0xD800 && codePoint < 0xDC00 && std::strncmp(this->_position, "\\u", 2) == 0) {
+      this->_position += 2;
+      auto lowSurrogate = this->_parseHexQuad();
+      codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+    }
+
+    if (codePoint < 0x80) {
+      value += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+      value += static_cast<char>(0xC0 | (codePoint >> 6));
+      value += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+      value += static_cast<char>(0xE0 | (codePoint >> 12));
+      value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      value += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+      value += static_cast<char>(0xF0 | (codePoint >> 18));
+      value += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+      value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      value += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+  }
+
+  /// \brief Parses a number, keeping integers that fit into int64 exact. Parsing doesn't depend on the current
+  /// locale, and numbers that aren't finite or are out of the range of doubles are rejected.
+  auto _parseNumber(Number& number) -> PropertyType {
+    this->_skipWhitespace();
+    auto start = this->_position;
+    if (*start != '-' && !std::isdigit(static_cast<unsigned char>(*start))) {
+      throw this->_error("expected a value");
+    }
+
+    // Input is null terminated, so numbers can be scanned and parsed without checking for its end
+    auto end = scanNumber(start);
+    char* parseEnd = nullptr;
+    number.real = strtod_l(start, &parseEnd, getClassicLocale());
+    if (end == start || parseEnd != end || !std::isfinite(number.real)) {
+      throw this->_error("invalid number");
+    }
+    this->_position = end;
+    if (std::any_of(start, end, [](char c) { return c == '.' || c == 'e' || c == 'E'; })) {
+      return PropertyType::Double;
+    }
+
+    // Integers out of range are kept as doubles instead
+    int64_t integer;
+    if (std::from_chars(start, end, integer).ec != std::errc{}) {
+      return PropertyType::Double;
+    }
+
+    number.integer = integer;
+    return PropertyType::Int;
+  }
+
+  void _skipValue() {
+    this->_skipWhitespace();
+    switch (*this->_position) {
+      case '{':
+        this->_parseObject([this](const std::string&) { this->_skipValue(); });
+        break;
+      case '[':
+        this->_parseArray([this]() { this->_skipValue(); });
+        break;
+      case '"':
+        this->_parseString();
+        break;
+
+      default:
+        if (!this->_parseLiteral("true") && !this->_parseLiteral("false") && !this->_parseLiteral("null")) {
+          Number number;
+          this->_parseNumber(number);
+        }
+    }
+  }
+
+  /// \brief Parses a Feature, a FeatureCollection or a bare geometry object.
+  void _parseFeature() {
+    auto type = GeometryType::None;
+    auto isCollection = false;
+    this->_parseObject([&](const std::string& key) {
+      if (key == "type") {
+        auto name = this->_parseString();
+        isCollection = isCollection || name == "FeatureCollection";
+        type = name == "Feature" ? type : getGeometryType(name);
+      } else if (key == "features") {
+        isCollection = true;
+        this->_parseArray([this]() { this->_parseFeature(); });
+      } else if (key == "geometry") {
+        type = this->_parseGeometry();
+      } else if (key == "coordinates") {
+        this->_parseCoordinates();
+      } else if (key == "properties") {
+        this->_parseProperties();
+      } else {
+        this->_skipValue();
+      }
+    });
+
+    if (!isCollection) {
+      this->_finishRow(type);
+    }
+  }
+
+  auto _parseGeometry() -> GeometryType {
+    auto type = GeometryType::None;
+    if (this->_parseLiteral("null")) {
+      return type;
+    }
+
+    this->_parseObject([&](const std::string& key) {
+      if (key == "type") {
+        type = getGeometryType(this->_parseString());
+      } else if (key == "coordinates") {
+        this->_parseCoordinates();
+      } else {
+        this->_skipValue();
+      }
+    });
+    return type;
+  }
+
+  /// \brief Parses coordinates of any geometry type, recording offsets of nested lists from their depth.
+  /// \return Depth of the coordinates, 1 for a position and 0 for an empty list.
+  auto _parseCoordinates() -> int {
+    auto& columns = this->_columns;
+    this->_expect('[');
+    this->_skipWhitespace();
+    if (*this->_position != '[' && *this->_position != ']') {
+      // Altitude defaults to zero, further dimensions are ignored
+      std::array<double, 3> position{};
+      size_t dimensions = 0;
+      do {
+        Number number;
+        auto type = this->_parseNumber(number);
+        if (dimensions < position.size()) {
+          position[dimensions] = type == PropertyType::Int ? static_cast<double>(number.integer) : number.real;
+        }
+        dimensions++;
+      } while (this->_consume(','));
+      this->_expect(']');
+
+      FeatureColumns::check(columns.coordinates.Append(position.data(), position.size()));
+      return 1;
+    }
+
+    auto firstPosition = columns.coordinates.length() / 3;
+    auto firstRing = columns.ringOffsets.length();
+    auto depth = 0;
+    if (!this->_consume(']')) {
+      do {
+        depth = std::max(depth, this->_parseCoordinates() + 1);
+      } while (this->_consume(','));
+      this->_expect(']');
+    }
+
+    if (depth == 2) {
+      FeatureColumns::check(columns.ringOffsets.Append(static_cast<int32_t>(firstPosition - this->_rowPosition)));
+    } else if (depth == 3) {
+      FeatureColumns::check(columns.polygonOffsets.Append(static_cast<int32_t>(firstRing - this->_rowRing)));
+    }
+    return depth;
+  }
+
+  void _parseProperties() {
+    if (this->_parseLiteral("null")) {
+      return;
+    }
+
+    this->_parseObject([this](const std::string& key) {
+      auto column = this->_getPropertyColumn(key);
+      if (column) {
+        this->_parsePropertyValue(*column);
+      } else {
+        this->_skipValue();
+      }
+    });
+  }
+
+  void _parsePropertyValue(PropertyColumn& column) {
+    this->_skipWhitespace();
+    auto start = this->_position;
+    Number number{};
+    switch (*this->_position) {
+      case '"':
+        this->_setPropertyValue(column, PropertyType::String, number, this->_parseString());
+        return;
+      case '{':
+      case '[':
+        // Nested values are kept as JSON text
+        this->_skipValue();
+        this->_setPropertyValue(column, PropertyType::String, number, std::string{start, this->_position});
+        return;
+
+      default:
+        if (this->_parseLiteral("null")) {
+          return;
+        }
+        if (this->_parseLiteral("true") || this->_parseLiteral("false")) {
+          number.integer = *start == 't';
+          this->_setPropertyValue(column, PropertyType::Bool, number);
+          return;
+        }
+
+        auto type = this->_parseNumber(number);
+        this->_setPropertyValue(column, type, number);
+    }
+  }
+
+  void _setPropertyValue(PropertyColumn& column, PropertyType type, Number number, std::string string = {}) {
+    auto row = static_cast<size_t>(this->_columns.numRows);
+    column.types.resize(row + 1, PropertyType::Null);
+    column.numbers.resize(row + 1);
+    column.types[row] = type;
+    column.numbers[row] = number;
+    if (type == PropertyType::String) {
+      column.strings.resize(row + 1);
+      column.strings[row] = std::move(string);
+    }
+    column.type = mergePropertyTypes(column.type, type);
+  }
+
+  auto _getPropertyColumn(const std::string& name) -> PropertyColumn* {
+    auto& columns = this->_columns;
+    auto [index, inserted] = columns.propertyIndices.try_emplace(name, kSkippedProperty);
+    if (inserted && this->_isPropertyIncluded(name)) {
+      index->second = columns.properties.size();
+      columns.properties.push_back(PropertyColumn{name});
+    }
+
+    return index->second == kSkippedProperty ? nullptr : &columns.properties[index->second];
+  }
+
+  auto _isPropertyIncluded(const std::string& name) const -> bool {
+    for (auto geometryColumn : {kGeometryTypeColumn, kCoordinatesColumn, kRingOffsetsColumn, kPolygonOffsetsColumn}) {
+      if (name == geometryColumn) {
+        return false;
+      }
+    }
+
+    const auto& includeColumns = this->_includeColumns;
+    auto included = std::find(includeColumns.begin(), includeColumns.end(), name) != includeColumns.end();
+    return includeColumns.empty() || included;
+  }
+
+  void _finishRow(GeometryType type) {
+    auto& columns = this->_columns;
+    auto positions = columns.coordinates.length() / 3;
+    if (positions > std::numeric_limits<int32_t>::max()) {
+      throw std::runtime_error("Too many positions in a block of GeoJSON data");
+    }
+
+    columns.geometryTypes.push_back(type);
+    FeatureColumns::check(columns.coordinateOffsets.Append(static_cast<int32_t>(positions)));
+    FeatureColumns::check(columns.ringListOffsets.Append(static_cast<int32_t>(columns.ringOffsets.length())));
+    FeatureColumns::check(columns.polygonListOffsets.Append(static_cast<int32_t>(columns.polygonOffsets.length())));
+    columns.numRows++;
+
+    this->_rowPosition = positions;
+    this->_rowRing = columns.ringOffsets.length();
+  }
+
+  const std::string& _input;
+  const char* _position;
+  FeatureColumns& _columns;
+  const std::vector<std::string>& _includeColumns;
+
+  /// Index of the first position and ring of the current row, which offsets are relative to
+  int64_t _rowPosition{0};
+  int64_t _rowRing{0};
+};
+
+auto readInput(const std::shared_ptr<arrow::io::InputStream>& input, int64_t blockSize) -> std::string {
+  std::string data;
+  while (true) {
+    auto buffer = input->Read(blockSize);
+    if (!buffer.ok()) {
+      throw std::runtime_error("An error has occured while reading GeoJSON data");
+    }
+    if ((*buffer)->size() == 0) {
+      return data;
+    }
+
+    data.append(reinterpret_cast<const char*>((*buffer)->data()), static_cast<size_t>((*buffer)->size()));
+  }
+}
+
+/// \brief Splits lines of input into blocks of about blockSize bytes.
+/// \return Offsets at which the blocks start, followed by the size of the input.
+auto splitLines(const std::string& input, size_t blockSize) -> std::vector<size_t> {
+  std::vector<size_t> offsets{0};
+  do {
+    auto lineEnd = input.find('\n', std::min(offsets.back() + blockSize, input.size()));
+    offsets.push_back(lineEnd == std::string::npos ? input.size() : lineEnd + 1);
+  } while (offsets.back() < input.size());
+
+  return offsets;
+}
+
+/// \brief Formats a number with as few digits as needed to read it back exactly, always using a decimal point.
+auto formatNumber(double value) -> std::string {
+  std::array<char, 32> text;
+  {
+    // snprintf has no variant taking a locale on all platforms, so the thread's locale is switched instead
+    ScopedClassicLocale classicLocale;
+    for (auto precision = 15; precision < 17; ++precision) {
+      std::snprintf(text.data(), text.size(), "%.*g", precision, value);
+      if (strtod_l(text.data(), nullptr, getClassicLocale()) == value) {
+        return text.data();
+      }
+    }
+
+    std::snprintf(text.data(), text.size(), "%.17g", value);
+  }
+  return text.data();
+}
+
+/// \brief Blocks of input that are parsed concurrently. Shared with pool threads, which may only start once all the
+/// blocks have been parsed and the load has returned.
+struct BlockParses {
+  /// \brief Parses a single block. Only called for claimed blocks, while the load is waiting for them.
+  std::function<void(size_t)> parseBlock;
+  size_t blockCount{0};
+  std::atomic<size_t> nextIndex{0};
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t parsedCount{0};
+  std::exception_ptr error;
+};
+
+/// \brief Claims and parses blocks until all of them have been claimed, recording the first error.
+void parseClaimedBlocks(BlockParses& parses) {
+  for (auto index = parses.nextIndex++; index < parses.blockCount; index = parses.nextIndex++) {
+    std::exception_ptr error;
+    try {
+      parses.parseBlock(index);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{parses.mutex};
+      if (error && !parses.error) {
+        parses.error = error;
+      }
+      parses.parsedCount++;
+    }
+    parses.condition.notify_all();
+  }
+}
+
+template <typename Builder, typename Append>
+auto makePropertyArray(const PropertyColumn* column, int64_t length, Append&& append)
+    -> std::shared_ptr<arrow::Array> {
+  Builder builder;
+  FeatureColumns::check(builder.Reserve(length));
+  for (size_t row = 0; row < static_cast<size_t>(length); ++row) {
+    auto type = column && row < column->types.size() ? column->types[row] : PropertyType::Null;
+    FeatureColumns::check(type == PropertyType::Null ? builder.AppendNull() : append(builder, type, row));
+  }
+
+  std::shared_ptr<arrow::Array> array;
+  FeatureColumns::check(builder.Finish(&array));
+  return array;
+}
+
+auto makePropertyArray(const PropertyColumn* column, PropertyType type, int64_t length)
+    -> std::shared_ptr<arrow::Array> {
+  switch (type) {
+    case PropertyType::Bool:
+      return makePropertyArray<arrow::BooleanBuilder>(column, length, [&](auto& builder, auto, auto row) {
+        return builder.Append(column->numbers[row].integer != 0);
+      });
+    case PropertyType::Int:
+      return makePropertyArray<arrow::Int64Builder>(column, length, [&](auto& builder, auto, auto row) {
+        return builder.Append(column->numbers[row].integer);
+      });
+    case PropertyType::Double:
+      return makePropertyArray<arrow::DoubleBuilder>(column, length, [&](auto& builder, auto rowType, auto row) {
+        const auto& number = column->numbers[row];
+        return builder.Append(rowType == PropertyType::Int ? static_cast<double>(number.integer) : number.real);
+      });
+    case PropertyType::String:
+      return makePropertyArray<arrow::StringBuilder>(column, length, [&](auto& builder, auto rowType, auto row) {
+        const auto& number = column->numbers[row];
+        switch (rowType) {
+          case PropertyType::Bool:
+            return builder.Append(std::string{number.integer ? "true" : "false"});
+          case PropertyType::Int:
+            return builder.Append(std::to_string(number.integer));
+          case PropertyType::Double:
+            return builder.Append(formatNumber(number.real));
+
+          default:
+            return builder.Append(column->strings[row]);
+        }
+      });
+
+    default:
+      return std::make_shared<arrow::NullArray>(length);
+  }
+}
+
+auto makeGeometrySchema() -> std::vector<std::shared_ptr<arrow::Field>> {
+  return {arrow::field(kGeometryTypeColumn, arrow::utf8()),
+          arrow::field(kCoordinatesColumn, arrow::list(arrow::fixed_size_list(arrow::float64(), 3))),
+          arrow::field(kRingOffsetsColumn, arrow::list(arrow::int32())),
+          arrow::field(kPolygonOffsetsColumn, arrow::list(arrow::int32()))};
+}
+
+template <typename T>
+auto finishBuffer(arrow::TypedBufferBuilder<T>& builder) -> std::shared_ptr<arrow::Buffer> {
+  std::shared_ptr<arrow::Buffer> buffer;
+  FeatureColumns::check(builder.Finish(&buffer));
+  return buffer;
+}
+
+/// \brief Makes a record batch out of parsed columns, using list offsets and coordinates without copying them.
+auto makeRecordBatch(FeatureColumns& columns, const std::shared_ptr<arrow::Schema>& schema,
+                     const std::vector<PropertyType>& propertyTypes) -> std::shared_ptr<arrow::RecordBatch> {
+  arrow::StringBuilder geometryTypeBuilder;
+  for (auto type : columns.geometryTypes) {
+    FeatureColumns::check(type == GeometryType::None
+                              ? geometryTypeBuilder.AppendNull()
+                              : geometryTypeBuilder.Append(std::string{kGeometryTypeNames[static_cast<size_t>(type)]}));
+  }
+  std::shared_ptr<arrow::Array> geometryTypes;
+  FeatureColumns::check(geometryTypeBuilder.Finish(&geometryTypes));
+
+  auto coordinatesType = std::static_pointer_cast<arrow::ListType>(schema->field(1)->type());
+  auto numPositions = columns.coordinates.length() / 3;
+  auto values = std::make_shared<arrow::DoubleArray>(numPositions * 3, finishBuffer(columns.coordinates));
+  auto positions = std::make_shared<arrow::FixedSizeListArray>(coordinatesType->value_type(), numPositions, values);
+  auto coordinates = std::make_shared<arrow::ListArray>(coordinatesType, columns.numRows,
+                                                        finishBuffer(columns.coordinateOffsets), positions);
+
+  auto ringOffsets =
+      std::make_shared<arrow::Int32Array>(columns.ringOffsets.length(), finishBuffer(columns.ringOffsets));
+  auto polygonOffsets =
+      std::make_shared<arrow::Int32Array>(columns.polygonOffsets.length(), finishBuffer(columns.polygonOffsets));
+
+  std::vector<std::shared_ptr<arrow::Array>> arrays{
+      geometryTypes, coordinates,
+      std::make_shared<arrow::ListArray>(schema->field(2)->type(), columns.numRows,
+                                         finishBuffer(columns.ringListOffsets), ringOffsets),
+      std::make_shared<arrow::ListArray>(schema->field(3)->type(), columns.numRows,
+                                         finishBuffer(columns.polygonListOffsets), polygonOffsets)};
+
+  for (size_t i = 0; i < propertyTypes.size(); ++i) {
+    auto index = columns.propertyIndices.find(schema->field(static_cast<int>(arrays.size()))->name());
+    auto column = index != columns.propertyIndices.end() && index->second != kSkippedProperty
+                      ? &columns.properties[index->second]
+                      : nullptr;
+    arrays.push_back(makePropertyArray(column, propertyTypes[i], columns.numRows));
+  }
+
+  return arrow::RecordBatch::Make(schema, columns.numRows, arrays);
+}
+
+}  // anonymous namespace
+
+auto GeoJSONLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
+    -> std::shared_ptr<arrow::Table> {
+  return probegl::catchError<arrow::Table>([&]() { return this->loadTable(input); }, error);
+}
+
+auto GeoJSONLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input) -> std::shared_ptr<arrow::Table> {
+  auto blockSize = std::max(this->options.blockSize, 1);
+  auto data = readInput(input, blockSize);
+  const auto& includeColumns = this->options.includeColumns;
+
+  std::vector<std::unique_ptr<FeatureColumns>> blocks;
+  blocks.push_back(std::make_unique<FeatureColumns>());
+  FeatureParser firstParser{data, 0, *blocks.front(), includeColumns};
+
+  // Input is newline delimited when its first object ends a line, in which case it's split into blocks of lines
+  std::vector<size_t> offsets{0, data.size()};
+  if (data.find_first_not_of(" \t\r\n") != std::string::npos && firstParser.parseValue()) {
+    offsets = splitLines(data, static_cast<size_t>(blockSize));
+
+    // The first block continues after the object that has already been parsed
+    auto firstEnd = std::find_if(offsets.begin() + 1, offsets.end(),
+                                 [&](size_t offset) { return offset >= firstParser.offset(); });
+    offsets.erase(offsets.begin() + 1, firstEnd);
+  }
+  while (blocks.size() + 1 < offsets.size()) {
+    blocks.push_back(std::make_unique<FeatureColumns>());
+  }
+
+  auto parses = std::make_shared<BlockParses>();
+  parses->blockCount = blocks.size();
+  parses->parseBlock = [&](size_t index) {
+    auto end = data.data() + offsets[index + 1];
+    if (index == 0) {
+      firstParser.parseValues(end);
+    } else {
+      FeatureParser{data, offsets[index], *blocks[index], includeColumns}.parseValues(end);
+    }
+  };
+
+  // Pool threads help with parsing, while the calling thread parses blocks too, so that the load completes even if
+  // it's called from a pool thread and all the other pool threads are busy
+  size_t threadCount = 1;
+  if (this->options.useThreads) {
+    threadCount = this->options.threadCount > 0 ? static_cast<size_t>(this->options.threadCount)
+                                                : std::max(1u, std::thread::hardware_concurrency());
+  }
+  auto helperCount = std::min(threadCount, blocks.size()) - 1;
+  for (size_t i = 0; i < helperCount; ++i) {
+    LoaderPool::shared().load([parses](const CancellationToken&) {
+      parseClaimedBlocks(*parses);
+      return std::shared_ptr<arrow::Table>{};
+    });
+  }
+  parseClaimedBlocks(*parses);
+
+  {
+    std::unique_lock<std::mutex> lock{parses->mutex};
+    parses->condition.wait(lock, [&]() { return parses->parsedCount == parses->blockCount; });
+    if (parses->error) {
+      std::rethrow_exception(parses->error);
+    }
+  }
+
+  // Properties are typed across all blocks, in order of first appearance
+  auto fields = makeGeometrySchema();
+  std::vector<PropertyType> propertyTypes;
+  std::unordered_map<std::string, size_t> propertyIndices;
+  for (const auto& block : blocks) {
+    for (const auto& column : block->properties) {
+      auto [index, inserted] = propertyIndices.try_emplace(column.name, propertyTypes.size());
+      if (inserted) {
+        propertyTypes.push_back(column.type);
+      } else {
+        propertyTypes[index->second] = mergePropertyTypes(propertyTypes[index->second], column.type);
+      }
+    }
+  }
+  fields.resize(fields.size() + propertyTypes.size());
+  for (const auto& [name, index] : propertyIndices) {
+    fields[fields.size() - propertyTypes.size() + index] = arrow::field(name, getDataType(propertyTypes[index]));
+  }
+
+  auto schema = arrow::schema(fields);
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (auto& block : blocks) {
+    batches.push_back(makeRecordBatch(*block, schema, propertyTypes));
+  }
+
+  auto table = arrow::Table::FromRecordBatches(schema, batches);
+  if (!table.ok()) {
+    throw std::runtime_error("An error has occured while loading GeoJSON data");
+  }
+
+  return selectColumns(*table, includeColumns);
+}
+
+auto GeoJSONLoader::loadTableAsync(const std::shared_ptr<arrow::io::InputStream> input, LoaderPool& pool)
+    -> std::shared_ptr<LoadHandle> {
+  return pool.load([loader = *this, input](const CancellationToken&) mutable { return loader.loadTable(input); });
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_GEOJSON_GEOJSON_LOADER_H
+#define LOADERSGL_GEOJSON_GEOJSON_LOADER_H
+
+#include <arrow/io/interfaces.h>
+#include <arrow/table.h>
+
+#include <memory>
+
+#include "../../core/src/loader-options.h"
+#include "../../core/src/loader-pool.h"
+#include "probe.gl/core.h"
+
+namespace loadersgl {
+
+/// \brief Loads GeoJSON features into tables with flat geometry columns, without building a JSON document first.
+///
+/// Input is either a single GeoJSON object, such as a FeatureCollection, or newline delimited GeoJSON objects, one
+/// per line. Each Feature or bare geometry becomes a row with the following geometry columns:
+/// - geometryType: utf8, GeoJSON type of the geometry, such as "MultiPolygon". Null for unsupported geometries.
+/// - coordinates: list<fixed_size_list<float64, 3>>, all positions of the geometry. Missing altitudes are zero.
+/// - ringOffsets: list<int32>, index of the first position of each list of positions, such as a polygon ring.
+/// - polygonOffsets: list<int32>, index in ringOffsets of the first ring of each list of rings, such as a polygon.
+/// Properties are loaded into columns of their own, typed as bool, int64, float64 or utf8. Properties whose values
+/// have different types are loaded as utf8, with objects and arrays kept as JSON text.
+class GeoJSONLoader {
+ public:
+  explicit GeoJSONLoader(const LoaderOptions& options = {}) : options{options} {}
+
+#pragma mark - Exception-free API
+
+  auto loadTable(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::Table>;
+
+#pragma mark -
+
+  /// \brief Loads all features of the input. Newline delimited input is parsed in blocks of about options.blockSize
+  /// bytes, concurrently when threads are enabled. Each block is loaded as a separate chunk.
+  auto loadTable(const std::shared_ptr<arrow::io::InputStream> input) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Loads all features of the input on a loader pool thread. Cancelling the returned handle only skips the
+  /// load if it hasn't started yet.
+  /// \note The load uses a copy of the loader, later changes to options don't affect it.
+  auto loadTableAsync(const std::shared_ptr<arrow::io::InputStream> input, LoaderPool& pool = LoaderPool::shared())
+      -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Options used by all loads. Properties that aren't included are skipped while parsing. Column types and
+  /// options specific to CSV are ignored.
+  LoaderOptions options;
+};
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_GEOJSON_GEOJSON_LOADER_H
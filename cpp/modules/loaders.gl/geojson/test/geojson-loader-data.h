@@ -0,0 +1,59 @@
+// Copyright (c) 2020 Unfolded, Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+static auto geojsonFeatureCollection = R"JSON({
+  "type": "FeatureCollection",
+  "features": [
+    {
+      "type": "Feature",
+      "properties": {"name": "point", "value": 1, "visible": true},
+      "geometry": {"type": "Point", "coordinates": [-122.45, 37.8]}
+    },
+    {
+      "type": "Feature",
+      "geometry": {
+        "coordinates": [[[0, 0, 10], [1, 0, 10], [1, 1, 10], [0, 0, 10]], [[0.2, 0.2], [0.4, 0.2], [0.2, 0.2]]],
+        "type": "Polygon"
+      },
+      "properties": {"name": "polygon é", "value": 2.5, "tags": ["a", "b"]}
+    },
+    {
+      "type": "Feature",
+      "geometry": {
+        "type": "MultiLineString",
+        "coordinates": [[[0, 0], [1, 1]], [[2, 2], [3, 3], [4, 4]]]
+      },
+      "properties": null
+    },
+    {
+      "type": "Feature",
+      "geometry": null,
+      "properties": {"name": "empty", "visible": false}
+    }
+  ]
+})JSON";
+
+static auto ndjsonFeatures = R"JSON(
+{"type":"Feature","geometry":{"type":"Point","coordinates":[0,0]},"properties":{"id":0,"value":1}}
+{"type":"Feature","geometry":{"type":"Point","coordinates":[1,1]},"properties":{"id":1,"value":2}}
+{"type":"Feature","geometry":{"type":"LineString","coordinates":[[2,2],[3,3]]},"properties":{"id":2}}
+{"type":"Feature","geometry":{"type":"Point","coordinates":[3,3]},"properties":{"id":3,"value":4.5}}
+{"type":"MultiPolygon","coordinates":[[[[0,0],[1,0],[0,0]]],[[[5,5],[6,5],[5,5]]]]}
+)JSON";
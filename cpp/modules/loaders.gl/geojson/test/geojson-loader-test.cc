@@ -0,0 +1,192 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/array.h>
+#include <arrow/io/memory.h>
+#include <gtest/gtest.h>
+
+#include <clocale>
+#include <memory>
+#include <string>
+
+#include "./geojson-loader-data.h"
+#include "deck.gl/layers.h"
+#include "loaders.gl/geojson.h"
+
+using namespace loadersgl;
+
+namespace {
+
+TEST(GeoJSONLoaderTest, FeatureCollection) {
+  GeoJSONLoader loader;
+  auto input = std::make_shared<arrow::io::BufferReader>(geojsonFeatureCollection);
+
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = loader.loadTable(input); });
+
+  ASSERT_EQ(table->num_rows(), 4);
+  ASSERT_EQ(table->num_columns(), 8);
+  ASSERT_EQ(table->column(0)->num_chunks(), 1);
+
+  auto geometryTypes = std::static_pointer_cast<arrow::StringArray>(table->GetColumnByName("geometryType")->chunk(0));
+  EXPECT_EQ(geometryTypes->GetString(0), "Point");
+  EXPECT_EQ(geometryTypes->GetString(1), "Polygon");
+  EXPECT_EQ(geometryTypes->GetString(2), "MultiLineString");
+  EXPECT_TRUE(geometryTypes->IsNull(3));
+
+  // Positions of all geometries share a single buffer
+  auto coordinates = std::static_pointer_cast<arrow::ListArray>(table->GetColumnByName("coordinates")->chunk(0));
+  auto positions = std::static_pointer_cast<arrow::FixedSizeListArray>(coordinates->values());
+  auto values = std::static_pointer_cast<arrow::DoubleArray>(positions->values());
+  EXPECT_EQ(values->length(), 13 * 3);
+  EXPECT_EQ(coordinates->value_length(1), 7);
+  EXPECT_EQ(coordinates->value_length(3), 0);
+  EXPECT_DOUBLE_EQ(values->Value(0), -122.45);
+  EXPECT_DOUBLE_EQ(values->Value(2), 0.0);
+  EXPECT_DOUBLE_EQ(values->Value(coordinates->value_offset(1) * 3 + 2), 10.0);
+
+  // Rows can be accessed as lists of positions
+  deckgl::Row row{table, 1};
+  auto polygon = row.getVector3List<double>("coordinates");
+  ASSERT_EQ(polygon.size(), 7u);
+  EXPECT_EQ(polygon[1], (mathgl::Vector3<double>{1.0, 0.0, 10.0}));
+
+  // Offsets are relative to rows
+  auto ringOffsets = std::static_pointer_cast<arrow::ListArray>(table->GetColumnByName("ringOffsets")->chunk(0));
+  auto rings = std::static_pointer_cast<arrow::Int32Array>(ringOffsets->values());
+  EXPECT_EQ(ringOffsets->value_length(0), 0);
+  ASSERT_EQ(ringOffsets->value_length(1), 2);
+  EXPECT_EQ(rings->Value(ringOffsets->value_offset(1) + 1), 4);
+  ASSERT_EQ(ringOffsets->value_length(2), 2);
+  EXPECT_EQ(rings->Value(ringOffsets->value_offset(2) + 1), 2);
+
+  auto polygonOffsets = std::static_pointer_cast<arrow::ListArray>(table->GetColumnByName("polygonOffsets")->chunk(0));
+  EXPECT_EQ(polygonOffsets->value_length(0), 0);
+  EXPECT_EQ(polygonOffsets->value_length(1), 1);
+  EXPECT_EQ(polygonOffsets->value_length(2), 1);
+
+  // Properties
+  auto names = std::static_pointer_cast<arrow::StringArray>(table->GetColumnByName("name")->chunk(0));
+  EXPECT_EQ(names->GetString(1), "polygon é");
+  EXPECT_TRUE(names->IsNull(2));
+
+  auto numbers = std::static_pointer_cast<arrow::DoubleArray>(table->GetColumnByName("value")->chunk(0));
+  EXPECT_DOUBLE_EQ(numbers->Value(0), 1.0);
+  EXPECT_DOUBLE_EQ(numbers->Value(1), 2.5);
+
+  auto visible = std::static_pointer_cast<arrow::BooleanArray>(table->GetColumnByName("visible")->chunk(0));
+  EXPECT_TRUE(visible->Value(0));
+  EXPECT_FALSE(visible->Value(3));
+  EXPECT_TRUE(visible->IsNull(1));
+
+  auto tags = std::static_pointer_cast<arrow::StringArray>(table->GetColumnByName("tags")->chunk(0));
+  EXPECT_EQ(tags->GetString(1), R"(["a", "b"])");
+}
+
+TEST(GeoJSONLoaderTest, NDJSON) {
+  LoaderOptions options;
+  options.blockSize = 64;
+  GeoJSONLoader loader{options};
+  auto input = std::make_shared<arrow::io::BufferReader>(ndjsonFeatures);
+
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = loader.loadTable(input); });
+
+  // Each line ends up in a block of its own
+  ASSERT_EQ(table->num_rows(), 5);
+  EXPECT_EQ(table->column(0)->num_chunks(), 5);
+
+  // Property types are merged across blocks
+  EXPECT_EQ(table->GetColumnByName("id")->type()->id(), arrow::Type::INT64);
+  EXPECT_EQ(table->GetColumnByName("value")->type()->id(), arrow::Type::DOUBLE);
+  EXPECT_EQ(table->GetColumnByName("value")->null_count(), 2);
+
+  deckgl::Row row{table, 3};
+  EXPECT_EQ(row.getInt("id"), 3);
+  EXPECT_DOUBLE_EQ(row.getDouble("value"), 4.5);
+  EXPECT_EQ(row.getVector3List<double>("coordinates").size(), 1u);
+
+  row.incrementRowIndex();
+  EXPECT_EQ(row.getString("geometryType"), "MultiPolygon");
+  EXPECT_EQ(row.getVector3List<double>("coordinates").size(), 6u);
+  EXPECT_FALSE(row.isValid("id"));
+}
+
+TEST(GeoJSONLoaderTest, IncludeColumns) {
+  LoaderOptions options;
+  options.includeColumns = {"coordinates", "name"};
+  GeoJSONLoader loader{options};
+
+  auto table = loader.loadTable(std::make_shared<arrow::io::BufferReader>(geojsonFeatureCollection));
+  ASSERT_EQ(table->num_columns(), 2);
+  EXPECT_EQ(table->schema()->field(0)->name(), "coordinates");
+  EXPECT_EQ(table->schema()->field(1)->name(), "name");
+
+  probegl::Error error;
+  auto invalidInput = std::make_shared<arrow::io::BufferReader>(R"JSON({"type": "Feature", "geometry": {)JSON");
+  EXPECT_EQ(loader.loadTable(invalidInput, error), nullptr);
+  EXPECT_TRUE(error.has_value());
+}
+
+TEST(GeoJSONLoaderTest, Numbers) {
+  GeoJSONLoader loader;
+  auto load = [&](const std::string& value) {
+    auto feature = R"JSON({"type": "Feature", "geometry": null, "properties": {"value": )JSON" + value + "}}";
+    return loader.loadTable(std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(feature)));
+  };
+
+  EXPECT_EQ(load("-12")->GetColumnByName("value")->type()->id(), arrow::Type::INT64);
+  EXPECT_DOUBLE_EQ(deckgl::Row(load("-2.5e-1"), 0).getDouble("value"), -0.25);
+
+  // Integers out of the range of int64 are kept as doubles
+  auto table = load("12345678901234567890");
+  EXPECT_EQ(table->GetColumnByName("value")->type()->id(), arrow::Type::DOUBLE);
+  EXPECT_DOUBLE_EQ(deckgl::Row(table, 0).getDouble("value"), 12345678901234567890.0);
+
+  // Numbers that can't be represented as finite doubles are rejected
+  EXPECT_THROW(load("-inf"), std::runtime_error);
+  EXPECT_THROW(load("-nan"), std::runtime_error);
+  EXPECT_THROW(load("1e400"), std::runtime_error);
+  EXPECT_THROW(load("-"), std::runtime_error);
+  EXPECT_THROW(load("0x10"), std::runtime_error);
+
+  // Numbers are parsed and formatted the same way in locales with a decimal comma, if one is installed
+  std::string previousLocale = std::setlocale(LC_ALL, nullptr);
+  for (auto name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8"}) {
+    if (std::setlocale(LC_ALL, name)) {
+      break;
+    }
+  }
+
+  EXPECT_DOUBLE_EQ(deckgl::Row(load("0.5"), 0).getDouble("value"), 0.5);
+
+  // Numbers in columns that also contain strings are formatted with a decimal point
+  auto features = R"JSON({"type": "Feature", "geometry": null, "properties": {"value": 2.5}}
+{"type": "Feature", "geometry": null, "properties": {"value": "a"}}
+)JSON";
+  auto mixed = loader.loadTable(std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(features)));
+  EXPECT_EQ(mixed->GetColumnByName("value")->type()->id(), arrow::Type::STRING);
+  EXPECT_EQ(deckgl::Row(mixed, 0).getString("value"), "2.5");
+  EXPECT_EQ(deckgl::Row(mixed, 1).getString("value"), "a");
+
+  std::setlocale(LC_ALL, previousLocale.c_str());
+}
+
+}  // namespace
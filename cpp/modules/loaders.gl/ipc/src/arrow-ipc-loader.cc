@@ -0,0 +1,181 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./arrow-ipc-loader.h"  // NOLINT(build/include)
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+
+#include <cstring>
+#include <vector>
+
+#include "../../core/src/column-selection.h"
+#include "../../core/src/mapped-file.h"
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief Magic bytes that files in IPC file format start with, stream format data doesn't have any.
+constexpr char fileFormatMagic[] = "ARROW1";
+constexpr int64_t fileFormatMagicLength = sizeof(fileFormatMagic) - 1;
+
+/// \brief Reads record batches of a file in IPC file format in order.
+class FileBatchReader : public arrow::RecordBatchReader {
+ public:
+  explicit FileBatchReader(const std::shared_ptr<arrow::ipc::RecordBatchFileReader>& reader) : _reader{reader} {}
+
+  auto schema() const -> std::shared_ptr<arrow::Schema> override { return this->_reader->schema(); }
+
+  auto ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) -> arrow::Status override {
+    if (this->_batchIndex >= this->_reader->num_record_batches()) {
+      *batch = nullptr;
+      return arrow::Status::OK();
+    }
+
+    auto readResult = this->_reader->ReadRecordBatch(this->_batchIndex++);
+    if (!readResult.ok()) {
+      return readResult.status();
+    }
+    *batch = readResult.ValueOrDie();
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> _reader;
+  int _batchIndex{0};
+};
+
+auto isFileFormat(const std::shared_ptr<arrow::io::RandomAccessFile>& input) -> bool {
+  auto readResult = input->ReadAt(0, fileFormatMagicLength);
+  if (!readResult.ok()) {
+    throw std::runtime_error("Cannot read Arrow IPC data");
+  }
+
+  auto magic = readResult.ValueOrDie();
+  return magic->size() == fileFormatMagicLength &&
+         std::memcmp(magic->data(), fileFormatMagic, fileFormatMagicLength) == 0;
+}
+
+auto makeReadOptions(const LoaderOptions& options) -> arrow::ipc::IpcReadOptions {
+  applyThreadCount(options);
+  auto readOptions = arrow::ipc::IpcReadOptions::Defaults();
+  readOptions.use_threads = options.useThreads;
+  return readOptions;
+}
+
+auto openFileReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                    const arrow::ipc::IpcReadOptions& readOptions)
+    -> std::shared_ptr<arrow::ipc::RecordBatchFileReader> {
+  auto openResult = arrow::ipc::RecordBatchFileReader::Open(input, readOptions);
+  if (!openResult.ok()) {
+    throw std::runtime_error("Cannot instantiate RecordBatchFileReader");
+  }
+  return openResult.ValueOrDie();
+}
+
+}  // anonymous namespace
+
+auto ArrowIPCLoader::loadTable(const std::string& path, probegl::Error& error) noexcept
+    -> std::shared_ptr<arrow::Table> {
+  return probegl::catchError<arrow::Table>([&]() { return this->loadTable(path); }, error);
+}
+
+auto ArrowIPCLoader::loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                               probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table> {
+  return probegl::catchError<arrow::Table>([&]() { return this->loadTable(input); }, error);
+}
+
+auto ArrowIPCLoader::openBatchReader(const std::string& path, probegl::Error& error) noexcept
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  return probegl::catchError<arrow::RecordBatchReader>([&]() { return this->openBatchReader(path); }, error);
+}
+
+auto ArrowIPCLoader::openFile(const std::string& path, probegl::Error& error) noexcept
+    -> std::shared_ptr<arrow::ipc::RecordBatchFileReader> {
+  return probegl::catchError<arrow::ipc::RecordBatchFileReader>([&]() { return this->openFile(path); }, error);
+}
+
+auto ArrowIPCLoader::loadTable(const std::string& path) -> std::shared_ptr<arrow::Table> {
+  return this->loadTable(mapFile(path));
+}
+
+auto ArrowIPCLoader::loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input)
+    -> std::shared_ptr<arrow::Table> {
+  auto reader = this->_openBatchReader(input);
+
+  std::shared_ptr<arrow::Table> table;
+  if (!reader->ReadAll(&table).ok()) {
+    throw std::runtime_error("An error has occured while reading Arrow IPC data");
+  }
+
+  return table;
+}
+
+auto ArrowIPCLoader::loadTableAsync(const std::string& path, LoaderPool& pool) -> std::shared_ptr<LoadHandle> {
+  return pool.load([loader = *this, path](const CancellationToken& token) mutable {
+    auto reader = loader.openBatchReader(path);
+    return readTable(*reader, token);
+  });
+}
+
+auto ArrowIPCLoader::openBatchReader(const std::string& path) -> std::shared_ptr<arrow::RecordBatchReader> {
+  return this->_openBatchReader(mapFile(path));
+}
+
+auto ArrowIPCLoader::openFile(const std::string& path) -> std::shared_ptr<arrow::ipc::RecordBatchFileReader> {
+  auto input = mapFile(path);
+  if (!isFileFormat(input)) {
+    throw std::runtime_error("Not an Arrow IPC file, stream format data can only be read in order");
+  }
+
+  auto readOptions = makeReadOptions(this->options);
+  auto reader = openFileReader(input, readOptions);
+  if (this->options.includeColumns.empty()) {
+    return reader;
+  }
+
+  // Batches read on demand aren't post-processed, so only the included fields that exist are read instead
+  for (const auto& name : this->options.includeColumns) {
+    auto index = reader->schema()->GetFieldIndex(name);
+    if (index >= 0) {
+      readOptions.included_fields.push_back(index);
+    }
+  }
+
+  return openFileReader(input, readOptions);
+}
+
+auto ArrowIPCLoader::_openBatchReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input)
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  std::shared_ptr<arrow::RecordBatchReader> reader;
+  if (isFileFormat(input)) {
+    reader = std::make_shared<FileBatchReader>(openFileReader(input, makeReadOptions(this->options)));
+  } else {
+    auto openResult = arrow::ipc::RecordBatchStreamReader::Open(input, makeReadOptions(this->options));
+    if (!openResult.ok()) {
+      throw std::runtime_error("Cannot instantiate RecordBatchStreamReader");
+    }
+    reader = openResult.ValueOrDie();
+  }
+
+  // Other columns are decoded too, but as they're referenced rather than copied, their pages are never touched
+  return selectColumns(reader, this->options.includeColumns);
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_IPC_ARROW_IPC_LOADER_H
+#define LOADERSGL_IPC_ARROW_IPC_LOADER_H
+
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+
+#include <memory>
+#include <string>
+
+#include "../../core/src/loader-options.h"
+#include "../../core/src/loader-pool.h"
+#include "probe.gl/core.h"
+
+namespace loadersgl {
+
+/// \brief Loads tables stored in Arrow IPC file (Feather v2) or stream format. Files are memory mapped, so loaded
+/// tables reference the mapped pages directly, without copying or parsing any data. Pages of columns that are never
+/// read aren't loaded from disk at all.
+/// \note Tables keep the mapping alive, files shouldn't be modified while tables loaded from them are in use.
+class ArrowIPCLoader {
+ public:
+  explicit ArrowIPCLoader(const LoaderOptions& options = {}) : options{options} {}
+
+#pragma mark - Exception-free API
+
+  auto loadTable(const std::string& path, probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table>;
+  auto loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::Table>;
+  auto openBatchReader(const std::string& path, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+  auto openFile(const std::string& path, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::ipc::RecordBatchFileReader>;
+
+#pragma mark -
+
+  /// \brief Memory maps a file and loads all of its record batches into a table.
+  /// \param path Path to a file in IPC file or stream format, the format is detected from the file's contents.
+  auto loadTable(const std::string& path) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Loads all record batches from an input into a table. Data is only referenced, not copied, when the input
+  /// supports zero copy reads, such as memory mapped files and buffers.
+  /// \param input Input in IPC file or stream format, the format is detected from the input's contents.
+  auto loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Memory maps a file and loads its record batches on a loader pool thread. Cancelling the returned handle
+  /// stops loading at the next batch.
+  /// \note The load uses a copy of the loader, later changes to options don't affect it.
+  auto loadTableAsync(const std::string& path, LoaderPool& pool = LoaderPool::shared()) -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Memory maps a file and opens a reader that loads one record batch at a time, in order.
+  /// \param path Path to a file in IPC file or stream format.
+  auto openBatchReader(const std::string& path) -> std::shared_ptr<arrow::RecordBatchReader>;
+
+  /// \brief Memory maps a file in IPC file format and opens a reader that loads record batches on demand, in any order.
+  /// Only the footer of the file is read when it is opened.
+  /// \note Batches read through the returned reader contain the included columns that exist in the file, in file order.
+  auto openFile(const std::string& path) -> std::shared_ptr<arrow::ipc::RecordBatchFileReader>;
+
+  /// \brief Options used by all loads. Only included columns and threading apply to IPC data.
+  LoaderOptions options;
+
+ private:
+  auto _openBatchReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input)
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+};
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_IPC_ARROW_IPC_LOADER_H
@@ -0,0 +1,150 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "loaders.gl/ipc.h"
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief The fixture for testing class ArrowIPCLoader. Writes the same two batches in file and stream format.
+class ArrowIPCLoaderTest : public ::testing::Test {
+ protected:
+  ArrowIPCLoaderTest() {
+    auto directory = std::filesystem::temp_directory_path();
+    filePath = (directory / "loadersgl-ipc-test.arrow").string();
+    streamPath = (directory / "loadersgl-ipc-test.arrows").string();
+
+    auto schema = arrow::schema({arrow::field("int", arrow::int32()), arrow::field("double", arrow::float64())});
+    for (auto batchIndex = 0; batchIndex < 2; batchIndex++) {
+      arrow::Int32Builder intBuilder;
+      arrow::DoubleBuilder doubleBuilder;
+      for (auto i = 0; i < 3; i++) {
+        EXPECT_TRUE(intBuilder.Append(batchIndex * 3 + i).ok());
+        EXPECT_TRUE(doubleBuilder.Append((batchIndex * 3 + i) / 2.0).ok());
+      }
+
+      std::shared_ptr<arrow::Array> ints;
+      std::shared_ptr<arrow::Array> doubles;
+      EXPECT_TRUE(intBuilder.Finish(&ints).ok());
+      EXPECT_TRUE(doubleBuilder.Finish(&doubles).ok());
+      batches.push_back(arrow::RecordBatch::Make(schema, 3, {ints, doubles}));
+    }
+
+    this->_write(filePath, true);
+    this->_write(streamPath, false);
+  }
+
+  ~ArrowIPCLoaderTest() {
+    std::remove(filePath.c_str());
+    std::remove(streamPath.c_str());
+  }
+
+  std::string filePath;
+  std::string streamPath;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+
+ private:
+  void _write(const std::string& path, bool fileFormat) {
+    auto sink = arrow::io::FileOutputStream::Open(path).ValueOrDie();
+    auto schema = batches[0]->schema();
+    auto writer = fileFormat ? arrow::ipc::NewFileWriter(sink.get(), schema).ValueOrDie()
+                             : arrow::ipc::NewStreamWriter(sink.get(), schema).ValueOrDie();
+    for (const auto& batch : batches) {
+      EXPECT_TRUE(writer->WriteRecordBatch(*batch).ok());
+    }
+    EXPECT_TRUE(writer->Close().ok());
+    EXPECT_TRUE(sink->Close().ok());
+  }
+};
+
+TEST_F(ArrowIPCLoaderTest, LoadTable) {
+  ArrowIPCLoader loader;
+  for (const auto& path : {filePath, streamPath}) {
+    std::shared_ptr<arrow::Table> table;
+    ASSERT_NO_THROW({ table = loader.loadTable(path); });
+
+    EXPECT_EQ(table->num_rows(), 6);
+    EXPECT_EQ(table->num_columns(), 2);
+    EXPECT_EQ(table->column(0)->num_chunks(), 2);
+
+    auto ints = std::static_pointer_cast<arrow::Int32Array>(table->column(0)->chunk(1));
+    EXPECT_EQ(ints->Value(0), 3);
+    auto doubles = std::static_pointer_cast<arrow::DoubleArray>(table->column(1)->chunk(1));
+    EXPECT_DOUBLE_EQ(doubles->Value(2), 2.5);
+  }
+
+  probegl::Error error;
+  EXPECT_EQ(loader.loadTable("missing.arrow", error), nullptr);
+  EXPECT_TRUE(error.has_value());
+}
+
+TEST_F(ArrowIPCLoaderTest, IncludeColumns) {
+  LoaderOptions options;
+  options.includeColumns = {"double", "missing"};
+  ArrowIPCLoader loader{options};
+
+  auto table = loader.loadTable(streamPath);
+  ASSERT_EQ(table->num_columns(), 2);
+  EXPECT_EQ(table->schema()->field(0)->name(), "double");
+  EXPECT_EQ(table->column(1)->null_count(), 6);
+
+  // Batches read on demand only contain included columns that exist
+  auto reader = loader.openFile(filePath);
+  auto batch = reader->ReadRecordBatch(0).ValueOrDie();
+  ASSERT_EQ(batch->num_columns(), 1);
+  EXPECT_EQ(batch->schema()->field(0)->name(), "double");
+}
+
+TEST_F(ArrowIPCLoaderTest, LazyLoading) {
+  ArrowIPCLoader loader;
+
+  // Batches of files can be read in any order
+  auto fileReader = loader.openFile(filePath);
+  ASSERT_EQ(fileReader->num_record_batches(), 2);
+  auto batch = fileReader->ReadRecordBatch(1).ValueOrDie();
+  EXPECT_EQ(std::static_pointer_cast<arrow::Int32Array>(batch->column(0))->Value(0), 3);
+  EXPECT_THROW(loader.openFile(streamPath), std::runtime_error);
+
+  // Batches of both formats can be read in order
+  for (const auto& path : {filePath, streamPath}) {
+    auto reader = loader.openBatchReader(path);
+    int batchCount = 0;
+    std::shared_ptr<arrow::RecordBatch> nextBatch;
+    while (reader->ReadNext(&nextBatch).ok() && nextBatch) {
+      EXPECT_TRUE(nextBatch->Equals(*batches[batchCount]));
+      batchCount++;
+    }
+    EXPECT_EQ(batchCount, 2);
+  }
+}
+
+}  // namespace
@@ -23,22 +23,64 @@
 #include <arrow/api.h>
 #include <arrow/json/api.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
+
+#include "../../core/src/column-selection.h"
+#include "../../core/src/mapped-file.h"
 
 using namespace loadersgl;
 
+namespace {
+
+auto makeParseOptions(const LoaderOptions& options) -> arrow::json::ParseOptions {
+  auto parseOptions = arrow::json::ParseOptions::Defaults();
+  if (options.columnTypes.empty()) {
+    return parseOptions;
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& [name, type] : options.columnTypes) {
+    fields.push_back(arrow::field(name, type));
+  }
+  // Typed columns come first in loaded tables, keep their order stable
+  std::sort(fields.begin(), fields.end(), [](const auto& a, const auto& b) { return a->name() < b->name(); });
+  parseOptions.explicit_schema = arrow::schema(fields);
+
+  // Other fields don't need to be parsed when types of all the included columns are known
+  auto allTyped = !options.includeColumns.empty() &&
+                  std::all_of(options.includeColumns.begin(), options.includeColumns.end(),
+                              [&](const std::string& name) { return options.columnTypes.count(name) > 0; });
+  if (allTyped) {
+    parseOptions.unexpected_field_behavior = arrow::json::UnexpectedFieldBehavior::Ignore;
+  }
+
+  return parseOptions;
+}
+
+}  // anonymous namespace
+
 auto JSONLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
     -> std::shared_ptr<arrow::Table> {
   return probegl::catchError<arrow::Table>([&]() { return this->loadTable(input); }, error);
 }
 
+auto JSONLoader::loadTable(const std::string& path, probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table> {
+  return probegl::catchError<arrow::Table>([&]() { return this->loadTable(path); }, error);
+}
+
 auto JSONLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input) -> std::shared_ptr<arrow::Table> {
   arrow::Status status;
   arrow::MemoryPool* pool = arrow::default_memory_pool();
 
+  applyThreadCount(this->options);
   auto readOptions = arrow::json::ReadOptions::Defaults();
-  auto parseOptions = arrow::json::ParseOptions::Defaults();
+  readOptions.use_threads = this->options.useThreads;
+  readOptions.block_size = this->options.blockSize;
+  auto parseOptions = makeParseOptions(this->options);
 
   // Instantiate TableReader from input stream and options
   std::shared_ptr<arrow::json::TableReader> reader;
@@ -56,5 +98,23 @@ auto JSONLoader::loadTable(const std::shared_ptr<arrow::io::InputStream> input)
     throw std::runtime_error("An error has occured while parsing JSON data");
   }
 
-  return table;
+  return selectColumns(table, this->options.includeColumns);
+}
+
+auto JSONLoader::loadTableAsync(const std::shared_ptr<arrow::io::InputStream> input, LoaderPool& pool)
+    -> std::shared_ptr<LoadHandle> {
+  return pool.load([loader = *this, input](const CancellationToken& token) mutable {
+    return loader.loadTable(std::make_shared<CancellableInputStream>(input, token));
+  });
+}
+
+auto JSONLoader::loadTable(const std::string& path) -> std::shared_ptr<arrow::Table> {
+  return this->loadTable(mapFile(path, FileAccess::SEQUENTIAL));
+}
+
+auto JSONLoader::loadTableAsync(const std::string& path, LoaderPool& pool) -> std::shared_ptr<LoadHandle> {
+  return pool.load([loader = *this, path](const CancellationToken& token) mutable {
+    auto input = std::make_shared<CancellableInputStream>(mapFile(path, FileAccess::SEQUENTIAL), token);
+    return loader.loadTable(input);
+  });
 }
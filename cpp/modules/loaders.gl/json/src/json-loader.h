@@ -25,21 +25,46 @@
 #include <arrow/table.h>
 
 #include <memory>
+#include <string>
 
+#include "../../core/src/loader-options.h"
+#include "../../core/src/loader-pool.h"
 #include "probe.gl/core.h"
 
 namespace loadersgl {
 
 class JSONLoader {
  public:
+  explicit JSONLoader(const LoaderOptions& options = {}) : options{options} {}
+
 #pragma mark - Exception-free API
 
   auto loadTable(const std::shared_ptr<arrow::io::InputStream> input, probegl::Error& error) noexcept
       -> std::shared_ptr<arrow::Table>;
 
+  auto loadTable(const std::string& path, probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table>;
+
 #pragma mark -
 
   auto loadTable(const std::shared_ptr<arrow::io::InputStream> input) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Parses the whole input on a loader pool thread. Cancelling the returned handle stops parsing before the
+  /// next block of input is read.
+  /// \note The load uses a copy of the loader, later changes to options don't affect it.
+  auto loadTableAsync(const std::shared_ptr<arrow::io::InputStream> input, LoaderPool& pool = LoaderPool::shared())
+      -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Parses a local file of newline delimited JSON. The file is memory mapped and read sequentially, so blocks
+  /// are parsed straight out of the page cache.
+  /// \param path Path to a newline delimited JSON file.
+  auto loadTable(const std::string& path) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Parses a memory mapped local file on a loader pool thread, see loadTableAsync() for streams.
+  /// \param path Path to a newline delimited JSON file, which is only opened once the load starts.
+  auto loadTableAsync(const std::string& path, LoaderPool& pool = LoaderPool::shared()) -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Options used by all loads. Options specific to CSV are ignored.
+  LoaderOptions options;
 };
 
 }  // namespace loadersgl
@@ -22,6 +22,8 @@
 #include <arrow/io/memory.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <string>
 
@@ -102,4 +104,80 @@ TEST_F(JSONLoaderTest, SimpleData) {
   EXPECT_EQ(descriptions->GetString(0), "Test");
 }
 
+TEST_F(JSONLoaderTest, LoaderOptions) {
+  auto input = std::make_shared<arrow::io::BufferReader>(jsonDataTypes);
+
+  jsonLoader->options.includeColumns = {"int", "string", "missing"};
+  jsonLoader->options.columnTypes = {{"int", arrow::int32()}};
+
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = jsonLoader->loadTable(input); });
+
+  // Only included columns are loaded, in the order they were included in
+  ASSERT_EQ(table->num_columns(), 3);
+  EXPECT_EQ(table->num_rows(), 2);
+  EXPECT_EQ(table->schema()->field(0)->name(), "int");
+  EXPECT_EQ(table->schema()->field(1)->name(), "string");
+  EXPECT_EQ(table->schema()->field(2)->name(), "missing");
+
+  ASSERT_EQ(table->column(0)->type()->id(), arrow::Type::INT32);
+  auto ints = std::static_pointer_cast<arrow::Int32Array>(table->column(0)->chunk(0));
+  EXPECT_EQ(ints->Value(0), -3351);
+  EXPECT_EQ(table->column(2)->null_count(), 2);
+}
+
+/// \brief Reads from a buffer, blocking the first read until it's released.
+class BlockingInputStream : public arrow::io::InputStream {
+ public:
+  BlockingInputStream(const std::string& data, std::shared_future<void> released)
+      : _input{std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(data))}, _released{released} {}
+
+  auto Close() -> arrow::Status override { return this->_input->Close(); }
+  auto closed() const -> bool override { return this->_input->closed(); }
+  auto Tell() const -> arrow::Result<int64_t> override { return this->_input->Tell(); }
+
+  auto Read(int64_t nbytes, void* out) -> arrow::Result<int64_t> override {
+    this->_released.wait();
+    this->readCount++;
+    return this->_input->Read(nbytes, out);
+  }
+
+  auto Read(int64_t nbytes) -> arrow::Result<std::shared_ptr<arrow::Buffer>> override {
+    this->_released.wait();
+    this->readCount++;
+    return this->_input->Read(nbytes);
+  }
+
+  std::atomic<int> readCount{0};
+
+ private:
+  std::shared_ptr<arrow::io::BufferReader> _input;
+  std::shared_future<void> _released;
+};
+
+TEST_F(JSONLoaderTest, LoadTableAsync) {
+  std::string data;
+  for (auto i = 0; i < 100; i++) {
+    data += R"({"value": )" + std::to_string(i) + "}\n";
+  }
+  jsonLoader->options.blockSize = 64;
+  LoaderPool pool{1};
+
+  std::promise<void> released;
+  auto releasedFuture = released.get_future().share();
+  auto input = std::make_shared<BlockingInputStream>(data, releasedFuture);
+  auto handle = jsonLoader->loadTableAsync(input, pool);
+
+  // Blocks after the one being read when the load was cancelled are never read
+  handle->cancel();
+  released.set_value();
+  EXPECT_THROW(handle->get(), std::runtime_error);
+  EXPECT_LE(input->readCount, 1);
+
+  // Loads that aren't cancelled read all the blocks
+  input = std::make_shared<BlockingInputStream>(data, releasedFuture);
+  EXPECT_EQ(jsonLoader->loadTableAsync(input, pool)->get()->num_rows(), 100);
+  EXPECT_GT(input->readCount, 1);
+}
+
 }  // namespace
@@ -0,0 +1,320 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./parquet-loader.h"  // NOLINT(build/include)
+
+#include <arrow/api.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "../../core/src/column-selection.h"
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief Reads batches through a Parquet file reader, keeping the file reader alive for as long as it's needed.
+class RowGroupBatchReader : public arrow::RecordBatchReader {
+ public:
+  RowGroupBatchReader(std::unique_ptr<parquet::arrow::FileReader> fileReader,
+                      std::unique_ptr<arrow::RecordBatchReader> reader)
+      : _fileReader{std::move(fileReader)}, _reader{std::move(reader)} {}
+
+  auto schema() const -> std::shared_ptr<arrow::Schema> override { return this->_reader->schema(); }
+
+  auto ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) -> arrow::Status override {
+    return this->_reader->ReadNext(batch);
+  }
+
+ private:
+  std::unique_ptr<parquet::arrow::FileReader> _fileReader;
+  std::unique_ptr<arrow::RecordBatchReader> _reader;
+};
+
+auto openFileReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input, const LoaderOptions& options)
+    -> std::unique_ptr<parquet::arrow::FileReader> {
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  if (!parquet::arrow::OpenFile(input, arrow::default_memory_pool(), &reader).ok()) {
+    throw std::runtime_error("Cannot instantiate Parquet FileReader");
+  }
+
+  applyThreadCount(options);
+  reader->set_use_threads(options.useThreads);
+  return reader;
+}
+
+/// \brief Row groups that are read concurrently by a loadTable() call and the loader pool threads helping it.
+struct RowGroupReads {
+  std::shared_ptr<arrow::io::RandomAccessFile> input;
+  std::shared_ptr<parquet::FileMetaData> metadata;
+  std::vector<int> rowGroups;
+  std::vector<int> columnIndices;
+
+  /// Index into rowGroups of the next row group that hasn't been claimed by a reading thread
+  std::atomic<size_t> nextIndex{0};
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  size_t readCount{0};
+  std::exception_ptr error;
+};
+
+/// \brief Opens a file reader of its own for a thread, as file readers can't be used by multiple threads at once.
+/// File metadata has already been parsed, and is shared by all the readers.
+auto openRowGroupReader(const RowGroupReads& reads) -> std::unique_ptr<parquet::arrow::FileReader> {
+  auto parquetReader =
+      parquet::ParquetFileReader::Open(reads.input, parquet::default_reader_properties(), reads.metadata);
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  if (!parquet::arrow::FileReader::Make(arrow::default_memory_pool(), std::move(parquetReader), &reader).ok()) {
+    throw std::runtime_error("Cannot instantiate Parquet FileReader");
+  }
+
+  // Row groups are already decoded in parallel, decoding their columns in parallel too would oversubscribe threads
+  reader->set_use_threads(false);
+  return reader;
+}
+
+/// \brief Claims and reads row groups until all of them have been claimed, recording the table or error of each.
+void readClaimedRowGroups(RowGroupReads& reads) {
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  for (auto index = reads.nextIndex++; index < reads.rowGroups.size(); index = reads.nextIndex++) {
+    std::shared_ptr<arrow::Table> table;
+    std::exception_ptr error;
+    try {
+      if (!reader) {
+        reader = openRowGroupReader(reads);
+      }
+      if (!reader->ReadRowGroup(reads.rowGroups[index], reads.columnIndices, &table).ok()) {
+        throw std::runtime_error("An error has occured while reading Parquet data");
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{reads.mutex};
+      reads.tables[index] = table;
+      if (error && !reads.error) {
+        reads.error = error;
+      }
+      reads.readCount++;
+    }
+    reads.condition.notify_all();
+  }
+}
+
+/// \brief Returns indices of leaf columns that belong to included top level fields, all columns if none are included.
+auto getColumnIndices(const parquet::FileMetaData& metadata, const std::vector<std::string>& includeColumns)
+    -> std::vector<int> {
+  std::vector<int> columnIndices;
+  auto schema = metadata.schema();
+  for (int i = 0; i < schema->num_columns(); ++i) {
+    auto name = schema->Column(i)->path()->ToDotVector().front();
+    auto included = std::find(includeColumns.begin(), includeColumns.end(), name) != includeColumns.end();
+    if (includeColumns.empty() || included) {
+      columnIndices.push_back(i);
+    }
+  }
+  return columnIndices;
+}
+
+/// \brief Returns the minimum and maximum value of a floating point column in a row group, if they're known.
+auto getColumnRange(const parquet::RowGroupMetaData& rowGroup, int columnIndex)
+    -> std::optional<std::pair<double, double>> {
+  auto column = rowGroup.ColumnChunk(columnIndex);
+  auto statistics = column->is_stats_set() ? column->statistics() : nullptr;
+  if (!statistics || !statistics->HasMinMax()) {
+    return std::nullopt;
+  }
+
+  switch (statistics->physical_type()) {
+    case parquet::Type::DOUBLE: {
+      auto typedStatistics = std::static_pointer_cast<parquet::DoubleStatistics>(statistics);
+      return std::make_pair(typedStatistics->min(), typedStatistics->max());
+    }
+    case parquet::Type::FLOAT: {
+      auto typedStatistics = std::static_pointer_cast<parquet::FloatStatistics>(statistics);
+      return std::make_pair(static_cast<double>(typedStatistics->min()), static_cast<double>(typedStatistics->max()));
+    }
+
+    default:
+      return std::nullopt;
+  }
+}
+
+}  // anonymous namespace
+
+auto ParquetLoader::loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                              probegl::Error& error) noexcept -> std::shared_ptr<arrow::Table> {
+  return probegl::catchError<arrow::Table>([&]() { return this->loadTable(input); }, error);
+}
+
+auto ParquetLoader::loadBatches(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                                const std::function<BatchCallback>& onBatch,
+                                const std::function<ProgressCallback>& onProgress, probegl::Error& error) noexcept
+    -> std::shared_ptr<LoadProgress> {
+  return probegl::catchError<LoadProgress>([&]() { return this->loadBatches(input, onBatch, onProgress); }, error);
+}
+
+auto ParquetLoader::openBatchReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                                    probegl::Error& error) noexcept -> std::shared_ptr<arrow::RecordBatchReader> {
+  return probegl::catchError<arrow::RecordBatchReader>([&]() { return this->openBatchReader(input); }, error);
+}
+
+auto ParquetLoader::loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input)
+    -> std::shared_ptr<arrow::Table> {
+  auto reader = openFileReader(input, this->options);
+  auto metadata = reader->parquet_reader()->metadata();
+
+  std::shared_ptr<arrow::Table> table;
+  auto columnIndices = getColumnIndices(*metadata, this->options.includeColumns);
+  auto rowGroups = this->selectRowGroups(*metadata);
+  if (!this->options.useThreads || rowGroups.size() < 2) {
+    if (!reader->ReadRowGroups(rowGroups, columnIndices, &table).ok()) {
+      throw std::runtime_error("An error has occured while reading Parquet data");
+    }
+    return selectColumns(table, this->options.includeColumns);
+  }
+
+  auto reads = std::make_shared<RowGroupReads>();
+  reads->input = input;
+  reads->metadata = metadata;
+  reads->rowGroups = rowGroups;
+  reads->columnIndices = columnIndices;
+  reads->tables.resize(rowGroups.size());
+
+  // Pool threads help with reading, while the calling thread reads row groups too, so that the load completes even
+  // if it's called from a pool thread and all the other pool threads are busy. Helpers that only start once all row
+  // groups have been claimed return right away, the shared state outlives this call for them.
+  auto threadCount = this->options.threadCount > 0 ? static_cast<size_t>(this->options.threadCount)
+                                                   : std::max(1u, std::thread::hardware_concurrency());
+  auto helperCount = std::min(threadCount, rowGroups.size()) - 1;
+  for (size_t i = 0; i < helperCount; ++i) {
+    LoaderPool::shared().load([reads](const CancellationToken&) {
+      readClaimedRowGroups(*reads);
+      return std::shared_ptr<arrow::Table>{};
+    });
+  }
+  readClaimedRowGroups(*reads);
+
+  std::unique_lock<std::mutex> lock{reads->mutex};
+  reads->condition.wait(lock, [&]() { return reads->readCount == reads->rowGroups.size(); });
+  if (reads->error) {
+    std::rethrow_exception(reads->error);
+  }
+
+  auto concatenateResult = arrow::ConcatenateTables(reads->tables);
+  if (!concatenateResult.ok()) {
+    throw std::runtime_error("An error has occured while reading Parquet data");
+  }
+  return selectColumns(concatenateResult.ValueOrDie(), this->options.includeColumns);
+}
+
+auto ParquetLoader::loadTableAsync(const std::shared_ptr<arrow::io::RandomAccessFile>& input, LoaderPool& pool)
+    -> std::shared_ptr<LoadHandle> {
+  return pool.load([loader = *this, input](const CancellationToken& token) mutable {
+    auto reader = loader.openBatchReader(input);
+    return readTable(*reader, token);
+  });
+}
+
+auto ParquetLoader::loadBatches(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                                const std::function<BatchCallback>& onBatch,
+                                const std::function<ProgressCallback>& onProgress) -> LoadProgress {
+  auto reader = openFileReader(input, this->options);
+  auto metadata = reader->parquet_reader()->metadata();
+  auto columnIndices = getColumnIndices(*metadata, this->options.includeColumns);
+
+  LoadProgress progress;
+  for (auto rowGroupIndex : this->selectRowGroups(*metadata)) {
+    std::shared_ptr<arrow::Table> rowGroup;
+    if (!reader->ReadRowGroup(rowGroupIndex, columnIndices, &rowGroup).ok()) {
+      throw std::runtime_error("An error has occured while reading Parquet data");
+    }
+    progress.bytesRead += metadata->RowGroup(rowGroupIndex)->total_byte_size();
+
+    arrow::TableBatchReader batchReader{*selectColumns(rowGroup, this->options.includeColumns)};
+    std::shared_ptr<arrow::RecordBatch> batch;
+    while (batchReader.ReadNext(&batch).ok() && batch) {
+      progress.batchesRead++;
+      progress.rowsRead += batch->num_rows();
+      progress.cancelled = !onBatch(batch);
+      if (onProgress) {
+        onProgress(progress);
+      }
+      if (progress.cancelled) {
+        return progress;
+      }
+    }
+  }
+
+  return progress;
+}
+
+auto ParquetLoader::openBatchReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input)
+    -> std::shared_ptr<arrow::RecordBatchReader> {
+  auto fileReader = openFileReader(input, this->options);
+  auto metadata = fileReader->parquet_reader()->metadata();
+  auto columnIndices = getColumnIndices(*metadata, this->options.includeColumns);
+
+  std::unique_ptr<arrow::RecordBatchReader> reader;
+  if (!fileReader->GetRecordBatchReader(this->selectRowGroups(*metadata), columnIndices, &reader).ok()) {
+    throw std::runtime_error("Cannot instantiate Parquet RecordBatchReader");
+  }
+
+  auto rowGroupReader = std::make_shared<RowGroupBatchReader>(std::move(fileReader), std::move(reader));
+  return selectColumns(rowGroupReader, this->options.includeColumns);
+}
+
+auto ParquetLoader::selectRowGroups(const parquet::FileMetaData& metadata) const -> std::vector<int> {
+  auto schema = metadata.schema();
+  auto lngIndex = this->boundsFilter ? schema->ColumnIndex(this->boundsFilter->lngColumn) : -1;
+  auto latIndex = this->boundsFilter ? schema->ColumnIndex(this->boundsFilter->latColumn) : -1;
+
+  std::vector<int> rowGroups;
+  for (int i = 0; i < metadata.num_row_groups(); ++i) {
+    if (lngIndex >= 0 && latIndex >= 0) {
+      auto rowGroup = metadata.RowGroup(i);
+      auto lngRange = getColumnRange(*rowGroup, lngIndex);
+      auto latRange = getColumnRange(*rowGroup, latIndex);
+      const auto& bounds = this->boundsFilter->bounds;
+      if (lngRange && latRange &&
+          (lngRange->second < bounds[0] || latRange->second < bounds[1] || lngRange->first > bounds[2] ||
+           latRange->first > bounds[3])) {
+        continue;
+      }
+    }
+
+    rowGroups.push_back(i);
+  }
+
+  return rowGroups;
+}
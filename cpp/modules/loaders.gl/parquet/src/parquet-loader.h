@@ -0,0 +1,112 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef LOADERSGL_PARQUET_PARQUET_LOADER_H
+#define LOADERSGL_PARQUET_PARQUET_LOADER_H
+
+#include <arrow/io/interfaces.h>
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../../core/src/load-progress.h"
+#include "../../core/src/loader-options.h"
+#include "../../core/src/loader-pool.h"
+#include "probe.gl/core.h"
+
+namespace parquet {
+class FileMetaData;
+}  // namespace parquet
+
+namespace loadersgl {
+
+/// \brief Loads Parquet files, reading only included columns, and optionally only row groups that can overlap a
+/// bounding box.
+class ParquetLoader {
+ public:
+  /// \brief Skips row groups whose coordinates are known to lie outside of a bounding box, such as the viewport.
+  struct BoundsFilter {
+    /// \brief Bounding box as [minLng, minLat, maxLng, maxLat], see WebMercatorViewport::getBounds.
+    std::array<double, 4> bounds;
+    std::string lngColumn{"lng"};
+    std::string latColumn{"lat"};
+  };
+
+  explicit ParquetLoader(const LoaderOptions& options = {}) : options{options} {}
+
+#pragma mark - Exception-free API
+
+  auto loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::Table>;
+
+  auto loadBatches(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                   const std::function<BatchCallback>& onBatch, const std::function<ProgressCallback>& onProgress,
+                   probegl::Error& error) noexcept -> std::shared_ptr<LoadProgress>;
+
+  auto openBatchReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input, probegl::Error& error) noexcept
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+
+#pragma mark -
+
+  /// \brief Reads selected row groups into a single table. When threads are enabled, row groups are decoded
+  /// concurrently by the calling thread and threads of the shared loader pool, up to options.threadCount or the
+  /// number of hardware threads, and concatenated in file order.
+  auto loadTable(const std::shared_ptr<arrow::io::RandomAccessFile>& input) -> std::shared_ptr<arrow::Table>;
+
+  /// \brief Reads selected row groups on a loader pool thread. Cancelling the returned handle stops reading at the
+  /// next batch.
+  /// \note The load uses a copy of the loader, later changes to options and filters don't affect it.
+  auto loadTableAsync(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                      LoaderPool& pool = LoaderPool::shared()) -> std::shared_ptr<LoadHandle>;
+
+  /// \brief Reads selected row groups one at a time, handing out their record batches as soon as each row group has
+  /// been decoded, so that data can be displayed progressively, for example through Layer::appendData.
+  /// \param input File to read Parquet data from.
+  /// \param onBatch Called on the calling thread for each batch, in file order. Returning false stops loading.
+  /// \param onProgress Optional, called after each batch has been handled. Bytes read are counted per row group.
+  /// \return Final progress of the load.
+  auto loadBatches(const std::shared_ptr<arrow::io::RandomAccessFile>& input,
+                   const std::function<BatchCallback>& onBatch,
+                   const std::function<ProgressCallback>& onProgress = nullptr) -> LoadProgress;
+
+  /// \brief Opens a reader that decodes selected row groups as batches are requested from it.
+  auto openBatchReader(const std::shared_ptr<arrow::io::RandomAccessFile>& input)
+      -> std::shared_ptr<arrow::RecordBatchReader>;
+
+  /// \brief Returns indices of row groups that are read, all row groups unless a bounds filter is set.
+  /// \note Row groups without min/max statistics for both coordinate columns are always read.
+  auto selectRowGroups(const parquet::FileMetaData& metadata) const -> std::vector<int>;
+
+  /// \brief Options used by all loads. Only included columns and threading apply to Parquet data.
+  LoaderOptions options;
+
+  /// \brief Optional filter applied to row groups by all loads.
+  std::optional<BoundsFilter> boundsFilter;
+};
+
+}  // namespace loadersgl
+
+#endif  // LOADERSGL_PARQUET_PARQUET_LOADER_H
@@ -0,0 +1,161 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <arrow/api.h>
+#include <arrow/io/memory.h>
+#include <gtest/gtest.h>
+#include <parquet/arrow/writer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "loaders.gl/parquet.h"
+
+using namespace loadersgl;
+
+namespace {
+
+/// \brief The fixture for testing class ParquetLoader. Writes four row groups of points, spaced further apart each.
+class ParquetLoaderTest : public ::testing::Test {
+ protected:
+  ParquetLoaderTest() {
+    arrow::DoubleBuilder lngBuilder;
+    arrow::DoubleBuilder latBuilder;
+    arrow::Int32Builder valueBuilder;
+    for (auto i = 0; i < 12; i++) {
+      EXPECT_TRUE(lngBuilder.Append(i / 3 * 10.0 + i % 3).ok());
+      EXPECT_TRUE(latBuilder.Append(i / 3 * 5.0 + i % 3).ok());
+      EXPECT_TRUE(valueBuilder.Append(i).ok());
+    }
+
+    std::shared_ptr<arrow::Array> lngs;
+    std::shared_ptr<arrow::Array> lats;
+    std::shared_ptr<arrow::Array> values;
+    EXPECT_TRUE(lngBuilder.Finish(&lngs).ok());
+    EXPECT_TRUE(latBuilder.Finish(&lats).ok());
+    EXPECT_TRUE(valueBuilder.Finish(&values).ok());
+
+    auto schema = arrow::schema({arrow::field("lng", arrow::float64()), arrow::field("lat", arrow::float64()),
+                                 arrow::field("value", arrow::int32())});
+    auto table = arrow::Table::Make(schema, {lngs, lats, values});
+
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    EXPECT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), sink, 3).ok());
+    input = std::make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  }
+
+  std::shared_ptr<arrow::io::RandomAccessFile> input;
+};
+
+TEST_F(ParquetLoaderTest, LoadTable) {
+  ParquetLoader loader;
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_NO_THROW({ table = loader.loadTable(input); });
+
+  EXPECT_EQ(table->num_rows(), 12);
+  EXPECT_EQ(table->num_columns(), 3);
+
+  auto invalidInput = std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString("lng,lat\n1,2\n"));
+  probegl::Error error;
+  EXPECT_EQ(loader.loadTable(invalidInput, error), nullptr);
+  EXPECT_TRUE(error.has_value());
+}
+
+TEST_F(ParquetLoaderTest, ConcurrentRowGroups) {
+  LoaderOptions options;
+  options.threadCount = 2;
+  ParquetLoader loader{options};
+
+  // Row groups are decoded concurrently, but end up in file order
+  auto table = loader.loadTable(input);
+  ASSERT_EQ(table->num_rows(), 12);
+  auto values = table->GetColumnByName("value");
+  ASSERT_EQ(values->num_chunks(), 4);
+  for (auto i = 0; i < values->num_chunks(); i++) {
+    EXPECT_EQ(std::static_pointer_cast<arrow::Int32Array>(values->chunk(i))->Value(0), i * 3);
+  }
+
+  // Reading row groups serially gives the same table
+  loader.options.useThreads = false;
+  EXPECT_TRUE(loader.loadTable(input)->Equals(*table));
+}
+
+TEST_F(ParquetLoaderTest, IncludeColumns) {
+  LoaderOptions options;
+  options.includeColumns = {"value", "lng", "missing"};
+  ParquetLoader loader{options};
+
+  auto table = loader.loadTable(input);
+  ASSERT_EQ(table->num_columns(), 3);
+  EXPECT_EQ(table->schema()->field(0)->name(), "value");
+  EXPECT_EQ(table->schema()->field(1)->name(), "lng");
+  EXPECT_EQ(table->column(2)->null_count(), 12);
+
+  // Batches read on demand only contain included columns that exist
+  auto reader = loader.openBatchReader(input);
+  ASSERT_EQ(reader->schema()->num_fields(), 2);
+  EXPECT_EQ(reader->schema()->field(0)->name(), "value");
+}
+
+TEST_F(ParquetLoaderTest, BoundsFilter) {
+  ParquetLoader loader;
+  loader.boundsFilter = ParquetLoader::BoundsFilter{{9.0, 4.0, 15.0, 6.0}};
+
+  // Only the second row group overlaps the bounds
+  auto table = loader.loadTable(input);
+  ASSERT_EQ(table->num_rows(), 3);
+  auto values = std::static_pointer_cast<arrow::Int32Array>(table->GetColumnByName("value")->chunk(0));
+  EXPECT_EQ(values->Value(0), 3);
+
+  // Row groups are kept when coordinate columns can't be found
+  loader.boundsFilter->lngColumn = "longitude";
+  EXPECT_EQ(loader.loadTable(input)->num_rows(), 12);
+}
+
+TEST_F(ParquetLoaderTest, LoadBatches) {
+  ParquetLoader loader;
+  loader.boundsFilter = ParquetLoader::BoundsFilter{{15.0, 8.0, 100.0, 100.0}};
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  int progressCount = 0;
+  auto progress = loader.loadBatches(
+      input,
+      [&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        batches.push_back(batch);
+        return true;
+      },
+      [&](const LoadProgress& progress) { progressCount++; });
+
+  // Last two row groups are read, one batch each
+  ASSERT_EQ(batches.size(), 2u);
+  EXPECT_EQ(progressCount, 2);
+  EXPECT_EQ(progress.rowsRead, 6);
+  EXPECT_GT(progress.bytesRead, 0);
+  EXPECT_FALSE(progress.cancelled);
+  EXPECT_EQ(std::static_pointer_cast<arrow::Int32Array>(batches[1]->column(2))->Value(0), 9);
+
+  // Loading stops when a batch is rejected
+  progress = loader.loadBatches(input, [](const std::shared_ptr<arrow::RecordBatch>& batch) { return false; });
+  EXPECT_EQ(progress.batchesRead, 1);
+  EXPECT_TRUE(progress.cancelled);
+}
+
+}  // namespace
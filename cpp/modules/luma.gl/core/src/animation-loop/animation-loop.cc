@@ -30,7 +30,11 @@
 using namespace lumagl;
 using namespace lumagl::utils;
 
-AnimationLoop::AnimationLoop(const Options& options) : _size{options.size} {
+AnimationLoop::AnimationLoop(const Options& options)
+    : stats{options.stats ? options.stats : std::make_shared<probegl::Stats>("luma.gl")},
+      _size{options.size},
+      _frameTime{this->stats->getHistogram("Frame Time", {1.0 / 120, 1.0 / 60, 1.0 / 30, 1.0 / 15, 1.0 / 5})},
+      _frameCount{this->stats->get("Frames")} {
   // NOTE: This **must** be done before any wgpu API calls as otherwise functions will be undefined
   initializeProcTable();
 
@@ -51,6 +55,9 @@ void AnimationLoop::draw(wgpu::TextureView textureView, std::function<void(wgpu:
 }
 
 void AnimationLoop::draw(wgpu::TextureView textureView, std::function<void(wgpu::RenderPassEncoder)> onRender) {
+  probegl::ScopedStatTimer frameTimer{this->_frameTime};
+  this->_frameCount.increment();
+
   utils::ComboRenderPassDescriptor passDescriptor({textureView});
   wgpu::CommandEncoder encoder = this->_device.CreateCommandEncoder();
   wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&passDescriptor);
@@ -67,7 +74,10 @@ void AnimationLoop::draw(wgpu::TextureView textureView, std::function<void(wgpu:
   pass.EndPass();
 
   wgpu::CommandBuffer commands = encoder.Finish();
-  this->_queue.Submit(1, &commands);
+  {
+    PROBEGL_TRACE_SCOPE("Queue::Submit");
+    this->_queue.Submit(1, &commands);
+  }
 
   this->flush();
 }
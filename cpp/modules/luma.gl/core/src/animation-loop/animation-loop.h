@@ -62,6 +62,8 @@ class AnimationLoop {
   auto queue() -> wgpu::Queue { return this->_queue; }
 
   bool running{false};
+  /// \brief Stats that frame timings are recorded into.
+  std::shared_ptr<probegl::Stats> stats;
 
  protected:
   void _initialize(wgpu::Device device, wgpu::Queue queue);
@@ -71,6 +73,8 @@ class AnimationLoop {
 
  private:
   wgpu::Queue _queue;
+  probegl::Stat& _frameTime;
+  probegl::Stat& _frameCount;
 };
 
 struct AnimationLoop::Options {
@@ -82,6 +86,8 @@ struct AnimationLoop::Options {
   wgpu::Device device;
   wgpu::Queue queue;
   Size size;
+  /// \brief Stats that frame timings are recorded into, a new set of stats is created if not provided.
+  std::shared_ptr<probegl::Stats> stats;
 };
 
 }  // namespace lumagl
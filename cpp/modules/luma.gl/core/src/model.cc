@@ -39,26 +39,13 @@ Model::Model(wgpu::Device device, const Model::Options& options) {
   this->vsModule = createShaderModule(device, SingleShaderStage::Vertex, options.vs.c_str());
   this->fsModule = createShaderModule(device, SingleShaderStage::Fragment, options.fs.c_str());
 
-  ComboRenderPipelineDescriptor descriptor{device};
-  descriptor.vertexStage.module = this->vsModule;
-  descriptor.cFragmentStage.module = this->fsModule;
-  descriptor.primitiveTopology = options.primitiveTopology;
-
-  descriptor.cColorStates[0].format = options.textureFormat;
-  descriptor.cColorStates[0].colorBlend.srcFactor = wgpu::BlendFactor::SrcAlpha;
-  descriptor.cColorStates[0].colorBlend.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
-  descriptor.cColorStates[0].alphaBlend.srcFactor = wgpu::BlendFactor::SrcAlpha;
-  descriptor.cColorStates[0].alphaBlend.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
-
-  this->_initializeVertexState(&descriptor.cVertexState, options.attributeSchema, options.instancedAttributeSchema);
+  this->_primitiveTopology = options.primitiveTopology;
 
   // Initialize uniform cache
   this->_bindings = std::vector<std::optional<BindingInitializationHelper>>{options.uniforms.size()};
 
   this->uniformBindGroupLayout = this->_createBindGroupLayout(device, options.uniforms);
-  descriptor.layout = makeBasicPipelineLayout(device, &this->uniformBindGroupLayout);
-
-  this->pipeline = device.CreateRenderPipeline(&descriptor);
+  this->pipeline = this->_createPipeline(options.textureFormat, true);
 
   // TODO(ilija@unfolded.ai): Is there a more elegant way of doing this, other than divering from arrow API and
   // providing a simple way to initialize an empty table?
@@ -76,6 +63,10 @@ void Model::setInstancedAttributes(const std::shared_ptr<garrow::Table>& attribu
 
 void Model::setIndices(const std::shared_ptr<garrow::Array>& indices) { this->_indices = indices; }
 
+void Model::setInstanceRanges(const std::optional<std::vector<InstanceRange>>& ranges) {
+  this->_instanceRanges = ranges;
+}
+
 void Model::setUniformBuffer(uint32_t binding, const wgpu::Buffer& buffer, uint64_t offset, uint64_t size) {
   this->_setBinding(binding, BindingInitializationHelper{binding, buffer, offset, size});
 }
@@ -88,8 +79,16 @@ void Model::setUniformSampler(uint32_t binding, const wgpu::Sampler& sampler) {
   this->_setBinding(binding, BindingInitializationHelper{binding, sampler});
 }
 
+void Model::setPicking(bool picking) {
+  if (picking && !this->pickingPipeline) {
+    this->pickingPipeline = this->_createPipeline(kPickingTextureFormat, false);
+  }
+
+  this->_picking = picking;
+}
+
 void Model::draw(wgpu::RenderPassEncoder pass) {
-  pass.SetPipeline(this->pipeline);
+  pass.SetPipeline(this->_picking ? this->pickingPipeline : this->pipeline);
   this->_setVertexBuffers(pass);
   // The last two arguments are used for specifying dynamic offsets, which is not something we support right now
   pass.SetBindGroup(0, this->bindGroup, 0, nullptr);
@@ -101,10 +100,56 @@ void Model::draw(wgpu::RenderPassEncoder pass) {
 
   if (this->_indices) {
     pass.SetIndexBuffer(this->_indices->buffer());
-    pass.DrawIndexed(static_cast<uint32_t>(this->_indices->length()), instanceCount);
+  }
+
+  if (!this->_instanceRanges) {
+    this->_draw(pass, vertexCount, instanceCount, 0);
+    return;
+  }
+
+  for (auto const& range : this->_instanceRanges.value()) {
+    this->_draw(pass, vertexCount, range.instanceCount, range.firstInstance);
+  }
+}
+
+void Model::_draw(wgpu::RenderPassEncoder pass, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstInstance) {
+  if (this->_indices) {
+    pass.DrawIndexed(static_cast<uint32_t>(this->_indices->length()), instanceCount, 0, 0, firstInstance);
   } else {
-    pass.Draw(vertexCount, instanceCount);
+    pass.Draw(vertexCount, instanceCount, 0, firstInstance);
+  }
+
+  this->_drawCallCount++;
+  this->_drawnInstanceCount += instanceCount;
+}
+
+auto Model::bufferByteLength() const -> uint64_t {
+  uint64_t byteLength = 0;
+  byteLength += this->_attributeTable ? this->_attributeTable->byteLength() : 0;
+  byteLength += this->_instancedAttributeTable ? this->_instancedAttributeTable->byteLength() : 0;
+  byteLength += this->_indices ? this->_indices->byteLength() : 0;
+  return byteLength;
+}
+
+auto Model::_createPipeline(wgpu::TextureFormat textureFormat, bool blend) -> wgpu::RenderPipeline {
+  ComboRenderPipelineDescriptor descriptor{this->_device};
+  descriptor.vertexStage.module = this->vsModule;
+  descriptor.cFragmentStage.module = this->fsModule;
+  descriptor.primitiveTopology = this->_primitiveTopology;
+
+  // Colors are replaced rather than blended when blending is disabled, which is what the descriptor defaults to
+  descriptor.cColorStates[0].format = textureFormat;
+  if (blend) {
+    descriptor.cColorStates[0].colorBlend.srcFactor = wgpu::BlendFactor::SrcAlpha;
+    descriptor.cColorStates[0].colorBlend.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
+    descriptor.cColorStates[0].alphaBlend.srcFactor = wgpu::BlendFactor::SrcAlpha;
+    descriptor.cColorStates[0].alphaBlend.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
   }
+
+  this->_initializeVertexState(&descriptor.cVertexState, this->_attributeSchema, this->_instancedAttributeSchema);
+  descriptor.layout = makeBasicPipelineLayout(this->_device, &this->uniformBindGroupLayout);
+
+  return this->_device.CreateRenderPipeline(&descriptor);
 }
 
 void Model::_initializeVertexState(utils::ComboVertexStateDescriptor* descriptor,
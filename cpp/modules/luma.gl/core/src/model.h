@@ -47,6 +47,19 @@ struct UniformDescriptor {
   bool isDynamic{false};
 };
 
+/// \brief Format of textures that models draw into while picking.
+static constexpr wgpu::TextureFormat kPickingTextureFormat = wgpu::TextureFormat::RGBA8Unorm;
+
+/// \brief Range of consecutive instances to draw.
+struct InstanceRange {
+ public:
+  InstanceRange(uint32_t firstInstance, uint32_t instanceCount)
+      : firstInstance{firstInstance}, instanceCount{instanceCount} {}
+
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+};
+
 /// \brief A Model holds all the data necessary to draw an object, e.g.: shaders, uniforms and vertex attributes.
 class Model {
  public:
@@ -60,17 +73,36 @@ class Model {
 
   void setIndices(const std::shared_ptr<garrow::Array>& indices);
 
+  /// \brief Restricts drawing to the given ranges of instances, issuing a draw call for each one of them.
+  /// \param ranges Ranges of instances to draw, or std::nullopt to draw all the instances.
+  void setInstanceRanges(const std::optional<std::vector<InstanceRange>>& ranges);
+
   void setUniformBuffer(uint32_t binding, const wgpu::Buffer& buffer, uint64_t offset = 0,
                         uint64_t size = wgpu::kWholeSize);
   void setUniformTexture(uint32_t binding, const wgpu::TextureView& textureView);
   void setUniformSampler(uint32_t binding, const wgpu::Sampler& sampler);
 
+  /// \brief Switches between drawing into regular render targets, and drawing into picking render targets.
+  /// Picking targets use kPickingTextureFormat, and are drawn into with blending disabled so that encoded picking
+  /// colors are written as they are.
+  /// \param picking Whether subsequent draw calls should draw into picking render targets.
+  void setPicking(bool picking);
+
   void draw(wgpu::RenderPassEncoder pass);
 
+  /// \brief Number of draw calls issued by this model since it was created.
+  auto drawCallCount() const -> uint64_t { return this->_drawCallCount; }
+  /// \brief Number of instances drawn by this model since it was created.
+  auto drawnInstanceCount() const -> uint64_t { return this->_drawnInstanceCount; }
+  /// \brief Total size of attribute, instanced attribute and index buffers currently set on this model, in bytes.
+  auto bufferByteLength() const -> uint64_t;
+
   auto device() -> wgpu::Device { return this->_device; }
 
   /// \brief Rendering pipeline.
   wgpu::RenderPipeline pipeline;
+  /// \brief Rendering pipeline used while picking, created on first use.
+  wgpu::RenderPipeline pickingPipeline;
   /// \brief Layout of the bind group.
   wgpu::BindGroupLayout uniformBindGroupLayout;
   /// \brief Bind group containg uniform data.
@@ -81,6 +113,7 @@ class Model {
   wgpu::ShaderModule fsModule;
 
  private:
+  auto _createPipeline(wgpu::TextureFormat textureFormat, bool blend) -> wgpu::RenderPipeline;
   void _initializeVertexState(utils::ComboVertexStateDescriptor* descriptor,
                               const std::shared_ptr<garrow::Schema>& attributeSchema,
                               const std::shared_ptr<garrow::Schema>& instancedAttributeSchema);
@@ -89,6 +122,7 @@ class Model {
 
   void _setBinding(uint32_t binding, const utils::BindingInitializationHelper& initHelper);
   void _setVertexBuffers(wgpu::RenderPassEncoder pass);
+  void _draw(wgpu::RenderPassEncoder pass, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstInstance);
 
   wgpu::Device _device;
   std::shared_ptr<garrow::Schema> _attributeSchema;
@@ -96,8 +130,13 @@ class Model {
   std::shared_ptr<garrow::Table> _attributeTable;
   std::shared_ptr<garrow::Table> _instancedAttributeTable;
   std::shared_ptr<garrow::Array> _indices;
+  std::optional<std::vector<InstanceRange>> _instanceRanges;
+  wgpu::PrimitiveTopology _primitiveTopology;
+  bool _picking{false};
   std::vector<UniformDescriptor> _uniformDescriptors;
   std::vector<std::optional<utils::BindingInitializationHelper>> _bindings;
+  uint64_t _drawCallCount{0};
+  uint64_t _drawnInstanceCount{0};
 };
 
 /// \brief Initializer options for the Model class.
@@ -20,6 +20,8 @@
 
 #include "./array.h"  // NOLINT(build/include)
 
+#include <algorithm>
+
 #include "./util/arrow-utils.h"
 #include "./util/webgpu-utils.h"
 
@@ -46,40 +48,74 @@ void Array::setData(const std::shared_ptr<arrow::Array>& data, wgpu::BufferUsage
   auto bufferByteSize = vertexSize * data->length();
   if (!this->_buffer || bufferByteSize != this->_bufferByteSize) {
     this->_buffer = this->_createBuffer(this->_device, bufferByteSize, usage);
+    this->_bufferCapacity = bufferByteSize;
   }
 
-  // TODO(ilija@unfolded.ai): Handle arrays with null values correctly
-  if (data->null_count() > 0) {
-    throw std::runtime_error("Data with null values is currently not supported");
-  }
+  this->_writeData(data, 0);
 
-  // If child_data isn't empty, data is a list array
-  if (!data->data()->child_data.empty()) {
-    uint64_t offset = 0;
+  this->_length = data->length();
+  this->_bufferByteSize = bufferByteSize;
+}
 
-    // Go through child data for list data types and use child buffers
-    for (auto const& childData : data->data()->child_data) {
-      // We assume this is a NumericArray, no easy way to check if that's the case because it's templated
-      auto dataBuffer = childData->buffers[1];
+void Array::appendData(const std::shared_ptr<arrow::Array>& data, wgpu::BufferUsage usage) {
+  auto vertexFormatOptional = vertexFormatFromArrowType(data->type());
+  if (!vertexFormatOptional.has_value()) {
+    throw std::runtime_error("Unsupported data format");
+  }
+  auto vertexSize = getVertexFormatSize(vertexFormatOptional.value());
 
-      this->_buffer.SetSubData(offset, dataBuffer->size(), dataBuffer->data());
-      offset += dataBuffer->size();
+  auto bufferByteSize = this->_bufferByteSize + vertexSize * data->length();
+  if (!this->_buffer || bufferByteSize > this->_bufferCapacity) {
+    // Grow geometrically so that appending batch after batch only copies data a logarithmic number of times
+    auto bufferCapacity = std::max(bufferByteSize, this->_bufferCapacity * 2);
+    auto buffer = this->_createBuffer(this->_device, bufferCapacity, usage);
+    if (this->_buffer && this->_bufferByteSize > 0) {
+      auto encoder = this->_device.CreateCommandEncoder();
+      encoder.CopyBufferToBuffer(this->_buffer, 0, buffer, 0, this->_bufferByteSize);
+      auto commands = encoder.Finish();
+      this->_device.CreateQueue().Submit(1, &commands);
     }
-  } else {
-    // Primite data type, just iterate over the buffers
-    // We assume this is a NumericArray, no easy way to check if that's the case because it's templated
-    auto dataBuffer = data->data()->buffers[1];
-    this->_buffer.SetSubData(0, dataBuffer->size(), dataBuffer->data());
+
+    // The previous buffer is released rather than destroyed, as the copy out of it may still be pending
+    this->_buffer = buffer;
+    this->_bufferCapacity = bufferCapacity;
   }
 
-  this->_length = data->length();
+  this->_writeData(data, this->_bufferByteSize);
+
+  this->_length += data->length();
   this->_bufferByteSize = bufferByteSize;
 }
 
 auto Array::_createBuffer(wgpu::Device device, uint64_t size, wgpu::BufferUsage usage) -> wgpu::Buffer {
   wgpu::BufferDescriptor bufferDesc;
   bufferDesc.size = size;
-  bufferDesc.usage = wgpu::BufferUsage::CopyDst | usage;
+  // Buffers are also copy sources, so that their contents can be moved into a larger buffer when appending data
+  bufferDesc.usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | usage;
 
   return device.CreateBuffer(&bufferDesc);
 }
+
+void Array::_writeData(const std::shared_ptr<arrow::Array>& nullableData, uint64_t offset) {
+  // Values behind null elements are undefined, so they're zeroed before being uploaded
+  auto data = fillNulls(nullableData).array;
+
+  // If child_data isn't empty, data is a fixed size list array, whose values are stored in its child data
+  auto arrayData = data->data();
+  auto valueData = arrayData;
+  int64_t valuesPerElement = 1;
+  auto firstValue = arrayData->offset;
+  if (!arrayData->child_data.empty()) {
+    valueData = arrayData->child_data[0];
+    valuesPerElement = std::static_pointer_cast<arrow::FixedSizeListType>(data->type())->list_size();
+    firstValue = valueData->offset + arrayData->offset * valuesPerElement;
+  }
+
+  // We assume values are numeric, no easy way to check if that's the case because NumericArray is templated
+  // Only the elements of the array are written, as sliced arrays share buffers with the arrays they were sliced from
+  auto valueByteWidth = std::static_pointer_cast<arrow::FixedWidthType>(valueData->type)->bit_width() / 8;
+  auto byteLength = static_cast<uint64_t>(data->length() * valuesPerElement * valueByteWidth);
+  if (byteLength > 0) {
+    this->_buffer.SetSubData(offset, byteLength, valueData->buffers[1]->data() + firstValue * valueByteWidth);
+  }
+}
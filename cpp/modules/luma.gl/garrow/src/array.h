@@ -50,15 +50,25 @@ class Array {
 
   /// \brief Size in the number of elements this array contains.
   auto length() const -> int64_t { return this->_length; };
+  /// \brief Size in bytes of the data uploaded into the backing GPU buffer.
+  auto byteLength() const -> uint64_t { return this->_bufferByteSize; };
+  /// \brief Size in bytes of the backing GPU buffer, which can be larger than byteLength after appending data.
+  auto byteCapacity() const -> uint64_t { return this->_bufferCapacity; };
 
   /* Arrow non-compliant API */
 
+  /// \brief Uploads data, replacing whatever the array held before.
+  /// \note Null elements are uploaded as zeros, see fillNulls() for replacing them with other values beforehand.
   void setData(const std::shared_ptr<arrow::Array>& data, wgpu::BufferUsage usage);
+  /// \brief Uploads data following the data already in the array, only writing the new elements to the GPU.
+  /// \note The backing buffer grows geometrically when it runs out of space, which makes it a new buffer.
+  void appendData(const std::shared_ptr<arrow::Array>& data, wgpu::BufferUsage usage);
   template <typename T>
   void setData(const T* data, size_t length, wgpu::BufferUsage usage) {
     auto bufferByteSize = sizeof(T) * length;
     if (!this->_buffer || bufferByteSize != this->_bufferByteSize) {
       this->_buffer = this->_createBuffer(this->_device, bufferByteSize, usage);
+      this->_bufferCapacity = bufferByteSize;
     }
 
     this->_buffer.SetSubData(0, bufferByteSize, data);
@@ -71,11 +81,13 @@ class Array {
 
  private:
   auto _createBuffer(wgpu::Device device, uint64_t size, wgpu::BufferUsage usage) -> wgpu::Buffer;
+  void _writeData(const std::shared_ptr<arrow::Array>& data, uint64_t offset);
 
   wgpu::Device _device;
   wgpu::Buffer _buffer{nullptr};
   int64_t _length{0};
   uint64_t _bufferByteSize{0};
+  uint64_t _bufferCapacity{0};
 };
 
 }  // namespace garrow
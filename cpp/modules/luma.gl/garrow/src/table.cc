@@ -28,3 +28,11 @@ auto Table::ColumnNames() const -> std::vector<std::string> {
                  [](std::shared_ptr<Field> field) { return field->name(); });
   return names;
 };
+
+auto Table::byteLength() const -> uint64_t {
+  uint64_t byteLength = 0;
+  for (const auto& column : this->_columns) {
+    byteLength += column ? column->byteCapacity() : 0;
+  }
+  return byteLength;
+}
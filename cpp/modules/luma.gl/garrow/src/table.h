@@ -65,6 +65,10 @@ class Table {
   /// \brief Returns number of rows in this table.
   auto num_rows() const -> int64_t { return this->_columns.empty() ? 0 : this->_columns[0]->length(); }
 
+  /// \brief Returns the total size of GPU buffers backing the columns of this table, in bytes, including capacity
+  /// reserved for appended data.
+  auto byteLength() const -> uint64_t;
+
  private:
   std::shared_ptr<Schema> _schema;
   std::vector<std::shared_ptr<Array>> _columns;
@@ -20,6 +20,9 @@
 
 #include "./arrow-utils.h"  // NOLINT(build/include)
 
+#include <algorithm>
+#include <cstring>
+
 #include "../table.h"
 
 namespace lumagl {
@@ -28,6 +31,95 @@ namespace garrow {
 auto vertexFormatFromArrowListType(const std::shared_ptr<arrow::FixedSizeListType>& type)
     -> std::optional<wgpu::VertexFormat>;
 
+namespace {
+
+/// \brief Reads up to 64 bits of a bitmap starting at an arbitrary bit offset, bits past length are left unset.
+auto readBitmapWord(const uint8_t* bitmap, int64_t bitOffset, int64_t length) -> uint64_t {
+  auto bytes = bitmap + bitOffset / 8;
+  auto shift = bitOffset % 8;
+  auto byteCount = (shift + length + 7) / 8;
+
+  uint64_t word = 0;
+  for (int64_t i = 0; i < std::min<int64_t>(byteCount, 8); ++i) {
+    word |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  }
+  word >>= shift;
+  if (byteCount > 8) {
+    word |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+  }
+
+  return length == 64 ? word : word & ((uint64_t{1} << length) - 1);
+}
+
+/// \brief Calls a function with the index of each unset bit of a bitmap, skipping words whose bits are all set.
+template <typename Function>
+void forEachUnsetBit(const uint8_t* bitmap, int64_t bitOffset, int64_t length, Function&& function) {
+  for (int64_t start = 0; start < length; start += 64) {
+    auto wordLength = std::min<int64_t>(64, length - start);
+    auto wordMask = wordLength == 64 ? ~uint64_t{0} : (uint64_t{1} << wordLength) - 1;
+    auto unsetBits = ~readBitmapWord(bitmap, bitOffset + start, wordLength) & wordMask;
+    for (int64_t bit = 0; unsetBits != 0; ++bit, unsetBits >>= 1) {
+      if (unsetBits & 1) {
+        function(start + bit);
+      }
+    }
+  }
+}
+
+/// \brief Converts value components to the bytes of a single element of a given value type.
+template <typename CType>
+void encodeElement(const std::vector<double>& components, int64_t valuesPerElement, uint8_t* destination) {
+  for (int64_t i = 0; i < valuesPerElement; ++i) {
+    auto value = static_cast<size_t>(i) < components.size() ? static_cast<CType>(components[i]) : CType{0};
+    std::memcpy(destination + i * sizeof(CType), &value, sizeof(CType));
+  }
+}
+
+auto encodeElement(const arrow::DataType& valueType, const std::vector<double>& components, int64_t valuesPerElement)
+    -> std::vector<uint8_t> {
+  auto valueByteWidth = static_cast<const arrow::FixedWidthType&>(valueType).bit_width() / 8;
+  std::vector<uint8_t> element(static_cast<size_t>(valuesPerElement * valueByteWidth));
+  switch (valueType.id()) {
+    case arrow::Type::FLOAT:
+      encodeElement<float>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::DOUBLE:
+      encodeElement<double>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::INT8:
+      encodeElement<int8_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::UINT8:
+      encodeElement<uint8_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::INT16:
+      encodeElement<int16_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::UINT16:
+      encodeElement<uint16_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::INT32:
+      encodeElement<int32_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::UINT32:
+      encodeElement<uint32_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::INT64:
+      encodeElement<int64_t>(components, valuesPerElement, element.data());
+      break;
+    case arrow::Type::UINT64:
+      encodeElement<uint64_t>(components, valuesPerElement, element.data());
+      break;
+
+    default:
+      throw std::runtime_error("Unable to replace null values of type " + valueType.ToString());
+  }
+
+  return element;
+}
+
+}  // anonymous namespace
+
 auto arrowTypeFromVertexFormat(wgpu::VertexFormat format) -> std::shared_ptr<arrow::DataType> {
   // Based on https://gpuweb.github.io/gpuweb/#vertex-formats
   // uchar = unsigned 8-bit value
@@ -121,6 +213,28 @@ auto vertexFormatFromArrowType(const std::shared_ptr<arrow::DataType>& type) ->
   return std::nullopt;
 }
 
+auto arrayFromBuffer(const std::shared_ptr<arrow::Buffer>& buffer, wgpu::VertexFormat format)
+    -> std::shared_ptr<arrow::Array> {
+  auto type = arrowTypeFromVertexFormat(format);
+  auto listType = std::dynamic_pointer_cast<arrow::FixedSizeListType>(type);
+  auto valueType = listType ? listType->value_type() : type;
+
+  int64_t valuesPerVertex = listType ? listType->list_size() : 1;
+  int64_t valueByteWidth = std::static_pointer_cast<arrow::FixedWidthType>(valueType)->bit_width() / 8;
+  auto vertexByteWidth = valuesPerVertex * valueByteWidth;
+  if (buffer->size() % vertexByteWidth != 0) {
+    throw std::runtime_error("Buffer size is not a multiple of the vertex format size");
+  }
+
+  auto length = buffer->size() / vertexByteWidth;
+  auto values = arrow::ArrayData::Make(valueType, length * valuesPerVertex, {nullptr, buffer}, 0);
+  if (!listType) {
+    return arrow::MakeArray(values);
+  }
+
+  return arrow::MakeArray(arrow::ArrayData::Make(type, length, {nullptr}, {values}, 0));
+}
+
 auto transformTable(const std::shared_ptr<arrow::Table>& table, const std::vector<ColumnBuilder>& builders,
                     wgpu::Device device) -> std::shared_ptr<Table> {
   std::vector<std::shared_ptr<Field>> fields;
@@ -152,6 +266,79 @@ auto transformTable(const std::shared_ptr<arrow::Table>& table, const std::vecto
   return std::make_shared<Table>(schema, arrays);
 }
 
+auto fillNulls(const std::shared_ptr<arrow::Array>& array, const std::vector<double>& nullValue,
+               arrow::MemoryPool* pool) -> FilledArray {
+  auto data = array->data();
+  auto valueData = data;
+  int64_t valuesPerElement = 1;
+  if (auto listType = std::dynamic_pointer_cast<arrow::FixedSizeListType>(array->type())) {
+    valueData = data->child_data[0];
+    valuesPerElement = listType->list_size();
+  }
+
+  // Slices of list arrays may report nulls of values that lie outside of the slice, which are skipped below
+  auto hasNullElements = array->null_count() > 0;
+  auto hasNullValues = valueData != data && valueData->GetNullCount() > 0;
+  if (!hasNullElements && !hasNullValues) {
+    return FilledArray{array};
+  }
+
+  auto valueType = std::dynamic_pointer_cast<arrow::FixedWidthType>(valueData->type);
+  if (!valueType || valueType->bit_width() % 8 != 0) {
+    throw std::runtime_error("Unable to replace null values of type " + valueData->type->ToString());
+  }
+
+  // All the values are copied at once, and only null elements are overwritten afterwards
+  auto valueByteWidth = valueType->bit_width() / 8;
+  auto elementByteWidth = valuesPerElement * valueByteWidth;
+  auto firstValue = valueData == data ? data->offset : valueData->offset + data->offset * valuesPerElement;
+  auto allocateResult = arrow::AllocateBuffer(array->length() * elementByteWidth, pool);
+  if (!allocateResult.ok()) {
+    throw std::runtime_error("Unable to allocate array buffer");
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(allocateResult).ValueOrDie();
+  auto destination = buffer->mutable_data();
+  if (array->length() > 0) {
+    std::memcpy(destination, valueData->buffers[1]->data() + firstValue * valueByteWidth,
+                static_cast<size_t>(array->length() * elementByteWidth));
+  }
+
+  auto nullElement = encodeElement(*valueType, nullValue, valuesPerElement);
+  int64_t filledCount = 0;
+  int64_t lastFilledElement = -1;
+  auto fillElement = [&](int64_t element) {
+    if (element != lastFilledElement) {
+      std::memcpy(destination + element * elementByteWidth, nullElement.data(), nullElement.size());
+      lastFilledElement = element;
+      filledCount++;
+    }
+  };
+
+  if (hasNullElements) {
+    forEachUnsetBit(data->buffers[0]->data(), data->offset, array->length(), fillElement);
+  }
+  if (hasNullValues && valueData->buffers[0]) {
+    // Null values within lists that are null themselves have been replaced already
+    auto elementBitmap = hasNullElements ? data->buffers[0]->data() : nullptr;
+    forEachUnsetBit(valueData->buffers[0]->data(), firstValue, array->length() * valuesPerElement,
+                    [&](int64_t value) {
+                      auto element = value / valuesPerElement;
+                      auto elementBit = data->offset + element;
+                      if (!elementBitmap || (elementBitmap[elementBit / 8] >> (elementBit % 8)) & 1) {
+                        fillElement(element);
+                      }
+                    });
+  }
+
+  auto values = arrow::ArrayData::Make(valueData->type, array->length() * valuesPerElement, {nullptr, buffer}, 0);
+  if (valueData == data) {
+    return FilledArray{arrow::MakeArray(values), filledCount};
+  }
+
+  return FilledArray{arrow::MakeArray(arrow::ArrayData::Make(data->type, array->length(), {nullptr}, {values}, 0)),
+                     filledCount};
+}
+
 auto vertexFormatFromArrowListType(const std::shared_ptr<arrow::FixedSizeListType>& type)
     -> std::optional<wgpu::VertexFormat> {
   using ArrowType = arrow::Type::type;
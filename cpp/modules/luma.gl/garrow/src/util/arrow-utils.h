@@ -37,16 +37,46 @@ struct AttributeDescriptor;
 struct ColumnBuilder {
   using ColumnMapping = auto(const std::shared_ptr<arrow::Table>&) -> std::shared_ptr<arrow::Array>;
 
-  ColumnBuilder(const std::shared_ptr<arrow::Field>& field, const std::function<ColumnMapping>& mapColumn)
-      : field{field}, mapColumn{mapColumn} {}
+  ColumnBuilder(const std::shared_ptr<arrow::Field>& field, const std::function<ColumnMapping>& mapColumn,
+                const std::vector<double>& nullValue = {})
+      : field{field}, mapColumn{mapColumn}, nullValue{nullValue} {}
 
   std::shared_ptr<arrow::Field> field;
   std::function<ColumnMapping> mapColumn;
+  /// \brief Value that null elements of mapped columns are replaced with, one entry per component.
+  /// Components that aren't listed are zero.
+  std::vector<double> nullValue;
+};
+
+/// \brief Array whose null elements were replaced by fillNulls().
+struct FilledArray {
+  std::shared_ptr<arrow::Array> array;
+  /// \brief Number of elements that were replaced.
+  int64_t filledCount{0};
 };
 
 auto arrowTypeFromVertexFormat(wgpu::VertexFormat format) -> std::shared_ptr<arrow::DataType>;
 auto vertexFormatFromArrowType(const std::shared_ptr<arrow::DataType>& type) -> std::optional<wgpu::VertexFormat>;
 
+/// \brief Wraps tightly packed vertex data, such as a GPU-ready buffer produced elsewhere, into an array without
+/// copying it.
+/// \param buffer Vertex data, its size has to be a multiple of the size of the vertex format.
+/// \param format Format of each vertex, normalized formats are wrapped as their unnormalized counterparts.
+/// \return Array of type arrowTypeFromVertexFormat(format), with one element per vertex.
+auto arrayFromBuffer(const std::shared_ptr<arrow::Buffer>& buffer, wgpu::VertexFormat format)
+    -> std::shared_ptr<arrow::Array>;
+
+/// \brief Replaces null elements of a numeric array, or of a fixed size list of numeric values, with a given value.
+/// Lists containing null values are replaced as a whole. Validity bitmaps are scanned a word at a time, so arrays with
+/// few nulls are mostly copied as they are.
+/// \param array Array to replace null elements of.
+/// \param nullValue Components of the value to replace null elements with, converted to the value type of the array.
+/// Components that aren't listed are zero.
+/// \param pool Memory pool to allocate the resulting array from.
+/// \return Array without a validity bitmap, which is the given array itself if it doesn't contain any nulls.
+auto fillNulls(const std::shared_ptr<arrow::Array>& array, const std::vector<double>& nullValue = {},
+               arrow::MemoryPool* pool = arrow::default_memory_pool()) -> FilledArray;
+
 auto transformTable(const std::shared_ptr<arrow::Table>& table, const std::vector<ColumnBuilder>& builders,
                     wgpu::Device device) -> std::shared_ptr<Table>;
 
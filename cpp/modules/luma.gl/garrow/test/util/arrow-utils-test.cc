@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <vector>
+
 using namespace lumagl::garrow;
 
 namespace {
@@ -48,4 +51,67 @@ TEST_F(ArrowUtilsTestSuite, VertexFormatFromArrowType) {
   EXPECT_EQ(vertexFormatFromArrowType(arrow::fixed_size_list(arrow::float32(), 5)), std::nullopt);
 }
 
+TEST_F(ArrowUtilsTestSuite, ArrayFromBuffer) {
+  std::vector<uint8_t> colors{255, 0, 0, 255, 0, 128, 255, 64};
+  auto buffer = std::make_shared<arrow::Buffer>(colors.data(), static_cast<int64_t>(colors.size()));
+
+  auto array = arrayFromBuffer(buffer, wgpu::VertexFormat::UChar4Norm);
+  EXPECT_EQ(array->length(), 2);
+  EXPECT_TRUE(array->type()->Equals(arrow::fixed_size_list(arrow::uint8(), 4)));
+
+  // Data is referenced rather than copied
+  auto values = std::static_pointer_cast<arrow::FixedSizeListArray>(array)->values();
+  EXPECT_EQ(std::static_pointer_cast<arrow::UInt8Array>(values)->raw_values(), colors.data());
+
+  EXPECT_EQ(arrayFromBuffer(buffer, wgpu::VertexFormat::Float2)->length(), 1);
+  EXPECT_THROW(arrayFromBuffer(buffer, wgpu::VertexFormat::Float3), std::runtime_error);
+}
+
+TEST_F(ArrowUtilsTestSuite, FillNulls) {
+  // Nulls spread across more than one bitmap word, in a slice that doesn't start at a byte boundary
+  arrow::FloatBuilder builder;
+  for (auto i = 0; i < 100; ++i) {
+    EXPECT_TRUE((i % 30 == 5 ? builder.AppendNull() : builder.Append(static_cast<float>(i))).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder.Finish(&array).ok());
+
+  auto filled = fillNulls(array->Slice(3, 90), {-1.0});
+  auto values = std::static_pointer_cast<arrow::FloatArray>(filled.array);
+  EXPECT_EQ(filled.filledCount, 3);
+  EXPECT_EQ(values->length(), 90);
+  EXPECT_EQ(values->null_count(), 0);
+  EXPECT_FLOAT_EQ(values->Value(0), 3.0f);
+  EXPECT_FLOAT_EQ(values->Value(2), -1.0f);
+  EXPECT_FLOAT_EQ(values->Value(62), -1.0f);
+  EXPECT_FLOAT_EQ(values->Value(63), 66.0f);
+  EXPECT_FLOAT_EQ(values->Value(89), 92.0f);
+
+  // Arrays without nulls are returned as they are
+  auto slice = array->Slice(6, 20);
+  EXPECT_EQ(fillNulls(slice).array, slice);
+  EXPECT_EQ(fillNulls(slice).filledCount, 0);
+}
+
+TEST_F(ArrowUtilsTestSuite, FillNullsInLists) {
+  arrow::Int16Builder valueBuilder;
+  EXPECT_TRUE(valueBuilder.AppendValues(std::vector<int16_t>{1, 2, 5, 5, 3}).ok());
+  EXPECT_TRUE(valueBuilder.AppendNull().ok());
+  std::shared_ptr<arrow::Array> values;
+  EXPECT_TRUE(valueBuilder.Finish(&values).ok());
+
+  // Lists that are null, or that contain null values, are replaced as a whole
+  std::vector<uint8_t> listValidity{0b101};
+  auto listBitmap = std::make_shared<arrow::Buffer>(listValidity.data(), 1);
+  auto array = arrow::MakeArray(
+      arrow::ArrayData::Make(arrow::fixed_size_list(arrow::int16(), 2), 3, {listBitmap}, {values->data()}, 1));
+
+  auto filled = fillNulls(array, {7.0});
+  EXPECT_EQ(filled.filledCount, 2);
+  auto filledValues = std::static_pointer_cast<arrow::Int16Array>(
+      std::static_pointer_cast<arrow::FixedSizeListArray>(filled.array)->values());
+  EXPECT_EQ(std::vector<int16_t>(filledValues->raw_values(), filledValues->raw_values() + filledValues->length()),
+            (std::vector<int16_t>{1, 2, 7, 0, 7, 0}));
+}
+
 }  // anonymous namespace
@@ -67,6 +67,7 @@ namespace lumagl {
 namespace utils {
 
 auto createShaderModule(const wgpu::Device& device, SingleShaderStage stage, const char* source) -> wgpu::ShaderModule {
+  PROBEGL_TRACE_SCOPE("createShaderModule");
   shaderc_shader_kind kind = shadercShaderKind(stage);
 
   shaderc::Compiler compiler;
@@ -25,6 +25,7 @@
 #include <cmath>
 #include <limits>
 #include <ostream>
+#include <stdexcept>
 
 #undef PI  // Get rid of nasty cmath macro (conflicts e.g. with ranges)
 
@@ -413,7 +414,6 @@ class Matrix4 {
   auto operator()(int row, int col) const -> const coord { return _m[row][col]; }
 
   auto determinant() const -> coord;
-  // TODO(randy@unfolded.ai)
   auto invert() const -> Matrix4<coord>;
   auto transpose() const -> Matrix4<coord>;
 
@@ -1128,6 +1128,46 @@ auto Matrix4<coord>::determinant() const -> coord {
          at(3, 0) * at(2, 1) * at(0, 2) * at(1, 3) + at(3, 0) * at(2, 1) * at(1, 2) * at(0, 3);
 }
 
+template <typename coord>
+auto Matrix4<coord>::invert() const -> Matrix4<coord> {
+  // Inverse from the 2x2 sub-determinants of the upper and lower halves, see gl-matrix mat4.invert
+  auto b00 = at(0, 0) * at(1, 1) - at(0, 1) * at(1, 0);
+  auto b01 = at(0, 0) * at(1, 2) - at(0, 2) * at(1, 0);
+  auto b02 = at(0, 0) * at(1, 3) - at(0, 3) * at(1, 0);
+  auto b03 = at(0, 1) * at(1, 2) - at(0, 2) * at(1, 1);
+  auto b04 = at(0, 1) * at(1, 3) - at(0, 3) * at(1, 1);
+  auto b05 = at(0, 2) * at(1, 3) - at(0, 3) * at(1, 2);
+  auto b06 = at(2, 0) * at(3, 1) - at(2, 1) * at(3, 0);
+  auto b07 = at(2, 0) * at(3, 2) - at(2, 2) * at(3, 0);
+  auto b08 = at(2, 0) * at(3, 3) - at(2, 3) * at(3, 0);
+  auto b09 = at(2, 1) * at(3, 2) - at(2, 2) * at(3, 1);
+  auto b10 = at(2, 1) * at(3, 3) - at(2, 3) * at(3, 1);
+  auto b11 = at(2, 2) * at(3, 3) - at(2, 3) * at(3, 2);
+
+  auto det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+  if (det == static_cast<coord>(0)) {
+    throw std::runtime_error("invert called on singular matrix");
+  }
+  auto invDet = static_cast<coord>(1) / det;
+
+  return Matrix4<coord>{(at(1, 1) * b11 - at(1, 2) * b10 + at(1, 3) * b09) * invDet,
+                        (at(0, 2) * b10 - at(0, 1) * b11 - at(0, 3) * b09) * invDet,
+                        (at(3, 1) * b05 - at(3, 2) * b04 + at(3, 3) * b03) * invDet,
+                        (at(2, 2) * b04 - at(2, 1) * b05 - at(2, 3) * b03) * invDet,
+                        (at(1, 2) * b08 - at(1, 0) * b11 - at(1, 3) * b07) * invDet,
+                        (at(0, 0) * b11 - at(0, 2) * b08 + at(0, 3) * b07) * invDet,
+                        (at(3, 2) * b02 - at(3, 0) * b05 - at(3, 3) * b01) * invDet,
+                        (at(2, 0) * b05 - at(2, 2) * b02 + at(2, 3) * b01) * invDet,
+                        (at(1, 0) * b10 - at(1, 1) * b08 + at(1, 3) * b06) * invDet,
+                        (at(0, 1) * b08 - at(0, 0) * b10 - at(0, 3) * b06) * invDet,
+                        (at(3, 0) * b04 - at(3, 1) * b02 + at(3, 3) * b00) * invDet,
+                        (at(2, 1) * b02 - at(2, 0) * b04 - at(2, 3) * b00) * invDet,
+                        (at(1, 1) * b07 - at(1, 0) * b09 - at(1, 2) * b06) * invDet,
+                        (at(0, 0) * b09 - at(0, 1) * b07 + at(0, 2) * b06) * invDet,
+                        (at(3, 1) * b01 - at(3, 0) * b03 - at(3, 2) * b00) * invDet,
+                        (at(2, 0) * b03 - at(2, 1) * b01 + at(2, 2) * b00) * invDet};
+}
+
 #ifdef DONT
 template <typename coord>
 auto Matrix4<coord>::RotationMatrix(coord a_x, coord a_y, coord a_z) -> Matrix4<coord> {
@@ -41,4 +41,21 @@ TEST_F(MathTest, Vector3Sum) {
   EXPECT_FLOAT_EQ(vectorSum.z, 0.6);
 }
 
+TEST_F(MathTest, Matrix4Invert) {
+  auto matrix = mathgl::Matrix4<double>::makeTranslation(mathgl::Vector3<double>{1.0, -2.0, 3.0}) *
+                mathgl::Matrix4<double>::makeRotationZ(0.5) *
+                mathgl::Matrix4<double>::makeScale(mathgl::Vector3<double>{2.0, 4.0, 0.5});
+  matrix(3, 2) = -1.0;
+
+  auto identity = matrix * matrix.invert();
+  for (int row = 0; row < 4; ++row) {
+    for (int col = 0; col < 4; ++col) {
+      EXPECT_NEAR(identity(row, col), row == col ? 1.0 : 0.0, 1e-12);
+    }
+  }
+
+  auto singular = mathgl::Matrix4<double>::makeScale(mathgl::Vector3<double>{1.0, 0.0, 1.0});
+  EXPECT_THROW(singular.invert(), std::runtime_error);
+}
+
 }  // namespace
@@ -26,7 +26,9 @@
 #include "./core/src/error.h"
 #include "./core/src/log.h"
 #include "./core/src/platform.h"
+#include "./core/src/stats.h"
 #include "./core/src/system-utils.h"
 #include "./core/src/timer.h"
+#include "./core/src/trace.h"
 
 #endif  // PROBEGL_CORE
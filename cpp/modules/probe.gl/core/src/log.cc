@@ -23,10 +23,19 @@
 
 #include "./log.h"  // NOLINT(build/include)
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
 #include "./assert.h"
 #include "./platform.h"
+#include "./system-utils.h"
 
 #if defined(PROBEGL_PLATFORM_ANDROID)
 #include <android/log.h>
@@ -70,33 +79,326 @@ android_LogPriority AndroidLogPriority(LogSeverity severity) {
 }
 #endif  // defined(PROBEGL_PLATFORM_ANDROID)
 
-}  // anonymous namespace
+struct LogRecord {
+  LogSeverity severity;
+  std::string message;
+  std::chrono::system_clock::time_point time;
+};
 
-LogMessage::LogMessage(LogSeverity severity) : mSeverity(severity) {}
+// Unbounded, lock-free queue with multiple producers and a single consumer.
+// See http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+class LogQueue {
+ public:
+  LogQueue() : _head{&_stub}, _tail{&_stub} {}
+  ~LogQueue() {
+    LogRecord record;
+    while (this->pop(record)) {
+    }
+    if (this->_tail != &this->_stub) {
+      delete this->_tail;
+    }
+  }
 
-LogMessage::~LogMessage() {
-  std::string fullMessage = mStream.str();
+  void push(LogRecord&& record) {
+    auto node = new Node{std::move(record)};
+    auto previous = this->_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
 
-  // If this message has been moved, its stream is empty.
-  if (fullMessage.empty()) {
-    return;
+  // Must only be called from a single thread at a time.
+  auto pop(LogRecord& record) -> bool {
+    auto tail = this->_tail;
+    auto next = tail->next.load(std::memory_order_acquire);
+    if (!next) {
+      return false;
+    }
+
+    // The popped node stays in the queue as its new stub, and the previous stub is released
+    record = std::move(next->record);
+    this->_tail = next;
+    if (tail != &this->_stub) {
+      delete tail;
+    }
+
+    return true;
+  }
+
+ private:
+  struct Node {
+    LogRecord record;
+    std::atomic<Node*> next{nullptr};
+  };
+
+  Node _stub;
+  std::atomic<Node*> _head;
+  Node* _tail;
+};
+
+class Logger {
+ public:
+  static auto instance() -> Logger& {
+    static Logger logger;
+    return logger;
+  }
+
+  ~Logger() { this->_stopWriter(); }
+
+  auto enabled(LogSeverity severity) const -> bool {
+    return static_cast<int>(severity) >= this->_minSeverity.load(std::memory_order_relaxed);
+  }
+
+  auto options() -> LogOptions {
+    std::lock_guard<std::mutex> lock{this->_outputMutex};
+    return this->_options;
+  }
+
+  void setOptions(const LogOptions& options) {
+    this->_stopWriter();
+    {
+      std::lock_guard<std::mutex> lock{this->_outputMutex};
+      this->_options = options;
+      this->_repeatWindows.clear();
+    }
+    this->_minSeverity.store(static_cast<int>(options.minSeverity), std::memory_order_relaxed);
+    if (options.async) {
+      this->_startWriter();
+    }
   }
 
-  const char* severityName = SeverityName(mSeverity);
+  void log(LogRecord&& record) {
+    if (!this->_async.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock{this->_outputMutex};
+      this->_write(record);
+      return;
+    }
 
-  FILE* outputStream = stdout;
-  if (mSeverity == LogSeverity::Warning || mSeverity == LogSeverity::Error) {
-    outputStream = stderr;
+    if (this->_pendingCount.fetch_add(1, std::memory_order_relaxed) >= kMaxPendingCount) {
+      this->_pendingCount.fetch_sub(1, std::memory_order_relaxed);
+      this->_droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    this->_queue.push(std::move(record));
+
+    // The writer may have been stopped after the check above, and may have drained the queue before the push. Pairs
+    // with the fence in _stopWriter, so that either the writer's final drain or this one writes the message out.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!this->_async.load(std::memory_order_relaxed)) {
+      this->_drain();
+      return;
+    }
+
+    this->_writerCondition.notify_one();
+  }
+
+  void flush() {
+    if (this->_async.load(std::memory_order_acquire)) {
+      std::unique_lock<std::mutex> lock{this->_writerMutex};
+      this->_writerCondition.notify_one();
+      this->_flushedCondition.wait(lock, [&]() {
+        return this->_pendingCount.load(std::memory_order_relaxed) == 0 || !this->_writer.joinable();
+      });
+    }
+
+    std::lock_guard<std::mutex> lock{this->_outputMutex};
+    fflush(this->_options.output ? this->_options.output : stdout);
+    fflush(stderr);
+  }
+
+ private:
+  // Messages logged while this many messages are waiting to be written out are dropped
+  static constexpr uint64_t kMaxPendingCount = 8192;
+
+  Logger() = default;
+
+  void _startWriter() {
+    this->_stopping = false;
+    this->_async.store(true, std::memory_order_release);
+    this->_writer = std::thread{[this]() { this->_runWriter(); }};
   }
 
+  void _stopWriter() {
+    if (!this->_writer.joinable()) {
+      return;
+    }
+
+    this->_async.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+      std::lock_guard<std::mutex> lock{this->_writerMutex};
+      this->_stopping = true;
+    }
+    this->_writerCondition.notify_one();
+    this->_writer.join();
+
+    // Write out messages that were queued while the writer was shutting down
+    this->_drain();
+  }
+
+  void _runWriter() {
+    std::unique_lock<std::mutex> lock{this->_writerMutex};
+    while (true) {
+      lock.unlock();
+      this->_drain();
+      lock.lock();
+
+      this->_flushedCondition.notify_all();
+      if (this->_stopping) {
+        break;
+      }
+
+      // Producers don't take the lock when notifying, so a wakeup can be missed and the timeout bounds the latency
+      this->_writerCondition.wait_for(lock, std::chrono::milliseconds{10});
+    }
+  }
+
+  void _drain() {
+    // Besides the writer, producers that raced with stopping it drain the queue, which only supports a single consumer
+    std::lock_guard<std::mutex> drainLock{this->_drainMutex};
+    LogRecord record;
+    while (this->_queue.pop(record)) {
+      {
+        std::lock_guard<std::mutex> lock{this->_outputMutex};
+        this->_write(record);
+      }
+      this->_pendingCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if (auto droppedCount = this->_droppedCount.exchange(0, std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock{this->_outputMutex};
+      this->_write(LogRecord{LogSeverity::Warning, "Dropped " + std::to_string(droppedCount) + " log messages",
+                             std::chrono::system_clock::now()});
+    }
+  }
+
+  // Applies rate limiting and writes a message out, must be called with _outputMutex held.
+  void _write(const LogRecord& record) {
+    if (this->_options.rateLimit > 0 && !this->_checkRateLimit(record)) {
+      return;
+    }
+
+    this->_output(record);
+  }
+
+  auto _checkRateLimit(const LogRecord& record) -> bool {
+    auto interval = std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::duration<double>{this->_options.rateLimitInterval});
+
+    // Forget about messages that haven't been repeated recently, to keep the number of tracked messages bounded
+    if (this->_repeatWindows.size() > kMaxRepeatWindowCount) {
+      for (auto window = this->_repeatWindows.begin(); window != this->_repeatWindows.end();) {
+        window = record.time - window->second.start > interval ? this->_repeatWindows.erase(window) : ++window;
+      }
+    }
+
+    auto key = std::string{SeverityName(record.severity)} + ": " + record.message;
+    auto& window = this->_repeatWindows[key];
+    if (window.count == 0 || record.time - window.start > interval) {
+      if (window.suppressedCount > 0) {
+        auto summary = "Suppressed " + std::to_string(window.suppressedCount) + " repeats of: " + record.message;
+        this->_output(LogRecord{record.severity, summary, record.time});
+      }
+      window = RepeatWindow{record.time, 0, 0};
+    }
+
+    if (window.count >= this->_options.rateLimit) {
+      window.suppressedCount++;
+      return false;
+    }
+
+    window.count++;
+    return true;
+  }
+
+  void _output(const LogRecord& record) {
+    const char* severityName = SeverityName(record.severity);
+
+    FILE* outputStream = stdout;
+    if (record.severity == LogSeverity::Warning || record.severity == LogSeverity::Error) {
+      outputStream = stderr;
+    }
+    if (this->_options.output) {
+      outputStream = this->_options.output;
+    }
+
+    std::string line;
+    if (this->_options.format == LogFormat::JSONLines) {
+      auto time = std::chrono::duration<double>{record.time.time_since_epoch()}.count();
+      std::ostringstream stream;
+      stream.precision(16);
+      stream << "{\"time\":" << time << ",\"severity\":";
+      writeJSONString(stream, severityName);
+      stream << ",\"message\":";
+      writeJSONString(stream, record.message);
+      stream << "}";
+      line = stream.str();
+    } else {
+      line = std::string{severityName} + ": " + record.message;
+    }
+
 #if defined(PROBEGL_PLATFORM_ANDROID)
-  android_LogPriority androidPriority = AndroidLogPriority(mSeverity);
-  __android_log_print(androidPriority, "probe.gl", "%s: %s\n", severityName, fullMessage.c_str());
+    android_LogPriority androidPriority = AndroidLogPriority(record.severity);
+    __android_log_print(androidPriority, "probe.gl", "%s\n", line.c_str());
 #else   // defined(PROBEGL_PLATFORM_ANDROID)
         // Note: we use fprintf because <iostream> includes static initializers.
-  fprintf(outputStream, "%s: %s\n", severityName, fullMessage.c_str());
-  fflush(outputStream);
+    fprintf(outputStream, "%s\n", line.c_str());
+    fflush(outputStream);
 #endif  // defined(PROBEGL_PLATFORM_ANDROID)
+  }
+
+  struct RepeatWindow {
+    std::chrono::system_clock::time_point start;
+    uint32_t count;
+    uint32_t suppressedCount;
+  };
+  static constexpr size_t kMaxRepeatWindowCount = 1024;
+
+  std::atomic<int> _minSeverity{static_cast<int>(LogSeverity::Debug)};
+  std::atomic<bool> _async{false};
+
+  // Guards options, and writing messages out
+  std::mutex _outputMutex;
+  LogOptions _options;
+  std::unordered_map<std::string, RepeatWindow> _repeatWindows;
+
+  LogQueue _queue;
+  std::mutex _drainMutex;
+  std::atomic<uint64_t> _pendingCount{0};
+  std::atomic<uint64_t> _droppedCount{0};
+
+  std::mutex _writerMutex;
+  std::condition_variable _writerCondition;
+  std::condition_variable _flushedCondition;
+  bool _stopping{false};
+  std::thread _writer;
+};
+
+}  // anonymous namespace
+
+void setLogOptions(const LogOptions& options) { Logger::instance().setOptions(options); }
+
+auto getLogOptions() -> LogOptions { return Logger::instance().options(); }
+
+void flushLog() { Logger::instance().flush(); }
+
+LogMessage::LogMessage(LogSeverity severity) : mSeverity(severity) {
+  if (Logger::instance().enabled(severity)) {
+    mStream = std::make_unique<std::ostringstream>();
+  }
+}
+
+LogMessage::~LogMessage() {
+  // If this message has been moved or filtered out, it has no stream.
+  if (!mStream) {
+    return;
+  }
+
+  std::string fullMessage = mStream->str();
+  if (fullMessage.empty()) {
+    return;
+  }
+
+  Logger::instance().log(LogRecord{mSeverity, std::move(fullMessage), std::chrono::system_clock::now()});
 }
 
 auto DebugLog() -> LogMessage { return LogMessage{LogSeverity::Debug}; }
@@ -51,7 +51,14 @@
 //
 //   // Get more information
 //   PROBEGL_DEBUG() << texture.GetFormat();
+//
+// Messages below the minimum severity set with setLogOptions() are dropped before anything is formatted. Setting
+// LogOptions::async hands formatted messages over to a background thread, so that logging from the render thread never
+// waits on I/O.
 
+#include <cstdint>
+#include <cstdio>
+#include <memory>
 #include <sstream>
 
 namespace probegl {
@@ -65,6 +72,34 @@ enum class LogSeverity {
   Error,
 };
 
+enum class LogFormat {
+  // Human readable lines, e.g. "Warning: message".
+  Text,
+  // A JSON object per line, containing the time, severity and message.
+  JSONLines,
+};
+
+// Options controlling which log messages are written out, and how.
+struct LogOptions {
+  // Messages below this severity are dropped without being formatted.
+  LogSeverity minSeverity{LogSeverity::Debug};
+  // Whether messages are written out by a background thread. Messages are dropped rather than queued indefinitely if
+  // the background thread can't keep up.
+  bool async{false};
+  LogFormat format{LogFormat::Text};
+  // Maximum number of identical messages written out within rateLimitInterval seconds, or 0 for no limit.
+  uint32_t rateLimit{0};
+  double rateLimitInterval{1.0};
+  // File to write messages into, or nullptr to write them into stdout, and warnings and errors into stderr.
+  FILE* output{nullptr};
+};
+
+void setLogOptions(const LogOptions& options);
+auto getLogOptions() -> LogOptions;
+
+// Blocks until all the messages logged so far have been written out.
+void flushLog();
+
 // Essentially an ostringstream that will print itself in its destructor.
 class LogMessage {
  public:
@@ -76,7 +111,9 @@ class LogMessage {
 
   template <typename T>
   auto operator<<(T&& value) -> LogMessage& {
-    mStream << value;
+    if (mStream) {
+      *mStream << value;
+    }
     return *this;
   }
 
@@ -85,7 +122,8 @@ class LogMessage {
   auto operator=(const LogMessage& other) -> LogMessage& = delete;
 
   LogSeverity mSeverity;
-  std::ostringstream mStream;
+  // Only allocated for messages that pass severity filtering.
+  std::unique_ptr<std::ostringstream> mStream;
 };
 
 // Short-hands to create a LogMessage with the respective severity.
@@ -0,0 +1,261 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./stats.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+#include "./system-utils.h"
+
+using namespace probegl;
+
+namespace {
+
+auto getTypeName(Stat::Type type) -> const char* {
+  switch (type) {
+    case Stat::Type::COUNTER:
+      return "counter";
+    case Stat::Type::GAUGE:
+      return "gauge";
+    case Stat::Type::TIMER:
+      return "timer";
+    case Stat::Type::HISTOGRAM:
+      return "histogram";
+  }
+
+  return "unknown";
+}
+
+/// \brief Converts a name into a valid Prometheus metric name, e.g. "Frame Time" becomes "frame_time".
+auto getMetricName(const std::string& name) -> std::string {
+  std::string metricName;
+  for (char c : name) {
+    auto isAlphanumeric = std::isalnum(static_cast<unsigned char>(c)) != 0;
+    if (isAlphanumeric) {
+      metricName += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    } else if (!metricName.empty() && metricName.back() != '_') {
+      metricName += '_';
+    }
+  }
+  while (!metricName.empty() && metricName.back() == '_') {
+    metricName.pop_back();
+  }
+
+  return metricName;
+}
+
+}  // anonymous namespace
+
+Stat::Stat(const std::string& name, Type type, const std::atomic<bool>& enabled,
+           const std::vector<double>& bucketBounds)
+    : _name{name}, _type{type}, _enabled{enabled}, _bucketBounds{bucketBounds} {
+  if (!std::is_sorted(this->_bucketBounds.begin(), this->_bucketBounds.end())) {
+    throw std::logic_error("Histogram bucket bounds must be sorted in ascending order");
+  }
+
+  this->_bucketCounts.resize(type == Type::HISTOGRAM ? this->_bucketBounds.size() + 1 : 0);
+}
+
+void Stat::addSample(double value) {
+  if (!this->enabled()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{this->_samplesMutex};
+  auto count = this->_count.fetch_add(1, std::memory_order_relaxed);
+  this->_sum += value;
+  this->_min = count == 0 ? value : std::min(this->_min, value);
+  this->_max = count == 0 ? value : std::max(this->_max, value);
+
+  if (!this->_bucketCounts.empty()) {
+    auto bucket = std::lower_bound(this->_bucketBounds.begin(), this->_bucketBounds.end(), value);
+    this->_bucketCounts[std::distance(this->_bucketBounds.begin(), bucket)]++;
+  }
+}
+
+auto Stat::snapshot(bool reset) -> Snapshot {
+  reset = reset && this->_type != Type::GAUGE;
+
+  Snapshot snapshot;
+  snapshot.name = this->_name;
+  snapshot.type = this->_type;
+  snapshot.bucketBounds = this->_bucketBounds;
+
+  std::lock_guard<std::mutex> lock{this->_samplesMutex};
+  snapshot.count = reset ? this->_count.exchange(0, std::memory_order_relaxed)
+                         : this->_count.load(std::memory_order_relaxed);
+  snapshot.sum = this->_sum;
+  snapshot.min = this->_min;
+  snapshot.max = this->_max;
+  snapshot.bucketCounts = this->_bucketCounts;
+
+  if (reset) {
+    this->_sum = 0.0;
+    this->_min = 0.0;
+    this->_max = 0.0;
+    std::fill(this->_bucketCounts.begin(), this->_bucketCounts.end(), 0);
+  }
+
+  return snapshot;
+}
+
+void Stat::reset() { this->snapshot(true); }
+
+Stats::Stats(const std::string& id, bool enabled) : _id{id}, _enabled{enabled} {}
+
+auto Stats::get(const std::string& name, Stat::Type type) -> Stat& { return this->_get(name, type, {}); }
+
+auto Stats::getHistogram(const std::string& name, const std::vector<double>& bucketBounds) -> Stat& {
+  return this->_get(name, Stat::Type::HISTOGRAM, bucketBounds);
+}
+
+auto Stats::remove(const std::string& name) -> bool {
+  std::lock_guard<std::mutex> lock{this->_statsMutex};
+
+  auto stat = std::find_if(this->_stats.begin(), this->_stats.end(),
+                           [&](const std::unique_ptr<Stat>& stat) { return stat->name() == name; });
+  if (stat == this->_stats.end()) {
+    return false;
+  }
+
+  this->_stats.erase(stat);
+  return true;
+}
+
+auto Stats::snapshot(bool reset) -> std::vector<Stat::Snapshot> {
+  std::lock_guard<std::mutex> lock{this->_statsMutex};
+
+  std::vector<Stat::Snapshot> snapshots;
+  snapshots.reserve(this->_stats.size());
+  for (auto& stat : this->_stats) {
+    snapshots.push_back(stat->snapshot(reset));
+  }
+
+  return snapshots;
+}
+
+void Stats::reset() { this->snapshot(true); }
+
+void Stats::exportJSON(std::ostream& stream) {
+  auto snapshots = this->snapshot();
+
+  stream << "{\"id\":";
+  writeJSONString(stream, this->_id);
+  stream << ",\"stats\":[";
+  for (size_t i = 0; i < snapshots.size(); i++) {
+    const auto& snapshot = snapshots[i];
+    stream << (i > 0 ? "," : "") << "{\"name\":";
+    writeJSONString(stream, snapshot.name);
+    stream << ",\"type\":\"" << getTypeName(snapshot.type) << "\",\"count\":" << snapshot.count;
+    if (snapshot.type == Stat::Type::TIMER || snapshot.type == Stat::Type::HISTOGRAM) {
+      stream << ",\"sum\":" << snapshot.sum << ",\"min\":" << snapshot.min << ",\"max\":" << snapshot.max
+             << ",\"average\":" << snapshot.average();
+    }
+    if (snapshot.type == Stat::Type::HISTOGRAM) {
+      stream << ",\"bounds\":[";
+      for (size_t j = 0; j < snapshot.bucketBounds.size(); j++) {
+        stream << (j > 0 ? "," : "") << snapshot.bucketBounds[j];
+      }
+      stream << "],\"counts\":[";
+      for (size_t j = 0; j < snapshot.bucketCounts.size(); j++) {
+        stream << (j > 0 ? "," : "") << snapshot.bucketCounts[j];
+      }
+      stream << "]";
+    }
+    stream << "}";
+  }
+  stream << "]}";
+}
+
+void Stats::exportPrometheus(std::ostream& stream) {
+  auto prefix = getMetricName(this->_id);
+  for (const auto& snapshot : this->snapshot()) {
+    auto metricName = prefix + "_" + getMetricName(snapshot.name);
+    switch (snapshot.type) {
+      case Stat::Type::COUNTER:
+        metricName += "_total";
+        stream << "# TYPE " << metricName << " counter\n";
+        stream << metricName << " " << snapshot.count << "\n";
+        break;
+
+      case Stat::Type::GAUGE:
+        stream << "# TYPE " << metricName << " gauge\n";
+        stream << metricName << " " << snapshot.count << "\n";
+        break;
+
+      case Stat::Type::TIMER:
+        // Timer names describe durations, which Prometheus conventionally reports in seconds
+        metricName += "_seconds";
+        stream << "# TYPE " << metricName << " summary\n";
+        stream << metricName << "_sum " << snapshot.sum << "\n";
+        stream << metricName << "_count " << snapshot.count << "\n";
+        break;
+
+      case Stat::Type::HISTOGRAM: {
+        stream << "# TYPE " << metricName << " histogram\n";
+
+        // Prometheus buckets are cumulative
+        uint64_t cumulativeCount = 0;
+        for (size_t i = 0; i < snapshot.bucketBounds.size(); i++) {
+          cumulativeCount += snapshot.bucketCounts[i];
+          stream << metricName << "_bucket{le=\"" << snapshot.bucketBounds[i] << "\"} " << cumulativeCount << "\n";
+        }
+        stream << metricName << "_bucket{le=\"+Inf\"} " << snapshot.count << "\n";
+        stream << metricName << "_sum " << snapshot.sum << "\n";
+        stream << metricName << "_count " << snapshot.count << "\n";
+        break;
+      }
+    }
+  }
+}
+
+void Stats::writeToFile(const std::string& path, Format format) {
+  writeFileAtomically(path, [&](std::ostream& stream) {
+    stream.precision(std::numeric_limits<double>::max_digits10);
+    switch (format) {
+      case Format::JSON:
+        this->exportJSON(stream);
+        break;
+      case Format::PROMETHEUS:
+        this->exportPrometheus(stream);
+        break;
+    }
+  });
+}
+
+auto Stats::_get(const std::string& name, Stat::Type type, const std::vector<double>& bucketBounds) -> Stat& {
+  std::lock_guard<std::mutex> lock{this->_statsMutex};
+
+  auto stat = std::find_if(this->_stats.begin(), this->_stats.end(),
+                           [&](const std::unique_ptr<Stat>& stat) { return stat->name() == name; });
+  if (stat != this->_stats.end()) {
+    if ((*stat)->type() != type) {
+      throw std::logic_error("Stat " + name + " already exists with a different type");
+    }
+
+    return **stat;
+  }
+
+  this->_stats.push_back(std::make_unique<Stat>(name, type, this->_enabled, bucketBounds));
+  return *this->_stats.back();
+}
@@ -0,0 +1,185 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PROBEGL_CORE_STATS_H
+#define PROBEGL_CORE_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "./timer.h"
+
+namespace probegl {
+
+/// \brief A single named statistic. Counters count events, gauges hold the latest value of a quantity, e.g. memory in
+/// use, timers accumulate durations in seconds and histograms sort samples into buckets. Modelled after Stat class of
+/// probe.gl JS.
+/// \note Recording is thread safe, and turns into a single relaxed load when the owning Stats are disabled.
+class Stat {
+ public:
+  enum class Type { COUNTER, GAUGE, TIMER, HISTOGRAM };
+
+  /// \brief Values of a stat at a given point in time.
+  struct Snapshot {
+    std::string name;
+    Type type;
+    /// \brief Counter or gauge value, or number of samples recorded by timers and histograms.
+    uint64_t count{0};
+    /// \brief Sum of all the recorded samples.
+    double sum{0.0};
+    double min{0.0};
+    double max{0.0};
+    /// \brief Inclusive upper bounds of histogram buckets.
+    std::vector<double> bucketBounds;
+    /// \brief Number of samples that fell into each bucket, with an extra bucket for samples above all the bounds.
+    std::vector<uint64_t> bucketCounts;
+
+    auto average() const -> double { return this->count > 0 ? this->sum / static_cast<double>(this->count) : 0.0; }
+  };
+
+  Stat(const std::string& name, Type type, const std::atomic<bool>& enabled,
+       const std::vector<double>& bucketBounds = {});
+
+  auto name() const -> const std::string& { return this->_name; }
+  auto type() const -> Type { return this->_type; }
+  auto enabled() const -> bool { return this->_enabled.load(std::memory_order_relaxed); }
+
+  /// \brief Increments a counter.
+  void increment(uint64_t amount = 1) {
+    if (this->enabled()) {
+      this->_count.fetch_add(amount, std::memory_order_relaxed);
+    }
+  }
+
+  /// \brief Sets the value of a gauge.
+  void set(uint64_t value) {
+    if (this->enabled()) {
+      this->_count.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  /// \brief Records a duration in seconds, or a histogram sample.
+  void addSample(double value);
+
+  /// \brief Captures current values of this stat.
+  /// \param reset Whether to reset the stat after capturing it, without losing samples recorded in between. Gauges
+  /// keep their values.
+  auto snapshot(bool reset = false) -> Snapshot;
+  void reset();
+
+ private:
+  std::string _name;
+  Type _type;
+  const std::atomic<bool>& _enabled;
+  std::vector<double> _bucketBounds;
+
+  std::atomic<uint64_t> _count{0};
+  std::mutex _samplesMutex;
+  double _sum{0.0};
+  double _min{0.0};
+  double _max{0.0};
+  std::vector<uint64_t> _bucketCounts;
+};
+
+/// \brief Adds the time elapsed between construction and destruction to a timer stat.
+/// Doesn't touch the clock at all if the stat is disabled, or missing.
+class ScopedStatTimer {
+ public:
+  explicit ScopedStatTimer(Stat& stat) : ScopedStatTimer{&stat} {}
+  explicit ScopedStatTimer(Stat* stat) : _stat{stat && stat->enabled() ? stat : nullptr} {
+    if (this->_stat) {
+      this->_timer.start();
+    }
+  }
+  ~ScopedStatTimer() {
+    if (this->_stat) {
+      this->_timer.stop();
+      this->_stat->addSample(this->_timer.getElapsedTime());
+    }
+  }
+
+  ScopedStatTimer(const ScopedStatTimer&) = delete;
+  auto operator=(const ScopedStatTimer&) -> ScopedStatTimer& = delete;
+
+ private:
+  Stat* _stat;
+  Timer _timer;
+};
+
+/// \brief A registry of named stats, e.g. all the stats collected by a single deck.
+/// Stats are created on first access and live as long as the registry does, so references to them can be kept around
+/// by instrumented code in order to avoid name lookups on hot paths.
+class Stats {
+ public:
+  /// \param id Identifier of this registry, used as a prefix when exporting stats.
+  /// \param enabled Whether stats are recorded. Disabled stats cost close to nothing.
+  explicit Stats(const std::string& id, bool enabled = true);
+
+  auto id() const -> const std::string& { return this->_id; }
+  auto enabled() const -> bool { return this->_enabled.load(std::memory_order_relaxed); }
+  void setEnabled(bool enabled) { this->_enabled.store(enabled, std::memory_order_relaxed); }
+
+  /// \brief Retrieves a stat with a given name, creating it if it doesn't exist yet.
+  /// \throws std::logic_error if a stat with the same name but a different type already exists.
+  auto get(const std::string& name, Stat::Type type = Stat::Type::COUNTER) -> Stat&;
+
+  /// \brief Retrieves a histogram with a given name, creating it with the given bucket bounds if it doesn't exist yet.
+  /// \param bucketBounds Ascending, inclusive upper bounds of histogram buckets.
+  auto getHistogram(const std::string& name, const std::vector<double>& bucketBounds) -> Stat&;
+
+  /// \brief Removes a stat, such as a gauge of an object that no longer exists. References to it become invalid.
+  /// \return Whether a stat with the given name existed.
+  auto remove(const std::string& name) -> bool;
+
+  /// \brief Captures current values of all the stats, in the order they were created in.
+  /// \param reset Whether to reset stats after capturing them, e.g. in order to collect stats per frame.
+  auto snapshot(bool reset = false) -> std::vector<Stat::Snapshot>;
+  void reset();
+
+  /// \brief Writes current values of all the stats as a JSON object.
+  void exportJSON(std::ostream& stream);
+  /// \brief Writes current values of all the stats in Prometheus text exposition format.
+  /// Metric names are prefixed with the registry id, e.g. Frame Time in deck.gl stats becomes deck_gl_frame_time.
+  void exportPrometheus(std::ostream& stream);
+
+  enum class Format { JSON, PROMETHEUS };
+
+  /// \brief Exports stats into a file, replacing it atomically so that readers never see a partially written file.
+  /// \throws std::runtime_error if the file couldn't be written.
+  void writeToFile(const std::string& path, Format format);
+
+ private:
+  auto _get(const std::string& name, Stat::Type type, const std::vector<double>& bucketBounds) -> Stat&;
+
+  std::string _id;
+  std::atomic<bool> _enabled;
+
+  std::mutex _statsMutex;
+  std::vector<std::unique_ptr<Stat>> _stats;
+};
+
+}  // namespace probegl
+
+#endif  // PROBEGL_CORE_STATS_H
@@ -23,6 +23,10 @@
 
 #include "./system-utils.h"  // NOLINT(build/include)
 
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
 #include "./platform.h"
 
 #if defined(PROBEGL_PLATFORM_POSIX)
@@ -43,3 +47,49 @@ void probegl::uSleep(unsigned int usecs) { Sleep(static_cast<DWORD>(usecs / 1000
 #else
 #error "Implement uSleep for your platform."
 #endif
+
+void probegl::writeJSONString(std::ostream& stream, const std::string& value) {
+  stream << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        stream << "\\\"";
+        break;
+      case '\\':
+        stream << "\\\\";
+        break;
+      case '\n':
+        stream << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[7];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          stream << escaped;
+        } else {
+          stream << c;
+        }
+    }
+  }
+  stream << '"';
+}
+
+void probegl::writeFileAtomically(const std::string& path, const std::function<void(std::ostream&)>& write) {
+  auto temporaryPath = path + ".tmp";
+  {
+    std::ofstream file{temporaryPath, std::ios::out | std::ios::trunc};
+    if (!file) {
+      throw std::runtime_error("Failed to open file " + temporaryPath);
+    }
+
+    write(file);
+    if (!file.flush()) {
+      throw std::runtime_error("Failed to write file " + temporaryPath);
+    }
+  }
+
+  if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+    std::remove(temporaryPath.c_str());
+    throw std::runtime_error("Failed to replace file " + path);
+  }
+}
@@ -24,10 +24,22 @@
 #ifndef PROBEGL_CORE_SYSTEMUTILS_H
 #define PROBEGL_CORE_SYSTEMUTILS_H
 
+#include <functional>
+#include <ostream>
+#include <string>
+
 namespace probegl {
 
 void uSleep(unsigned int usecs);
 
+/// \brief Writes a string as a quoted JSON string, escaping characters as needed.
+void writeJSONString(std::ostream& stream, const std::string& value);
+
+/// \brief Writes a file by writing into a temporary file first, and then replacing the original file with it, so that
+/// readers never see a partially written file.
+/// \throws std::runtime_error if the file couldn't be written.
+void writeFileAtomically(const std::string& path, const std::function<void(std::ostream&)>& write);
+
 }  // namespace probegl
 
 #endif  // PROBEGL_CORE_SYSTEMUTILS_H
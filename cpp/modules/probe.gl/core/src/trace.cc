@@ -0,0 +1,165 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "./trace.h"  // NOLINT(build/include)
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+#include "./log.h"
+#include "./system-utils.h"
+
+using namespace probegl;
+
+namespace {
+
+auto roundUpToPowerOfTwo(size_t value) -> size_t {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+
+  return result;
+}
+
+/// \brief Holds the trace buffer of a thread, releasing it once the thread exits.
+class ThreadBufferHandle {
+ public:
+  ~ThreadBufferHandle() {
+    if (this->buffer) {
+      this->buffer->setReleased(true);
+    }
+  }
+
+  std::shared_ptr<TraceBuffer> buffer;
+};
+
+}  // anonymous namespace
+
+TraceBuffer::TraceBuffer(uint32_t threadId, size_t capacity)
+    : _threadId{threadId}, _events(roundUpToPowerOfTwo(std::max<size_t>(capacity, 1))), _mask{_events.size() - 1} {}
+
+auto TraceBuffer::drain(const std::function<void(const TraceEvent&)>& onEvent) -> uint64_t {
+  auto tail = this->_tail.load(std::memory_order_relaxed);
+  auto head = this->_head.load(std::memory_order_acquire);
+  for (; tail != head; tail++) {
+    onEvent(this->_events[tail & this->_mask]);
+  }
+
+  this->_tail.store(tail, std::memory_order_release);
+  return this->_droppedCount.exchange(0, std::memory_order_relaxed);
+}
+
+auto Tracer::instance() -> Tracer& {
+  static Tracer tracer;
+  return tracer;
+}
+
+void Tracer::flush(std::ostream& stream) {
+  std::vector<std::shared_ptr<TraceBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock{this->_buffersMutex};
+    buffers = this->_buffers;
+  }
+
+  auto flags = stream.flags();
+  stream << std::fixed << std::setprecision(3);
+
+  // Complete events ("ph":"X") carry both the start time and the duration of a span, in microseconds
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto const& buffer : buffers) {
+    auto droppedCount = buffer->drain([&](const TraceEvent& event) {
+      stream << (first ? "" : ",") << "{\"name\":";
+      writeJSONString(stream, event.name);
+      stream << ",\"cat\":\"probe.gl\",\"ph\":\"X\",\"ts\":" << event.startNs / 1000.0
+             << ",\"dur\":" << event.durationNs / 1000.0 << ",\"pid\":1,\"tid\":" << buffer->threadId();
+      if (event.arg[0] != '\0') {
+        stream << ",\"args\":{\"id\":";
+        writeJSONString(stream, event.arg);
+        stream << "}";
+      }
+      stream << "}";
+      first = false;
+    });
+
+    if (droppedCount > 0) {
+      probegl::WarningLog() << "Tracer: " << droppedCount << " spans were dropped by thread " << buffer->threadId()
+                            << ", flush more often to avoid losing spans";
+    }
+  }
+  stream << "]}";
+
+  stream.flags(flags);
+
+  // Buffers of exited threads are no longer needed once they've been drained, unless another thread took them over
+  std::lock_guard<std::mutex> lock{this->_buffersMutex};
+  this->_buffers.erase(std::remove_if(this->_buffers.begin(), this->_buffers.end(),
+                                      [](const std::shared_ptr<TraceBuffer>& buffer) {
+                                        return buffer->released() && buffer->empty();
+                                      }),
+                       this->_buffers.end());
+}
+
+void Tracer::writeToFile(const std::string& path) {
+  writeFileAtomically(path, [&](std::ostream& stream) { this->flush(stream); });
+}
+
+auto Tracer::bufferCount() -> size_t {
+  std::lock_guard<std::mutex> lock{this->_buffersMutex};
+  return this->_buffers.size();
+}
+
+auto Tracer::_getThreadBuffer() -> TraceBuffer& {
+  thread_local ThreadBufferHandle handle;
+  if (!handle.buffer) {
+    handle.buffer = this->_acquireBuffer();
+  }
+
+  return *handle.buffer;
+}
+
+auto Tracer::_acquireBuffer() -> std::shared_ptr<TraceBuffer> {
+  std::lock_guard<std::mutex> lock{this->_buffersMutex};
+  // Spans that the previous thread didn't get to flush are kept, and flushed under the same thread id
+  for (auto const& buffer : this->_buffers) {
+    if (buffer->released()) {
+      buffer->setReleased(false);
+      return buffer;
+    }
+  }
+
+  this->_buffers.push_back(std::make_shared<TraceBuffer>(this->_nextThreadId++));
+  return this->_buffers.back();
+}
+
+void TraceScope::_begin(const char* name, const char* arg) {
+  this->_event.name = name;
+  size_t argLength = 0;
+  if (arg) {
+    argLength = strnlen(arg, TraceEvent::kMaxArgLength);
+    std::memcpy(this->_event.arg, arg, argLength);
+  }
+  this->_event.arg[argLength] = '\0';
+
+  // Read the clock last, so that the span doesn't include its own setup
+  this->_event.startNs = Tracer::now();
+}
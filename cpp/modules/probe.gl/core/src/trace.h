@@ -0,0 +1,184 @@
+// Copyright (c) 2020 Unfolded Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PROBEGL_CORE_TRACE_H
+#define PROBEGL_CORE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Trace spans record the time spent in a scope into a timeline that can be opened in Perfetto or chrome://tracing:
+//
+//     void LayerManager::updateLayers() {
+//       PROBEGL_TRACE_SCOPE("LayerManager::updateLayers");
+//       ...
+//     }
+//
+// An optional second argument, e.g. a layer id, is recorded along with each span. Spans are only recorded while
+// tracing is enabled with probegl::Tracer::instance().setEnabled(true), and are compiled out entirely unless
+// PROBEGL_ENABLE_TRACING is defined.
+
+#define PROBEGL_TRACE_CONCAT_HELPER(a, b) a##b
+#define PROBEGL_TRACE_CONCAT(a, b) PROBEGL_TRACE_CONCAT_HELPER(a, b)
+
+#if defined(PROBEGL_ENABLE_TRACING)
+#define PROBEGL_TRACE_SCOPE(...) probegl::TraceScope PROBEGL_TRACE_CONCAT(probeglTraceScope, __LINE__)(__VA_ARGS__)
+#else
+#define PROBEGL_TRACE_SCOPE(...)
+#endif
+
+namespace probegl {
+
+/// \brief A completed span, as recorded into a thread's trace buffer.
+struct TraceEvent {
+  static constexpr size_t kMaxArgLength = 47;
+
+  /// \brief Name of the span, which has to be a string literal.
+  const char* name;
+  /// \brief Optional span argument, truncated to kMaxArgLength characters to avoid allocating while recording.
+  char arg[kMaxArgLength + 1];
+  uint64_t startNs;
+  uint64_t durationNs;
+};
+
+/// \brief Fixed size, lock-free ring buffer of events recorded by a single thread and drained by a single reader.
+/// Events recorded while the buffer is full are dropped, rather than stalling the recording thread.
+class TraceBuffer {
+ public:
+  /// \param capacity Maximum number of undrained events, rounded up to a power of two.
+  explicit TraceBuffer(uint32_t threadId, size_t capacity = 16384);
+
+  auto threadId() const -> uint32_t { return this->_threadId; }
+
+  /// \brief Whether all the recorded events have been drained.
+  auto empty() const -> bool {
+    return this->_head.load(std::memory_order_acquire) == this->_tail.load(std::memory_order_acquire);
+  }
+
+  /// \brief Whether the thread owning this buffer has exited, in which case it can be handed over to another thread.
+  auto released() const -> bool { return this->_released.load(std::memory_order_acquire); }
+  void setReleased(bool released) { this->_released.store(released, std::memory_order_release); }
+
+  /// \brief Appends an event. Must only be called from the thread owning the buffer.
+  void push(const TraceEvent& event) {
+    auto head = this->_head.load(std::memory_order_relaxed);
+    if (head - this->_tail.load(std::memory_order_acquire) > this->_mask) {
+      this->_droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    this->_events[head & this->_mask] = event;
+    this->_head.store(head + 1, std::memory_order_release);
+  }
+
+  /// \brief Removes all the recorded events, passing each one of them to the given callback.
+  /// Must not be called from multiple threads at once.
+  /// \return Number of events that were dropped since the last drain because the buffer was full.
+  auto drain(const std::function<void(const TraceEvent&)>& onEvent) -> uint64_t;
+
+ private:
+  uint32_t _threadId;
+  std::vector<TraceEvent> _events;
+  uint64_t _mask;
+  std::atomic<uint64_t> _head{0};
+  std::atomic<uint64_t> _tail{0};
+  std::atomic<uint64_t> _droppedCount{0};
+  std::atomic<bool> _released{false};
+};
+
+/// \brief Collects spans recorded by all the threads, and exports them in Chrome trace event format.
+class Tracer {
+ public:
+  static auto instance() -> Tracer&;
+
+  auto enabled() const -> bool { return this->_enabled.load(std::memory_order_relaxed); }
+  void setEnabled(bool enabled) { this->_enabled.store(enabled, std::memory_order_relaxed); }
+
+  /// \brief Records a span into the trace buffer of the calling thread.
+  void record(const TraceEvent& event) { this->_getThreadBuffer().push(event); }
+
+  /// \brief Writes all the spans recorded since the last flush as a Chrome trace event JSON object, and clears them.
+  void flush(std::ostream& stream);
+  /// \brief Flushes recorded spans into a JSON file, which can be opened in Perfetto or chrome://tracing.
+  /// \throws std::runtime_error if the file couldn't be written.
+  void writeToFile(const std::string& path);
+
+  /// \brief Returns the number of trace buffers, one for each thread that is recording spans and one for each exited
+  /// thread whose spans haven't been flushed yet.
+  auto bufferCount() -> size_t;
+
+  /// \brief Returns the current time in nanoseconds, relative to an unspecified origin.
+  static auto now() -> uint64_t {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+ private:
+  Tracer() = default;
+
+  auto _getThreadBuffer() -> TraceBuffer&;
+  /// \brief Hands a buffer released by an exited thread over to the calling thread, or creates a new one.
+  auto _acquireBuffer() -> std::shared_ptr<TraceBuffer>;
+
+  std::atomic<bool> _enabled{false};
+  std::mutex _buffersMutex;
+  /// Buffers are shared with their threads, so that spans of threads that have exited can still be flushed. Buffers
+  /// of exited threads are reused by new threads, and freed once they've been flushed.
+  std::vector<std::shared_ptr<TraceBuffer>> _buffers;
+  uint32_t _nextThreadId{1};
+};
+
+/// \brief Records a span covering the lifetime of this object, use PROBEGL_TRACE_SCOPE instead of using it directly.
+class TraceScope {
+ public:
+  /// \param name Name of the span, which has to be a string literal as only the pointer to it is recorded.
+  explicit TraceScope(const char* name, const char* arg = nullptr) {
+    if (Tracer::instance().enabled()) {
+      this->_begin(name, arg);
+    }
+  }
+  TraceScope(const char* name, const std::string& arg) : TraceScope{name, arg.c_str()} {}
+  ~TraceScope() {
+    if (this->_event.name) {
+      this->_event.durationNs = Tracer::now() - this->_event.startNs;
+      Tracer::instance().record(this->_event);
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  auto operator=(const TraceScope&) -> TraceScope& = delete;
+
+ private:
+  void _begin(const char* name, const char* arg);
+
+  TraceEvent _event{nullptr};
+};
+
+}  // namespace probegl
+
+#endif  // PROBEGL_CORE_TRACE_H
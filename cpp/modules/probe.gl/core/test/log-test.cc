@@ -0,0 +1,176 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "probe.gl/core.h"
+
+using namespace probegl;
+
+namespace {
+
+/// \brief A value that counts how many times it was formatted.
+struct CountedValue {
+  int* formatCount;
+};
+
+auto operator<<(std::ostream& stream, const CountedValue& value) -> std::ostream& {
+  (*value.formatCount)++;
+  return stream << "value";
+}
+
+/// \brief The fixture for testing logging, which captures log output into a temporary file.
+class LogTest : public ::testing::Test {
+ protected:
+  LogTest() : defaultOptions{getLogOptions()}, output{std::tmpfile()} {}
+  ~LogTest() {
+    setLogOptions(this->defaultOptions);
+    std::fclose(this->output);
+  }
+
+  auto readOutput() -> std::string {
+    flushLog();
+    std::string contents;
+    std::rewind(this->output);
+    for (int c = std::fgetc(this->output); c != EOF; c = std::fgetc(this->output)) {
+      contents += static_cast<char>(c);
+    }
+
+    return contents;
+  }
+
+  LogOptions defaultOptions;
+  FILE* output;
+};
+
+TEST_F(LogTest, MinSeverity) {
+  LogOptions options;
+  options.minSeverity = LogSeverity::Warning;
+  options.output = this->output;
+  setLogOptions(options);
+
+  int formatCount = 0;
+  InfoLog() << CountedValue{&formatCount};
+  WarningLog() << "Warning " << CountedValue{&formatCount};
+
+  EXPECT_EQ(this->readOutput(), "Warning: Warning value\n");
+  EXPECT_EQ(formatCount, 1);
+}
+
+TEST_F(LogTest, RateLimit) {
+  LogOptions options;
+  options.rateLimit = 2;
+  options.rateLimitInterval = 0.05;
+  options.output = this->output;
+  setLogOptions(options);
+
+  for (auto i = 0; i < 5; i++) {
+    WarningLog() << "Repeated";
+  }
+  ErrorLog() << "Other";
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+  WarningLog() << "Repeated";
+
+  EXPECT_EQ(this->readOutput(),
+            "Warning: Repeated\nWarning: Repeated\nError: Other\n"
+            "Warning: Suppressed 3 repeats of: Repeated\nWarning: Repeated\n");
+}
+
+TEST_F(LogTest, JSONLines) {
+  LogOptions options;
+  options.format = LogFormat::JSONLines;
+  options.output = this->output;
+  setLogOptions(options);
+
+  ErrorLog() << "Quoted \"message\"";
+
+  auto output = this->readOutput();
+  EXPECT_EQ(output.find("{\"time\":"), 0u);
+  EXPECT_NE(output.find(",\"severity\":\"Error\",\"message\":\"Quoted \\\"message\\\"\"}\n"), std::string::npos);
+}
+
+TEST_F(LogTest, Async) {
+  LogOptions options;
+  options.async = true;
+  options.output = this->output;
+  setLogOptions(options);
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; i++) {
+    threads.emplace_back([]() {
+      for (auto j = 0; j < 100; j++) {
+        InfoLog() << "Message";
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto output = this->readOutput();
+  size_t lineCount = 0;
+  for (auto c : output) {
+    lineCount += c == '\n';
+  }
+  EXPECT_EQ(lineCount, 400u);
+
+  // Switching back to synchronous logging writes out all the queued messages
+  InfoLog() << "Last";
+  setLogOptions(LogOptions{});
+  EXPECT_NE(this->readOutput().find("Info: Last\n"), std::string::npos);
+}
+
+TEST_F(LogTest, AsyncShutdown) {
+  LogOptions syncOptions;
+  syncOptions.output = this->output;
+  LogOptions asyncOptions = syncOptions;
+  asyncOptions.async = true;
+  setLogOptions(asyncOptions);
+
+  // Messages logged while the writer is being stopped are still written out
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; i++) {
+    threads.emplace_back([]() {
+      for (auto j = 0; j < 200; j++) {
+        InfoLog() << "Message";
+      }
+    });
+  }
+  for (auto i = 0; i < 21; i++) {
+    setLogOptions(i % 2 == 0 ? syncOptions : asyncOptions);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto output = this->readOutput();
+  size_t lineCount = 0;
+  for (auto c : output) {
+    lineCount += c == '\n';
+  }
+  EXPECT_EQ(lineCount, 800u);
+}
+
+}  // namespace
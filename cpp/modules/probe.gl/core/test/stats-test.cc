@@ -0,0 +1,131 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "probe.gl/core.h"
+
+using namespace probegl;
+
+TEST(ProbeGL, StatsCounter) {
+  Stats stats{"test"};
+  auto& counter = stats.get("Draw Calls");
+  counter.increment();
+  counter.increment(2);
+  EXPECT_EQ(&stats.get("Draw Calls"), &counter);
+  EXPECT_THROW(stats.get("Draw Calls", Stat::Type::TIMER), std::logic_error);
+
+  auto snapshots = stats.snapshot(true);
+  ASSERT_EQ(snapshots.size(), 1u);
+  EXPECT_EQ(snapshots[0].name, "Draw Calls");
+  EXPECT_EQ(snapshots[0].count, 3u);
+  EXPECT_EQ(counter.snapshot().count, 0u);
+
+  // Disabled stats don't record anything
+  stats.setEnabled(false);
+  counter.increment();
+  EXPECT_EQ(counter.snapshot().count, 0u);
+}
+
+TEST(ProbeGL, StatsGauge) {
+  Stats stats{"deck.gl"};
+  auto& gauge = stats.get("GPU Memory", Stat::Type::GAUGE);
+  gauge.set(1024);
+  gauge.set(512);
+
+  // Gauges keep their values when stats are reset
+  EXPECT_EQ(stats.snapshot(true)[0].count, 512u);
+  EXPECT_EQ(gauge.snapshot().count, 512u);
+
+  std::stringstream prometheus;
+  stats.exportPrometheus(prometheus);
+  EXPECT_EQ(prometheus.str(), "# TYPE deck_gl_gpu_memory gauge\ndeck_gl_gpu_memory 512\n");
+
+  // Removed stats are no longer exported, and start over if they're retrieved again
+  EXPECT_TRUE(stats.remove("GPU Memory"));
+  EXPECT_FALSE(stats.remove("GPU Memory"));
+  EXPECT_TRUE(stats.snapshot().empty());
+  EXPECT_EQ(stats.get("GPU Memory", Stat::Type::GAUGE).snapshot().count, 0u);
+}
+
+TEST(ProbeGL, StatsTimer) {
+  Stats stats{"test"};
+  auto& timer = stats.get("Frame Time", Stat::Type::TIMER);
+  {
+    ScopedStatTimer scopedTimer{timer};
+    uSleep(10);
+  }
+  timer.addSample(1.0);
+  { ScopedStatTimer missingTimer{nullptr}; }
+
+  auto snapshot = timer.snapshot();
+  EXPECT_EQ(snapshot.count, 2u);
+  EXPECT_GT(snapshot.min, 0.0);
+  EXPECT_DOUBLE_EQ(snapshot.max, 1.0);
+  EXPECT_DOUBLE_EQ(snapshot.average(), snapshot.sum / 2);
+}
+
+TEST(ProbeGL, StatsHistogram) {
+  Stats stats{"test"};
+  EXPECT_THROW(stats.getHistogram("Unsorted", {2.0, 1.0}), std::logic_error);
+
+  auto& histogram = stats.getHistogram("Instances", {10.0, 100.0});
+  for (auto value : {5.0, 10.0, 50.0, 500.0}) {
+    histogram.addSample(value);
+  }
+
+  auto snapshot = histogram.snapshot();
+  EXPECT_EQ(snapshot.count, 4u);
+  EXPECT_DOUBLE_EQ(snapshot.sum, 565.0);
+  EXPECT_EQ(snapshot.bucketCounts, (std::vector<uint64_t>{2, 1, 1}));
+}
+
+TEST(ProbeGL, StatsExport) {
+  Stats stats{"deck.gl"};
+  stats.get("Draw Calls").increment(4);
+  stats.get("Layer Update Time", Stat::Type::TIMER).addSample(0.5);
+  stats.getHistogram("Frame Time", {0.1}).addSample(0.05);
+
+  std::stringstream json;
+  stats.exportJSON(json);
+  EXPECT_EQ(json.str(),
+            "{\"id\":\"deck.gl\",\"stats\":["
+            "{\"name\":\"Draw Calls\",\"type\":\"counter\",\"count\":4},"
+            "{\"name\":\"Layer Update Time\",\"type\":\"timer\",\"count\":1,"
+            "\"sum\":0.5,\"min\":0.5,\"max\":0.5,\"average\":0.5},"
+            "{\"name\":\"Frame Time\",\"type\":\"histogram\",\"count\":1,"
+            "\"sum\":0.05,\"min\":0.05,\"max\":0.05,\"average\":0.05,\"bounds\":[0.1],\"counts\":[1,0]}]}");
+
+  std::stringstream prometheus;
+  stats.exportPrometheus(prometheus);
+  EXPECT_EQ(prometheus.str(),
+            "# TYPE deck_gl_draw_calls_total counter\n"
+            "deck_gl_draw_calls_total 4\n"
+            "# TYPE deck_gl_layer_update_time_seconds summary\n"
+            "deck_gl_layer_update_time_seconds_sum 0.5\n"
+            "deck_gl_layer_update_time_seconds_count 1\n"
+            "# TYPE deck_gl_frame_time histogram\n"
+            "deck_gl_frame_time_bucket{le=\"0.1\"} 1\n"
+            "deck_gl_frame_time_bucket{le=\"+Inf\"} 1\n"
+            "deck_gl_frame_time_sum 0.05\n"
+            "deck_gl_frame_time_count 1\n");
+}
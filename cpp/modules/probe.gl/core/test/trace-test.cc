@@ -0,0 +1,109 @@
+// Copyright (c) 2020, Unfolded Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "probe.gl/core.h"
+
+using namespace probegl;
+
+namespace {
+
+auto countOccurrences(const std::string& string, const std::string& substring) -> size_t {
+  size_t count = 0;
+  for (auto position = string.find(substring); position != std::string::npos;
+       position = string.find(substring, position + 1)) {
+    count++;
+  }
+
+  return count;
+}
+
+}  // anonymous namespace
+
+TEST(ProbeGL, TraceBuffer) {
+  TraceBuffer buffer{1, 2};
+  buffer.push(TraceEvent{"first"});
+  buffer.push(TraceEvent{"second"});
+  buffer.push(TraceEvent{"dropped"});
+
+  std::vector<std::string> names;
+  EXPECT_EQ(buffer.drain([&](const TraceEvent& event) { names.push_back(event.name); }), 1u);
+  EXPECT_EQ(names, (std::vector<std::string>{"first", "second"}));
+  EXPECT_EQ(buffer.drain([&](const TraceEvent& event) { names.push_back(event.name); }), 0u);
+  EXPECT_EQ(names.size(), 2u);
+}
+
+TEST(ProbeGL, Tracer) {
+  auto& tracer = Tracer::instance();
+  std::stringstream discarded;
+  tracer.flush(discarded);
+
+  // Spans aren't recorded while tracing is disabled
+  { TraceScope scope{"Disabled"}; }
+
+  tracer.setEnabled(true);
+  { TraceScope scope{"Main", std::string{"layer-id"}}; }
+  std::thread thread{[]() { TraceScope scope{"Worker"}; }};
+  thread.join();
+  tracer.setEnabled(false);
+
+  std::stringstream trace;
+  tracer.flush(trace);
+  auto json = trace.str();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[{"), 0u);
+  EXPECT_EQ(countOccurrences(json, "\"ph\":\"X\""), 2u);
+  EXPECT_EQ(countOccurrences(json, "\"name\":\"Main\""), 1u);
+  EXPECT_EQ(countOccurrences(json, "\"args\":{\"id\":\"layer-id\"}"), 1u);
+  EXPECT_EQ(countOccurrences(json, "\"name\":\"Worker\""), 1u);
+  EXPECT_EQ(countOccurrences(json, "Disabled"), 0u);
+
+  // Flushing clears recorded spans
+  std::stringstream emptyTrace;
+  tracer.flush(emptyTrace);
+  EXPECT_EQ(emptyTrace.str(), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+}
+
+TEST(ProbeGL, TracerReleasesBuffersOfExitedThreads) {
+  auto& tracer = Tracer::instance();
+  std::stringstream discarded;
+  tracer.flush(discarded);
+  auto bufferCount = tracer.bufferCount();
+
+  // Threads that run one after another take over the buffer of the previous one
+  tracer.setEnabled(true);
+  for (int i = 0; i < 4; i++) {
+    std::thread thread{[]() { TraceScope scope{"Worker"}; }};
+    thread.join();
+  }
+  tracer.setEnabled(false);
+  EXPECT_LE(tracer.bufferCount(), bufferCount + 1);
+
+  std::stringstream trace;
+  tracer.flush(trace);
+  EXPECT_EQ(countOccurrences(trace.str(), "\"name\":\"Worker\""), 4u);
+
+  // Once flushed, buffers of exited threads are freed
+  EXPECT_LE(tracer.bufferCount(), bufferCount);
+}